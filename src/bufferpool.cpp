@@ -0,0 +1,50 @@
+#include "bufferpool.h"
+
+/// Puffer, die über dieses Vielfache der Standardgröße gewachsen sind, werden nicht aufbewahrt
+static constexpr int OversizeFactor = 16;
+
+BufferPool::BufferPool(int bufferSize, int maxPooled)
+    : m_bufferSize(bufferSize)
+    , m_maxPooled(maxPooled)
+    , m_allocations(0)
+    , m_reuses(0)
+{
+}
+
+/**
+ * @brief Liefert einen Puffer aus dem Pool oder legt einen neuen an
+ *
+ * reserve() markiert die Kapazität als reserviert, dadurch gibt
+ * resize(0) den Speicher später nicht frei.
+ */
+QByteArray BufferPool::acquire()
+{
+    if (!m_free.isEmpty()) {
+        m_reuses++;
+        QByteArray buffer = m_free.takeLast();
+        buffer.resize(0);
+        return buffer;
+    }
+
+    m_allocations++;
+    QByteArray buffer;
+    buffer.reserve(m_bufferSize);
+    return buffer;
+}
+
+void BufferPool::release(QByteArray &buffer)
+{
+    if (m_free.size() < m_maxPooled && buffer.capacity() <= m_bufferSize * OversizeFactor) {
+        buffer.resize(0);
+        m_free.append(buffer);
+    }
+    buffer = QByteArray();
+}
+
+qint64 BufferPool::pooledBytes() const
+{
+    qint64 bytes = 0;
+    for (const QByteArray &buffer : m_free)
+        bytes += buffer.capacity();
+    return bytes;
+}
@@ -0,0 +1,64 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief Pool wiederverwendbarer Puffer für Empfang und Versand
+ *
+ * Puffer werden mit reservierter Kapazität ausgegeben und nach der Rückgabe
+ * geleert, aber nicht freigegeben. Im eingeschwungenen Zustand entstehen
+ * beim Lesen und Senden damit keine Heap-Allokationen mehr.
+ *
+ * Puffer, die durch eine große Nachricht stark gewachsen sind, werden bei
+ * der Rückgabe verworfen, damit ein einzelner Ausreißer nicht dauerhaft
+ * Speicher im Pool bindet.
+ *
+ * @note Nicht threadsicher - jeder MqttReactor besitzt eigene Pools.
+ */
+class BufferPool
+{
+public:
+    /**
+     * @brief Konstruktor
+     * @param bufferSize Reservierte Kapazität neuer Puffer in Bytes
+     * @param maxPooled Maximale Anzahl vorgehaltener Puffer
+     */
+    explicit BufferPool(int bufferSize = 4096, int maxPooled = 32);
+
+    /**
+     * @brief Liefert einen leeren Puffer mit mindestens bufferSize() Kapazität
+     */
+    QByteArray acquire();
+
+    /**
+     * @brief Gibt einen Puffer an den Pool zurück
+     * @param buffer Puffer aus acquire() (ist danach leer)
+     */
+    void release(QByteArray &buffer);
+
+    /// Reservierte Kapazität neuer Puffer
+    int bufferSize() const { return m_bufferSize; }
+
+    /// Anzahl aktuell vorgehaltener Puffer
+    int pooledCount() const { return m_free.size(); }
+
+    /// Im Pool gebundener Speicher in Bytes
+    qint64 pooledBytes() const;
+
+    /// Anzahl neu angelegter Puffer
+    quint64 allocations() const { return m_allocations; }
+
+    /// Anzahl wiederverwendeter Puffer
+    quint64 reuses() const { return m_reuses; }
+
+private:
+    QVector<QByteArray> m_free;                              ///< Freie Puffer (LIFO, zuletzt benutzte sind warm im Cache)
+    int m_bufferSize;                                        ///< Reservierte Kapazität neuer Puffer
+    int m_maxPooled;                                         ///< Obergrenze vorgehaltener Puffer
+    quint64 m_allocations;                                   ///< Statistik: neu angelegte Puffer
+    quint64 m_reuses;                                        ///< Statistik: wiederverwendete Puffer
+};
+
+#endif // BUFFERPOOL_H
@@ -0,0 +1,330 @@
+#include "clientsnapshot.h"
+#include "crc32c.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr char Magic[8] = {'N', 'S', 'W', 'S', 'N', 'A', 'P', '\0'};
+constexpr quint32 Version = 1;
+constexpr quint32 ByteOrderMark = 0x01020304;
+
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    qint64 createdMs;
+    qint32 activeNetwork;
+    quint32 subscriptionCount;
+    quint32 valueCount;
+    quint32 clientIdSize;
+    quint64 clientIdOffset;
+    quint64 subscriptionsOffset;
+    quint64 valuesOffset;
+    quint64 totalSize;
+    quint32 bodyCrc;                                         ///< CRC32C über alles hinter dem Header
+    quint32 reserved;
+};
+
+struct SubscriptionRecord {
+    quint32 topicOffset;
+    quint16 topicSize;
+    quint8 qos;
+    qint8 network;
+};
+
+struct ValueRecord {
+    quint64 hash;
+    qint64 timestampMs;
+    quint32 topicOffset;
+    quint32 topicSize;
+    quint32 valueOffset;
+    quint32 valueSize;
+};
+
+static_assert(sizeof(FileHeader) == 80, "Snapshot-Header muss 80 Bytes groß sein");
+static_assert(sizeof(SubscriptionRecord) == 8, "Abonnement-Datensatz muss 8 Bytes groß sein");
+static_assert(sizeof(ValueRecord) == 32, "Werte-Datensatz muss 32 Bytes groß sein");
+
+void align8(QByteArray &buffer)
+{
+    buffer.append(QByteArray((8 - buffer.size() % 8) % 8, '\0'));
+}
+
+/// true wenn size weitere Bytes ab dem Dateiende noch mit 32-Bit-Offsets adressierbar sind
+bool fitsOffset(const QByteArray &buffer, qint64 size)
+{
+    return (qint64)buffer.size() + size <= (qint64)std::numeric_limits<quint32>::max();
+}
+
+}
+
+ClientSnapshot::ClientSnapshot()
+    : m_data(nullptr)
+    , m_size(0)
+{
+}
+
+ClientSnapshot::~ClientSnapshot()
+{
+    close();
+}
+
+quint64 ClientSnapshot::topicHash(const QByteArray &topic)
+{
+    quint64 hash = 14695981039346656037ULL;
+    for (char c : topic) {
+        hash ^= (quint8)c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Baut die Datei im Speicher auf und ersetzt die alte atomar
+ *
+ * Erst werden Platz für Header und Datensätze reserviert, dann Topics
+ * und Payloads angehängt und die Offsets in die Datensätze eingetragen.
+ */
+bool ClientSnapshot::write(const QString &path, const Session &session, const QVector<Subscription> &subscriptions,
+                           const QVector<Value> &values, QString *errorString)
+{
+    auto fail = [errorString](const QString &message) {
+        if (errorString)
+            *errorString = message;
+        return false;
+    };
+
+    QByteArray file(sizeof(FileHeader), '\0');
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrderMark;
+    header.createdMs = session.createdMs;
+    header.activeNetwork = session.activeNetwork;
+    header.subscriptionCount = (quint32)subscriptions.size();
+    header.valueCount = (quint32)values.size();
+
+    const QByteArray clientId = session.clientId.toUtf8();
+    header.clientIdOffset = file.size();
+    header.clientIdSize = (quint32)clientId.size();
+    file.append(clientId);
+    align8(file);
+
+    header.subscriptionsOffset = file.size();
+    file.append(QByteArray((int)(subscriptions.size() * sizeof(SubscriptionRecord)), '\0'));
+    header.valuesOffset = file.size();
+    file.append(QByteArray((int)(values.size() * sizeof(ValueRecord)), '\0'));
+
+    for (int i = 0; i < subscriptions.size(); ++i) {
+        const QByteArray topic = subscriptions.at(i).topic.toUtf8();
+        if (topic.size() > 0xFFFF)
+            return fail("Snapshot: Topic zu lang (" + QString::number(topic.size()) + " Bytes)");
+        if (subscriptions.at(i).network < std::numeric_limits<qint8>::min()
+            || subscriptions.at(i).network > std::numeric_limits<qint8>::max())
+            return fail("Snapshot: Netz-ID außerhalb des Formats");
+        if (!fitsOffset(file, topic.size()))
+            return fail("Snapshot zu groß für 32-Bit-Offsets");
+
+        SubscriptionRecord record;
+        record.topicOffset = (quint32)file.size();
+        record.topicSize = (quint16)topic.size();
+        record.qos = subscriptions.at(i).qos;
+        record.network = (qint8)subscriptions.at(i).network;
+        file.append(topic.constData(), record.topicSize);
+        memcpy(file.data() + header.subscriptionsOffset + i * sizeof(SubscriptionRecord), &record, sizeof(record));
+    }
+
+    // Werte nach Hash sortiert ablegen (Binärsuche beim Lesen)
+    QVector<ValueRecord> records;
+    records.reserve(values.size());
+    for (const Value &value : values) {
+        const QByteArray topic = value.topic.toUtf8();
+        if (!fitsOffset(file, (qint64)topic.size() + value.value.size()))
+            return fail("Snapshot zu groß für 32-Bit-Offsets");
+
+        ValueRecord record;
+        record.hash = topicHash(topic);
+        record.timestampMs = value.timestampMs;
+        record.topicOffset = (quint32)file.size();
+        record.topicSize = (quint32)topic.size();
+        file.append(topic);
+        record.valueOffset = (quint32)file.size();
+        record.valueSize = (quint32)value.value.size();
+        file.append(value.value);
+        records.append(record);
+    }
+    std::sort(records.begin(), records.end(), [](const ValueRecord &a, const ValueRecord &b) { return a.hash < b.hash; });
+    if (!records.isEmpty())
+        memcpy(file.data() + header.valuesOffset, records.constData(), records.size() * sizeof(ValueRecord));
+
+    header.totalSize = file.size();
+    header.bodyCrc = Crc32c::compute(file.constData() + sizeof(FileHeader), file.size() - (int)sizeof(FileHeader));
+    memcpy(file.data(), &header, sizeof(header));
+
+    QSaveFile output(path);
+    if (!output.open(QIODevice::WriteOnly) || output.write(file) != file.size() || !output.commit())
+        return fail("Snapshot kann nicht geschrieben werden: " + output.errorString());
+    return true;
+}
+
+/**
+ * @brief Blendet die Datei ein und prüft Header, Grenzen und Prüfsumme
+ */
+bool ClientSnapshot::open(const QString &path, QString *errorString)
+{
+    close();
+
+    auto fail = [this, errorString](const QString &message) {
+        if (errorString)
+            *errorString = message;
+        close();
+        return false;
+    };
+
+    m_file = std::make_unique<QFile>(path);
+    if (!m_file->open(QIODevice::ReadOnly))
+        return fail("Snapshot nicht vorhanden: " + path);
+
+    const qint64 size = m_file->size();
+    if (size < (qint64)sizeof(FileHeader))
+        return fail("Snapshot zu kurz");
+
+    const uchar *data = m_file->map(0, size);
+    if (!data)
+        return fail("Snapshot kann nicht eingeblendet werden: " + m_file->errorString());
+
+    FileHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.byteOrder != ByteOrderMark)
+        return fail("Unbekanntes Snapshot-Format");
+
+    const quint64 subscriptionsEnd = header.subscriptionsOffset + (quint64)header.subscriptionCount * sizeof(SubscriptionRecord);
+    const quint64 valuesEnd = header.valuesOffset + (quint64)header.valueCount * sizeof(ValueRecord);
+    if (header.totalSize != (quint64)size
+        || header.clientIdOffset + header.clientIdSize > (quint64)size
+        || subscriptionsEnd > (quint64)size || valuesEnd > (quint64)size
+        || header.subscriptionsOffset % 8 != 0 || header.valuesOffset % 8 != 0)
+        return fail("Snapshot unvollständig");
+
+    const quint32 crc = Crc32c::compute(reinterpret_cast<const char*>(data) + sizeof(FileHeader), (int)(size - sizeof(FileHeader)));
+    if (crc != header.bodyCrc)
+        return fail("Snapshot-Prüfsumme falsch");
+
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void ClientSnapshot::close()
+{
+    if (m_file) {
+        if (m_data)
+            m_file->unmap(const_cast<uchar*>(m_data));
+        m_file->close();
+        m_file.reset();
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/// Sicht auf einen Bereich der Einblendung, leer wenn außerhalb
+QByteArray ClientSnapshot::bytes(quint32 offset, quint32 size) const
+{
+    if ((qint64)offset + size > m_size)
+        return QByteArray();
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data) + offset, (int)size);
+}
+
+ClientSnapshot::Session ClientSnapshot::session() const
+{
+    Session session;
+    if (!m_data)
+        return session;
+
+    const FileHeader *header = reinterpret_cast<const FileHeader*>(m_data);
+    session.clientId = QString::fromUtf8(bytes((quint32)header->clientIdOffset, header->clientIdSize));
+    session.activeNetwork = header->activeNetwork;
+    session.createdMs = header->createdMs;
+    return session;
+}
+
+QVector<ClientSnapshot::Subscription> ClientSnapshot::subscriptions() const
+{
+    QVector<Subscription> result;
+    if (!m_data)
+        return result;
+
+    const FileHeader *header = reinterpret_cast<const FileHeader*>(m_data);
+    const SubscriptionRecord *records = reinterpret_cast<const SubscriptionRecord*>(m_data + header->subscriptionsOffset);
+    result.reserve(header->subscriptionCount);
+    for (quint32 i = 0; i < header->subscriptionCount; ++i) {
+        Subscription subscription;
+        subscription.topic = QString::fromUtf8(bytes(records[i].topicOffset, records[i].topicSize));
+        subscription.qos = records[i].qos;
+        subscription.network = records[i].network;
+        result.append(subscription);
+    }
+    return result;
+}
+
+int ClientSnapshot::valueCount() const
+{
+    return m_data ? (int)reinterpret_cast<const FileHeader*>(m_data)->valueCount : 0;
+}
+
+/**
+ * @brief Binärsuche über den Hash, bei Kollisionen Vergleich des Topics
+ */
+bool ClientSnapshot::value(const QString &topic, QByteArray *value, qint64 *timestampMs) const
+{
+    if (!m_data)
+        return false;
+
+    const FileHeader *header = reinterpret_cast<const FileHeader*>(m_data);
+    const ValueRecord *begin = reinterpret_cast<const ValueRecord*>(m_data + header->valuesOffset);
+    const ValueRecord *end = begin + header->valueCount;
+
+    const QByteArray key = topic.toUtf8();
+    const quint64 hash = topicHash(key);
+    const ValueRecord *it = std::lower_bound(begin, end, hash, [](const ValueRecord &record, quint64 h) {
+        return record.hash < h;
+    });
+
+    for (; it != end && it->hash == hash; ++it) {
+        if (bytes(it->topicOffset, it->topicSize) != key)
+            continue;
+        if (value)
+            *value = bytes(it->valueOffset, it->valueSize);
+        if (timestampMs)
+            *timestampMs = it->timestampMs;
+        return true;
+    }
+    return false;
+}
+
+QVector<ClientSnapshot::Value> ClientSnapshot::values() const
+{
+    QVector<Value> result;
+    if (!m_data)
+        return result;
+
+    const FileHeader *header = reinterpret_cast<const FileHeader*>(m_data);
+    const ValueRecord *records = reinterpret_cast<const ValueRecord*>(m_data + header->valuesOffset);
+    result.reserve(header->valueCount);
+    for (quint32 i = 0; i < header->valueCount; ++i) {
+        Value value;
+        value.topic = QString::fromUtf8(bytes(records[i].topicOffset, records[i].topicSize));
+        value.value = QByteArray(bytes(records[i].valueOffset, records[i].valueSize).constData(), (int)records[i].valueSize);
+        value.timestampMs = records[i].timestampMs;
+        result.append(value);
+    }
+    return result;
+}
@@ -0,0 +1,120 @@
+#ifndef CLIENTSNAPSHOT_H
+#define CLIENTSNAPSHOT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class QFile;
+
+/**
+ * @brief Abbild des Client-Zustands für einen schnellen Neustart
+ *
+ * Enthält Sitzungsdaten (Client-ID, aktives Netz), die Abonnements aller
+ * Verbindungen und den Last-Value-Cache. Nach einem Neustart wird die
+ * Datei per mmap eingeblendet - die Werte stehen sofort zur Verfügung,
+ * während die Verbindungen im Hintergrund aufgebaut werden.
+ *
+ * Dateiformat (native Byte-Reihenfolge, Datensätze 8-Byte ausgerichtet):
+ * @code
+ * Header          80 Bytes, Magic "NSWSNAP", Version, Offsets, CRC32C
+ * Client-ID       UTF-8
+ * Abonnements     n x 8 Bytes  (Topic-Offset, Länge, QoS, Netz)
+ * Werte           m x 32 Bytes (Topic-Hash, Zeitstempel, Offsets, Längen), nach Hash sortiert
+ * Daten           Topics und Payloads
+ * @endcode
+ *
+ * Ein Wert wird per Binärsuche über den Topic-Hash gefunden und ohne
+ * Kopie als Sicht auf die Einblendung geliefert. Geschrieben wird über
+ * QSaveFile (atomares Umbenennen), eine noch eingeblendete alte Datei
+ * bleibt dabei gültig.
+ *
+ * Verwendung:
+ * @code
+ * auto snapshot = std::make_shared<ClientSnapshot>();
+ * if (snapshot->open(path)) {
+ *     QByteArray state;
+ *     if (snapshot->value("switch/state", &state))
+ *         qDebug() << "Letzter Zustand:" << state;
+ * }
+ * @endcode
+ */
+class ClientSnapshot
+{
+public:
+    /// Sitzungsdaten
+    struct Session {
+        QString clientId;
+        int activeNetwork = -1;
+        qint64 createdMs = 0;                                ///< Erstellungszeit (ms seit Epoch)
+    };
+
+    /// Abonnement einer Verbindung
+    struct Subscription {
+        QString topic;
+        quint8 qos = 0;
+        int network = 0;
+    };
+
+    /// Letzter Wert eines Topics
+    struct Value {
+        QString topic;
+        QByteArray value;
+        qint64 timestampMs = 0;                              ///< Empfangszeit (ms seit Epoch)
+    };
+
+    ClientSnapshot();
+    ~ClientSnapshot();
+
+    /**
+     * @brief Schreibt einen Snapshot
+     * @param path Zieldatei (wird atomar ersetzt)
+     * @param errorString Fehlerbeschreibung (optional)
+     * @return false auch bei Topics über 65535 Bytes, Netzen außerhalb
+     *         von qint8 oder einer Datei über 4 GiB (32-Bit-Offsets)
+     */
+    static bool write(const QString &path, const Session &session, const QVector<Subscription> &subscriptions,
+                      const QVector<Value> &values, QString *errorString = nullptr);
+
+    /**
+     * @brief Blendet einen Snapshot ein und prüft ihn
+     * @return false wenn die Datei fehlt, beschädigt ist oder nicht zum Format passt
+     */
+    bool open(const QString &path, QString *errorString = nullptr);
+
+    /// true wenn ein gültiger Snapshot eingeblendet ist
+    bool isOpen() const { return m_data != nullptr; }
+
+    /// Größe der Datei in Bytes
+    qint64 size() const { return m_size; }
+
+    Session session() const;
+    QVector<Subscription> subscriptions() const;
+
+    /// Anzahl gespeicherter Werte
+    int valueCount() const;
+
+    /**
+     * @brief Sucht den Wert eines Topics
+     * @param value Wert als Sicht auf die Einblendung (gültig solange der Snapshot offen ist)
+     * @param timestampMs Empfangszeit (optional)
+     */
+    bool value(const QString &topic, QByteArray *value, qint64 *timestampMs = nullptr) const;
+
+    /// Alle Werte als Kopie (z.B. um sie in einen neuen Snapshot zu übernehmen)
+    QVector<Value> values() const;
+
+    /// Hash für die Wertetabelle (FNV-1a, 64 Bit, über UTF-8)
+    static quint64 topicHash(const QByteArray &topic);
+
+private:
+    void close();
+    QByteArray bytes(quint32 offset, quint32 size) const;
+
+    std::unique_ptr<QFile> m_file;
+    const uchar *m_data;                                     ///< Einblendung (nullptr = keine)
+    qint64 m_size;
+};
+
+#endif // CLIENTSNAPSHOT_H
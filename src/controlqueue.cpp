@@ -0,0 +1,65 @@
+#include "controlqueue.h"
+
+#include <algorithm>
+
+ControlQueue::ControlQueue()
+    : m_nextOrder(0)
+{
+}
+
+bool ControlQueue::later(const Operation &a, const Operation &b)
+{
+    if (a.deadlineNs != b.deadlineNs)
+        return a.deadlineNs > b.deadlineNs;
+    return a.order > b.order;
+}
+
+void ControlQueue::push(qint64 deadlineNs, const QByteArray &packet, ExpiredCallback expired, WrittenCallback written)
+{
+    Operation operation;
+    operation.deadlineNs = deadlineNs;
+    operation.order = m_nextOrder++;
+    operation.packet = packet;
+    operation.expired = std::move(expired);
+    operation.written = std::move(written);
+
+    m_heap.push_back(std::move(operation));
+    std::push_heap(m_heap.begin(), m_heap.end(), later);
+}
+
+ControlQueue::Operation ControlQueue::pop()
+{
+    std::pop_heap(m_heap.begin(), m_heap.end(), later);
+    Operation operation = std::move(m_heap.back());
+    m_heap.pop_back();
+    return operation;
+}
+
+/**
+ * @brief Entnimmt abgelaufene Pakete von der Heap-Spitze
+ *
+ * Die früheste Frist steht oben - ist sie nicht abgelaufen, sind es
+ * auch alle anderen nicht.
+ */
+std::vector<ControlQueue::Operation> ControlQueue::takeExpired(qint64 nowNs)
+{
+    std::vector<Operation> expired;
+    while (!m_heap.empty() && m_heap.front().deadlineNs <= nowNs)
+        expired.push_back(pop());
+    return expired;
+}
+
+qint64 ControlQueue::memoryFootprint() const
+{
+    qint64 bytes = (qint64)(m_heap.capacity() * sizeof(Operation));
+    for (const Operation &operation : m_heap)
+        bytes += operation.packet.capacity();
+    return bytes;
+}
+
+std::vector<ControlQueue::Operation> ControlQueue::takeAll()
+{
+    std::vector<Operation> all;
+    all.swap(m_heap);
+    return all;
+}
@@ -0,0 +1,80 @@
+#ifndef CONTROLQUEUE_H
+#define CONTROLQUEUE_H
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Sendewarteschlange für Steuerpakete mit Frist (Earliest Deadline First)
+ *
+ * Umschaltbefehle und ähnliche Steuerpakete sind nur bis zu einer Frist
+ * sinnvoll. Staut sich der Socket, warten sie hier statt im Sendepuffer
+ * hinter Massendaten: Es wird immer das Paket mit der frühesten Frist als
+ * nächstes gesendet, Pakete mit abgelaufener Frist werden verworfen und
+ * ihr Callback aufgerufen, statt Bandbreite zu belegen.
+ *
+ * Die Warteschlange ist ein binärer Heap über (Frist, Einstellreihenfolge),
+ * bei gleicher Frist bleibt die Reihenfolge erhalten.
+ *
+ * Zeiten sind monotone Nanosekunden (MessageEnvelope::monotonicNs()).
+ *
+ * Verwendet vom MqttClient, siehe MqttClient::publishBefore().
+ */
+class ControlQueue
+{
+public:
+    /// Wird aufgerufen, wenn ein Paket wegen abgelaufener Frist verworfen wird
+    using ExpiredCallback = std::function<void()>;
+
+    /// Wird aufgerufen, sobald ein Paket an den Socket übergeben ist
+    using WrittenCallback = std::function<void()>;
+
+    /// Eingestelltes Steuerpaket
+    struct Operation {
+        qint64 deadlineNs = 0;
+        quint64 order = 0;                                   ///< Einstellreihenfolge (Gleichstand)
+        QByteArray packet;                                   ///< Fertiges MQTT-Paket
+        ExpiredCallback expired;
+        WrittenCallback written;
+    };
+
+    ControlQueue();
+
+    /// Stellt ein Paket ein
+    void push(qint64 deadlineNs, const QByteArray &packet, ExpiredCallback expired, WrittenCallback written = nullptr);
+
+    /// Entnimmt das Paket mit der frühesten Frist (Warteschlange darf nicht leer sein)
+    Operation pop();
+
+    /// Früheste Frist (Warteschlange darf nicht leer sein)
+    qint64 nextDeadlineNs() const { return m_heap.front().deadlineNs; }
+
+    bool isEmpty() const { return m_heap.empty(); }
+    int size() const { return (int)m_heap.size(); }
+
+    /// Belegter Speicher der wartenden Pakete in Bytes
+    qint64 memoryFootprint() const;
+
+    /**
+     * @brief Verwirft alle Pakete, deren Frist bis nowNs abgelaufen ist
+     * @return Verworfene Pakete, Callbacks sind noch nicht aufgerufen
+     *
+     * Die Callbacks ruft der Aufrufer auf, nachdem sein Zustand
+     * konsistent ist (sie dürfen neue Pakete einstellen).
+     */
+    std::vector<Operation> takeExpired(qint64 nowNs);
+
+    /// Entnimmt alle Pakete (z.B. bei Verbindungsverlust)
+    std::vector<Operation> takeAll();
+
+private:
+    /// Heap-Ordnung: früheste Frist oben
+    static bool later(const Operation &a, const Operation &b);
+
+    std::vector<Operation> m_heap;
+    quint64 m_nextOrder;
+};
+
+#endif // CONTROLQUEUE_H
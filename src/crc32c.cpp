@@ -0,0 +1,188 @@
+#include "crc32c.h"
+
+#include <QtEndian>
+#include <cstring>
+
+#if defined(Q_PROCESSOR_X86_64) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#define CRC32C_X86 1
+#include <nmmintrin.h>
+#endif
+
+#if defined(Q_PROCESSOR_ARM_64) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+#define CRC32C_ARM 1
+#include <arm_acle.h>
+#ifdef Q_OS_LINUX
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
+namespace {
+
+using ComputeFunction = quint32 (*)(const char*, int, quint32);
+
+constexpr quint32 Polynomial = 0x82F63B78;  // Castagnoli, bitweise umgekehrt
+
+/// Tabellen für Slicing-by-8: tables[k][b] = CRC von Byte b gefolgt von k Nullbytes
+struct Tables {
+    quint32 t[8][256];
+
+    Tables()
+    {
+        for (quint32 b = 0; b < 256; ++b) {
+            quint32 crc = b;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ ((crc & 1) ? Polynomial : 0);
+            t[0][b] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (int b = 0; b < 256; ++b)
+                t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+    }
+};
+
+const Tables& tables()
+{
+    static const Tables instance;
+    return instance;
+}
+
+quint32 computeSlicing(const char *data, int size, quint32 crc)
+{
+    const auto &t = tables().t;
+    const quint8 *p = reinterpret_cast<const quint8*>(data);
+    crc = ~crc;
+
+    while (size >= 8) {
+        quint32 low, high;
+        memcpy(&low, p, 4);
+        memcpy(&high, p + 4, 4);
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        low = qFromLittleEndian(low);
+        high = qFromLittleEndian(high);
+#endif
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+
+    return ~crc;
+}
+
+#ifdef CRC32C_X86
+__attribute__((target("sse4.2")))
+quint32 computeSse42(const char *data, int size, quint32 crc)
+{
+    quint64 state = ~crc;
+
+    while (size >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        state = _mm_crc32_u64(state, word);
+        data += 8;
+        size -= 8;
+    }
+    quint32 state32 = (quint32)state;
+    while (size-- > 0)
+        state32 = _mm_crc32_u8(state32, (quint8)*data++);
+
+    return ~state32;
+}
+#endif
+
+#ifdef CRC32C_ARM
+__attribute__((target("+crc")))
+quint32 computeArmv8(const char *data, int size, quint32 crc)
+{
+    quint32 state = ~crc;
+
+    while (size >= 8) {
+        quint64 word;
+        memcpy(&word, data, 8);
+        state = __crc32cd(state, word);
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        state = __crc32cb(state, (quint8)*data++);
+
+    return ~state;
+}
+#endif
+
+struct Selection {
+    ComputeFunction function = computeSlicing;
+    const char *name = "table";
+
+    Selection()
+    {
+#ifdef CRC32C_X86
+        if (__builtin_cpu_supports("sse4.2")) {
+            function = computeSse42;
+            name = "sse4.2";
+        }
+#endif
+#ifdef CRC32C_ARM
+#if defined(__ARM_FEATURE_CRC32)
+        const bool hasCrc = true;
+#elif defined(Q_OS_LINUX)
+        const bool hasCrc = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+        const bool hasCrc = false;
+#endif
+        if (hasCrc) {
+            function = computeArmv8;
+            name = "armv8";
+        }
+#endif
+    }
+};
+
+const Selection& selection()
+{
+    static const Selection instance;
+    return instance;
+}
+
+} // namespace
+
+quint32 Crc32c::compute(const char *data, int size, quint32 crc)
+{
+    return selection().function(data, size, crc);
+}
+
+quint32 Crc32c::computeTable(const char *data, int size, quint32 crc)
+{
+    return computeSlicing(data, size, crc);
+}
+
+const char* Crc32c::implementation()
+{
+    return selection().name;
+}
+
+void Crc32c::appendTrailer(QByteArray &buffer, int from)
+{
+    const quint32 crc = compute(buffer.constData() + from, buffer.size() - from);
+    buffer.append((char)(crc >> 24));
+    buffer.append((char)(crc >> 16));
+    buffer.append((char)(crc >> 8));
+    buffer.append((char)crc);
+}
+
+bool Crc32c::verifyTrailer(const char *data, int size)
+{
+    if (size < TrailerSize)
+        return false;
+
+    const int covered = size - TrailerSize;
+    const quint8 *trailer = reinterpret_cast<const quint8*>(data + covered);
+    const quint32 expected = (quint32)trailer[0] << 24 | (quint32)trailer[1] << 16
+                           | (quint32)trailer[2] << 8 | trailer[3];
+    return compute(data, covered) == expected;
+}
@@ -0,0 +1,66 @@
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief CRC32C (Castagnoli) Prüfsumme für Nutzdaten
+ *
+ * Wird als Integritätsschutz für Umschaltbefehle auf Pfaden ohne TLS
+ * verwendet (siehe MqttClient::setPayloadChecksum()).
+ *
+ * Die Implementierung wird einmalig zur Laufzeit gewählt:
+ * - x86-64 mit SSE4.2: crc32 Instruktion (8 Byte pro Schritt)
+ * - ARMv8 mit CRC-Erweiterung: crc32cx Instruktion
+ * - sonst: Tabellenverfahren (Slicing-by-8)
+ *
+ * Alle Varianten liefern identische Ergebnisse (Prüfwert für "123456789": 0xE3069283).
+ *
+ * Verwendung:
+ * @code
+ * quint32 crc = Crc32c::compute(data.constData(), data.size());
+ * // Fortsetzen über mehrere Blöcke
+ * crc = Crc32c::compute(more.constData(), more.size(), crc);
+ * @endcode
+ */
+class Crc32c
+{
+public:
+    static constexpr int TrailerSize = 4;                    ///< Größe der Prüfsumme im Anhang (Big Endian)
+
+    /**
+     * @brief Berechnet die Prüfsumme mit der schnellsten verfügbaren Variante
+     * @param data Zeiger auf die Daten
+     * @param size Länge in Bytes
+     * @param crc Ergebnis eines vorherigen Blocks zum Fortsetzen (0 = Anfang)
+     */
+    static quint32 compute(const char *data, int size, quint32 crc = 0);
+
+    /**
+     * @brief Berechnet die Prüfsumme immer mit dem Tabellenverfahren
+     *
+     * Referenz für Vergleichsmessungen und Plattformen ohne CRC-Instruktion.
+     */
+    static quint32 computeTable(const char *data, int size, quint32 crc = 0);
+
+    /// Name der gewählten Variante ("sse4.2", "armv8" oder "table")
+    static const char* implementation();
+
+    /**
+     * @brief Hängt die Prüfsumme über einen Bereich des Puffers an
+     * @param buffer Puffer (wird um TrailerSize Bytes erweitert)
+     * @param from Beginn des geschützten Bereichs, der bis zum Pufferende reicht
+     */
+    static void appendTrailer(QByteArray &buffer, int from);
+
+    /**
+     * @brief Prüft den Anhang am Ende eines Bereichs
+     * @param data Beginn des geschützten Bereichs
+     * @param size Länge inklusive Anhang
+     * @return true wenn der Anhang vorhanden ist und passt
+     */
+    static bool verifyTrailer(const char *data, int size);
+};
+
+#endif // CRC32C_H
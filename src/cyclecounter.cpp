@@ -0,0 +1,50 @@
+#include "cyclecounter.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Ermittelt die Zählerrate
+ *
+ * x86: Differenz von TSC und steady_clock über ca. 10 ms. Bei invariantem
+ * TSC reicht das für eine Genauigkeit im Promillebereich.
+ */
+double calibrate()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point clockStart = Clock::now();
+    const quint64 ticksStart = CycleCounter::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    const quint64 ticksEnd = CycleCounter::now();
+    const qint64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - clockStart).count();
+    return ns > 0 ? (double)(ticksEnd - ticksStart) / ns : 1.0;
+#elif defined(__aarch64__)
+    quint64 frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency > 0 ? frequency / 1e9 : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+}
+
+double CycleCounter::ticksPerNs()
+{
+    static const double rate = calibrate();
+    return rate;
+}
+
+const char* CycleCounter::source()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return "tsc";
+#elif defined(__aarch64__)
+    return "cntvct";
+#else
+    return "steady_clock";
+#endif
+}
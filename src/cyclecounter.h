@@ -0,0 +1,62 @@
+#ifndef CYCLECOUNTER_H
+#define CYCLECOUNTER_H
+
+#include <QtGlobal>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/**
+ * @brief Billiger Zeitstempel für Messungen im Nachrichtenpfad
+ *
+ * Liest direkt den Zykluszähler der CPU statt clock_gettime():
+ * - x86: rdtsc (invarianter TSC, konstante Rate)
+ * - ARMv8: cntvct_el0 (virtueller Zähler, Rate aus cntfrq_el0)
+ * - sonst: std::chrono::steady_clock in ns
+ *
+ * Zählerwerte sind nur als Differenz im selben Prozess sinnvoll. Die
+ * Umrechnung in ns wird beim ersten Aufruf von ticksPerNs() einmalig
+ * kalibriert (x86: ca. 10 ms Messung gegen steady_clock).
+ *
+ * Verwendung:
+ * @code
+ * const quint64 start = CycleCounter::now();
+ * handler(message);
+ * const qint64 ns = CycleCounter::toNs(CycleCounter::now() - start);
+ * @endcode
+ */
+class CycleCounter
+{
+public:
+    /// Aktueller Zählerstand
+    static inline quint64 now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        quint64 value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return (quint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /// Zählerschritte pro Nanosekunde (kalibriert)
+    static double ticksPerNs();
+
+    /// Zählerdifferenz in Nanosekunden
+    static qint64 toNs(quint64 ticks) { return (qint64)(ticks / ticksPerNs()); }
+
+    /// Dauer in Nanosekunden als Zählerdifferenz
+    static quint64 fromNs(qint64 ns) { return (quint64)(ns * ticksPerNs()); }
+
+    /// Name der Zählerquelle ("tsc", "cntvct" oder "steady_clock")
+    static const char* source();
+};
+
+#endif // CYCLECOUNTER_H
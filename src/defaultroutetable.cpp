@@ -0,0 +1,77 @@
+#include "defaultroutetable.h"
+
+/// Schlüssel nur prozessintern verwendet - native Byte-Reihenfolge genügt
+QByteArray DefaultRouteTable::routeKey(int family, quint32 metric, const QByteArray &gateway)
+{
+    const quint16 family16 = (quint16)family;
+    QByteArray key;
+    key.reserve(6 + gateway.size());
+    key.append(reinterpret_cast<const char*>(&family16), sizeof(family16));
+    key.append(reinterpret_cast<const char*>(&metric), sizeof(metric));
+    key.append(gateway);
+    return key;
+}
+
+bool DefaultRouteTable::add(const QString &interfaceName, const QByteArray &key)
+{
+    if (m_resyncing)
+        m_dumped[interfaceName].insert(key);
+
+    QSet<QByteArray> &routes = m_routes[interfaceName];
+    const bool first = routes.isEmpty();
+    routes.insert(key);
+    return first;
+}
+
+bool DefaultRouteTable::remove(const QString &interfaceName, const QByteArray &key)
+{
+    if (m_resyncing) {
+        auto dumped = m_dumped.find(interfaceName);
+        if (dumped != m_dumped.end() && dumped->remove(key) && dumped->isEmpty())
+            m_dumped.erase(dumped);
+    }
+
+    // Unbekannte Routen (z.B. vor dem ersten Dump) ändern nichts
+    auto it = m_routes.find(interfaceName);
+    if (it == m_routes.end() || !it->remove(key))
+        return false;
+    if (!it->isEmpty())
+        return false;
+    m_routes.erase(it);
+    return true;
+}
+
+bool DefaultRouteTable::removeInterface(const QString &interfaceName)
+{
+    m_dumped.remove(interfaceName);
+    return m_routes.remove(interfaceName) > 0;
+}
+
+void DefaultRouteTable::beginResync()
+{
+    m_dumped.clear();
+    m_resyncing = true;
+}
+
+void DefaultRouteTable::addDumped(const QString &interfaceName, const QByteArray &key)
+{
+    m_dumped[interfaceName].insert(key);
+}
+
+QVector<DefaultRouteTable::Change> DefaultRouteTable::endResync()
+{
+    QVector<Change> changes;
+    for (auto it = m_routes.constBegin(); it != m_routes.constEnd(); ++it) {
+        if (!m_dumped.contains(it.key()))
+            changes.append(Change(it.key(), false));
+    }
+    for (auto it = m_dumped.constBegin(); it != m_dumped.constEnd(); ++it) {
+        if (!m_routes.contains(it.key()))
+            changes.append(Change(it.key(), true));
+    }
+
+    m_routes = m_dumped;
+    m_dumped.clear();
+    m_resyncing = false;
+    return changes;
+}
@@ -0,0 +1,76 @@
+#ifndef DEFAULTROUTETABLE_H
+#define DEFAULTROUTETABLE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Default-Routen je Interface aus Routen-Ereignissen
+ *
+ * Ein Interface kann mehrere Default-Routen haben: je eine für IPv4 und
+ * IPv6, mehrere Metriken oder Gateways, ECMP-Nexthops. Jede Route wird
+ * über einen Schlüssel (routeKey()) geführt - entfernt der Kernel eine
+ * davon, bleibt das Interface nutzbar, solange noch eine andere existiert.
+ *
+ * add() und remove() melden nur die Übergänge "erste Route" und "letzte
+ * Route". Für einen Abgleich nach verlorenen Ereignissen wird ein Dump
+ * zwischen beginResync() und endResync() gesammelt; währenddessen
+ * eintreffende Ereignisse gehen in beide Stände ein.
+ */
+class DefaultRouteTable
+{
+public:
+    /// Interface mit neuem Zustand (true = hat mindestens eine Default-Route)
+    using Change = QPair<QString, bool>;
+
+    /**
+     * @brief Schlüssel einer Route
+     * @param family AF_INET oder AF_INET6
+     * @param metric Priorität der Route (RTA_PRIORITY)
+     * @param gateway Gateway-Adresse als Rohbytes (leer = direkt)
+     */
+    static QByteArray routeKey(int family, quint32 metric, const QByteArray &gateway);
+
+    /// @return true wenn das Interface damit seine erste Default-Route hat
+    bool add(const QString &interfaceName, const QByteArray &key);
+
+    /// @return true wenn damit die letzte Default-Route des Interfaces entfernt wurde
+    bool remove(const QString &interfaceName, const QByteArray &key);
+
+    /**
+     * @brief Vergisst alle Routen eines Interfaces (Interface entfernt oder abgeschaltet)
+     * @return true wenn das Interface vorher Default-Routen hatte
+     */
+    bool removeInterface(const QString &interfaceName);
+
+    /// true wenn das Interface mindestens eine Default-Route hat
+    bool hasRoute(const QString &interfaceName) const { return m_routes.contains(interfaceName); }
+
+    /// Anzahl Default-Routen eines Interfaces
+    int routeCount(const QString &interfaceName) const { return m_routes.value(interfaceName).size(); }
+
+    /// Beginnt einen Abgleich per Dump
+    void beginResync();
+
+    /// Route aus dem Dump
+    void addDumped(const QString &interfaceName, const QByteArray &key);
+
+    /**
+     * @brief Übernimmt den Dump als neuen Stand
+     * @return Interfaces, deren Zustand sich dadurch geändert hat
+     */
+    QVector<Change> endResync();
+
+    bool isResyncing() const { return m_resyncing; }
+
+private:
+    QHash<QString, QSet<QByteArray>> m_routes;               ///< Map: Interface -> Schlüssel der Default-Routen
+    QHash<QString, QSet<QByteArray>> m_dumped;               ///< Stand aus dem laufenden Dump
+    bool m_resyncing = false;
+};
+
+#endif // DEFAULTROUTETABLE_H
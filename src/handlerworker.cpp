@@ -0,0 +1,98 @@
+#include "handlerworker.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+HandlerWorker::HandlerWorker(int capacity, OverflowPolicy policy, const ThreadTuning::Placement &placement)
+    : m_capacity(qMax(1, capacity))
+    , m_policy(policy)
+    , m_placement(placement)
+    , m_stopping(false)
+    , m_dropped(0)
+{
+}
+
+HandlerWorker::~HandlerWorker()
+{
+    stop();
+    wait();
+}
+
+/**
+ * @brief Nimmt eine Nachricht in die Warteschlange auf
+ *
+ * Kopiert nur den Handler und teilt die Payload (implizit geteilt).
+ */
+bool HandlerWorker::post(const Handler &handler, const QByteArray &message)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_stopping)
+        return false;
+
+    if ((int)m_queue.size() >= m_capacity) {
+        m_dropped++;
+        if (m_policy == DropNewest)
+            return false;
+        m_queue.pop_front();
+    }
+
+    m_queue.push_back(Job{handler, message});
+    m_wakeup.wakeOne();
+    return true;
+}
+
+void HandlerWorker::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopping = true;
+    m_queue.clear();
+    m_wakeup.wakeAll();
+}
+
+int HandlerWorker::depth() const
+{
+    QMutexLocker locker(&m_mutex);
+    return (int)m_queue.size();
+}
+
+quint64 HandlerWorker::dropped() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+QString HandlerWorker::placementReport() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_placementReport;
+}
+
+/**
+ * @brief Arbeitsschleife: eine Nachricht entnehmen, Handler ohne Sperre aufrufen
+ */
+void HandlerWorker::run()
+{
+    QString error;
+    if (!m_placement.isDefault() && !ThreadTuning::applyToCurrentThread(m_placement, &error))
+        qDebug() << "HandlerWorker: Platzierung nicht möglich:" << error;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_placementReport = ThreadTuning::describeCurrentThread();
+    }
+    qDebug() << "HandlerWorker gestartet -" << placementReport();
+
+    for (;;) {
+        Job job;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_queue.empty() && !m_stopping)
+                m_wakeup.wait(&m_mutex);
+            if (m_stopping)
+                return;
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        job.handler(job.message);
+    }
+}
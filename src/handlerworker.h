@@ -0,0 +1,95 @@
+#ifndef HANDLERWORKER_H
+#define HANDLERWORKER_H
+
+#include "threadtuning.h"
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <functional>
+
+/**
+ * @brief Eigener Thread für zu langsame Topic-Handler
+ *
+ * Der MqttClient verschiebt dafür freigegebene Handler
+ * (MqttClient::HandlerThreading::Isolatable), die ihr Zeitbudget
+ * wiederholt überschreiten, in diesen Worker (siehe
+ * MqttClient::setHandlerBudget()).
+ * Der I/O-Thread stellt die Nachricht nur noch in eine begrenzte
+ * Warteschlange, der Handler läuft hier.
+ *
+ * Ist die Warteschlange voll, entscheidet die OverflowPolicy, welche
+ * Nachricht verworfen wird. Der I/O-Thread blockiert nie.
+ *
+ * @note Handler im Worker laufen nebenläufig zum I/O-Thread. Zugriffe auf
+ *       den MqttClient (z.B. publish()) müssen per
+ *       QMetaObject::invokeMethod() in dessen Thread erfolgen.
+ */
+class HandlerWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<void(const QByteArray&)>;
+
+    /// Verhalten bei voller Warteschlange
+    enum OverflowPolicy {
+        DropNewest,                                          ///< Neue Nachricht verwerfen
+        DropOldest                                           ///< Älteste wartende Nachricht verwerfen
+    };
+
+    /**
+     * @brief Konstruktor
+     * @param capacity Maximale Anzahl wartender Nachrichten
+     * @param policy Verhalten bei voller Warteschlange
+     * @param placement CPU-Bindung und Priorität des Worker-Threads
+     */
+    explicit HandlerWorker(int capacity = 1024, OverflowPolicy policy = DropOldest,
+                           const ThreadTuning::Placement &placement = ThreadTuning::Placement());
+
+    /// Stoppt den Thread, wartende Nachrichten werden verworfen
+    ~HandlerWorker();
+
+    /**
+     * @brief Stellt eine Nachricht für einen Handler ein
+     * @return false wenn die neue Nachricht verworfen wurde
+     */
+    bool post(const Handler &handler, const QByteArray &message);
+
+    /// Beendet den Thread nach der laufenden Nachricht
+    void stop();
+
+    /// Anzahl wartender Nachrichten
+    int depth() const;
+
+    /// Anzahl wegen voller Warteschlange verworfener Nachrichten
+    quint64 dropped() const;
+
+    /// Tatsächliche Platzierung des Worker-Threads (nach dem Start)
+    QString placementReport() const;
+
+protected:
+    void run() override;
+
+private:
+    struct Job {
+        Handler handler;
+        QByteArray message;
+    };
+
+    const int m_capacity;
+    const OverflowPolicy m_policy;
+    const ThreadTuning::Placement m_placement;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeup;
+    std::deque<Job> m_queue;                                 ///< Wartende Nachrichten (durch m_mutex geschützt)
+    bool m_stopping;
+    quint64 m_dropped;
+    QString m_placementReport;
+};
+
+#endif // HANDLERWORKER_H
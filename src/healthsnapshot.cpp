@@ -0,0 +1,88 @@
+#include "healthsnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+void RttWindow::add(qint64 rttUs)
+{
+    m_samples[m_next] = rttUs;
+    m_next = (m_next + 1) % Capacity;
+    m_count = qMin(m_count + 1, Capacity);
+}
+
+void RttWindow::percentiles(qint64 *p50, qint64 *p90, qint64 *p99) const
+{
+    if (m_count == 0) {
+        *p50 = *p90 = *p99 = -1;
+        return;
+    }
+
+    std::array<qint64, Capacity> sorted = m_samples;
+    std::sort(sorted.begin(), sorted.begin() + m_count);
+    auto at = [&](double percentile) {
+        return sorted[qBound(0, (int)(percentile / 100.0 * (m_count - 1) + 0.5), m_count - 1)];
+    };
+    *p50 = at(50.0);
+    *p90 = at(90.0);
+    *p99 = at(99.0);
+}
+
+HealthPublisher::HealthPublisher()
+    : m_sequence(0)
+{
+    for (std::atomic<quint64> &word : m_words)
+        word.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Schreibseite des Seqlocks
+ *
+ * Ungerade Sequenz markiert den Schreibvorgang; die Release-Barriere
+ * ordnet die Datenworte nach dieser Markierung, das abschließende
+ * Release-Store vor der geraden Sequenz.
+ */
+void HealthPublisher::publish(const HealthSnapshot &snapshot)
+{
+    const quint64 sequence = m_sequence.load(std::memory_order_relaxed);
+
+    HealthSnapshot versioned = snapshot;
+    versioned.version = sequence / 2 + 1;
+    quint64 words[Words] = {};
+    memcpy(words, &versioned, sizeof(versioned));
+
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (int i = 0; i < Words; ++i)
+        m_words[i].store(words[i], std::memory_order_relaxed);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Leseseite des Seqlocks
+ *
+ * Eine Kopie ist gültig, wenn vorher und nachher dieselbe gerade
+ * Sequenz gelesen wurde.
+ */
+bool HealthPublisher::read(HealthSnapshot *snapshot) const
+{
+    quint64 words[Words];
+    for (;;) {
+        const quint64 before = m_sequence.load(std::memory_order_acquire);
+        if (before == 0)
+            return false;
+        if (before & 1)
+            continue;
+
+        for (int i = 0; i < Words; ++i)
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before)
+            break;
+    }
+
+    memcpy(snapshot, words, sizeof(*snapshot));
+    return true;
+}
@@ -0,0 +1,119 @@
+#ifndef HEALTHSNAPSHOT_H
+#define HEALTHSNAPSHOT_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Gleitendes Fenster der letzten Round-Trip-Zeiten eines Netzes
+ *
+ * Ringpuffer fester Größe, Perzentile werden beim Abfragen über eine
+ * sortierte Kopie bestimmt (Proben kommen im Sekundentakt).
+ */
+class RttWindow
+{
+public:
+    static constexpr int Capacity = 64;
+
+    /// Trägt eine Messung ein (ältere fallen heraus)
+    void add(qint64 rttUs);
+
+    /// Anzahl Messungen im Fenster
+    int count() const { return m_count; }
+
+    /// Perzentile 50/90/99 in Mikrosekunden (-1 ohne Messungen)
+    void percentiles(qint64 *p50, qint64 *p90, qint64 *p99) const;
+
+private:
+    std::array<qint64, Capacity> m_samples {};
+    int m_count = 0;
+    int m_next = 0;
+};
+
+/// Zustand eines Netzes im HealthSnapshot
+struct NetworkHealth
+{
+    bool linkUp;
+    bool routeUp;
+    bool connected;
+    bool usable;
+    qint32 missedProbes;
+    double health;                                           ///< Gesundheitswert 0..1
+    qint64 rttUs;                                            ///< Geglättete Round-Trip-Zeit (-1 = unbekannt)
+    qint64 rttP50Us;                                         ///< Perzentile der letzten RttWindow::Capacity Proben (-1 = unbekannt)
+    qint64 rttP90Us;
+    qint64 rttP99Us;
+};
+
+/**
+ * @brief Momentaufnahme des NetworkSelector-Zustands für andere Threads
+ *
+ * Reine Daten ohne Zeiger, damit sie wortweise kopiert werden kann.
+ * Zeiten sind monotone Nanosekunden (MessageEnvelope::monotonicNs()).
+ */
+struct HealthSnapshot
+{
+    static constexpr int MaxNetworks = 8;
+
+    quint64 version;                                         ///< Fortlaufend pro Veröffentlichung (0 = noch keine)
+    qint64 publishedNs;
+    qint32 activeNetwork;
+    qint32 bestNetwork;                                      ///< Favorit der Selection-Policy (-1 = keines nutzbar)
+    qint32 networkCount;                                     ///< Gültige Einträge in networks (höchstens MaxNetworks)
+    quint32 switchCount;                                     ///< Abgeschlossene Umschaltvorgänge
+    qint32 lastSwitchFrom;
+    qint32 lastSwitchTo;
+    qint64 lastSwitchNs;                                     ///< Ende des letzten Umschaltens (0 = noch keines)
+    qint64 lastSwitchDurationNs;
+    bool lastSwitchSucceeded;
+    NetworkHealth networks[MaxNetworks];
+};
+
+static_assert(std::is_trivially_copyable<HealthSnapshot>::value, "HealthSnapshot muss trivial kopierbar sein");
+
+/**
+ * @brief Veröffentlicht HealthSnapshots über ein Seqlock
+ *
+ * Genau ein Schreiber (der I/O-Thread des NetworkSelector) ruft publish()
+ * auf, beliebig viele Threads lesen mit read(). Der Schreiber wartet nie
+ * auf Leser und Leser nehmen keine Sperre - sie kopieren die Daten und
+ * wiederholen nur, wenn währenddessen veröffentlicht wurde. Da nur bei
+ * Zustandsänderungen und Messproben veröffentlicht wird, ist das selten.
+ *
+ * Die Daten liegen in atomaren 64-Bit-Worten und werden mit relaxed
+ * Zugriffen kopiert, das gleichzeitige Lesen ist damit kein Datenwettlauf.
+ *
+ * Verwendung aus einem beliebigen Thread:
+ * @code
+ * HealthSnapshot health;
+ * if (selector->healthPublisher().read(&health))
+ *     qDebug() << "Aktiv:" << health.activeNetwork << "RTT p99:" << health.networks[health.activeNetwork].rttP99Us;
+ * @endcode
+ */
+class HealthPublisher
+{
+public:
+    HealthPublisher();
+
+    /// Veröffentlicht eine neue Momentaufnahme (nur vom Schreiber-Thread, version wird gesetzt)
+    void publish(const HealthSnapshot &snapshot);
+
+    /**
+     * @brief Liest die aktuelle Momentaufnahme (aus jedem Thread)
+     * @return false solange noch nichts veröffentlicht wurde
+     */
+    bool read(HealthSnapshot *snapshot) const;
+
+    /// Anzahl der Veröffentlichungen (0 = noch keine)
+    quint64 version() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr int Words = (sizeof(HealthSnapshot) + sizeof(quint64) - 1) / sizeof(quint64);
+
+    alignas(64) std::atomic<quint64> m_sequence;             ///< Ungerade während des Schreibens
+    std::atomic<quint64> m_words[Words];
+};
+
+#endif // HEALTHSNAPSHOT_H
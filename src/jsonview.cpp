@@ -0,0 +1,401 @@
+#include "jsonview.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+inline const char* skipWhitespace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Sucht das nächste '"' oder '\' - 16 Bytes pro Schritt
+ */
+inline const char* findQuoteOrEscape(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    while (end - p >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, escape)));
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"');
+    const uint8x16_t escape = vdupq_n_u8('\\');
+    while (end - p >= 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        if (vmaxvq_u8(vorrq_u8(vceqq_u8(block, quote), vceqq_u8(block, escape))))
+            break;  // Treffer liegt in diesem Block
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\')
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Sucht das nächste für Verschachtelung relevante Zeichen: " { } [ ]
+ */
+inline const char* findStructural(const char *p, const char *end)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i openArray = _mm_set1_epi8('[');
+    const __m128i closeArray = _mm_set1_epi8(']');
+    while (end - p >= 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, open));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, close));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, openArray));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, closeArray));
+        const int mask = _mm_movemask_epi8(hits);
+        if (mask)
+            return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#elif defined(__ARM_NEON)
+    while (end - p >= 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        uint8x16_t hits = vorrq_u8(vceqq_u8(block, vdupq_n_u8('"')), vceqq_u8(block, vdupq_n_u8('{')));
+        hits = vorrq_u8(hits, vceqq_u8(block, vdupq_n_u8('}')));
+        hits = vorrq_u8(hits, vceqq_u8(block, vdupq_n_u8('[')));
+        hits = vorrq_u8(hits, vceqq_u8(block, vdupq_n_u8(']')));
+        if (vmaxvq_u8(hits))
+            break;
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '{' && *p != '}' && *p != '[' && *p != ']')
+        ++p;
+    return p;
+}
+
+/**
+ * @brief Überspringt einen String
+ * @param p Zeiger hinter dem öffnenden Anführungszeichen
+ * @param escaped Wird true, wenn Escape-Sequenzen vorkommen
+ * @return Zeiger auf das schließende Anführungszeichen oder end
+ */
+inline const char* skipString(const char *p, const char *end, bool &escaped)
+{
+    for (;;) {
+        p = findQuoteOrEscape(p, end);
+        if (p >= end || *p == '"')
+            return p;
+        escaped = true;
+        p += 2;  // Backslash und maskiertes Zeichen
+    }
+}
+
+/**
+ * @brief Überspringt ein Objekt oder Array samt Inhalt
+ * @param p Zeiger auf '{' oder '['
+ * @return Zeiger hinter der schließenden Klammer oder nullptr
+ */
+inline const char* skipContainer(const char *p, const char *end)
+{
+    int depth = 0;
+    while (p < end) {
+        p = findStructural(p, end);
+        if (p >= end)
+            return nullptr;
+
+        switch (*p) {
+        case '"': {
+            bool escaped = false;
+            p = skipString(p + 1, end, escaped);
+            if (p >= end)
+                return nullptr;
+            break;
+        }
+        case '{':
+        case '[':
+            depth++;
+            break;
+        default:
+            if (--depth == 0)
+                return p + 1;
+            break;
+        }
+        ++p;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Kopiert eine Zahl in einen nullterminierten Stackpuffer für strtod
+ */
+inline bool copyNumber(const char *begin, int size, char (&buffer)[64])
+{
+    if (size <= 0 || size >= (int)sizeof(buffer))
+        return false;
+    memcpy(buffer, begin, size);
+    buffer[size] = '\0';
+    return true;
+}
+
+void appendUtf8(QByteArray &out, uint codePoint)
+{
+    if (codePoint < 0x80) {
+        out.append((char)codePoint);
+    } else if (codePoint < 0x800) {
+        out.append((char)(0xC0 | (codePoint >> 6)));
+        out.append((char)(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.append((char)(0xE0 | (codePoint >> 12)));
+        out.append((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append((char)(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.append((char)(0xF0 | (codePoint >> 18)));
+        out.append((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.append((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.append((char)(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+bool parseHex4(const char *p, const char *end, uint &value)
+{
+    if (end - p < 4)
+        return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')      value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool JsonView::isObject() const
+{
+    const char *p = skipWhitespace(m_begin, m_end);
+    return p < m_end && *p == '{';
+}
+
+/**
+ * @brief Durchsucht die oberste Ebene nach dem Schlüssel
+ *
+ * Werte anderer Felder werden nur übersprungen, nicht interpretiert.
+ */
+JsonView::Value JsonView::value(const char *key) const
+{
+    const int keySize = (int)strlen(key);
+    const char *p = skipWhitespace(m_begin, m_end);
+    if (p >= m_end || *p != '{')
+        return Value();
+    ++p;
+
+    while (true) {
+        p = skipWhitespace(p, m_end);
+        if (p >= m_end || *p != '"')
+            return Value();  // '}' (Ende) oder Syntaxfehler
+
+        // Schlüssel
+        bool keyEscaped = false;
+        const char *keyBegin = p + 1;
+        p = skipString(keyBegin, m_end, keyEscaped);
+        if (p >= m_end)
+            return Value();
+        const bool match = !keyEscaped && p - keyBegin == keySize && memcmp(keyBegin, key, keySize) == 0;
+
+        p = skipWhitespace(p + 1, m_end);
+        if (p >= m_end || *p != ':')
+            return Value();
+        p = skipWhitespace(p + 1, m_end);
+        if (p >= m_end)
+            return Value();
+
+        // Wert
+        const char *valueBegin = p;
+        Type type;
+        bool escaped = false;
+
+        switch (*p) {
+        case '"':
+            type = String;
+            p = skipString(p + 1, m_end, escaped);
+            if (p >= m_end)
+                return Value();
+            if (match)
+                return Value(String, valueBegin + 1, (int)(p - valueBegin - 1), escaped);
+            ++p;
+            break;
+        case '{':
+        case '[':
+            type = *p == '{' ? Object : Array;
+            p = skipContainer(p, m_end);
+            if (!p)
+                return Value();
+            break;
+        default:
+            // Zahl, true, false, null - bis zum nächsten Trenner
+            while (p < m_end && *p != ',' && *p != '}' && *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+                ++p;
+            if (*valueBegin == 't' || *valueBegin == 'f')
+                type = Bool;
+            else if (*valueBegin == 'n')
+                type = Null;
+            else
+                type = Number;
+            break;
+        }
+
+        if (match)
+            return Value(type, valueBegin, (int)(p - valueBegin), escaped);
+
+        p = skipWhitespace(p, m_end);
+        if (p >= m_end || *p != ',')
+            return Value();
+        ++p;
+    }
+}
+
+bool JsonView::Value::toBool(bool defaultValue) const
+{
+    if (m_type != Bool)
+        return defaultValue;
+    return m_size == 4 && memcmp(m_begin, "true", 4) == 0;
+}
+
+qint64 JsonView::Value::toInteger(qint64 defaultValue, bool *ok) const
+{
+    if (ok)
+        *ok = false;
+    if (m_type != Number)
+        return defaultValue;
+
+    // Schneller Weg für reine Ganzzahlen
+    const char *p = m_begin;
+    const char *end = m_begin + m_size;
+    const bool negative = p < end && *p == '-';
+    if (negative)
+        ++p;
+    if (p < end && end - p <= 18) {
+        qint64 value = 0;
+        const char *digits = p;
+        while (p < end && *p >= '0' && *p <= '9')
+            value = value * 10 + (*p++ - '0');
+        if (p == end && p > digits) {
+            if (ok)
+                *ok = true;
+            return negative ? -value : value;
+        }
+    }
+
+    // Umwandlung nur im Bereich von qint64 definiert: [-2^63, 2^63)
+    const double value = toDouble(std::numeric_limits<double>::quiet_NaN());
+    constexpr double Limit = 9223372036854775808.0;
+    if (!(value >= -Limit && value < Limit) || std::trunc(value) != value)
+        return defaultValue;
+    if (ok)
+        *ok = true;
+    return (qint64)value;
+}
+
+double JsonView::Value::toDouble(double defaultValue) const
+{
+    char buffer[64];
+    if (m_type != Number || !copyNumber(m_begin, m_size, buffer))
+        return defaultValue;
+
+    char *parsedEnd = nullptr;
+    const double value = strtod(buffer, &parsedEnd);
+    return parsedEnd == buffer + m_size ? value : defaultValue;
+}
+
+QByteArray JsonView::Value::rawString() const
+{
+    return m_type == String ? QByteArray::fromRawData(m_begin, m_size) : QByteArray();
+}
+
+bool JsonView::Value::equals(const char *text) const
+{
+    const int size = (int)strlen(text);
+    return m_type == String && !m_escaped && m_size == size && memcmp(m_begin, text, size) == 0;
+}
+
+JsonView JsonView::Value::toObject() const
+{
+    return m_type == Object ? JsonView(m_begin, m_size) : JsonView();
+}
+
+/**
+ * @brief Dekodiert einen String
+ *
+ * Ohne Escape-Sequenzen direkt aus UTF-8, sonst über einen
+ * Zwischenpuffer mit aufgelösten Sequenzen (inkl. Surrogat-Paaren).
+ */
+QString JsonView::Value::toString() const
+{
+    if (m_type != String)
+        return QString();
+    if (!m_escaped)
+        return QString::fromUtf8(m_begin, m_size);
+
+    QByteArray decoded;
+    decoded.reserve(m_size);
+    const char *p = m_begin;
+    const char *end = m_begin + m_size;
+
+    while (p < end) {
+        if (*p != '\\') {
+            decoded.append(*p++);
+            continue;
+        }
+        if (++p >= end)
+            break;
+
+        const char c = *p++;
+        switch (c) {
+        case 'b': decoded.append('\b'); break;
+        case 'f': decoded.append('\f'); break;
+        case 'n': decoded.append('\n'); break;
+        case 'r': decoded.append('\r'); break;
+        case 't': decoded.append('\t'); break;
+        case 'u': {
+            uint codePoint;
+            if (!parseHex4(p, end, codePoint))
+                return QString();
+            p += 4;
+            // Surrogat-Paar zu einem Codepunkt zusammenfassen
+            uint low;
+            if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u'
+                && parseHex4(p + 2, end, low) && low >= 0xDC00 && low < 0xE000) {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+            appendUtf8(decoded, codePoint);
+            break;
+        }
+        default:
+            decoded.append(c);  // \" \\ \/
+            break;
+        }
+    }
+
+    return QString::fromUtf8(decoded);
+}
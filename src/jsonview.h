@@ -0,0 +1,120 @@
+#ifndef JSONVIEW_H
+#define JSONVIEW_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Lesender Zugriff auf einzelne Felder eines JSON-Objekts ohne DOM
+ *
+ * Statt das ganze Dokument wie QJsonDocument in einen Baum zu überführen,
+ * wird bei jeder Abfrage nur die oberste Ebene bis zum gesuchten Schlüssel
+ * durchsucht. Strings und verschachtelte Werte werden mit SIMD (SSE2 bzw.
+ * NEON) übersprungen, es wird dabei kein Speicher angelegt.
+ *
+ * Die Sicht hält nur Zeiger in den Quellpuffer - dieser muss gültig
+ * bleiben, solange JsonView und daraus gewonnene Werte verwendet werden.
+ *
+ * Verwendung:
+ * @code
+ * JsonView json(payload);
+ * const QString state = json.value("state").toString();
+ * const qint64 id = json.value("id").toInteger(-1);
+ * @endcode
+ *
+ * @note Es wird nur so weit validiert, wie es für das Auffinden der
+ *       Felder nötig ist. Syntaxfehler vor dem gesuchten Feld liefern
+ *       Missing, Fehler dahinter bleiben unbemerkt.
+ */
+class JsonView
+{
+public:
+    enum Type { Missing, Null, Bool, Number, String, Object, Array };
+
+    /**
+     * @brief Einzelner Wert, zeigt in den Quellpuffer
+     */
+    class Value
+    {
+    public:
+        Value() = default;
+
+        Type type() const { return m_type; }
+        bool isMissing() const { return m_type == Missing; }
+
+        /// true/false, sonst defaultValue
+        bool toBool(bool defaultValue = false) const;
+
+        /**
+         * @brief Ganzzahl (auch 12.0 oder 1e3)
+         * @param ok false bei keiner Zahl, Nachkommastellen (12.5) oder
+         *           Werten außerhalb von qint64 (optional)
+         * @return Wert, sonst defaultValue
+         */
+        qint64 toInteger(qint64 defaultValue = 0, bool *ok = nullptr) const;
+
+        /// Zahl, sonst defaultValue
+        double toDouble(double defaultValue = 0.0) const;
+
+        /// Dekodierter String (Escape-Sequenzen aufgelöst), sonst leer
+        QString toString() const;
+
+        /**
+         * @brief Inhalt eines Strings ohne Kopie
+         *
+         * Escape-Sequenzen bleiben unverändert (siehe hasEscapes()).
+         * Das Ergebnis teilt den Quellpuffer (QByteArray::fromRawData).
+         */
+        QByteArray rawString() const;
+
+        /// true wenn der String Escape-Sequenzen enthält
+        bool hasEscapes() const { return m_escaped; }
+
+        /// Vergleicht einen String ohne Escape-Sequenzen mit einem Literal, ohne Kopie
+        bool equals(const char *text) const;
+
+        /// Sicht auf ein verschachteltes Objekt
+        JsonView toObject() const;
+
+        /// Rohtext des Werts (z.B. für Fehlermeldungen)
+        QByteArray raw() const { return QByteArray::fromRawData(m_begin, m_size); }
+
+    private:
+        friend class JsonView;
+        Value(Type type, const char *begin, int size, bool escaped)
+            : m_type(type), m_begin(begin), m_size(size), m_escaped(escaped) {}
+
+        Type m_type = Missing;
+        const char *m_begin = nullptr;                       ///< Wertbeginn, bei Strings ohne Anführungszeichen
+        int m_size = 0;
+        bool m_escaped = false;
+    };
+
+    JsonView() = default;
+
+    /// Sicht auf ein JSON-Dokument (Puffer muss gültig bleiben)
+    explicit JsonView(const QByteArray &data)
+        : m_begin(data.constData()), m_end(data.constData() + data.size()) {}
+
+    JsonView(const char *data, int size)
+        : m_begin(data), m_end(data + size) {}
+
+    /// true wenn das Dokument mit einem Objekt beginnt
+    bool isObject() const;
+
+    /**
+     * @brief Sucht ein Feld der obersten Ebene
+     * @param key Schlüssel (ohne Escape-Sequenzen)
+     * @return Wert oder Missing
+     */
+    Value value(const char *key) const;
+
+    /// true wenn das Feld vorhanden ist
+    bool contains(const char *key) const { return !value(key).isMissing(); }
+
+private:
+    const char *m_begin = nullptr;
+    const char *m_end = nullptr;
+};
+
+#endif // JSONVIEW_H
@@ -0,0 +1,89 @@
+#include "lastvaluecache.h"
+
+#include <QDateTime>
+
+LastValueCache::LastValueCache()
+{
+}
+
+/**
+ * @brief Trägt einen Wert ein
+ *
+ * Die Payload wird implizit geteilt; der Eintrag wird überschrieben statt
+ * neu angelegt, damit der Hash nach der Anlaufphase nicht mehr wächst.
+ */
+void LastValueCache::record(const QString &topic, const QByteArray &value, bool persistent)
+{
+    Entry &entry = m_entries[topic];
+    entry.value = value;
+    entry.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    entry.persistent = persistent;
+}
+
+bool LastValueCache::contains(const QString &topic) const
+{
+    if (m_entries.contains(topic))
+        return true;
+    return m_snapshot && m_snapshot->value(topic, nullptr);
+}
+
+QByteArray LastValueCache::value(const QString &topic) const
+{
+    Entry result;
+    entry(topic, &result);
+    return result.value;
+}
+
+bool LastValueCache::entry(const QString &topic, Entry *entry, bool *fromSnapshot) const
+{
+    auto it = m_entries.constFind(topic);
+    if (it != m_entries.constEnd()) {
+        if (entry)
+            *entry = it.value();
+        if (fromSnapshot)
+            *fromSnapshot = false;
+        return true;
+    }
+
+    Entry cached;
+    if (!m_snapshot || !m_snapshot->value(topic, &cached.value, &cached.timestampMs))
+        return false;
+
+    // Sicht auf die Einblendung kopieren - der Snapshot kann ersetzt werden
+    cached.value = QByteArray(cached.value.constData(), cached.value.size());
+    if (entry)
+        *entry = cached;
+    if (fromSnapshot)
+        *fromSnapshot = true;
+    return true;
+}
+
+/**
+ * @brief Werte für den nächsten Snapshot
+ *
+ * Nicht persistente Einträge fehlen und verdrängen zugleich einen alten
+ * Snapshot-Wert desselben Topics - ein früher im Klartext gespeicherter
+ * Wert wird so beim nächsten Schreiben entfernt.
+ */
+QVector<ClientSnapshot::Value> LastValueCache::collect() const
+{
+    QVector<ClientSnapshot::Value> values;
+    if (m_snapshot) {
+        for (const ClientSnapshot::Value &value : m_snapshot->values()) {
+            if (!m_entries.contains(value.topic))
+                values.append(value);
+        }
+    }
+
+    values.reserve(values.size() + m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (!it.value().persistent)
+            continue;
+        ClientSnapshot::Value value;
+        value.topic = it.key();
+        value.value = it.value().value;
+        value.timestampMs = it.value().timestampMs;
+        values.append(value);
+    }
+    return values;
+}
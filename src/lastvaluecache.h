@@ -0,0 +1,69 @@
+#ifndef LASTVALUECACHE_H
+#define LASTVALUECACHE_H
+
+#include "clientsnapshot.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <memory>
+
+/**
+ * @brief Letzter empfangener Wert je Topic
+ *
+ * Die MqttClients tragen jede empfangene Nachricht ein
+ * (MqttClient::setLastValueCache()). Nach einem Neustart kann ein
+ * eingeblendeter ClientSnapshot hinterlegt werden: Topics ohne neuen
+ * Wert werden dann direkt aus der Einblendung beantwortet, bis die
+ * Verbindung aktuelle Werte liefert.
+ *
+ * collect() führt Snapshot und neue Werte für den nächsten Snapshot
+ * zusammen.
+ */
+class LastValueCache
+{
+public:
+    /// Eintrag des Caches
+    struct Entry {
+        QByteArray value;
+        qint64 timestampMs = 0;                              ///< Empfangszeit (ms seit Epoch)
+        bool persistent = true;                              ///< false = nie in einen Snapshot schreiben
+    };
+
+    LastValueCache();
+
+    /**
+     * @brief Trägt einen empfangenen Wert ein
+     * @param persistent false für Werte, die nicht auf die Platte dürfen
+     *                   (z.B. entschlüsselte Payloads, siehe PayloadCipher)
+     */
+    void record(const QString &topic, const QByteArray &value, bool persistent = true);
+
+    /// true wenn für das Topic ein Wert vorliegt (neu oder aus dem Snapshot)
+    bool contains(const QString &topic) const;
+
+    /// Letzter Wert, leer wenn unbekannt
+    QByteArray value(const QString &topic) const;
+
+    /**
+     * @brief Letzter Wert mit Zeitstempel
+     * @param fromSnapshot wird true, wenn der Wert aus dem Snapshot stammt (optional)
+     * @return false wenn unbekannt
+     */
+    bool entry(const QString &topic, Entry *entry, bool *fromSnapshot = nullptr) const;
+
+    /// Hinterlegt einen eingeblendeten Snapshot als Rückfallebene
+    void setSnapshot(std::shared_ptr<const ClientSnapshot> snapshot) { m_snapshot = std::move(snapshot); }
+
+    /// Alle persistenten Werte (neue überdecken Snapshot-Werte) für ClientSnapshot::write()
+    QVector<ClientSnapshot::Value> collect() const;
+
+    /// Anzahl neu empfangener Topics (ohne Snapshot)
+    int size() const { return m_entries.size(); }
+
+private:
+    QHash<QString, Entry> m_entries;
+    std::shared_ptr<const ClientSnapshot> m_snapshot;
+};
+
+#endif // LASTVALUECACHE_H
@@ -0,0 +1,400 @@
+#include "linkmonitor.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// Sequenznummern der eigenen Dump-Anfragen
+constexpr quint32 LinkDumpSeq = 1;
+constexpr quint32 RouteDumpSeq = 2;
+
+}
+
+/**
+ * @brief Konstruktor - Socket wird erst mit start() geöffnet
+ */
+LinkMonitor::LinkMonitor(QObject *parent)
+    : QObject(parent)
+    , m_fd(-1)
+{
+}
+
+LinkMonitor::~LinkMonitor()
+{
+    stop();
+}
+
+/**
+ * @brief Öffnet den NETLINK_ROUTE Socket
+ *
+ * Abonnierte Gruppen:
+ * - RTMGRP_LINK: Interface UP/DOWN, Träger verloren
+ * - RTMGRP_IPV4_IFADDR / RTMGRP_IPV6_IFADDR: Adressen
+ * - RTMGRP_IPV4_ROUTE / RTMGRP_IPV6_ROUTE: Routen
+ */
+bool LinkMonitor::start()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0)
+        return true;
+
+    m_fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (m_fd < 0) {
+        emit error("Netlink-Socket konnte nicht geöffnet werden: " + QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+
+    sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR
+                      | RTMGRP_IPV4_ROUTE | RTMGRP_IPV6_ROUTE;
+
+    if (::bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        QString errorMsg = "Netlink-Socket konnte nicht gebunden werden: " + QString::fromLocal8Bit(strerror(errno));
+        stop();
+        emit error(errorMsg);
+        return false;
+    }
+
+    m_notifier = std::make_unique<QSocketNotifier>(m_fd, QSocketNotifier::Read, this);
+    connect(m_notifier.get(), &QSocketNotifier::activated, this, &LinkMonitor::onReadable);
+
+    qDebug() << "LinkMonitor gestartet";
+    return requestLinkDump();
+#else
+    emit error("LinkMonitor wird nur unter Linux unterstützt");
+    return false;
+#endif
+}
+
+/**
+ * @brief Schließt den Netlink-Socket
+ */
+void LinkMonitor::stop()
+{
+    m_notifier.reset();
+
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+}
+
+/**
+ * @brief Fordert alle Interfaces mit aktuellem Zustand an
+ *
+ * Die Antworten kommen als RTM_NEWLINK über denselben Socket und
+ * werden in handleMessage() wie Ereignisse behandelt.
+ */
+bool LinkMonitor::requestLinkDump()
+{
+#ifdef Q_OS_LINUX
+    struct {
+        nlmsghdr header;
+        ifinfomsg info;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(ifinfomsg));
+    request.header.nlmsg_type = RTM_GETLINK;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = LinkDumpSeq;
+    request.info.ifi_family = AF_UNSPEC;
+
+    if (::send(m_fd, &request, request.header.nlmsg_len, 0) < 0) {
+        emit error("RTM_GETLINK fehlgeschlagen: " + QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Fordert alle Routen an
+ *
+ * Die Antworten werden als Stand gesammelt und beim NLMSG_DONE mit den
+ * bekannten Default-Routen abgeglichen.
+ */
+bool LinkMonitor::requestRouteDump()
+{
+#ifdef Q_OS_LINUX
+    struct {
+        nlmsghdr header;
+        rtmsg route;
+    } request;
+    memset(&request, 0, sizeof(request));
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(rtmsg));
+    request.header.nlmsg_type = RTM_GETROUTE;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.header.nlmsg_seq = RouteDumpSeq;
+    request.route.rtm_family = AF_UNSPEC;
+
+    if (::send(m_fd, &request, request.header.nlmsg_len, 0) < 0) {
+        emit error("RTM_GETROUTE fehlgeschlagen: " + QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    m_defaultRoutes.beginResync();
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Liest den Socket leer und verarbeitet jede Nachricht
+ *
+ * Bei ENOBUFS (Kernel-Puffer übergelaufen) sind Ereignisse verloren
+ * gegangen - der Zustand wird per Dump neu angefordert.
+ */
+void LinkMonitor::onReadable()
+{
+#ifdef Q_OS_LINUX
+    alignas(nlmsghdr) char buffer[16384];
+
+    for (;;) {
+        ssize_t length = ::recv(m_fd, buffer, sizeof(buffer), 0);
+        if (length < 0) {
+            if (errno == ENOBUFS) {
+                qDebug() << "LinkMonitor: Ereignisse verloren, fordere Zustand neu an";
+                requestLinkDump();
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                emit error("Netlink-Lesefehler: " + QString::fromLocal8Bit(strerror(errno)));
+            return;
+        }
+
+        int remaining = (int)length;
+        for (const nlmsghdr *header = reinterpret_cast<const nlmsghdr*>(buffer);
+             NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_DONE) {
+                if (header->nlmsg_seq == LinkDumpSeq) {
+                    requestRouteDump();
+                } else if (header->nlmsg_seq == RouteDumpSeq && m_defaultRoutes.isResyncing()) {
+                    for (const DefaultRouteTable::Change &change : m_defaultRoutes.endResync()) {
+                        qDebug() << "LinkMonitor: Default-Route" << (change.second ? "vorhanden" : "fehlt") << "über" << change.first;
+                        emit routeChanged(change.first, change.second);
+                    }
+                }
+                continue;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR)
+                continue;
+
+            // Dump-Antworten tragen NLM_F_MULTI, Ereignisse nicht
+            if ((header->nlmsg_type == RTM_NEWROUTE || header->nlmsg_type == RTM_DELROUTE)
+                && (header->nlmsg_flags & NLM_F_MULTI) && header->nlmsg_seq == RouteDumpSeq) {
+                if (m_defaultRoutes.isResyncing())
+                    handleRoute(header, true);
+                continue;
+            }
+            handleMessage(header);
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Wertet Link-, Adress- und Routen-Nachrichten aus
+ *
+ * linkChanged() wird nur bei tatsächlicher Zustandsänderung ausgelöst,
+ * da der Kernel auch bei anderen Attributänderungen RTM_NEWLINK sendet.
+ */
+void LinkMonitor::handleMessage(const void *message)
+{
+#ifdef Q_OS_LINUX
+    const nlmsghdr *header = static_cast<const nlmsghdr*>(message);
+
+    switch (header->nlmsg_type) {
+    case RTM_NEWLINK:
+    case RTM_DELLINK: {
+        const ifinfomsg *info = static_cast<const ifinfomsg*>(NLMSG_DATA(header));
+        QString name;
+
+        // IFLA_IFNAME Attribut suchen
+        int attributeLength = IFLA_PAYLOAD(header);
+        for (const rtattr *attribute = IFLA_RTA(info); RTA_OK(attribute, attributeLength);
+             attribute = RTA_NEXT(attribute, attributeLength)) {
+            if (attribute->rta_type == IFLA_IFNAME) {
+                name = QString::fromLocal8Bit(static_cast<const char*>(RTA_DATA(attribute)));
+                break;
+            }
+        }
+        if (name.isEmpty())
+            name = interfaceName(info->ifi_index);
+        if (name.isEmpty())
+            return;
+
+        const bool up = header->nlmsg_type == RTM_NEWLINK
+                     && (info->ifi_flags & IFF_UP)
+                     && (info->ifi_flags & IFF_RUNNING);
+
+        if (header->nlmsg_type == RTM_DELLINK)
+            m_interfaceNames.remove(info->ifi_index);
+        else
+            m_interfaceNames.insert(info->ifi_index, name);
+
+        // Beim Abschalten verwirft der Kernel IPv4-Routen ohne RTM_DELROUTE
+        if ((header->nlmsg_type == RTM_DELLINK || !(info->ifi_flags & IFF_UP))
+            && m_defaultRoutes.removeInterface(name)) {
+            qDebug() << "LinkMonitor: Default-Routen entfallen mit Interface" << name;
+            emit routeChanged(name, false);
+        }
+
+        auto it = m_linkUp.find(name);
+        if (it != m_linkUp.end() && it.value() == up)
+            return;
+        m_linkUp.insert(name, up);
+
+        qDebug() << "LinkMonitor: Link" << name << (up ? "UP" : "DOWN");
+        emit linkChanged(name, up);
+        break;
+    }
+
+    case RTM_NEWADDR:
+    case RTM_DELADDR: {
+        const ifaddrmsg *info = static_cast<const ifaddrmsg*>(NLMSG_DATA(header));
+        QString name = interfaceName(info->ifa_index);
+        if (name.isEmpty())
+            return;
+
+        const bool added = header->nlmsg_type == RTM_NEWADDR;
+        qDebug() << "LinkMonitor: Adresse" << (added ? "hinzugefügt" : "entfernt") << "auf" << name;
+        emit addressChanged(name, added);
+        break;
+    }
+
+    case RTM_NEWROUTE:
+    case RTM_DELROUTE:
+        handleRoute(message, false);
+        break;
+
+    default:
+        break;
+    }
+#else
+    Q_UNUSED(message)
+#endif
+}
+
+/**
+ * @brief Zerlegt eine Default-Route in ihre Nexthops
+ *
+ * Jeder Nexthop (RTA_OIF/RTA_GATEWAY bzw. jeder Eintrag in RTA_MULTIPATH)
+ * ist eine eigene Route seines Interfaces. routeChanged() wird nur beim
+ * Übergang zwischen "keine" und "mindestens eine" Route ausgelöst.
+ */
+void LinkMonitor::handleRoute(const void *message, bool dumped)
+{
+#ifdef Q_OS_LINUX
+    const nlmsghdr *header = static_cast<const nlmsghdr*>(message);
+    const rtmsg *route = static_cast<const rtmsg*>(NLMSG_DATA(header));
+
+    // Nur Unicast-Default-Routen der Haupttabelle sind für die Uplink-Wahl relevant
+    if (route->rtm_table != RT_TABLE_MAIN || route->rtm_dst_len != 0 || route->rtm_type != RTN_UNICAST)
+        return;
+
+    int outputInterface = 0;
+    quint32 metric = 0;
+    QByteArray gateway;
+    const rtattr *multipath = nullptr;
+    int attributeLength = RTM_PAYLOAD(header);
+    for (const rtattr *attribute = RTM_RTA(route); RTA_OK(attribute, attributeLength);
+         attribute = RTA_NEXT(attribute, attributeLength)) {
+        switch (attribute->rta_type) {
+        case RTA_OIF:
+            outputInterface = *static_cast<const int*>(RTA_DATA(attribute));
+            break;
+        case RTA_PRIORITY:
+            metric = *static_cast<const quint32*>(RTA_DATA(attribute));
+            break;
+        case RTA_GATEWAY:
+            gateway = QByteArray(static_cast<const char*>(RTA_DATA(attribute)), (int)RTA_PAYLOAD(attribute));
+            break;
+        case RTA_MULTIPATH:
+            multipath = attribute;
+            break;
+        default:
+            break;
+        }
+    }
+
+    QVector<QPair<int, QByteArray>> nexthops;
+    if (multipath) {
+        int remaining = (int)RTA_PAYLOAD(multipath);
+        for (const rtnexthop *nexthop = static_cast<const rtnexthop*>(RTA_DATA(multipath));
+             RTNH_OK(nexthop, remaining);
+             remaining -= NLMSG_ALIGN(nexthop->rtnh_len), nexthop = RTNH_NEXT(nexthop)) {
+            QByteArray nexthopGateway;
+            int nexthopLength = nexthop->rtnh_len - (int)sizeof(rtnexthop);
+            for (const rtattr *attribute = RTNH_DATA(nexthop); RTA_OK(attribute, nexthopLength);
+                 attribute = RTA_NEXT(attribute, nexthopLength)) {
+                if (attribute->rta_type == RTA_GATEWAY)
+                    nexthopGateway = QByteArray(static_cast<const char*>(RTA_DATA(attribute)), (int)RTA_PAYLOAD(attribute));
+            }
+            nexthops.append(qMakePair(nexthop->rtnh_ifindex, nexthopGateway));
+        }
+    } else {
+        nexthops.append(qMakePair(outputInterface, gateway));
+    }
+
+    const bool added = header->nlmsg_type == RTM_NEWROUTE;
+    for (const auto &nexthop : nexthops) {
+        const QString name = interfaceName(nexthop.first);
+        if (name.isEmpty())
+            continue;
+
+        const QByteArray key = DefaultRouteTable::routeKey(route->rtm_family, metric, nexthop.second);
+        if (dumped) {
+            m_defaultRoutes.addDumped(name, key);
+            continue;
+        }
+
+        const bool changed = added ? m_defaultRoutes.add(name, key) : m_defaultRoutes.remove(name, key);
+        qDebug() << "LinkMonitor: Default-Route" << (route->rtm_family == AF_INET6 ? "IPv6" : "IPv4")
+                 << (added ? "hinzugefügt" : "entfernt") << "über" << name
+                 << "| verbleibend:" << m_defaultRoutes.routeCount(name);
+        if (changed)
+            emit routeChanged(name, added);
+    }
+#else
+    Q_UNUSED(message)
+    Q_UNUSED(dumped)
+#endif
+}
+
+/**
+ * @brief Löst einen Interface-Index in einen Namen auf
+ *
+ * Bevorzugt den Cache aus Link-Nachrichten, fällt auf if_indextoname() zurück.
+ */
+QString LinkMonitor::interfaceName(int ifindex) const
+{
+    if (ifindex <= 0)
+        return QString();
+
+    auto it = m_interfaceNames.constFind(ifindex);
+    if (it != m_interfaceNames.constEnd())
+        return it.value();
+
+#ifdef Q_OS_LINUX
+    char name[IF_NAMESIZE];
+    if (if_indextoname((unsigned)ifindex, name))
+        return QString::fromLocal8Bit(name);
+#endif
+    return QString();
+}
@@ -0,0 +1,155 @@
+#ifndef LINKMONITOR_H
+#define LINKMONITOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QSocketNotifier>
+#include <QString>
+#include <memory>
+
+#include "defaultroutetable.h"
+
+/**
+ * @brief Überwacht Netzwerk-Interfaces über Linux rtnetlink
+ *
+ * Öffnet einen NETLINK_ROUTE Socket und abonniert die Multicast-Gruppen für
+ * Link-, Adress- und Routen-Ereignisse. Änderungen werden ohne Polling
+ * innerhalb von Millisekunden gemeldet - deutlich schneller als ein
+ * Socket-Fehler oder ein ausbleibendes PINGRESP.
+ *
+ * Das Abonnieren der Gruppen benötigt keine Rechte, der Monitor funktioniert
+ * daher auch in einem unprivilegierten Network-Namespace (z.B. mit
+ * dummy/veth Interfaces: `unshare -rn`).
+ *
+ * Verwendung:
+ * @code
+ * LinkMonitor monitor;
+ * connect(&monitor, &LinkMonitor::linkChanged, [](const QString &ifname, bool up) {
+ *     qDebug() << ifname << (up ? "UP" : "DOWN");
+ * });
+ * monitor.start();
+ * @endcode
+ *
+ * @note Auf anderen Plattformen als Linux liefert start() false.
+ */
+class LinkMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     */
+    explicit LinkMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor - schließt den Netlink-Socket
+     */
+    ~LinkMonitor() override;
+
+    /**
+     * @brief Öffnet den Netlink-Socket und fordert den aktuellen Link-Zustand an
+     * @return true bei Erfolg, sonst false und error() wird ausgelöst
+     *
+     * Nach dem Start wird für jedes vorhandene Interface einmal
+     * linkChanged() mit dem Ausgangszustand ausgelöst, danach für jedes
+     * Interface mit Default-Route routeChanged(name, true).
+     */
+    bool start();
+
+    /**
+     * @brief Beendet die Überwachung
+     */
+    void stop();
+
+    /// true wenn der Netlink-Socket geöffnet ist
+    bool isRunning() const { return m_fd >= 0; }
+
+    /**
+     * @brief Letzter bekannter Zustand eines Interfaces
+     * @param interfaceName Name des Interfaces (z.B. "eth0")
+     * @return true wenn das Interface UP und RUNNING ist
+     */
+    bool isLinkUp(const QString &interfaceName) const { return m_linkUp.value(interfaceName, false); }
+
+    /// true wenn das Interface mindestens eine Default-Route (IPv4 oder IPv6) hat
+    bool hasDefaultRoute(const QString &interfaceName) const { return m_defaultRoutes.hasRoute(interfaceName); }
+
+signals:
+    /**
+     * @brief Link-Zustand eines Interfaces hat sich geändert
+     * @param interfaceName Name des Interfaces
+     * @param up true wenn UP und RUNNING (Träger vorhanden)
+     */
+    void linkChanged(const QString &interfaceName, bool up);
+
+    /**
+     * @brief Adresse wurde einem Interface hinzugefügt oder entfernt
+     * @param interfaceName Name des Interfaces
+     * @param added true = hinzugefügt, false = entfernt
+     */
+    void addressChanged(const QString &interfaceName, bool added);
+
+    /**
+     * @brief Interface hat seine erste Default-Route erhalten oder die letzte verloren
+     * @param interfaceName Ausgangs-Interface der Route
+     * @param added true = erste Route, false = keine Route mehr
+     *
+     * Gezählt werden Unicast-Default-Routen der Haupttabelle über beide
+     * Adressfamilien und alle ECMP-Nexthops (siehe DefaultRouteTable).
+     */
+    void routeChanged(const QString &interfaceName, bool added);
+
+    /**
+     * @brief Signal wird bei Fehlern ausgelöst
+     * @param errorString Beschreibung des Fehlers
+     */
+    void error(const QString &errorString);
+
+private:
+    /**
+     * @brief Liest alle anstehenden Netlink-Nachrichten
+     *
+     * Wird vom QSocketNotifier aufgerufen.
+     */
+    void onReadable();
+
+    /**
+     * @brief Sendet RTM_GETLINK Dump-Anfrage für den Ausgangszustand
+     *
+     * Nach dessen Ende folgt der Routen-Dump (requestRouteDump()) - pro
+     * Socket kann nur ein Dump gleichzeitig laufen.
+     */
+    bool requestLinkDump();
+
+    /**
+     * @brief Sendet RTM_GETROUTE Dump-Anfrage zum Abgleich der Default-Routen
+     */
+    bool requestRouteDump();
+
+    /**
+     * @brief Trägt eine Routen-Nachricht in m_defaultRoutes ein
+     * @param dumped true = Antwort auf requestRouteDump()
+     */
+    void handleRoute(const void *message, bool dumped);
+
+    /**
+     * @brief Wertet eine einzelne Netlink-Nachricht aus
+     * @param message Zeiger auf nlmsghdr
+     */
+    void handleMessage(const void *message);
+
+    /**
+     * @brief Ermittelt den Namen zu einem Interface-Index
+     */
+    QString interfaceName(int ifindex) const;
+
+    int m_fd;                                                ///< Netlink-Socket (-1 wenn geschlossen)
+    std::unique_ptr<QSocketNotifier> m_notifier;             ///< Lese-Benachrichtigung für den Socket
+    QHash<int, QString> m_interfaceNames;                    ///< Map: Interface-Index -> Name
+    QHash<QString, bool> m_linkUp;                           ///< Map: Interface-Name -> Link-Zustand
+    DefaultRouteTable m_defaultRoutes;                       ///< Default-Routen je Interface
+};
+
+#endif // LINKMONITOR_H
@@ -0,0 +1,116 @@
+#include "messagededuplicator.h"
+
+/**
+ * @brief Konstruktor - Reserviert den Ringpuffer
+ */
+MessageDeduplicator::MessageDeduplicator(int windowSize)
+    : m_ring(qMax(1, windowSize))
+    , m_ringHead(0)
+    , m_ringCount(0)
+    , m_duplicatesDropped(0)
+    , m_delivered{0, 0}
+{
+    m_pending.reserve(m_ring.size());
+}
+
+/**
+ * @brief Prüft eine Nachricht gegen das Duplikatfenster
+ *
+ * Ablauf:
+ * - Schuldet die Quelle noch eine Kopie dieses Inhalts -> Duplikat, verwerfen
+ * - Sonst ausliefern und vermerken, dass die andere Quelle eine Kopie schuldet
+ */
+bool MessageDeduplicator::accept(int source, const QString &topic, const QByteArray &payload)
+{
+    source &= 1;
+    const int other = source ^ 1;
+    const quint64 hash = contentHash(topic, payload);
+
+    auto it = m_pending.find(hash);
+    if (it != m_pending.end() && it->owed[source] > 0) {
+        // Andere Quelle war schneller - diese Kopie verwerfen, ihr Ring-Eintrag ist erfüllt
+        it->owed[source]--;
+        it->settled[source]++;
+        m_duplicatesDropped++;
+        return false;
+    }
+
+    // Fenster voll -> ältesten Eintrag verdrängen
+    if (m_ringCount == m_ring.size())
+        evictOldest();
+
+    m_pending[hash].owed[other]++;
+    m_ring[m_ringHead] = RingEntry{hash, other};
+    m_ringHead = (m_ringHead + 1) % m_ring.size();
+    m_ringCount++;
+
+    m_delivered[source]++;
+    return true;
+}
+
+/**
+ * @brief Löscht alle gemerkten Nachrichten
+ *
+ * Statistik-Zähler bleiben erhalten.
+ */
+void MessageDeduplicator::clear()
+{
+    m_pending.clear();
+    m_ringHead = 0;
+    m_ringCount = 0;
+}
+
+/**
+ * @brief FNV-1a über Topic (UTF-16) und Payload
+ *
+ * Ein Trennbyte zwischen Topic und Payload verhindert, dass
+ * ("ab", "c") und ("a", "bc") denselben Hash ergeben.
+ */
+quint64 MessageDeduplicator::contentHash(const QString &topic, const QByteArray &payload)
+{
+    quint64 hash = 14695981039346656037ULL;  // FNV Offset Basis
+    const quint64 prime = 1099511628211ULL;  // FNV Prime
+
+    const char *topicData = reinterpret_cast<const char*>(topic.constData());
+    const int topicBytes = topic.size() * int(sizeof(QChar));
+    for (int i = 0; i < topicBytes; ++i) {
+        hash ^= quint8(topicData[i]);
+        hash *= prime;
+    }
+
+    hash ^= 0xFF;  // Trennbyte
+    hash *= prime;
+
+    const char *payloadData = payload.constData();
+    for (int i = 0; i < payload.size(); ++i) {
+        hash ^= quint8(payloadData[i]);
+        hash *= prime;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Verdrängt den ältesten Eintrag aus dem Fenster
+ *
+ * Eine noch ausstehende Kopie wird "vergessen" - trifft sie später
+ * noch ein, wird sie als neue Nachricht ausgeliefert. War die Kopie
+ * bereits eingetroffen, bleibt die Zählung jüngerer Einträge unberührt.
+ */
+void MessageDeduplicator::evictOldest()
+{
+    const int tail = (m_ringHead - m_ringCount + m_ring.size()) % m_ring.size();
+    const RingEntry &entry = m_ring.at(tail);
+    m_ringCount--;
+
+    auto it = m_pending.find(entry.hash);
+    if (it == m_pending.end())
+        return;
+
+    if (it->settled[entry.owingSource] > 0)
+        it->settled[entry.owingSource]--;
+    else if (it->owed[entry.owingSource] > 0)
+        it->owed[entry.owingSource]--;
+    if (it->isEmpty())
+        m_pending.erase(it);
+}
@@ -0,0 +1,95 @@
+#ifndef MESSAGEDEDUPLICATOR_H
+#define MESSAGEDEDUPLICATOR_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Duplikatfilter für zwei redundante Nachrichtenquellen
+ *
+ * Wird vom RedundantMqttClient verwendet, um die Empfangsströme zweier
+ * Broker zusammenzuführen. Jede Nachricht wird über einen 64-Bit Inhalts-Hash
+ * (Topic + Payload) identifiziert, da MQTT Packet-IDs nur pro Verbindung
+ * gelten und zwischen Brokern nicht vergleichbar sind.
+ *
+ * Für jede ausgelieferte Nachricht merkt sich der Filter, dass die jeweils
+ * andere Quelle noch eine Kopie "schuldet". Trifft diese Kopie ein, wird sie
+ * verworfen. Kommt derselbe Inhalt erneut von derselben Quelle, handelt es
+ * sich um eine neue Nachricht und sie wird ausgeliefert.
+ *
+ * Das Fenster ist in der Anzahl der Einträge begrenzt (Ringpuffer), ältere
+ * Einträge werden verdrängt. Eingetroffene Kopien erfüllen die ältesten
+ * Einträge ihres Hashs; beim Verdrängen wird nur eine noch ausstehende
+ * Kopie vergessen, eine bereits erfüllte ändert die Zählung nicht.
+ */
+class MessageDeduplicator
+{
+public:
+    /**
+     * @brief Konstruktor
+     * @param windowSize Maximale Anzahl gemerkter Nachrichten (Standard: 4096)
+     */
+    explicit MessageDeduplicator(int windowSize = 4096);
+
+    /**
+     * @brief Prüft eine empfangene Nachricht
+     * @param source Quelle der Nachricht (0 oder 1)
+     * @param topic Topic der Nachricht
+     * @param payload Nachrichteninhalt
+     * @return true wenn die Nachricht ausgeliefert werden soll, false bei Duplikat
+     */
+    bool accept(int source, const QString &topic, const QByteArray &payload);
+
+    /**
+     * @brief Setzt den Filter zurück (z.B. nach Verbindungsverlust einer Quelle)
+     */
+    void clear();
+
+    /// Anzahl verworfener Duplikate seit dem Start
+    quint64 duplicatesDropped() const { return m_duplicatesDropped; }
+
+    /// Anzahl ausgelieferter Nachrichten pro Quelle
+    quint64 deliveredFrom(int source) const { return m_delivered[source & 1]; }
+
+    /**
+     * @brief Berechnet den Inhalts-Hash einer Nachricht (FNV-1a, 64 Bit)
+     *
+     * Der Hash ist unabhängig vom Qt-Hash-Seed und damit über Prozesse stabil.
+     */
+    static quint64 contentHash(const QString &topic, const QByteArray &payload);
+
+private:
+    /**
+     * @brief Zählung pro Hash und Quelle
+     *
+     * owed[i]: Kopien, die Quelle i noch liefern wird.
+     * settled[i]: Einträge im Ring, deren Kopie von Quelle i bereits eingetroffen ist.
+     * Kopien erfüllen und Verdrängung entfernt jeweils den ältesten Eintrag,
+     * die erfüllten liegen daher immer vor den ausstehenden.
+     */
+    struct Pending {
+        quint32 owed[2] = {0, 0};
+        quint32 settled[2] = {0, 0};
+
+        bool isEmpty() const { return !owed[0] && !owed[1] && !settled[0] && !settled[1]; }
+    };
+
+    /// Eintrag im Ringpuffer: Hash und Quelle, die noch eine Kopie schuldet
+    struct RingEntry {
+        quint64 hash = 0;
+        int owingSource = 0;
+    };
+
+    void evictOldest();
+
+    QHash<quint64, Pending> m_pending;                       ///< Map: Hash -> ausstehende Kopien
+    QVector<RingEntry> m_ring;                               ///< Ringpuffer der zuletzt ausgelieferten Nachrichten
+    int m_ringHead;                                          ///< Nächste Schreibposition im Ringpuffer
+    int m_ringCount;                                         ///< Anzahl belegter Einträge im Ringpuffer
+    quint64 m_duplicatesDropped;                             ///< Zähler verworfener Duplikate
+    quint64 m_delivered[2];                                  ///< Zähler ausgelieferter Nachrichten pro Quelle
+};
+
+#endif // MESSAGEDEDUPLICATOR_H
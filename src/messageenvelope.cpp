@@ -0,0 +1,90 @@
+#include "messageenvelope.h"
+
+#include <QRandomGenerator>
+#include <chrono>
+
+namespace {
+
+inline void appendBigEndian32(QByteArray &buffer, quint32 value)
+{
+    buffer.append((char)((value >> 24) & 0xFF));
+    buffer.append((char)((value >> 16) & 0xFF));
+    buffer.append((char)((value >> 8) & 0xFF));
+    buffer.append((char)(value & 0xFF));
+}
+
+inline quint32 readBigEndian32(const char *data)
+{
+    return (quint32)(quint8)data[0] << 24
+         | (quint32)(quint8)data[1] << 16
+         | (quint32)(quint8)data[2] << 8
+         | (quint32)(quint8)data[3];
+}
+
+} // namespace
+
+/**
+ * @brief Schreibt den 20-Byte Header
+ *
+ * Der Zeitstempel wird erst hier genommen, damit er möglichst nah
+ * am tatsächlichen Senden liegt.
+ */
+void MessageEnvelope::appendHeader(QByteArray &buffer, quint32 publisherId, quint32 sequence, quint8 codecId, quint8 epoch)
+{
+    buffer.append((char)Magic);
+    buffer.append((char)Version);
+    buffer.append((char)codecId);
+    buffer.append((char)epoch);
+
+    appendBigEndian32(buffer, publisherId);
+    appendBigEndian32(buffer, sequence);
+
+    const quint64 timestamp = monotonicNs();
+    appendBigEndian32(buffer, (quint32)(timestamp >> 32));  // High Word
+    appendBigEndian32(buffer, (quint32)timestamp);          // Low Word
+}
+
+/**
+ * @brief Parst den Header direkt im Quellpuffer
+ *
+ * Prüft Magic und Version. Payloads ohne Umschlag (z.B. von fremden
+ * Publishern) werden mit false abgelehnt und unverändert weitergereicht.
+ */
+bool MessageEnvelope::parse(const char *data, int size, View &view)
+{
+    if (size < HeaderSize)
+        return false;
+
+    if ((quint8)data[0] != Magic || (quint8)data[1] != Version)
+        return false;
+
+    view.codecId = (quint8)data[2];
+    view.epoch = (quint8)data[3];
+    view.publisherId = readBigEndian32(data + 4);
+    view.sequence = readBigEndian32(data + 8);
+    view.sendTimestampNs = (quint64)readBigEndian32(data + 12) << 32 | readBigEndian32(data + 16);
+    view.payload = data + HeaderSize;
+    view.payloadSize = size - HeaderSize;
+    return true;
+}
+
+quint64 MessageEnvelope::monotonicNs()
+{
+    using namespace std::chrono;
+    return (quint64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+quint32 MessageEnvelope::publisherIdFor(const QByteArray &clientId)
+{
+    quint32 hash = 2166136261u;  // FNV Offset Basis
+    for (int i = 0; i < clientId.size(); ++i) {
+        hash ^= (quint8)clientId.at(i);
+        hash *= 16777619u;       // FNV Prime
+    }
+    return hash;
+}
+
+quint8 MessageEnvelope::randomEpoch()
+{
+    return (quint8)QRandomGenerator::global()->bounded(1, 256);
+}
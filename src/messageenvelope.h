@@ -0,0 +1,88 @@
+#ifndef MESSAGEENVELOPE_H
+#define MESSAGEENVELOPE_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/**
+ * @brief Leichtgewichtiger binärer Umschlag für MQTT-Nutzdaten
+ *
+ * Wird optional vor die eigentliche Payload gesetzt und erlaubt dem Empfänger
+ * Verlust-, Duplikat- und Latenzmessung pro Publisher.
+ *
+ * Aufbau (20 Bytes, Big Endian wie MQTT selbst):
+ * - Byte 0:      Magic (0xE7)
+ * - Byte 1:      Version (1)
+ * - Byte 2:      Codec-ID (anwendungsdefiniert, z.B. 0 = Roh, 1 = JSON)
+ * - Byte 3:      Epoch (zufällig je Start des Publishers, 1-255; 0 = unbekannt)
+ * - Byte 4-7:    Publisher-ID
+ * - Byte 8-11:   Sequenznummer (pro Publisher, fortlaufend ab 0)
+ * - Byte 12-19:  Sendezeitpunkt in Nanosekunden (monotone Uhr)
+ *
+ * Die Epoch unterscheidet Neustarts eines Publishers: Die Publisher-ID
+ * ist aus der Client-ID abgeleitet und bleibt gleich, die Sequenz beginnt
+ * wieder bei 0. Ältere Sender setzen hier 0 (früher reservierte Flags).
+ *
+ * Das Parsen erfolgt ohne Kopie direkt auf dem Empfangspuffer.
+ */
+class MessageEnvelope
+{
+public:
+    static constexpr quint8 Magic = 0xE7;                    ///< Kennung des Umschlags
+    static constexpr quint8 Version = 1;                     ///< Aktuelle Format-Version
+    static constexpr int HeaderSize = 20;                    ///< Größe des Umschlags in Bytes
+
+    /**
+     * @brief Sicht auf einen geparsten Umschlag
+     *
+     * payload zeigt in den Quellpuffer und ist nur gültig, solange dieser lebt.
+     */
+    struct View {
+        quint8 codecId = 0;
+        quint8 epoch = 0;
+        quint32 publisherId = 0;
+        quint32 sequence = 0;
+        quint64 sendTimestampNs = 0;
+        const char *payload = nullptr;
+        int payloadSize = 0;
+    };
+
+    /**
+     * @brief Schreibt einen Umschlag-Header an das Ende eines Puffers
+     * @param buffer Ziel-Buffer (wird erweitert)
+     * @param publisherId ID des Publishers
+     * @param sequence Sequenznummer dieser Nachricht
+     * @param codecId Codec der folgenden Payload
+     * @param epoch Startkennung des Publishers (siehe randomEpoch())
+     */
+    static void appendHeader(QByteArray &buffer, quint32 publisherId, quint32 sequence, quint8 codecId, quint8 epoch);
+
+    /**
+     * @brief Parst einen Umschlag ohne Kopie
+     * @param data Zeiger auf den Beginn der Payload
+     * @param size Länge der Payload in Bytes
+     * @param view Ergebnis (nur bei Rückgabe true gültig)
+     * @return true wenn ein gültiger Umschlag erkannt wurde
+     */
+    static bool parse(const char *data, int size, View &view);
+
+    /**
+     * @brief Aktuelle Zeit der monotonen Uhr in Nanosekunden
+     *
+     * Sende- und Empfangszeit sind nur vergleichbar, wenn beide Seiten
+     * dieselbe Uhr verwenden (gleicher Host oder synchronisierte Uhren).
+     */
+    static quint64 monotonicNs();
+
+    /**
+     * @brief Leitet eine Publisher-ID aus der Client-ID ab (FNV-1a, 32 Bit)
+     */
+    static quint32 publisherIdFor(const QByteArray &clientId);
+
+    /**
+     * @brief Neue zufällige Epoch für einen Publisher-Start (nie 0)
+     */
+    static quint8 randomEpoch();
+};
+
+#endif // MESSAGEENVELOPE_H
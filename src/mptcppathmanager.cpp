@@ -0,0 +1,538 @@
+#include "mptcppathmanager.h"
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <linux/genetlink.h>
+#include <linux/mptcp.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef IPPROTO_MPTCP
+#define IPPROTO_MPTCP 262
+#endif
+#endif
+
+#ifdef Q_OS_LINUX
+namespace {
+
+/// Hängt ein Netlink-Attribut an (mit Auffüllen auf 4 Bytes)
+void appendAttribute(QByteArray &buffer, quint16 type, const void *data, int size)
+{
+    nlattr attribute;
+    attribute.nla_len = (quint16)(NLA_HDRLEN + size);
+    attribute.nla_type = type;
+    buffer.append(reinterpret_cast<const char*>(&attribute), NLA_HDRLEN);
+    buffer.append(static_cast<const char*>(data), size);
+    buffer.append(QByteArray(NLA_ALIGN(size) - size, '\0'));
+}
+
+template<typename T>
+void appendAttribute(QByteArray &buffer, quint16 type, T value)
+{
+    appendAttribute(buffer, type, &value, (int)sizeof(value));
+}
+
+/// Ruft callback(type, data, size) für jedes Attribut im Bereich auf
+template<typename Callback>
+void forEachAttribute(const char *data, int size, Callback callback)
+{
+    while (size >= NLA_HDRLEN) {
+        const nlattr *attribute = reinterpret_cast<const nlattr*>(data);
+        if (attribute->nla_len < NLA_HDRLEN || attribute->nla_len > size)
+            return;
+        callback(attribute->nla_type & NLA_TYPE_MASK, data + NLA_HDRLEN, attribute->nla_len - NLA_HDRLEN);
+        const int step = NLA_ALIGN(attribute->nla_len);
+        data += step;
+        size -= step;
+    }
+}
+
+/// Adresse in Familie und Netzwerk-Bytes, normalisierte Schreibweise in canonical
+bool parseAddress(const QString &address, int *family, unsigned char *bytes, QString *canonical)
+{
+    const QByteArray text = address.trimmed().toLatin1();
+    *family = text.indexOf(':') >= 0 ? AF_INET6 : AF_INET;
+    if (inet_pton(*family, text.constData(), bytes) != 1)
+        return false;
+
+    char buffer[INET6_ADDRSTRLEN];
+    if (!inet_ntop(*family, bytes, buffer, sizeof(buffer)))
+        return false;
+    *canonical = QString::fromLatin1(buffer);
+    return true;
+}
+
+/**
+ * @brief Schreibt MPTCP_PM_ATTR_ADDR (verschachtelt)
+ * @param id Endpunkt-ID (0 = weglassen)
+ * @param interfaceIndex Interface (0 = weglassen)
+ * @param flags Flags (-1 = weglassen)
+ */
+void appendAddress(QByteArray &attributes, int family, const unsigned char *bytes, quint8 id, int interfaceIndex, int flags)
+{
+    QByteArray nested;
+    appendAttribute<quint16>(nested, MPTCP_PM_ADDR_ATTR_FAMILY, (quint16)family);
+    if (family == AF_INET)
+        appendAttribute(nested, MPTCP_PM_ADDR_ATTR_ADDR4, bytes, 4);
+    else
+        appendAttribute(nested, MPTCP_PM_ADDR_ATTR_ADDR6, bytes, 16);
+    if (id != 0)
+        appendAttribute<quint8>(nested, MPTCP_PM_ADDR_ATTR_ID, id);
+    if (interfaceIndex > 0)
+        appendAttribute<qint32>(nested, MPTCP_PM_ADDR_ATTR_IF_IDX, interfaceIndex);
+    if (flags >= 0)
+        appendAttribute<quint32>(nested, MPTCP_PM_ADDR_ATTR_FLAGS, (quint32)flags);
+    appendAttribute(attributes, MPTCP_PM_ATTR_ADDR | NLA_F_NESTED, nested.constData(), nested.size());
+}
+
+const char* commandName(quint8 command)
+{
+    switch (command) {
+    case MPTCP_PM_CMD_ADD_ADDR:  return "ADD_ADDR";
+    case MPTCP_PM_CMD_DEL_ADDR:  return "DEL_ADDR";
+    case MPTCP_PM_CMD_GET_ADDR:  return "GET_ADDR";
+    case MPTCP_PM_CMD_SET_LIMITS: return "SET_LIMITS";
+    case MPTCP_PM_CMD_SET_FLAGS: return "SET_FLAGS";
+    default:                     return "GETFAMILY";
+    }
+}
+
+}
+#endif
+
+MptcpPathManager::MptcpPathManager()
+    : m_fd(-1)
+    , m_family(0)
+    , m_sequence(0)
+{
+}
+
+MptcpPathManager::~MptcpPathManager()
+{
+    close();
+}
+
+/**
+ * @brief Legt testweise einen MPTCP-Socket an
+ */
+bool MptcpPathManager::isSupported()
+{
+#ifdef Q_OS_LINUX
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_MPTCP);
+    if (fd < 0)
+        return false;
+    ::close(fd);
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Öffnet einen NETLINK_GENERIC Socket
+ *
+ * Blockierend mit Empfangs-Timeout - alle Anfragen warten auf ihre
+ * Bestätigung. Erweiterte Bestätigungen (NETLINK_EXT_ACK) liefern den
+ * Klartext des Kernels zu abgelehnten Anfragen.
+ */
+bool MptcpPathManager::open(QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0)
+        return true;
+
+    m_fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (m_fd < 0) {
+        if (errorString)
+            *errorString = "Netlink-Socket konnte nicht geöffnet werden: " + QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+
+    timeval timeout;
+    timeout.tv_sec = RequestTimeoutMs / 1000;
+    timeout.tv_usec = (RequestTimeoutMs % 1000) * 1000;
+    ::setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    const int on = 1;
+    ::setsockopt(m_fd, SOL_NETLINK, NETLINK_EXT_ACK, &on, sizeof(on));
+
+    sockaddr_nl address;
+    memset(&address, 0, sizeof(address));
+    address.nl_family = AF_NETLINK;
+    if (::bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        if (errorString)
+            *errorString = "Netlink-Socket konnte nicht gebunden werden: " + QString::fromLocal8Bit(strerror(errno));
+        close();
+        return false;
+    }
+
+    if (!resolveFamily(errorString)) {
+        close();
+        return false;
+    }
+    qDebug() << "MPTCP-Pfadmanager geöffnet, Familie" << m_family;
+    return true;
+#else
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Räumt die eigenen Endpunkte ab
+ *
+ * Sie gelten für den ganzen Namespace und überleben sonst den Prozess.
+ */
+void MptcpPathManager::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd < 0)
+        return;
+
+    const QList<QString> addresses = m_endpoints.keys();
+    for (const QString &address : addresses) {
+        QString errorString;
+        if (!removeEndpoint(address, &errorString))
+            qDebug() << errorString;
+    }
+
+    ::close(m_fd);
+    m_fd = -1;
+    m_family = 0;
+#endif
+}
+
+/**
+ * @brief Sendet eine Generic-Netlink-Anfrage und wartet auf die Antwort
+ * @param replies Nutzdaten (hinter genlmsghdr) aller Antwortnachrichten (optional)
+ *
+ * Endet mit der Bestätigung (NLMSG_ERROR mit 0) oder nach einem Dump
+ * mit NLMSG_DONE. Nachrichten zu älteren Anfragen, z.B. die Bestätigung
+ * eines Dumps, werden übersprungen.
+ */
+bool MptcpPathManager::request(quint16 family, quint8 command, quint8 version, quint16 flags, const QByteArray &attributes,
+                               QString *errorString, QVector<QByteArray> *replies)
+{
+#ifdef Q_OS_LINUX
+    auto fail = [command, errorString](const QString &reason) {
+        if (errorString)
+            *errorString = QString("MPTCP-Pfadmanager: %1 fehlgeschlagen: %2").arg(commandName(command), reason);
+        return false;
+    };
+
+    if (m_fd < 0)
+        return fail("nicht geöffnet");
+
+    QByteArray message(NLMSG_HDRLEN + GENL_HDRLEN, '\0');
+    message.append(attributes);
+
+    nlmsghdr *header = reinterpret_cast<nlmsghdr*>(message.data());
+    header->nlmsg_len = (quint32)message.size();
+    header->nlmsg_type = family;
+    header->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+    header->nlmsg_seq = ++m_sequence;
+    genlmsghdr *genl = reinterpret_cast<genlmsghdr*>(message.data() + NLMSG_HDRLEN);
+    genl->cmd = command;
+    genl->version = version;
+
+    if (::send(m_fd, message.constData(), message.size(), 0) < 0)
+        return fail(QString::fromLocal8Bit(strerror(errno)));
+
+    alignas(nlmsghdr) char buffer[16384];
+    for (;;) {
+        const ssize_t length = ::recv(m_fd, buffer, sizeof(buffer), 0);
+        if (length < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return fail("keine Antwort des Kernels");
+            return fail(QString::fromLocal8Bit(strerror(errno)));
+        }
+
+        int remaining = (int)length;
+        for (const nlmsghdr *reply = reinterpret_cast<const nlmsghdr*>(buffer);
+             NLMSG_OK(reply, remaining);
+             reply = NLMSG_NEXT(reply, remaining)) {
+            if (reply->nlmsg_seq != m_sequence)
+                continue;
+
+            if (reply->nlmsg_type == NLMSG_DONE)
+                return true;
+
+            if (reply->nlmsg_type == NLMSG_ERROR) {
+                const nlmsgerr *ack = static_cast<const nlmsgerr*>(NLMSG_DATA(reply));
+                if (ack->error == 0)
+                    return true;
+
+                // Klartext des Kernels hinter der zurückgeschickten Anfrage
+                QString reason = QString::fromLocal8Bit(strerror(-ack->error));
+                if (reply->nlmsg_flags & NLM_F_ACK_TLVS) {
+                    int offset = (int)sizeof(nlmsgerr);
+                    if (!(reply->nlmsg_flags & NLM_F_CAPPED))
+                        offset += (int)ack->msg.nlmsg_len - NLMSG_HDRLEN;
+                    const char *tlvs = static_cast<const char*>(NLMSG_DATA(reply)) + offset;
+                    const int size = (int)reply->nlmsg_len - NLMSG_HDRLEN - offset;
+                    forEachAttribute(tlvs, size, [&reason](int type, const char *data, int dataSize) {
+                        if (type == NLMSGERR_ATTR_MSG && dataSize > 1 && data[dataSize - 1] == '\0')
+                            reason += " (" + QString::fromLocal8Bit(data) + ")";
+                    });
+                }
+                return fail(reason);
+            }
+
+            if (replies && reply->nlmsg_len >= NLMSG_HDRLEN + GENL_HDRLEN)
+                replies->append(QByteArray(static_cast<const char*>(NLMSG_DATA(reply)) + GENL_HDRLEN,
+                                           (int)reply->nlmsg_len - NLMSG_HDRLEN - GENL_HDRLEN));
+        }
+    }
+#else
+    Q_UNUSED(family)
+    Q_UNUSED(command)
+    Q_UNUSED(version)
+    Q_UNUSED(flags)
+    Q_UNUSED(attributes)
+    Q_UNUSED(replies)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Fragt beim Netlink-Controller die ID der Familie "mptcp_pm" ab
+ */
+bool MptcpPathManager::resolveFamily(QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    QByteArray attributes;
+    appendAttribute(attributes, CTRL_ATTR_FAMILY_NAME, MPTCP_PM_NAME, (int)sizeof(MPTCP_PM_NAME));
+
+    QVector<QByteArray> replies;
+    if (!request(GENL_ID_CTRL, CTRL_CMD_GETFAMILY, 2, 0, attributes, errorString, &replies)) {
+        if (errorString)
+            *errorString += " - Kernel ohne MPTCP?";
+        return false;
+    }
+
+    for (const QByteArray &reply : replies) {
+        forEachAttribute(reply.constData(), reply.size(), [this](int type, const char *data, int size) {
+            if (type == CTRL_ATTR_FAMILY_ID && size >= 2)
+                memcpy(&m_family, data, sizeof(m_family));
+        });
+    }
+    if (m_family == 0) {
+        if (errorString)
+            *errorString = "MPTCP-Pfadmanager: Familie " MPTCP_PM_NAME " nicht gefunden";
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(errorString)
+    return false;
+#endif
+}
+
+bool MptcpPathManager::setLimits(int subflows, int acceptedAddresses, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    QByteArray attributes;
+    appendAttribute<quint32>(attributes, MPTCP_PM_ATTR_SUBFLOWS, (quint32)subflows);
+    appendAttribute<quint32>(attributes, MPTCP_PM_ATTR_RCV_ADD_ADDRS, (quint32)acceptedAddresses);
+    return request(m_family, MPTCP_PM_CMD_SET_LIMITS, MPTCP_PM_VER, 0, attributes, errorString);
+#else
+    Q_UNUSED(subflows)
+    Q_UNUSED(acceptedAddresses)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Legt den Endpunkt an und merkt sich die vom Kernel vergebene ID
+ *
+ * Die ID wird für removeEndpoint() benötigt und steht nicht in der
+ * Bestätigung - sie wird per Dump nachgeschlagen.
+ */
+bool MptcpPathManager::addEndpoint(const QString &address, const QString &interfaceName, int flags, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    int family = 0;
+    unsigned char bytes[16];
+    QString canonical;
+    if (!parseAddress(address, &family, bytes, &canonical)) {
+        if (errorString)
+            *errorString = "MPTCP-Pfadmanager: ungültige Adresse " + address;
+        return false;
+    }
+
+    int interfaceIndex = 0;
+    if (!interfaceName.isEmpty()) {
+        interfaceIndex = (int)if_nametoindex(interfaceName.toLocal8Bit().constData());
+        if (interfaceIndex == 0) {
+            if (errorString)
+                *errorString = "MPTCP-Pfadmanager: Interface " + interfaceName + " nicht vorhanden";
+            return false;
+        }
+    }
+
+    QByteArray attributes;
+    appendAddress(attributes, family, bytes, 0, interfaceIndex, flags);
+    if (!request(m_family, MPTCP_PM_CMD_ADD_ADDR, MPTCP_PM_VER, 0, attributes, errorString))
+        return false;
+
+    Endpoint added;
+    if (endpoint(canonical, &added, errorString))
+        m_endpoints.insert(canonical, added.id);
+    qDebug() << "MPTCP-Endpunkt angelegt:" << canonical << "ID" << added.id << "Flags" << flags;
+    return true;
+#else
+    Q_UNUSED(address)
+    Q_UNUSED(interfaceName)
+    Q_UNUSED(flags)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+bool MptcpPathManager::removeEndpoint(const QString &address, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    int family = 0;
+    unsigned char bytes[16];
+    QString canonical;
+    if (!parseAddress(address, &family, bytes, &canonical)) {
+        if (errorString)
+            *errorString = "MPTCP-Pfadmanager: ungültige Adresse " + address;
+        return false;
+    }
+
+    // DEL_ADDR sucht nach der ID - fremde Endpunkte beim Kernel nachschlagen
+    Endpoint current;
+    if (m_endpoints.contains(canonical))
+        current.id = m_endpoints.value(canonical);
+    else if (!endpoint(canonical, &current, errorString))
+        return false;
+
+    QByteArray attributes;
+    appendAddress(attributes, family, bytes, current.id, 0, -1);
+    m_endpoints.remove(canonical);
+    return request(m_family, MPTCP_PM_CMD_DEL_ADDR, MPTCP_PM_VER, 0, attributes, errorString);
+#else
+    Q_UNUSED(address)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Setzt oder löscht das Backup-Flag, die übrigen Flags bleiben
+ *
+ * SET_FLAGS ersetzt Backup- und Fullmesh-Flag gemeinsam, daher werden
+ * die aktuellen Flags zuerst beim Kernel nachgeschlagen.
+ */
+bool MptcpPathManager::setBackup(const QString &address, bool backup, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    int family = 0;
+    unsigned char bytes[16];
+    QString canonical;
+    if (!parseAddress(address, &family, bytes, &canonical)) {
+        if (errorString)
+            *errorString = "MPTCP-Pfadmanager: ungültige Adresse " + address;
+        return false;
+    }
+
+    Endpoint current;
+    if (!endpoint(canonical, &current, errorString))
+        return false;
+
+    const int flags = backup ? (current.flags | Backup) : (current.flags & ~Backup);
+    QByteArray attributes;
+    appendAddress(attributes, family, bytes, current.id, 0, flags);
+    return request(m_family, MPTCP_PM_CMD_SET_FLAGS, MPTCP_PM_VER, 0, attributes, errorString);
+#else
+    Q_UNUSED(address)
+    Q_UNUSED(backup)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Durchsucht den Dump aller Endpunkte nach der Adresse
+ */
+bool MptcpPathManager::endpoint(const QString &address, Endpoint *endpoint, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    int family = 0;
+    unsigned char bytes[16];
+    QString canonical;
+    if (!parseAddress(address, &family, bytes, &canonical)) {
+        if (errorString)
+            *errorString = "MPTCP-Pfadmanager: ungültige Adresse " + address;
+        return false;
+    }
+
+    QVector<QByteArray> replies;
+    if (!request(m_family, MPTCP_PM_CMD_GET_ADDR, MPTCP_PM_VER, NLM_F_DUMP, QByteArray(), errorString, &replies))
+        return false;
+
+    const int addressSize = family == AF_INET ? 4 : 16;
+    for (const QByteArray &reply : replies) {
+        bool found = false;
+        Endpoint entry;
+        forEachAttribute(reply.constData(), reply.size(), [&](int type, const char *data, int size) {
+            if (type != MPTCP_PM_ATTR_ADDR)
+                return;
+            forEachAttribute(data, size, [&](int addressType, const char *value, int valueSize) {
+                switch (addressType) {
+                case MPTCP_PM_ADDR_ATTR_ADDR4:
+                case MPTCP_PM_ADDR_ATTR_ADDR6:
+                    found = valueSize == addressSize && memcmp(value, bytes, addressSize) == 0
+                         && (addressType == MPTCP_PM_ADDR_ATTR_ADDR4) == (family == AF_INET);
+                    break;
+                case MPTCP_PM_ADDR_ATTR_ID:
+                    if (valueSize >= 1)
+                        entry.id = (quint8)value[0];
+                    break;
+                case MPTCP_PM_ADDR_ATTR_FLAGS:
+                    if (valueSize >= 4)
+                        memcpy(&entry.flags, value, 4);
+                    break;
+                case MPTCP_PM_ADDR_ATTR_IF_IDX:
+                    if (valueSize >= 4)
+                        memcpy(&entry.interfaceIndex, value, 4);
+                    break;
+                default:
+                    break;
+                }
+            });
+        });
+        if (found) {
+            if (endpoint)
+                *endpoint = entry;
+            return true;
+        }
+    }
+
+    if (errorString)
+        *errorString = "MPTCP-Pfadmanager: kein Endpunkt für " + canonical;
+    return false;
+#else
+    Q_UNUSED(address)
+    Q_UNUSED(endpoint)
+    if (errorString)
+        *errorString = "MPTCP wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
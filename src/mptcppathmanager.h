@@ -0,0 +1,154 @@
+#ifndef MPTCPPATHMANAGER_H
+#define MPTCPPATHMANAGER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Steuert den Multipath-TCP Pfadmanager des Kernels (Generic Netlink "mptcp_pm")
+ *
+ * Mit MPTCP läuft eine Broker-Verbindung über mehrere TCP-Subflows, je
+ * Uplink einer. Fällt ein Uplink weg, übernimmt ein anderer Subflow die
+ * Daten derselben Verbindung - die MQTT-Sitzung, ihre Abonnements und
+ * die Paket-IDs bleiben erhalten, es gibt keinen Neuaufbau.
+ *
+ * Welche lokalen Adressen Subflows bekommen, legen die Endpunkte des
+ * Pfadmanagers fest (wie `ip mptcp endpoint`). Ein Endpunkt mit Backup-Flag
+ * wird nur genutzt, wenn kein aktiver Subflow mehr sendet; setBackup()
+ * ändert die Rolle auch für bestehende Verbindungen (MP_PRIO an die Gegenstelle).
+ * Für geplante Wechsel zwischen intakten Uplinks. Ist ein Uplink
+ * ausgefallen, wird sein Endpunkt mit removeEndpoint() zurückgezogen:
+ * Ein nur zur Reserve erklärter toter Subflow würde von der Gegenstelle
+ * bis zum Retransmissions-Timeout weiter bedient.
+ *
+ * Die Einstellungen gelten für den ganzen Network-Namespace. Alle
+ * Befehle benötigen CAP_NET_ADMIN - in einem unprivilegierten Namespace
+ * (`unshare -rn`) ist das gegeben. Die Anfragen sind synchron und warten
+ * höchstens RequestTimeoutMs auf die Bestätigung des Kernels.
+ *
+ * Verwendung:
+ * @code
+ * MptcpPathManager pathManager;
+ * QString errorString;
+ * if (pathManager.open(&errorString)) {
+ *     pathManager.setLimits(2, 2);
+ *     pathManager.addEndpoint("10.0.1.2", "wlan0", MptcpPathManager::Subflow);
+ *     pathManager.addEndpoint("10.0.2.2", "wwan0", MptcpPathManager::Subflow | MptcpPathManager::Backup);
+ *     // Geplanter Wechsel: Mobilfunk wird aktiv, WLAN nur noch Reserve
+ *     pathManager.setBackup("10.0.2.2", false);
+ *     pathManager.setBackup("10.0.1.2", true);
+ *     // Mobilfunk fällt aus: Pfad zurückziehen, die Verbindung läuft über WLAN weiter
+ *     pathManager.removeEndpoint("10.0.2.2");
+ * }
+ * @endcode
+ *
+ * @note Auf anderen Plattformen als Linux liefert open() false.
+ */
+class MptcpPathManager
+{
+public:
+    /// Flags eines Endpunkts (Werte wie MPTCP_PM_ADDR_FLAG_*)
+    enum EndpointFlag {
+        Signal = 0x1,                                        ///< Adresse der Gegenstelle ankündigen (Serverseite)
+        Subflow = 0x2,                                       ///< Eigene Subflows von dieser Adresse aufbauen
+        Backup = 0x4,                                        ///< Nur nutzen, wenn kein aktiver Subflow bleibt
+        Fullmesh = 0x8                                       ///< Subflows zu allen bekannten Adressen der Gegenstelle
+    };
+
+    /// Endpunkt wie vom Kernel gemeldet
+    struct Endpoint {
+        quint8 id = 0;                                       ///< Vom Kernel vergebene ID
+        int flags = 0;                                       ///< Kombination aus EndpointFlag
+        int interfaceIndex = 0;                              ///< Gebundenes Interface (0 = keins)
+    };
+
+    static constexpr int RequestTimeoutMs = 1000;            ///< Höchste Wartezeit auf die Kernel-Bestätigung
+
+    MptcpPathManager();
+    ~MptcpPathManager();
+
+    MptcpPathManager(const MptcpPathManager&) = delete;
+    MptcpPathManager& operator=(const MptcpPathManager&) = delete;
+
+    /**
+     * @brief Prüft ob der Kernel MPTCP-Sockets anbietet
+     *
+     * false bei fehlender Unterstützung oder net.mptcp.enabled = 0.
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Öffnet den Netlink-Socket und ermittelt die Familie "mptcp_pm"
+     * @param errorString Fehlerbeschreibung (optional)
+     */
+    bool open(QString *errorString = nullptr);
+
+    /**
+     * @brief Entfernt die selbst angelegten Endpunkte und schließt den Socket
+     */
+    void close();
+
+    bool isOpen() const { return m_fd >= 0; }
+
+    /**
+     * @brief Setzt die Grenzen des Pfadmanagers
+     * @param subflows Zusätzliche Subflows pro Verbindung
+     * @param acceptedAddresses Von der Gegenstelle angekündigte Adressen, die genutzt werden
+     */
+    bool setLimits(int subflows, int acceptedAddresses, QString *errorString = nullptr);
+
+    /**
+     * @brief Legt einen Endpunkt für eine lokale Adresse an
+     * @param address Lokale IPv4- oder IPv6-Adresse des Uplinks
+     * @param interfaceName Interface für den Subflow (leer = nach Routing)
+     * @param flags Kombination aus EndpointFlag
+     *
+     * Der Endpunkt wird mit close() wieder entfernt.
+     */
+    bool addEndpoint(const QString &address, const QString &interfaceName, int flags, QString *errorString = nullptr);
+
+    /**
+     * @brief Entfernt den Endpunkt einer Adresse
+     *
+     * Subflows über die Adresse werden sofort geschlossen und der
+     * Gegenstelle über die verbleibenden per REMOVE_ADDR gemeldet - sie
+     * sendet dann nicht mehr in den toten Pfad. Für den Ausfall eines
+     * Uplinks deutlich schneller als das Warten auf die Erkennung durch
+     * Retransmissions-Timeouts.
+     */
+    bool removeEndpoint(const QString &address, QString *errorString = nullptr);
+
+    /**
+     * @brief Macht einen Endpunkt zur Reserve oder zum aktiven Pfad
+     * @param backup true = nur nutzen wenn kein aktiver Subflow bleibt
+     *
+     * Wirkt sofort auf alle bestehenden Subflows dieser Adresse.
+     */
+    bool setBackup(const QString &address, bool backup, QString *errorString = nullptr);
+
+    /**
+     * @brief Sucht den Endpunkt einer Adresse in der Liste des Kernels
+     * @return false wenn es keinen gibt oder die Abfrage fehlschlägt
+     *
+     * Findet auch Endpunkte, die außerhalb angelegt wurden (z.B. `ip mptcp endpoint add`).
+     */
+    bool endpoint(const QString &address, Endpoint *endpoint, QString *errorString = nullptr);
+
+    /// Selbst angelegte Endpunkte (Adresse -> ID)
+    const QHash<QString, quint8>& ownEndpoints() const { return m_endpoints; }
+
+private:
+    bool request(quint16 family, quint8 command, quint8 version, quint16 flags, const QByteArray &attributes,
+                 QString *errorString, QVector<QByteArray> *replies = nullptr);
+    bool resolveFamily(QString *errorString);
+
+    int m_fd;                                                ///< Netlink-Socket (-1 = geschlossen)
+    quint16 m_family;                                        ///< ID der Familie "mptcp_pm"
+    quint32 m_sequence;                                      ///< Laufende Nummer der Anfragen
+    QHash<QString, quint8> m_endpoints;                      ///< Selbst angelegte Endpunkte
+};
+
+#endif // MPTCPPATHMANAGER_H
@@ -1,45 +1,139 @@
 #include "mqttclient.h"
+#include "crc32c.h"
+#include "cyclecounter.h"
+#include "payloadcipher.h"
 #include <QDebug>
 
+#include <chrono>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <climits>
+#include <limits>
+#include <linux/mptcp.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef IPPROTO_MPTCP
+#define IPPROTO_MPTCP 262
+#endif
+#ifndef SOL_MPTCP
+#define SOL_MPTCP 284
+#endif
+#endif
+
+/**
+ * @brief Konstruktor - Client am Standard-Reactor des aktuellen Threads
+ */
+MqttClient::MqttClient(QObject *parent)
+    : MqttClient(MqttReactor::forCurrentThread(), parent)
+{
+}
+
 /**
  * @brief Konstruktor - Initialisiert den MQTT-Client
  *
- * Erstellt Socket und Timer mit Smart Pointern und verbindet alle Signals.
+ * Erstellt den Socket mit Smart Pointer und verbindet alle Signals.
+ * Keep-Alive und Pufferpools kommen vom Reactor.
  * Setzt Socket-Optionen für stabile Verbindung (Keep-Alive, Low Delay).
  */
-MqttClient::MqttClient(QObject *parent)
+MqttClient::MqttClient(MqttReactor *reactor, QObject *parent)
     : QObject(parent)
+    , m_reactor(reactor)
     , m_socket(std::make_unique<QTcpSocket>(this))          // Smart Pointer mit Parent für Qt-Integration
-    , m_keepAliveTimer(std::make_unique<QTimer>(this))      // Smart Pointer mit Parent
+    , m_timerWheel(reactor->timerWheel())                   // Ein Timer-Rad pro Reactor-Thread
+    , m_keepAliveTimer(0)
     , m_connected(false)
     , m_packetId(1)
+    , m_reading(false)
     , m_keepAliveInterval(30)  // 30 Sekunden Keep-Alive
+    , m_pingPending(false)
+    , m_envelopeEnabled(false)
+    , m_envelopeCodecId(0)
+    , m_publisherId(0)
+    , m_publishSequence(0)
+    , m_publisherEpoch(MessageEnvelope::randomEpoch())
+    , m_writeBatchingEnabled(true)
+    , m_pendingOffset(0)
+    , m_pendingMessages(0)
+    , m_lastBatchWindowMs(0)
+    , m_flushTimer(0)
+    , m_receiveTimestamps(false)
+    , m_receiveTimestampNs(0)
+    , m_dispatchTimestampNs(0)
+    , m_chunkTimestampNs(0)
+    , m_chunkReadNs(0)
+    , m_residualTimestampNs(0)
+    , m_residualReadNs(0)
+    , m_chunkStart(0)
+    , m_checksumFailures(0)
+    , m_decryptFailures(0)
+    , m_filteredMessages(0)
+    , m_lastValueCache(nullptr)
+    , m_handlerBudgetTicks(0)
+    , m_handlerStrikes(3)
+    , m_isolationCapacity(1024)
+    , m_isolationPolicy(HandlerWorker::DropOldest)
+    , m_controlBacklogLimit(0)
+    , m_pendingWriteLimit(4 * 1024 * 1024)
+    , m_droppedWrites(0)
+    , m_controlTimer(0)
+    , m_controlExpired(0)
+    , m_bufferTuning(false)
+    , m_bufferTimer(0)
+    , m_dropDuplicates(false)
+    , m_droppedDuplicates(0)
+    , m_multipath(false)
+    , m_multipathFd(-1)
+    , m_multipathLookupId(-1)
+    , m_multipathPort(0)
+    , m_multipathMode(QIODevice::ReadWrite)
 {
+    m_sequenceTracker = std::make_shared<SequenceTracker>();
+
     // Socket-Signals verbinden
     connect(m_socket.get(), &QTcpSocket::connected, this, &MqttClient::onConnected);
     connect(m_socket.get(), &QTcpSocket::disconnected, this, &MqttClient::onDisconnected);
     connect(m_socket.get(), &QTcpSocket::readyRead, this, &MqttClient::onReadyRead);
+    connect(m_socket.get(), &QTcpSocket::bytesWritten, this, &MqttClient::onBytesWritten);
     connect(m_socket.get(), QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::errorOccurred),
             this, &MqttClient::onSocketError);
 
-    // Keep-Alive Timer Signal verbinden
-    connect(m_keepAliveTimer.get(), &QTimer::timeout, this, &MqttClient::sendPingRequest);
-
     // Socket-Optionen für stabilere Verbindung
     m_socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);  // TCP Keep-Alive aktivieren
     m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);   // Nagle-Algorithmus deaktivieren
+
+    // Internen Lesepuffer begrenzen - der Rest bleibt im Kernel (Gegendruck)
+    m_socket->setReadBufferSize(MqttReactor::SocketReadBufferLimit);
+
+    m_reactor->attach(this);
 }
 
 /**
  * @brief Destruktor - Trennt Verbindung und räumt auf
  *
- * Smart Pointer geben automatisch QTcpSocket und QTimer frei.
+ * Smart Pointer geben automatisch den QTcpSocket frei.
+ * Der Keep-Alive wird im Timer-Rad abgemeldet.
  */
 MqttClient::~MqttClient()
 {
     if (m_connected) {
         disconnect();  // Sauberes Trennen wenn noch verbunden
     }
+    stopKeepAlive();
+    discardPendingWrites();
+    m_timerWheel->cancel(m_controlTimer);
+    m_timerWheel->cancel(m_bufferTimer);
+    m_controlQueue.takeAll();
+    abortMultipathConnect();
+    m_reactor->detach(this);
     // Smart Pointer räumen automatisch auf - kein manuelles delete nötig!
 }
 
@@ -52,8 +146,20 @@ MqttClient::~MqttClient()
 void MqttClient::connectToHost(const QString &host, quint16 port, const QString &clientId)
 {
     m_clientId = clientId;
+    m_publisherId = MessageEnvelope::publisherIdFor(clientId.toUtf8());
     qDebug() << "Verbinde mit" << host << ":" << port;
-    m_socket->connectToHost(host, port);
+
+    // Für Kernel-Zeitstempel müssen die Daten bis zum eigenen Lesen im Kernel bleiben
+    QIODevice::OpenMode mode = QIODevice::ReadWrite;
+    if (m_receiveTimestamps)
+        mode |= QIODevice::Unbuffered;
+
+    abortMultipathConnect();
+    if (m_multipath) {
+        connectMultipath(host, port, mode);
+        return;
+    }
+    m_socket->connectToHost(host, port, mode);
 }
 
 /**
@@ -101,7 +207,7 @@ QByteArray MqttClient::createConnectPacket(const QString &clientId)
 }
 
 /**
- * @brief Erstellt MQTT PUBLISH-Paket
+ * @brief Schreibt MQTT PUBLISH-Paket
  *
  * Struktur:
  * - Fixed Header: 0x30 | QoS | Retain
@@ -109,10 +215,52 @@ QByteArray MqttClient::createConnectPacket(const QString &clientId)
  * - Variable Header: Topic Name (+ Packet ID bei QoS>0)
  * - Payload: Nachrichteninhalt
  */
-QByteArray MqttClient::createPublishPacket(const QString &topic, const QByteArray &payload, quint8 qos, bool retain)
+bool MqttClient::appendPublishPacket(QByteArray &packet, const QString &topic, const QByteArray &payload, quint8 qos, bool retain)
 {
-    QByteArray packet;
+    const int packetStart = packet.size();
+
+    // Länge der Daten hinter dem Topic
+    QByteArray topicUtf8 = topic.toUtf8();
+    const bool envelope = hasEnvelope(topic);
+    const int envelopeSize = envelope ? MessageEnvelope::HeaderSize : 0;
+    const bool checksum = !m_checksumTopics.isEmpty() && m_checksumTopics.contains(topic);
+    const int trailerSize = checksum ? Crc32c::TrailerSize : 0;
+    const bool sealed = m_payloadCipher && !m_payloadCipher->isEmpty() && m_payloadCipher->hasKey(topic);
+    const int sealSize = sealed ? PayloadCipher::Overhead : 0;
+    const quint32 dataSize = envelopeSize + payload.length() + sealSize + trailerSize;
+
+    // Topic Name ist Beginn der authentifizierten Daten bei Verschlüsselung
+    const int topicStart = appendPublishHeader(packet, topicUtf8, dataSize, qos, retain);
+
+    const int dataStart = packet.size();
+
+    // Umschlag direkt vor die Payload setzen
+    if (envelope)
+        MessageEnvelope::appendHeader(packet, m_publisherId, m_publishSequence++, m_envelopeCodecId, m_publisherEpoch);
+
+    if (sealed) {
+        // Direkt aus der Payload in den Paketpuffer verschlüsseln
+        if (!m_payloadCipher->seal(topic, packet, topicStart, payload)) {
+            packet.resize(packetStart);
+            if (envelope)
+                m_publishSequence--;
+            return false;
+        }
+    } else {
+        packet.append(payload);
+    }
+
+    // Prüfsumme über Umschlag und Payload anhängen
+    if (checksum)
+        Crc32c::appendTrailer(packet, dataStart);
+    return true;
+}
 
+/**
+ * @brief Schreibt Fixed Header, Remaining Length und Topic Name
+ */
+int MqttClient::appendPublishHeader(QByteArray &packet, const QByteArray &topicUtf8, quint32 dataSize, quint8 qos, bool retain)
+{
     // Fixed Header: PUBLISH (0x30) + Flags
     quint8 fixedHeader = 0x30;  // PUBLISH
     if (retain) fixedHeader |= 0x01;  // Retain-Bit setzen
@@ -120,22 +268,15 @@ QByteArray MqttClient::createPublishPacket(const QString &topic, const QByteArra
 
     packet.append((char)fixedHeader);
 
-    // Variable Header: Topic Name
-    QByteArray variableHeader;
-    QByteArray topicUtf8 = topic.toUtf8();
-    variableHeader.append((char)(topicUtf8.length() >> 8));   // Länge High Byte
-    variableHeader.append((char)(topicUtf8.length() & 0xFF)); // Länge Low Byte
-    variableHeader.append(topicUtf8);                         // Topic-Daten
-
     // Remaining Length berechnen und kodieren
-    quint32 remainingLength = variableHeader.length() + payload.length();
-    encodeRemainingLength(packet, remainingLength);
-
-    // Zusammenfügen
-    packet.append(variableHeader);
-    packet.append(payload);
+    encodeRemainingLength(packet, 2 + topicUtf8.length() + dataSize);
 
-    return packet;
+    // Variable Header: Topic Name
+    const int topicStart = packet.size();
+    packet.append((char)(topicUtf8.length() >> 8));   // Länge High Byte
+    packet.append((char)(topicUtf8.length() & 0xFF)); // Länge Low Byte
+    packet.append(topicUtf8);                         // Topic-Daten
+    return topicStart;
 }
 
 /**
@@ -152,10 +293,11 @@ QByteArray MqttClient::createSubscribePacket(const QString &topic, quint8 qos)
     QByteArray packet;
     packet.append((char)0x82);  // SUBSCRIBE mit QoS 1 (erforderlich)
 
-    // Variable Header: Packet ID
+    // Variable Header: Packet ID (für die Zuordnung des SUBACK gemerkt)
     QByteArray variableHeader;
     variableHeader.append((char)(m_packetId >> 8));   // Packet ID High Byte
     variableHeader.append((char)(m_packetId & 0xFF)); // Packet ID Low Byte
+    m_pendingSubscribes.insert(m_packetId, topic);
     m_packetId++;  // Für nächstes Paket inkrementieren
 
     // Payload: Topic Filter + QoS
@@ -270,29 +412,30 @@ quint16 MqttClient::encodeRemainingLength(QByteArray &buffer, quint32 length)
  * Liest 1-4 Bytes und berechnet die tatsächliche Länge.
  * Offset wird automatisch erhöht.
  *
- * @return 0 bei Fehler oder dekodierte Länge
+ * Fehlende Bytes (Incomplete) und eine ungültige Kodierung mit
+ * gesetztem Continuation-Bit im vierten Byte (Malformed) werden
+ * unterschieden - nur im ersten Fall lohnt es sich, auf Daten zu warten.
  */
-quint32 MqttClient::decodeRemainingLength(const QByteArray &data, int &offset)
+MqttClient::LengthStatus MqttClient::decodeRemainingLength(const QByteArray &data, int &offset, quint32 &length)
 {
-    quint32 multiplier = 1;
     quint32 value = 0;
-    quint8 encodedByte;
 
-    do {
+    for (int i = 0; i < 4; ++i) {
         // Prüfen ob genug Daten vorhanden
         if (offset >= data.length())
-            return 0;
+            return LengthStatus::Incomplete;
 
-        encodedByte = data.at(offset++);
-        value += (encodedByte & 127) * multiplier;  // Untere 7 Bit extrahieren
-        multiplier *= 128;
+        const quint8 encodedByte = data.at(offset++);
+        value += (quint32)(encodedByte & 127) << (7 * i);  // Untere 7 Bit extrahieren
 
-        // Schutz gegen ungültige Kodierung (mehr als 4 Bytes)
-        if (multiplier > 128 * 128 * 128)
-            return 0;
-    } while ((encodedByte & 128) != 0);  // Solange Continuation-Bit gesetzt ist
+        if ((encodedByte & 128) == 0) {                    // Kein Continuation-Bit - fertig
+            length = value;
+            return LengthStatus::Complete;
+        }
+    }
 
-    return value;
+    // Schutz gegen ungültige Kodierung (mehr als 4 Bytes)
+    return LengthStatus::Malformed;
 }
 
 /**
@@ -309,19 +452,541 @@ void MqttClient::publish(const QString &topic, const QByteArray &message, quint8
         return;
     }
 
-    // PUBLISH-Paket erstellen und senden
-    QByteArray packet = createPublishPacket(topic, message, qos, retain);
-    qint64 written = m_socket->write(packet);
+    // Sammelfenster vom Regler (0 = sofort schreiben)
+    const qint64 now = (qint64)MessageEnvelope::monotonicNs();
+    int window = 0;
+    if (m_writeBatchingEnabled) {
+        m_writeBatcher.recordMessage(now);
+        window = m_writeBatcher.windowMs(now, m_socket->bytesToWrite() + pendingBytes());
+        if (window != m_lastBatchWindowMs) {
+            m_lastBatchWindowMs = window;
+            emit writeBatchWindowChanged(window);
+        }
+    }
+
+    if (window == 0 && pendingBytes() == 0 && bulkBudget() > 0) {
+        // PUBLISH-Paket im Puffer aus dem Sende-Pool erstellen und senden.
+        // write(const char*, qint64) kopiert in den Socket-Puffer, der
+        // Pool-Puffer ist danach sofort wieder frei.
+        BufferPool &pool = m_reactor->sendPool();
+        QByteArray packet = pool.acquire();
+        if (!appendPublishPacket(packet, topic, message, qos, retain)) {
+            pool.release(packet);
+            emit error("Nachricht für " + topic + " konnte nicht verschlüsselt werden");
+            return;
+        }
+        qint64 written = m_socket->write(packet.constData(), packet.size());
+        pool.release(packet);
+
+        if (written == -1) {
+            emit error("Fehler beim Senden!");
+            return;
+        }
 
-    if (written == -1) {
+        m_socket->flush();  // Sofort senden
+        m_writeBatcher.recordWrite(1);
+    } else {
+        // Im Sammelpuffer anhängen, geschrieben wird bei Fensterende oder voller Charge -
+        // bzw. sobald Sendepuffer und Steuer-Warteschlange es zulassen
+        if (!hasPendingCapacity(topic))
+            return;
+        if (!appendPublishPacket(m_pendingWrites, topic, message, qos, retain)) {
+            emit error("Nachricht für " + topic + " konnte nicht verschlüsselt werden");
+            return;
+        }
+        m_pendingMessages++;
+
+        if (window == 0 || pendingBytes() >= m_writeBatcher.config().maxBatchBytes) {
+            writePendingWrites();
+        } else if (m_flushTimer == 0) {
+            m_flushTimer = m_timerWheel->schedule(window, [this]() {
+                m_flushTimer = 0;
+                writePendingWrites();
+            });
+        }
+    }
+
+    qDebug() << "Nachricht publiziert - Topic:" << topic << "| Message:" << message;
+    emit published(topic);
+}
+
+/**
+ * @brief Publiziert eine Payload an mehrere Topics
+ *
+ * Gesammelte Einzelnachrichten werden vorher geschrieben, damit die
+ * Reihenfolge auf der Verbindung erhalten bleibt.
+ */
+bool MqttClient::publishMany(const QStringList &topics, const QByteArray &message, quint8 qos, bool retain)
+{
+    if (!m_connected) {
+        emit error("Nicht verbunden!");
+        return false;
+    }
+    if (topics.isEmpty())
+        return true;
+
+    writePendingWrites();
+    const bool direct = pendingBytes() == 0 && bulkBudget() > 0;
+    if (!direct && !hasPendingCapacity(topics.first()))
+        return false;
+
+    BufferPool &pool = m_reactor->sendPool();
+    QByteArray packets = pool.acquire();
+    QVector<int> headerEnds;
+    headerEnds.reserve(topics.size());
+
+    bool shared = true;
+    for (const QString &topic : topics) {
+        if (!canWritePreparedPacket(topic)) {
+            shared = false;
+            break;
+        }
+        appendPublishHeader(packets, topic.toUtf8(), message.size(), qos, retain);
+        headerEnds.append(packets.size());
+    }
+
+    bool ok;
+    if (shared && direct) {
+        ok = writeGathered(packets, headerEnds, message);
+    } else if (shared) {
+        // Sendepuffer belegt - Pakete zusammensetzen und hinter den zurückgehaltenen einreihen
+        int start = 0;
+        for (int end : headerEnds) {
+            m_pendingWrites.append(packets.constData() + start, end - start);
+            m_pendingWrites.append(message);
+            start = end;
+        }
+        m_pendingMessages += topics.size();
+        writePendingWrites();
+        ok = true;
+    } else {
+        // Payload wird pro Topic verändert - vollständige Pakete in einem Puffer
+        packets.resize(0);
+        for (const QString &topic : topics) {
+            if (!appendPublishPacket(packets, topic, message, qos, retain)) {
+                pool.release(packets);
+                emit error("Nachricht für " + topic + " konnte nicht verschlüsselt werden");
+                return false;
+            }
+        }
+        if (direct) {
+            ok = m_socket->write(packets.constData(), packets.size()) == packets.size();
+            if (ok)
+                m_socket->flush();
+            else
+                emit error("Fehler beim Senden!");
+        } else {
+            m_pendingWrites.append(packets);
+            m_pendingMessages += topics.size();
+            writePendingWrites();
+            ok = true;
+        }
+    }
+    pool.release(packets);
+
+    if (!ok)
+        return false;
+
+    if (direct)
+        m_writeBatcher.recordWrite(topics.size());
+    qDebug() << "Nachricht publiziert an" << topics.size() << "Topics | Message:" << message;
+    for (const QString &topic : topics)
+        emit published(topic);
+    return true;
+}
+
+/**
+ * @brief Scatter-Gather-Schreiben von Headern mit gemeinsamer Payload
+ *
+ * Direkt auf den Socket darf nur geschrieben werden, solange QTcpSocket
+ * nichts mehr zu senden hat - sonst würden Daten überholt. In diesem Fall
+ * (und außerhalb von Linux) werden die Pakete zusammengesetzt und in einem
+ * Schreibvorgang an den Socket übergeben.
+ */
+bool MqttClient::writeGathered(const QByteArray &headers, const QVector<int> &headerEnds, const QByteArray &payload)
+{
+    int next = 0;
+#ifdef Q_OS_LINUX
+    const int fd = (int)m_socket->socketDescriptor();
+    if (fd != -1 && m_socket->bytesToWrite() == 0) {
+        std::vector<iovec> iov;
+        iov.reserve(headerEnds.size() * 2);
+        int start = 0;
+        for (int end : headerEnds) {
+            iov.push_back(iovec{const_cast<char*>(headers.constData()) + start, (size_t)(end - start)});
+            if (!payload.isEmpty())
+                iov.push_back(iovec{const_cast<char*>(payload.constData()), (size_t)payload.size()});
+            start = end;
+        }
+
+        size_t index = 0;
+        while (index < iov.size()) {
+            const int count = (int)qMin<size_t>(iov.size() - index, IOV_MAX);
+            const ssize_t written = ::writev(fd, &iov[index], count);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                emit error("Fehler beim Senden: " + QString::fromLocal8Bit(strerror(errno)));
+                return false;
+            }
+
+            // Vollständig gesendete Abschnitte überspringen, angefangenen kürzen
+            size_t remaining = (size_t)written;
+            while (remaining > 0 && remaining >= iov[index].iov_len)
+                remaining -= iov[index++].iov_len;
+            if (remaining > 0) {
+                iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + remaining;
+                iov[index].iov_len -= remaining;
+            }
+        }
+
+        if (index == iov.size())
+            return true;
+
+        // Kernel-Puffer voll - Rest über QTcpSocket, sobald der Socket schreibbar ist
+        for (; index < iov.size(); ++index) {
+            if (m_socket->write(static_cast<const char*>(iov[index].iov_base), (qint64)iov[index].iov_len) == -1) {
+                emit error("Fehler beim Senden!");
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
+    QByteArray packets;
+    packets.reserve(headers.size() + headerEnds.size() * payload.size());
+    for (int end : headerEnds) {
+        packets.append(headers.constData() + next, end - next);
+        packets.append(payload);
+        next = end;
+    }
+    if (m_socket->write(packets) != packets.size()) {
         emit error("Fehler beim Senden!");
+        return false;
+    }
+    m_socket->flush();
+    return true;
+}
+
+/**
+ * @brief Schreibt Sammelpuffer und Steuer-Warteschlange vollständig
+ *
+ * Wartende Steuerpakete gehen voran, danach alle zurückgehaltenen
+ * Massendaten in einem Schreibvorgang. Der Puffer behält seine
+ * Kapazität für die nächste Charge.
+ */
+void MqttClient::flushPendingWrites()
+{
+    m_timerWheel->cancel(m_flushTimer);
+    m_flushTimer = 0;
+    m_timerWheel->cancel(m_controlTimer);
+    m_controlTimer = 0;
+
+    // Abgelaufene Steuerpakete nicht mehr senden, sondern wie in drainControlQueue() verwerfen
+    std::vector<ControlQueue::Operation> expired = m_controlQueue.takeExpired((qint64)MessageEnvelope::monotonicNs());
+    std::vector<ControlQueue::WrittenCallback> writtenCallbacks;
+
+    while (m_connected && !m_controlQueue.isEmpty()) {
+        ControlQueue::Operation operation = m_controlQueue.pop();
+        if (m_socket->write(operation.packet) == -1) {
+            expired.push_back(std::move(operation));
+            break;
+        }
+        if (operation.written)
+            writtenCallbacks.push_back(std::move(operation.written));
+    }
+
+    if (pendingBytes() > 0) {
+        const qint64 written = m_socket->write(m_pendingWrites.constData() + m_pendingOffset, pendingBytes());
+        if (m_pendingMessages > 0)
+            m_writeBatcher.recordWrite(m_pendingMessages);
+        m_pendingWrites.resize(0);
+        m_pendingOffset = 0;
+        m_pendingMessages = 0;
+
+        if (written == -1)
+            emit error("Fehler beim Senden!");
+    }
+    m_socket->flush();
+
+    // Callbacks zuletzt - sie dürfen neue Steuernachrichten einstellen
+    for (ControlQueue::WrittenCallback &callback : writtenCallbacks)
+        callback();
+    m_controlExpired += expired.size();
+    for (ControlQueue::Operation &operation : expired) {
+        if (operation.expired)
+            operation.expired();
+    }
+}
+
+/**
+ * @brief Platz für Massendaten im Sendepuffer des Sockets
+ *
+ * Massendaten füllen den Puffer nur bis setControlBacklogLimit(), damit
+ * ein Steuerpaket nie hinter mehr als diesem Rückstau wartet. Solange
+ * Steuerpakete warten, ist kein Platz. Ohne Limit wird nichts zurückgehalten.
+ */
+qint64 MqttClient::bulkBudget() const
+{
+    if (m_controlBacklogLimit <= 0)
+        return std::numeric_limits<qint64>::max();
+    if (!m_controlQueue.isEmpty())
+        return 0;
+    return m_controlBacklogLimit - m_socket->bytesToWrite();
+}
+
+/**
+ * @brief Prüft, ob der Sammelpuffer noch Pakete aufnehmen darf
+ *
+ * Ist der Socket dauerhaft überlastet, wächst der Puffer sonst ohne
+ * Grenze. Ab setPendingWriteLimit() wird die Nachricht verworfen.
+ */
+bool MqttClient::hasPendingCapacity(const QString &topic)
+{
+    if (m_pendingWriteLimit <= 0 || pendingBytes() < m_pendingWriteLimit)
+        return true;
+
+    m_droppedWrites++;
+    emit error("Sendepuffer voll - Nachricht für " + topic + " verworfen");
+    return false;
+}
+
+/**
+ * @brief Schreibt zurückgehaltene Pakete, soweit bulkBudget() es zulässt
+ *
+ * Es werden nur ganze Pakete übergeben (höchstens eines über das Budget
+ * hinaus), damit Steuerpakete danach an einer Paketgrenze einsetzen.
+ * Der Rest folgt mit bytesWritten().
+ */
+void MqttClient::writePendingWrites()
+{
+    m_timerWheel->cancel(m_flushTimer);
+    m_flushTimer = 0;
+
+    if (pendingBytes() == 0)
         return;
+
+    if (m_pendingMessages > 0) {
+        m_writeBatcher.recordWrite(m_pendingMessages);
+        m_pendingMessages = 0;
+    }
+
+    qint64 budget = bulkBudget();
+    while (budget > 0 && pendingBytes() > 0) {
+        int end = m_pendingOffset;
+        while (end < m_pendingWrites.size() && end - m_pendingOffset < budget) {
+            int offset = end + 1;
+            quint32 remainingLength = 0;
+            decodeRemainingLength(m_pendingWrites, offset, remainingLength);  // Eigene Pakete, immer vollständig
+            end = offset + (int)remainingLength;
+        }
+        end = qMin(end, m_pendingWrites.size());
+
+        const qint64 size = end - m_pendingOffset;
+        if (m_socket->write(m_pendingWrites.constData() + m_pendingOffset, size) != size) {
+            emit error("Fehler beim Senden!");
+            break;
+        }
+        m_pendingOffset = end;
+        m_socket->flush();
+        budget = bulkBudget();
     }
 
-    m_socket->flush();  // Sofort senden
+    if (pendingBytes() == 0) {
+        m_pendingWrites.resize(0);
+        m_pendingOffset = 0;
+    } else if (m_pendingOffset > m_pendingWrites.size() / 2) {
+        // Geschriebenen Anfang abschneiden, sonst wächst der Puffer bei anhaltendem Rückstau
+        m_pendingWrites.remove(0, m_pendingOffset);
+        m_pendingOffset = 0;
+    }
+}
 
-    qDebug() << "Nachricht publiziert - Topic:" << topic << "| Message:" << message;
-    emit published(topic);
+/**
+ * @brief Schreibt ein Paket unter Erhalt der Reihenfolge
+ *
+ * Sind noch Massendaten zurückgehalten, wird das Paket dahinter
+ * eingereiht, sonst direkt geschrieben.
+ */
+bool MqttClient::writeOrdered(const char *packet, int size)
+{
+    writePendingWrites();
+    if (pendingBytes() > 0) {
+        m_pendingWrites.append(packet, size);
+        return true;
+    }
+
+    if (m_socket->write(packet, size) != size)
+        return false;
+    m_socket->flush();
+    return true;
+}
+
+bool MqttClient::canWritePreparedPacket(const QString &topic) const
+{
+    return !hasEnvelope(topic)
+        && !m_checksumTopics.contains(topic)
+        && !(m_payloadCipher && m_payloadCipher->hasKey(topic));
+}
+
+/**
+ * @brief Schreibt ein fertiges Paket ohne Kodierung
+ *
+ * Für latenzkritische Befehle: keine Pufferverwaltung, kein Sammelfenster.
+ */
+bool MqttClient::writePreparedPacket(const char *packet, int size)
+{
+    if (!m_connected)
+        return false;
+
+    if (!writeOrdered(packet, size)) {
+        emit error("Fehler beim Senden!");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Publiziert mit Frist über die Steuer-Warteschlange
+ *
+ * Das Paket wird sofort kodiert (Umschlag, Prüfsumme, Verschlüsselung),
+ * damit es später unverändert geschrieben werden kann.
+ */
+bool MqttClient::publishBefore(const QString &topic, const QByteArray &message, qint64 deadlineNs,
+                               ControlQueue::ExpiredCallback expired, quint8 qos)
+{
+    if (!m_connected) {
+        emit error("Nicht verbunden!");
+        return false;
+    }
+
+    QByteArray packet;
+    if (!appendPublishPacket(packet, topic, message, qos, false)) {
+        emit error("Nachricht für " + topic + " konnte nicht verschlüsselt werden");
+        return false;
+    }
+
+    // published() erst, wenn das Paket tatsächlich geschrieben ist - es kann noch verfallen
+    return submitControl(packet, deadlineNs, std::move(expired), [this, topic]() { emit published(topic); });
+}
+
+bool MqttClient::writePreparedPacketBefore(const char *packet, int size, qint64 deadlineNs,
+                                           ControlQueue::ExpiredCallback expired)
+{
+    if (!m_connected)
+        return false;
+    return submitControl(QByteArray(packet, size), deadlineNs, std::move(expired));
+}
+
+bool MqttClient::submitControl(const QByteArray &packet, qint64 deadlineNs, ControlQueue::ExpiredCallback expired,
+                               ControlQueue::WrittenCallback written)
+{
+    if (deadlineNs <= (qint64)MessageEnvelope::monotonicNs()) {
+        m_controlExpired++;
+        qDebug() << "Steuernachricht mit abgelaufener Frist nicht gesendet";
+        return false;
+    }
+
+    m_controlQueue.push(deadlineNs, packet, std::move(expired), std::move(written));
+    drainControlQueue();
+    return true;
+}
+
+/**
+ * @brief Arbeitet die Steuer-Warteschlange ab
+ *
+ * Nach jedem Paket wird geflusht, damit bytesToWrite() nur den Teil
+ * enthält, den der Kernel noch nicht angenommen hat.
+ */
+void MqttClient::drainControlQueue()
+{
+    m_timerWheel->cancel(m_controlTimer);
+    m_controlTimer = 0;
+    if (m_controlQueue.isEmpty())
+        return;
+
+    const qint64 now = (qint64)MessageEnvelope::monotonicNs();
+    std::vector<ControlQueue::Operation> expired = m_controlQueue.takeExpired(now);
+    std::vector<ControlQueue::WrittenCallback> written;
+
+    while (m_connected && !m_controlQueue.isEmpty()
+           && (m_controlBacklogLimit <= 0 || m_socket->bytesToWrite() < m_controlBacklogLimit)) {
+        ControlQueue::Operation operation = m_controlQueue.pop();
+        if (m_socket->write(operation.packet) == -1) {
+            emit error("Fehler beim Senden!");
+            expired.push_back(std::move(operation));
+            break;
+        }
+        m_socket->flush();
+        if (operation.written)
+            written.push_back(std::move(operation.written));
+    }
+
+    if (!m_controlQueue.isEmpty()) {
+        const qint64 delayNs = m_controlQueue.nextDeadlineNs() - now;
+        const int delayMs = qMax(1, (int)((delayNs + 999999) / 1000000));
+        m_controlTimer = m_timerWheel->schedule(delayMs, [this]() {
+            m_controlTimer = 0;
+            drainControlQueue();
+        });
+    }
+
+    // Warteschlange leer - zurückgehaltene Massendaten dürfen wieder nachrücken
+    if (m_controlQueue.isEmpty() && pendingBytes() > 0 && m_flushTimer == 0)
+        writePendingWrites();
+
+    // Callbacks zuletzt - sie dürfen neue Steuernachrichten einstellen
+    for (ControlQueue::WrittenCallback &callback : written)
+        callback();
+    m_controlExpired += expired.size();
+    for (ControlQueue::Operation &operation : expired) {
+        if (operation.expired)
+            operation.expired();
+    }
+}
+
+void MqttClient::failControlQueue()
+{
+    m_timerWheel->cancel(m_controlTimer);
+    m_controlTimer = 0;
+
+    std::vector<ControlQueue::Operation> dropped = m_controlQueue.takeAll();
+    m_controlExpired += dropped.size();
+    for (ControlQueue::Operation &operation : dropped) {
+        if (operation.expired)
+            operation.expired();
+    }
+}
+
+void MqttClient::onBytesWritten(qint64 bytes)
+{
+    Q_UNUSED(bytes)
+    if (!m_controlQueue.isEmpty())
+        drainControlQueue();
+    else if (pendingBytes() > 0 && m_flushTimer == 0)
+        writePendingWrites();
+}
+
+void MqttClient::setWriteBatchingEnabled(bool enabled)
+{
+    m_writeBatchingEnabled = enabled;
+    if (!enabled)
+        writePendingWrites();
+}
+
+/**
+ * @brief Verwirft gesammelte Pakete nach Verbindungsverlust
+ */
+void MqttClient::discardPendingWrites()
+{
+    m_timerWheel->cancel(m_flushTimer);
+    m_flushTimer = 0;
+    m_pendingWrites.resize(0);
+    m_pendingOffset = 0;
+    m_pendingMessages = 0;
 }
 
 /**
@@ -340,8 +1005,8 @@ void MqttClient::subscribe(const QString &topic, quint8 qos)
 
     // SUBSCRIBE-Paket erstellen und senden
     QByteArray packet = createSubscribePacket(topic, qos);
-    m_socket->write(packet);
-    m_socket->flush();
+    writeOrdered(packet.constData(), packet.size());  // Reihenfolge zu gesammelten PUBLISH-Paketen erhalten
+    m_subscriptions[topic] = qos;
 
     qDebug() << "Subscribe gesendet - Topic:" << topic << "(ohne Handler)";
     emit subscribed(topic);
@@ -361,19 +1026,56 @@ void MqttClient::subscribe(const QString &topic, TopicHandler handler, quint8 qo
         return;
     }
 
-    // Handler registrieren
+    // Handler registrieren - Messwerte und Isolation galten dem vorigen Handler
     m_topicHandlers[topic] = handler;
+    m_handlerTimings.remove(topic);
+    m_isolatableHandlers.remove(topic);
     qDebug() << "Handler registriert für Topic:" << topic;
 
     // SUBSCRIBE-Paket erstellen und senden
     QByteArray packet = createSubscribePacket(topic, qos);
-    m_socket->write(packet);
-    m_socket->flush();
+    writeOrdered(packet.constData(), packet.size());  // Reihenfolge zu gesammelten PUBLISH-Paketen erhalten
+    m_subscriptions[topic] = qos;
 
     qDebug() << "Subscribe gesendet - Topic:" << topic << "(mit Handler)";
     emit subscribed(topic);
 }
 
+/**
+ * @brief Abonniert ein Topic mit Handler und Inhaltsfilter
+ *
+ * Der Filter wird vor dem SUBSCRIBE gesetzt, damit schon die erste
+ * Nachricht (z.B. retained) gefiltert wird.
+ */
+void MqttClient::subscribe(const QString &topic, TopicHandler handler, const PayloadFilter &filter, quint8 qos)
+{
+    if (!m_connected) {
+        emit error("Nicht verbunden!");
+        return;
+    }
+
+    setPayloadFilter(topic, filter);
+    subscribe(topic, handler, qos);
+}
+
+/**
+ * @brief Abonniert ein Topic mit Handler und Ausführungsort
+ *
+ * Die Freigabe für den Isolations-Worker gilt nur für diesen Handler;
+ * ein erneutes subscribe(), registerHandler() und unsubscribe() setzen sie zurück.
+ */
+void MqttClient::subscribe(const QString &topic, TopicHandler handler, HandlerThreading threading, quint8 qos)
+{
+    if (!m_connected) {
+        emit error("Nicht verbunden!");
+        return;
+    }
+
+    subscribe(topic, handler, qos);
+    if (threading == HandlerThreading::Isolatable)
+        m_isolatableHandlers.insert(topic);
+}
+
 /**
  * @brief Meldet ein Topic ab
  *
@@ -392,11 +1094,14 @@ void MqttClient::unsubscribe(const QString &topic)
         m_topicHandlers.remove(topic);
         qDebug() << "Handler entfernt für Topic:" << topic;
     }
+    m_payloadFilters.remove(topic);
+    m_handlerTimings.remove(topic);
+    m_isolatableHandlers.remove(topic);
+    m_subscriptions.remove(topic);
 
     // UNSUBSCRIBE-Paket erstellen und senden
     QByteArray packet = createUnsubscribePacket(topic);
-    m_socket->write(packet);
-    m_socket->flush();
+    writeOrdered(packet.constData(), packet.size());
 
     qDebug() << "Unsubscribe gesendet - Topic:" << topic;
     emit unsubscribed(topic);
@@ -410,6 +1115,8 @@ void MqttClient::unsubscribe(const QString &topic)
 void MqttClient::registerHandler(const QString &topic, TopicHandler handler)
 {
     m_topicHandlers[topic] = handler;
+    m_handlerTimings.remove(topic);
+    m_isolatableHandlers.remove(topic);  // Neuer Handler läuft wieder im eigenen Thread
     qDebug() << "Handler nachträglich registriert für Topic:" << topic;
 }
 
@@ -422,6 +1129,8 @@ void MqttClient::unregisterHandler(const QString &topic)
 {
     if (m_topicHandlers.contains(topic)) {
         m_topicHandlers.remove(topic);
+        m_handlerTimings.remove(topic);
+        m_isolatableHandlers.remove(topic);
         qDebug() << "Handler entfernt für Topic:" << topic;
     } else {
         qDebug() << "Kein Handler vorhanden für Topic:" << topic;
@@ -436,6 +1145,110 @@ bool MqttClient::hasHandler(const QString &topic) const
     return m_topicHandlers.contains(topic);
 }
 
+/**
+ * @brief Aktiviert oder deaktiviert den Nachrichten-Umschlag
+ *
+ * Die Sequenznummer läuft über Aktivierungen hinweg weiter, damit
+ * Empfänger keinen Neustart des Publishers erkennen.
+ */
+void MqttClient::setEnvelopeEnabled(bool enabled, quint8 codecId)
+{
+    m_envelopeEnabled = enabled;
+    m_envelopeCodecId = codecId;
+    qDebug() << "Nachrichten-Umschlag" << (enabled ? "aktiviert" : "deaktiviert");
+}
+
+void MqttClient::setTopicEnvelope(const QString &topic, bool enabled)
+{
+    if (enabled)
+        m_envelopeTopics.insert(topic);
+    else
+        m_envelopeTopics.remove(topic);
+    qDebug() << "Nachrichten-Umschlag für" << topic << (enabled ? "aktiviert" : "deaktiviert");
+}
+
+/**
+ * @brief Aktiviert oder deaktiviert die Prüfsumme für ein Topic
+ *
+ * Gilt für beide Richtungen, Sender und Empfänger müssen übereinstimmen.
+ */
+void MqttClient::setPayloadChecksum(const QString &topic, bool enabled)
+{
+    if (enabled)
+        m_checksumTopics.insert(topic);
+    else
+        m_checksumTopics.remove(topic);
+    qDebug() << "CRC32C-Prüfsumme für" << topic << (enabled ? "aktiviert" : "deaktiviert")
+             << "(" << Crc32c::implementation() << ")";
+}
+
+bool MqttClient::hasPayloadChecksum(const QString &topic) const
+{
+    return m_checksumTopics.contains(topic);
+}
+
+void MqttClient::setPayloadCipher(std::shared_ptr<PayloadCipher> cipher)
+{
+    m_payloadCipher = std::move(cipher);
+}
+
+void MqttClient::setSequenceTracker(std::shared_ptr<SequenceTracker> tracker)
+{
+    if (tracker)
+        m_sequenceTracker = std::move(tracker);
+}
+
+/**
+ * @brief Setzt das Zeitbudget für Topic-Handler
+ *
+ * Das Budget wird einmalig in Zählerschritte umgerechnet, im
+ * Nachrichtenpfad wird nur noch verglichen.
+ */
+void MqttClient::setHandlerBudget(qint64 budgetUs, int strikes)
+{
+    m_handlerBudgetTicks = budgetUs > 0 ? qMax<quint64>(1, CycleCounter::fromNs(budgetUs * 1000)) : 0;
+    m_handlerStrikes = qMax(1, strikes);
+    qDebug() << "Handler-Budget:" << budgetUs << "us," << m_handlerStrikes << "Überschreitungen bis zur Isolation"
+             << "(" << CycleCounter::source() << ")";
+}
+
+void MqttClient::setIsolationWorker(int capacity, HandlerWorker::OverflowPolicy policy, const ThreadTuning::Placement &placement)
+{
+    m_isolationCapacity = capacity;
+    m_isolationPolicy = policy;
+    m_isolationPlacement = placement;
+}
+
+MqttClient::HandlerStats MqttClient::handlerStats(const QString &topic) const
+{
+    HandlerStats stats;
+    auto it = m_handlerTimings.constFind(topic);
+    if (it == m_handlerTimings.constEnd())
+        return stats;
+
+    stats.calls = it->calls;
+    stats.overruns = it->overruns;
+    stats.maxNs = CycleCounter::toNs(it->maxTicks);
+    stats.isolated = it->isolated;
+    if (it->measured > 0)
+        stats.averageNs = CycleCounter::toNs(it->totalTicks / it->measured);
+    return stats;
+}
+
+bool MqttClient::isHandlerIsolated(const QString &topic) const
+{
+    auto it = m_handlerTimings.constFind(topic);
+    return it != m_handlerTimings.constEnd() && it->isolated;
+}
+
+void MqttClient::setPayloadFilter(const QString &topic, const PayloadFilter &filter)
+{
+    if (filter.isEmpty())
+        m_payloadFilters.remove(topic);
+    else
+        m_payloadFilters.insert(topic, filter);
+}
+
 /**
  * @brief Trennt die Verbindung zum Broker sauber
  *
@@ -445,15 +1258,19 @@ bool MqttClient::hasHandler(const QString &topic) const
 void MqttClient::disconnect()
 {
     // Keep-Alive Timer stoppen
-    m_keepAliveTimer->stop();
+    stopKeepAlive();
 
     // Alle Handler löschen
     m_topicHandlers.clear();
+    m_isolatableHandlers.clear();
     qDebug() << "Alle Handler gelöscht";
 
+    abortMultipathConnect();
+
     // Nur trennen wenn Socket verbunden ist
     if (m_socket->state() == QAbstractSocket::ConnectedState) {
         // DISCONNECT-Paket senden
+        flushPendingWrites();  // Gesammelte Pakete vor DISCONNECT senden
         QByteArray packet = createDisconnectPacket();
         m_socket->write(packet);
         m_socket->flush();
@@ -466,22 +1283,34 @@ void MqttClient::disconnect()
         if (m_socket->state() != QAbstractSocket::UnconnectedState) {
             m_socket->waitForDisconnected(1000);
         }
+    } else if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        // Laufenden Verbindungsaufbau abbrechen
+        m_socket->abort();
     }
 }
 
 /**
  * @brief Verarbeitet empfangene PUBLISH-Nachricht
  *
- * Prüft ob ein Handler registriert ist und ruft diesen auf,
- * andernfalls wird das messageReceived Signal ausgelöst.
+ * Trägt die Nachricht in den Last-Value-Cache ein, prüft ob ein Handler
+ * registriert ist und ruft diesen auf, andernfalls wird das
+ * messageReceived Signal ausgelöst.
  */
 void MqttClient::handlePublishMessage(const QString &topic, const QByteArray &message)
 {
+    // Entschlüsselte Payloads nur im Speicher halten, nie im Snapshot
+    if (m_lastValueCache)
+        m_lastValueCache->record(topic, message, !(m_payloadCipher && m_payloadCipher->hasKey(topic)));
+
     // Prüfen ob ein Handler für dieses Topic registriert ist
-    if (m_topicHandlers.contains(topic)) {
+    auto handler = m_topicHandlers.constFind(topic);
+    if (handler != m_topicHandlers.constEnd()) {
         qDebug() << "Handler aufgerufen für Topic:" << topic;
         // Handler aufrufen
-        m_topicHandlers[topic](message);
+        if (m_handlerBudgetTicks == 0)
+            handler.value()(message);
+        else
+            dispatchMeasured(topic, handler.value(), message);
     } else {
         // Kein Handler -> Signal aussenden
         qDebug() << "Kein Handler - Signal ausgelöst für Topic:" << topic;
@@ -489,6 +1318,66 @@ void MqttClient::handlePublishMessage(const QString &topic, const QByteArray &me
     }
 }
 
+/**
+ * @brief Handler-Aufruf mit Laufzeitmessung
+ *
+ * Isolierte Handler werden nur an den Worker übergeben. Sonst wird der
+ * Aufruf mit dem Zykluszähler gemessen; der Eintrag wird danach neu
+ * gesucht, da der Handler Abonnements geändert haben kann. Verschoben
+ * werden nur freigegebene Handler, alle anderen erzeugen eine Warnung.
+ */
+void MqttClient::dispatchMeasured(const QString &topic, const TopicHandler &handler, const QByteArray &message)
+{
+    if (m_isolationWorker) {
+        auto it = m_handlerTimings.find(topic);
+        if (it != m_handlerTimings.end() && it->isolated) {
+            it->calls++;
+            m_isolationWorker->post(handler, message);
+            return;
+        }
+    }
+
+    const quint64 start = CycleCounter::now();
+    handler(message);
+    const quint64 ticks = CycleCounter::now() - start;
+
+    HandlerTiming &timing = m_handlerTimings[topic];
+    timing.calls++;
+    timing.measured++;
+    timing.totalTicks += ticks;
+    timing.maxTicks = qMax(timing.maxTicks, ticks);
+    if (ticks <= m_handlerBudgetTicks || timing.isolated)
+        return;
+
+    ++timing.overruns;
+    if (!m_isolatableHandlers.contains(topic)) {
+        if (timing.overruns == (quint64)m_handlerStrikes)
+            qDebug() << "Handler überschreitet wiederholt das Budget, bleibt aber im Client-Thread - Topic:" << topic
+                     << "| Laufzeit:" << CycleCounter::toNs(ticks) / 1000 << "us";
+        return;
+    }
+    if (timing.overruns >= (quint64)m_handlerStrikes)
+        isolateHandler(topic, ticks);
+}
+
+void MqttClient::isolateHandler(const QString &topic, quint64 ticks)
+{
+    if (!m_topicHandlers.contains(topic))
+        return;  // Handler hat sich selbst abgemeldet
+
+    if (!m_isolationWorker) {
+        m_isolationWorker = std::make_unique<HandlerWorker>(m_isolationCapacity, m_isolationPolicy, m_isolationPlacement);
+        m_isolationWorker->setObjectName("mqtt-isolation");
+        m_isolationWorker->start();
+    }
+
+    m_handlerTimings[topic].isolated = true;
+    const qint64 durationNs = CycleCounter::toNs(ticks);
+    qDebug() << "Handler zu langsam, in Isolations-Worker verschoben - Topic:" << topic
+             << "| Laufzeit:" << durationNs / 1000 << "us";
+    emit handlerIsolated(topic, durationNs);
+}
+
 /**
  * @brief Slot: TCP-Verbindung wurde hergestellt
  *
@@ -499,6 +1388,10 @@ void MqttClient::onConnected()
 {
     qDebug() << "TCP Verbindung hergestellt, sende CONNECT Paket...";
 
+    if (m_receiveTimestamps)
+        enableReceiveTimestamps();
+    applySocketTuning();
+
     // MQTT CONNECT-Paket erstellen und senden
     QByteArray connectPacket = createConnectPacket(m_clientId);
     m_socket->write(connectPacket);
@@ -514,10 +1407,17 @@ void MqttClient::onConnected()
 void MqttClient::onDisconnected()
 {
     m_connected = false;
-    m_keepAliveTimer->stop();
+    m_pingPending = false;
+    stopKeepAlive();
+    discardPendingWrites();
+    failControlQueue();
+    m_timerWheel->cancel(m_bufferTimer);
+    m_bufferTimer = 0;
+    m_pendingSubscribes.clear();
 
     // Alle Handler löschen
     m_topicHandlers.clear();
+    m_isolatableHandlers.clear();
     qDebug() << "Verbindung getrennt - Alle Handler gelöscht";
 
     emit disconnected();
@@ -533,33 +1433,122 @@ void MqttClient::onDisconnected()
  * - UNSUBACK (0xB0): Unsubscription-Bestätigung
  * - PINGRESP (0xD0): Keep-Alive Antwort
  *
- * Puffert unvollständige Pakete in m_buffer.
+ * Gelesen wird in einen Puffer aus dem Empfangs-Pool des Reactors.
+ * Nur ein unvollständiges Paket am Ende wird in m_buffer aufbewahrt,
+ * im Normalfall hält der Client damit keinen eigenen Empfangspuffer.
+ *
+ * Startet ein Handler eine verschachtelte Event-Loop, werden neue Daten
+ * erst nach dem laufenden Durchlauf gelesen, damit die Reihenfolge erhalten bleibt.
+ *
+ * Mit Kernel-Zeitstempeln wird vor jedem Lesen der Zeitstempel der ältesten
+ * Daten im Socket ermittelt. Ein Paket, das im Rest vom letzten Durchlauf
+ * beginnt, behält den Zeitstempel dieses Durchlaufs.
  */
 void MqttClient::onReadyRead()
 {
-    // Neue Daten zum Puffer hinzufügen
-    m_buffer.append(m_socket->readAll());
+    if (m_reading)
+        return;
+    m_reading = true;
+
+    BufferPool &pool = m_reactor->receivePool();
+    QByteArray buffer = pool.acquire();
+
+    // Ungepuffert meldet erst read() das Verbindungsende, daher mindestens einmal lesen
+    bool readOnce = m_receiveTimestamps;
+
+    while (m_socket->bytesAvailable() > 0 || readOnce) {
+        readOnce = false;
+
+        // Rest vom letzten Durchlauf voranstellen, dann direkt vom Socket lesen
+        buffer.resize(0);
+        buffer.append(m_buffer);
+        m_buffer.clear();
+
+        const int start = buffer.size();
+        m_chunkStart = start;
+        if (m_receiveTimestamps) {
+            m_chunkTimestampNs = peekReceiveTimestamp();
+            m_chunkReadNs = realtimeNs();
+        }
+
+        const qint64 available = qMax<qint64>(1, m_socket->bytesAvailable());
+        buffer.resize(start + (int)available);
+        const qint64 got = m_socket->read(buffer.data() + start, available);
+        buffer.resize(start + (int)qMax<qint64>(0, got));
+
+        const int consumed = processPackets(buffer);
+        if (consumed < 0) {
+            // Protokollfehler - der Datenstrom ist nicht mehr auszuwerten
+            pool.release(buffer);
+            m_buffer.clear();
+            m_reading = false;
+            qDebug() << "Ungültige Remaining Length empfangen - Verbindung wird abgebrochen";
+            emit error("Protokollfehler: ungültige Paketlänge vom Broker");
+            m_socket->abort();
+            return;
+        }
+
+        // Unvollständiges Paket aufbewahren (eigene Kopie, der Pool-Puffer wird wiederverwendet)
+        if (consumed < buffer.size()) {
+            m_buffer = QByteArray(buffer.constData() + consumed, buffer.size() - consumed);
+            if (consumed >= start) {
+                m_residualTimestampNs = m_chunkTimestampNs;
+                m_residualReadNs = m_chunkReadNs;
+            }
+        }
+
+        if (got <= 0)
+            break;
+    }
+
+    pool.release(buffer);
+    m_reading = false;
+}
+
+/**
+ * @brief Verarbeitet alle vollständigen Pakete eines Empfangspuffers
+ * @return Anzahl verarbeiteter Bytes oder -1 bei einem Protokollfehler
+ *
+ * Die Paketdaten werden nicht kopiert, sondern als Sicht auf den Puffer
+ * ausgewertet. Nur Topic und Payload einer PUBLISH-Nachricht werden
+ * für die Handler kopiert.
+ */
+int MqttClient::processPackets(const QByteArray &buffer)
+{
+    int consumed = 0;
 
     // Alle vollständigen Pakete verarbeiten
-    while (!m_buffer.isEmpty()) {
+    while (consumed < buffer.length()) {
         // Mindestens 2 Bytes nötig (Fixed Header + Remaining Length)
-        if (m_buffer.length() < 2)
-            return;
+        if (buffer.length() - consumed < 2)
+            break;
 
         // Fixed Header parsen
-        quint8 packetType = m_buffer.at(0);
-        int offset = 1;
+        quint8 packetType = buffer.at(consumed);
+        int offset = consumed + 1;
 
         // Remaining Length dekodieren
-        quint32 remainingLength = decodeRemainingLength(m_buffer, offset);
+        quint32 remainingLength = 0;
+        const LengthStatus status = decodeRemainingLength(buffer, offset, remainingLength);
+        if (status == LengthStatus::Incomplete)
+            break;  // Längenfeld selbst noch unvollständig
+        if (status == LengthStatus::Malformed)
+            return -1;  // Ohne gültige Länge gibt es keine Paketgrenze mehr
 
         // Prüfen ob vollständiges Paket vorhanden
-        if (m_buffer.length() < offset + remainingLength)
-            return;  // Warten auf mehr Daten
+        if ((quint32)(buffer.length() - offset) < remainingLength)
+            break;  // Warten auf mehr Daten
+
+        // Zeitstempel des Lesevorgangs, in dem das Paket begonnen hat
+        if (m_receiveTimestamps) {
+            const bool residual = consumed < m_chunkStart;
+            m_receiveTimestampNs = residual ? m_residualTimestampNs : m_chunkTimestampNs;
+            m_dispatchTimestampNs = residual ? m_residualReadNs : m_chunkReadNs;
+        }
 
-        // Paket-Daten extrahieren
-        QByteArray packetData = m_buffer.mid(offset, remainingLength);
-        m_buffer.remove(0, offset + remainingLength);  // Verarbeitete Daten entfernen
+        // Sicht auf die Paket-Daten (ohne Kopie)
+        const QByteArray packetData = QByteArray::fromRawData(buffer.constData() + offset, remainingLength);
+        consumed = offset + remainingLength;
 
         // ===== Paket-Typ verarbeiten =====
 
@@ -570,7 +1559,7 @@ void MqttClient::onReadyRead()
                 qDebug() << "MQTT CONNACK empfangen - Verbindung erfolgreich!";
 
                 // Keep-Alive Timer starten (alle 20 Sekunden = 2/3 des Keep-Alive Intervalls)
-                m_keepAliveTimer->start((m_keepAliveInterval * 1000 * 2) / 3);
+                startKeepAlive();
 
                 emit connected();
             } else {
@@ -596,9 +1585,66 @@ void MqttClient::onReadyRead()
 
             QString topic = QString::fromUtf8(packetData.mid(pos, topicLength));
             pos += topicLength;
+            int end = packetData.length();
+
+            // Prüfsumme prüfen und abschneiden - beschädigte Nachrichten erreichen keinen Handler
+            if (!m_checksumTopics.isEmpty() && m_checksumTopics.contains(topic)) {
+                if (!Crc32c::verifyTrailer(packetData.constData() + pos, end - pos)) {
+                    m_checksumFailures++;
+                    qDebug() << "PUBLISH mit ungültiger Prüfsumme verworfen - Topic:" << topic;
+                    continue;
+                }
+                end -= Crc32c::TrailerSize;
+            }
+
+            // Umschlag direkt im Paketpuffer parsen und überspringen
+            MessageEnvelope::View envelope;
+            bool enveloped = false;
+            if (hasEnvelope(topic) && MessageEnvelope::parse(packetData.constData() + pos, end - pos, envelope)) {
+                enveloped = true;
+                pos += MessageEnvelope::HeaderSize;
+            }
+
+            // Inhaltsfilter des Topics (nullptr = keiner)
+            const PayloadFilter *filter = nullptr;
+            if (!m_payloadFilters.isEmpty()) {
+                auto it = m_payloadFilters.constFind(topic);
+                if (it != m_payloadFilters.constEnd())
+                    filter = &it.value();
+            }
 
-            // Payload extrahieren (Rest des Pakets)
-            QByteArray message = packetData.mid(pos);
+            // Payload extrahieren (Rest des Pakets, eigene Kopie für die Handler)
+            QByteArray message;
+            const bool encrypted = m_payloadCipher && !m_payloadCipher->isEmpty() && m_payloadCipher->hasKey(topic);
+            if (encrypted) {
+                // Direkt in die Kopie für die Handler entschlüsseln, Topic und Umschlag sind authentifiziert
+                if (!m_payloadCipher->open(topic, packetData.constData(), packetData.constData() + pos, end - pos, message)) {
+                    m_decryptFailures++;
+                    qDebug() << "PUBLISH konnte nicht entschlüsselt werden, verworfen - Topic:" << topic;
+                    continue;
+                }
+            }
+
+            // Sequenz erst nach der Authentifizierung übernehmen - ein gefälschter
+            // Umschlag darf das Fenster des Trackers nicht verschieben
+            if (enveloped && !m_sequenceTracker->record(envelope, MessageEnvelope::monotonicNs()) && m_dropDuplicates) {
+                m_droppedDuplicates++;
+                continue;
+            }
+
+            if (encrypted) {
+                if (filter && !filter->matches(message.constData(), message.size())) {
+                    m_filteredMessages++;
+                    continue;
+                }
+            } else {
+                // Filter auf dem Paketpuffer - abgelehnte Nachrichten werden nicht kopiert
+                if (filter && !filter->matches(packetData.constData() + pos, end - pos)) {
+                    m_filteredMessages++;
+                    continue;
+                }
+                message = QByteArray(packetData.constData() + pos, end - pos);
+            }
 
             qDebug() << "PUBLISH empfangen - Topic:" << topic << "| Message:" << message;
 
@@ -607,7 +1653,14 @@ void MqttClient::onReadyRead()
         }
         // SUBACK (0x90) - Subscription-Bestätigung
         else if ((packetType & 0xF0) == 0x90) {
-            qDebug() << "SUBACK empfangen - Subscription erfolgreich!";
+            if (packetData.length() < 3)
+                continue;
+            const quint16 packetId = (quint8)packetData.at(0) << 8 | (quint8)packetData.at(1);
+            const QString topic = m_pendingSubscribes.take(packetId);
+            const bool granted = (quint8)packetData.at(2) != 0x80;
+            qDebug() << "SUBACK empfangen - Topic:" << topic << (granted ? "bestätigt" : "abgelehnt");
+            if (!topic.isEmpty())
+                emit subscriptionAcknowledged(topic, granted);
         }
         // UNSUBACK (0xB0) - Unsubscription-Bestätigung
         else if ((packetType & 0xF0) == 0xB0) {
@@ -616,8 +1669,16 @@ void MqttClient::onReadyRead()
         // PINGRESP (0xD0) - Keep-Alive Antwort
         else if ((packetType & 0xF0) == 0xD0) {
             qDebug() << "PINGRESP empfangen - Keep-Alive OK";
+            if (m_pingPending) {
+                m_pingPending = false;
+                const qint64 rttUs = m_pingTimer.nsecsElapsed() / 1000;
+                m_writeBatcher.recordRoundTrip(rttUs);
+                emit roundTripMeasured(rttUs);
+            }
         }
     }
+
+    return consumed;
 }
 
 /**
@@ -634,9 +1695,16 @@ void MqttClient::onSocketError(QAbstractSocket::SocketError socketError)
 
     // Status zurücksetzen
     m_connected = false;
-    m_keepAliveTimer->stop();
+    m_pingPending = false;
+    stopKeepAlive();
+    discardPendingWrites();
+    failControlQueue();
+    m_timerWheel->cancel(m_bufferTimer);
+    m_bufferTimer = 0;
+    m_pendingSubscribes.clear();
 
     emit error(errorMsg);
+    emit connectionError(errorMsg);
 }
 
 /**
@@ -650,19 +1718,423 @@ void MqttClient::sendPingRequest()
     // Prüfen ob Verbindung noch besteht
     if (!m_connected || m_socket->state() != QAbstractSocket::ConnectedState) {
         qDebug() << "Kann PINGREQ nicht senden - nicht verbunden";
-        m_keepAliveTimer->stop();
+        stopKeepAlive();
         return;
     }
 
-    // PINGREQ-Paket erstellen und senden
+    // PINGREQ direkt schreiben, nicht hinter zurückgehaltenen Massendaten -
+    // sonst misst die Round-Trip-Zeit die eigene Warteschlange mit.
+    // m_pendingWrites beginnt immer an einer Paketgrenze.
     QByteArray packet = createPingRequestPacket();
-    qint64 written = m_socket->write(packet);
-
-    if (written == -1) {
+    if (m_socket->write(packet) != packet.size()) {
         qDebug() << "Fehler beim Senden von PINGREQ";
         return;
     }
-
     m_socket->flush();
+
     qDebug() << "PINGREQ gesendet (Keep-Alive)";
+
+    // Round-Trip-Messung starten (nur wenn keine Probe mehr aussteht)
+    if (!m_pingPending) {
+        m_pingPending = true;
+        m_pingTimer.start();
+    }
+}
+
+/**
+ * @brief Meldet den Keep-Alive im Timer-Rad an
+ *
+ * Ein laufender Keep-Alive wird vorher abgebrochen.
+ */
+void MqttClient::startKeepAlive()
+{
+    stopKeepAlive();
+    m_keepAliveTimer = m_timerWheel->scheduleRepeating((m_keepAliveInterval * 1000 * 2) / 3,
+                                                       [this]() { sendPingRequest(); });
+}
+
+void MqttClient::stopKeepAlive()
+{
+    m_timerWheel->cancel(m_keepAliveTimer);
+    m_keepAliveTimer = 0;
+}
+
+/**
+ * @brief Schätzt den nutzungsabhängigen Speicher des Clients
+ *
+ * Container werden mit Schlüsseln und Werten gezählt, ohne die
+ * Verwaltungsdaten der Hash-Tabellen. Handler zählen mit ihrer
+ * std::function, die von Lambdas ggf. zusätzlich belegten Captures
+ * sind nicht enthalten.
+ */
+qint64 MqttClient::memoryFootprint() const
+{
+    auto topicBytes = [](const QString &topic) {
+        return (qint64)sizeof(QString) + topic.capacity() * (qint64)sizeof(QChar);
+    };
+
+    qint64 bytes = m_buffer.capacity() + m_pendingWrites.capacity();
+    bytes += m_socket->bytesAvailable() + m_socket->bytesToWrite();
+    bytes += m_controlQueue.memoryFootprint();
+
+    for (auto it = m_topicHandlers.constBegin(); it != m_topicHandlers.constEnd(); ++it)
+        bytes += topicBytes(it.key()) + sizeof(TopicHandler);
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it)
+        bytes += topicBytes(it.key()) + sizeof(quint8);
+    for (auto it = m_pendingSubscribes.constBegin(); it != m_pendingSubscribes.constEnd(); ++it)
+        bytes += sizeof(quint16) + topicBytes(it.value());
+    for (auto it = m_payloadFilters.constBegin(); it != m_payloadFilters.constEnd(); ++it)
+        bytes += topicBytes(it.key()) + sizeof(PayloadFilter);
+    for (auto it = m_handlerTimings.constBegin(); it != m_handlerTimings.constEnd(); ++it)
+        bytes += topicBytes(it.key()) + sizeof(HandlerTiming);
+    for (const QSet<QString> *topics : {&m_isolatableHandlers, &m_envelopeTopics, &m_checksumTopics}) {
+        for (const QString &topic : *topics)
+            bytes += topicBytes(topic);
+    }
+
+    return bytes;
+}
+
+/**
+ * @brief Sendet eine zusätzliche Messprobe (PINGREQ)
+ *
+ * Nutzt denselben Weg wie der Keep-Alive, die Antwortzeit wird
+ * über roundTripMeasured() gemeldet.
+ */
+void MqttClient::probe()
+{
+    sendPingRequest();
+}
+
+qint64 MqttClient::realtimeNs()
+{
+    using namespace std::chrono;
+    return (qint64)duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void MqttClient::setSocketBufferTuning(bool enabled)
+{
+    m_bufferTuning = enabled;
+    m_timerWheel->cancel(m_bufferTimer);
+    m_bufferTimer = 0;
+    if (m_socket->state() == QAbstractSocket::ConnectedState)
+        applySocketTuning();
+}
+
+void MqttClient::setNotSentLowWatermark(int bytes)
+{
+    SocketBufferTuner::Config config = m_bufferTuner.config();
+    config.notSentLowWatermark = bytes;
+    m_bufferTuner.setConfig(config);
+
+    QString errorString;
+    if (m_socket->state() == QAbstractSocket::ConnectedState
+        && !SocketBufferTuner::applyNotSentLowWatermark((int)m_socket->socketDescriptor(), bytes, &errorString))
+        emit error(errorString);
+}
+
+/**
+ * @brief Socket-Optionen nach dem Verbindungsaufbau
+ *
+ * Die Pufferregelung startet mit den Puffergrößen des Kernels als
+ * Ausgangswert, die erste Auswertung dient als Bezugspunkt. Gesetzt
+ * wird erst, wenn ein gemessenes BDP darüber liegt.
+ */
+void MqttClient::applySocketTuning()
+{
+    const int fd = (int)m_socket->socketDescriptor();
+    QString errorString;
+
+    const int lowWatermark = m_bufferTuner.config().notSentLowWatermark;
+    if (lowWatermark >= 0 && !SocketBufferTuner::applyNotSentLowWatermark(fd, lowWatermark, &errorString))
+        emit error(errorString);
+
+    if (!m_bufferTuning || m_bufferTimer != 0)
+        return;
+
+    int sendBuffer = 0;
+    int receiveBuffer = 0;
+    if (!SocketBufferTuner::readBuffers(fd, &sendBuffer, &receiveBuffer)) {
+        qDebug() << "Socketpuffer-Regelung nicht verfügbar";
+        return;
+    }
+    m_bufferTuner.reset(sendBuffer, receiveBuffer);
+    tuneSocketBuffers();
+    m_bufferTimer = m_timerWheel->scheduleRepeating(SocketBufferTuner::EvaluationIntervalMs, [this]() {
+        tuneSocketBuffers();
+    });
+}
+
+/**
+ * @brief Liest TCP_INFO und setzt die Puffer bei geänderter Zielgröße
+ *
+ * Ohne RTT des Kernels wird die PINGREQ-Messung verwendet.
+ */
+void MqttClient::tuneSocketBuffers()
+{
+    const int fd = (int)m_socket->socketDescriptor();
+    SocketBufferTuner::Sample sample;
+    sample.nowNs = (qint64)MessageEnvelope::monotonicNs();
+    if (!SocketBufferTuner::readTcpInfo(fd, &sample))
+        return;
+    if (sample.rttUs < 0)
+        sample.rttUs = m_writeBatcher.metrics().rttUs;
+    SocketBufferTuner::readBuffers(fd, &sample.sendBuffer, &sample.receiveBuffer);
+
+    if (!m_bufferTuner.update(sample))
+        return;
+
+    // Nur vergrößerte Richtungen setzen, die andere bleibt beim Kernel-Autotuning
+    const SocketBufferTuner::Metrics &metrics = m_bufferTuner.metrics();
+    QString errorString;
+    if (!SocketBufferTuner::applyBuffers(fd, metrics.sendPinned ? metrics.sendBuffer : 0,
+                                         metrics.receivePinned ? metrics.receiveBuffer : 0, &errorString)) {
+        emit error(errorString);
+        return;
+    }
+    qDebug() << "Socketpuffer angepasst - SO_SNDBUF:" << metrics.sendBuffer << "SO_RCVBUF:" << metrics.receiveBuffer
+             << "| RTT:" << metrics.rttUs << "us | BDP:" << metrics.sendBdp << "/" << metrics.receiveBdp << "Bytes";
+}
+
+void MqttClient::setMultipathEnabled(bool enabled)
+{
+    m_multipath = enabled;
+}
+
+/**
+ * @brief Fragt MPTCP_INFO ab - nach einem Rückfall auf TCP lehnt der Kernel das ab
+ */
+bool MqttClient::isMultipathActive() const
+{
+#ifdef Q_OS_LINUX
+    if (!m_multipath || m_socket->state() != QAbstractSocket::ConnectedState)
+        return false;
+
+    mptcp_info info;
+    socklen_t length = sizeof(info);
+    return ::getsockopt((int)m_socket->socketDescriptor(), SOL_MPTCP, MPTCP_INFO, &info, &length) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Löst den Host asynchron auf, verbunden wird in onMultipathResolved()
+ */
+void MqttClient::connectMultipath(const QString &host, quint16 port, QIODevice::OpenMode mode)
+{
+    m_multipathHost = host;
+    m_multipathPort = port;
+    m_multipathMode = mode;
+#ifdef Q_OS_LINUX
+    m_multipathLookupId = QHostInfo::lookupHost(host, this, [this](const QHostInfo &info) {
+        onMultipathResolved(info);
+    });
+#else
+    fallbackToTcp("MPTCP wird nur unter Linux unterstützt");
+#endif
+}
+
+void MqttClient::onMultipathResolved(const QHostInfo &info)
+{
+    m_multipathLookupId = -1;
+    if (info.error() != QHostInfo::NoError || info.addresses().isEmpty()) {
+        fallbackToTcp("Host " + m_multipathHost + " nicht aufgelöst: " + info.errorString());
+        return;
+    }
+    m_multipathAddresses = info.addresses();
+    connectNextMultipathAddress();
+}
+
+/**
+ * @brief Verbindet nicht blockierend per IPPROTO_MPTCP
+ *
+ * Die Adressen sind bereits aufgelöst; getaddrinfo() wandelt sie nur
+ * noch numerisch (samt IPv6-Scope) in eine sockaddr um und blockiert
+ * nicht. QTcpSocket kann keinen MPTCP-Socket anlegen, übernimmt aber
+ * einen verbundenen. Keep-Alive und Nagle werden daher hier gesetzt -
+ * ältere Kernel lehnen einzelne Optionen für MPTCP ab, das ist unkritisch.
+ */
+void MqttClient::connectNextMultipathAddress()
+{
+#ifdef Q_OS_LINUX
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+
+    while (!m_multipathAddresses.isEmpty()) {
+        const QHostAddress candidate = m_multipathAddresses.takeFirst();
+
+        addrinfo *address = nullptr;
+        if (::getaddrinfo(candidate.toString().toUtf8().constData(), QByteArray::number(m_multipathPort).constData(),
+                          &hints, &address) != 0 || !address)
+            continue;
+
+        const int fd = ::socket(address->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_MPTCP);
+        if (fd < 0) {
+            const int socketError = errno;
+            ::freeaddrinfo(address);
+            if (socketError == EPROTONOSUPPORT || socketError == ENOPROTOOPT || socketError == EINVAL) {
+                fallbackToTcp("Kernel ohne MPTCP");
+                return;
+            }
+            qDebug() << "MPTCP-Socket für" << candidate.toString() << "nicht angelegt:" << strerror(socketError);
+            continue;
+        }
+
+        const int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        const bool started = ::connect(fd, address->ai_addr, address->ai_addrlen) == 0 || errno == EINPROGRESS;
+        const int connectError = errno;
+        ::freeaddrinfo(address);
+        if (!started) {
+            qDebug() << "MPTCP-Verbindung zu" << candidate.toString() << "fehlgeschlagen:" << strerror(connectError);
+            ::close(fd);
+            continue;
+        }
+
+        // Schreibbereit = Verbindungsaufbau beendet (erfolgreich oder nicht)
+        m_multipathFd = fd;
+        m_multipathNotifier = std::make_unique<QSocketNotifier>(fd, QSocketNotifier::Write);
+        connect(m_multipathNotifier.get(), &QSocketNotifier::activated, this, &MqttClient::onMultipathConnected);
+        return;
+    }
+
+    fallbackToTcp("keine Adresse von " + m_multipathHost + " per MPTCP erreichbar");
+#endif
+}
+
+/**
+ * @brief Rückfall auf den normalen Verbindungsaufbau von QTcpSocket
+ *
+ * Fehler meldet dann m_socket wie bei einer TCP-Verbindung.
+ */
+void MqttClient::fallbackToTcp(const QString &reason)
+{
+    abortMultipathConnect();
+    qDebug() << reason << "- verbinde mit TCP";
+    m_socket->connectToHost(m_multipathHost, m_multipathPort, m_multipathMode);
+}
+
+/**
+ * @brief Übergibt den verbundenen MPTCP-Socket an m_socket
+ *
+ * setSocketDescriptor() löst kein connected() aus, onConnected() wird
+ * daher direkt aufgerufen. Schlägt der Aufbau fehl, ist die nächste
+ * Adresse an der Reihe.
+ */
+void MqttClient::onMultipathConnected()
+{
+#ifdef Q_OS_LINUX
+    const int fd = m_multipathFd;
+    m_multipathFd = -1;
+
+    // Der Notifier darf nicht aus seinem eigenen Signal heraus gelöscht werden
+    QSocketNotifier *notifier = m_multipathNotifier.release();
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &socketError, &length) != 0)
+        socketError = errno;
+    if (socketError != 0) {
+        ::close(fd);
+        qDebug() << "MPTCP-Verbindung fehlgeschlagen:" << strerror(socketError);
+        connectNextMultipathAddress();
+        return;
+    }
+
+    m_multipathAddresses.clear();
+    if (!m_socket->setSocketDescriptor(fd, QAbstractSocket::ConnectedState, m_multipathMode)) {
+        ::close(fd);
+        fallbackToTcp("MPTCP-Socket konnte nicht übernommen werden: " + m_socket->errorString());
+        return;
+    }
+
+    qDebug() << (isMultipathActive() ? "MPTCP-Verbindung hergestellt" : "Broker ohne MPTCP - Verbindung läuft als TCP");
+    onConnected();
+#endif
+}
+
+bool MqttClient::isConnecting() const
+{
+    if (m_connected)
+        return false;
+    return m_multipathLookupId >= 0 || m_multipathFd >= 0 || m_socket->state() != QAbstractSocket::UnconnectedState;
+}
+
+void MqttClient::abortMultipathConnect()
+{
+    if (m_multipathLookupId >= 0) {
+        QHostInfo::abortHostLookup(m_multipathLookupId);
+        m_multipathLookupId = -1;
+    }
+    m_multipathAddresses.clear();
+    m_multipathNotifier.reset();
+#ifdef Q_OS_LINUX
+    if (m_multipathFd >= 0) {
+        ::close(m_multipathFd);
+        m_multipathFd = -1;
+    }
+#endif
+}
+
+/**
+ * @brief Schaltet Software-Empfangszeitstempel am Socket ein
+ *
+ * SO_TIMESTAMPNS liefert den Zeitpunkt, zu dem der Kernel das Segment
+ * angenommen hat - auch auf Loopback.
+ */
+void MqttClient::enableReceiveTimestamps()
+{
+#ifdef Q_OS_LINUX
+    const int on = 1;
+    if (::setsockopt((int)m_socket->socketDescriptor(), SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) != 0)
+        emit error("SO_TIMESTAMPNS konnte nicht aktiviert werden: " + QString::fromLocal8Bit(strerror(errno)));
+#else
+    qDebug() << "Kernel-Empfangszeitstempel werden nur unter Linux unterstützt";
+#endif
+}
+
+/**
+ * @brief Ermittelt den Zeitstempel des ersten Segments in der Empfangswarteschlange
+ *
+ * Bei TCP liefert der Kernel den Zeitstempel des ersten Segments, das
+ * recvmsg() berührt - mit einem Byte also das älteste ungelesene.
+ * Vom Kernel zusammengefasste Segmente tragen den Zeitstempel des
+ * letzten Teils, die Wartezeit ist dann eine untere Schranke.
+ */
+qint64 MqttClient::peekReceiveTimestamp()
+{
+#ifdef Q_OS_LINUX
+    char byte;
+    iovec iov;
+    iov.iov_base = &byte;
+    iov.iov_len = 1;
+
+    char control[CMSG_SPACE(sizeof(timespec))];
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (::recvmsg((int)m_socket->socketDescriptor(), &msg, MSG_PEEK | MSG_DONTWAIT) <= 0)
+        return 0;
+
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return (qint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+        }
+    }
+#endif
+    return 0;
 }
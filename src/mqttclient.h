@@ -5,10 +5,27 @@
 #include <QTcpSocket>
 #include <QByteArray>
 #include <QTimer>
+#include <QHash>
 #include <QMap>
+#include <QSet>
+#include <QSocketNotifier>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QHostInfo>
 #include <memory>
 #include <functional>
 
+#include "controlqueue.h"
+#include "handlerworker.h"
+#include "lastvaluecache.h"
+#include "mqttreactor.h"
+#include "payloadcipher.h"
+#include "payloadfilter.h"
+#include "sequencetracker.h"
+#include "socketbuffertuner.h"
+#include "timerwheel.h"
+#include "writebatchcontroller.h"
+
 /**
  * @brief MQTT-Client Implementierung für Qt mit Topic-Handler-System
  *
@@ -35,15 +52,45 @@ class MqttClient : public QObject
     Q_OBJECT
 
 public:
-    /// Typ-Alias für Handler-Funktionen
+    /**
+     * @brief Typ-Alias für Handler-Funktionen
+     *
+     * Handler laufen innerhalb der Empfangsverarbeitung und dürfen keine
+     * verschachtelte Event-Loop starten (z.B. NetworkSelector::switchTo()):
+     * weitere Daten dieser Verbindung werden erst nach dem Handler gelesen,
+     * eine Antwort darauf käme nie an. Stattdessen die asynchronen
+     * Varianten verwenden (isDispatching()).
+     */
     using TopicHandler = std::function<void(const QByteArray&)>;
 
+    /// Ausführungsort eines Topic-Handlers
+    enum class HandlerThreading {
+        OwnerThread,                                         ///< Immer im Thread des Clients (Standard)
+        Isolatable                                           ///< Darf bei Budgetüberschreitung in den Isolations-Worker
+    };
+
+    /// Ergebnis beim Dekodieren der Remaining Length
+    enum class LengthStatus {
+        Complete,                                            ///< Länge vollständig gelesen
+        Incomplete,                                          ///< Weitere Bytes nötig
+        Malformed                                            ///< Mehr als 4 Bytes - Protokollfehler
+    };
+
     /**
-     * @brief Konstruktor
+     * @brief Konstruktor - nutzt den Standard-Reactor des aktuellen Threads
      * @param parent Eltern-QObject für automatische Speicherverwaltung
      */
     explicit MqttClient(QObject *parent = nullptr);
 
+    /**
+     * @brief Konstruktor mit explizitem Reactor
+     * @param reactor Reactor, dessen Timer-Rad und Pufferpools genutzt werden
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     *
+     * Muss im Thread des Reactors aufgerufen werden (siehe MqttReactor::createClient()).
+     */
+    explicit MqttClient(MqttReactor *reactor, QObject *parent = nullptr);
+
     /**
      * @brief Destruktor
      *
@@ -76,6 +123,26 @@ public:
      */
     void publish(const QString &topic, const QByteArray &message, quint8 qos = 0, bool retain = false);
 
+    /**
+     * @brief Publiziert dieselbe Nachricht an mehrere Topics
+     * @param topics Ziel-Topics (z.B. Befehls-Topics aller Geräte)
+     * @param message Gemeinsame Payload
+     * @param qos Quality of Service Level - Standard: 0
+     * @param retain Soll die Nachricht vom Broker gespeichert werden? Standard: false
+     * @return false wenn nicht verbunden oder der Schreibvorgang fehlschlug
+     *
+     * Die PUBLISH-Header aller Topics werden hintereinander in einen Puffer
+     * kodiert, die Payload nur referenziert. Ist der Sendepuffer des Sockets
+     * leer, gehen Header und Payload mit writev() direkt an den Kernel -
+     * die Payload wird dabei nicht kopiert, die Charge braucht einen
+     * Systemaufruf pro IOV_MAX/2 Topics.
+     *
+     * Topics mit Umschlag, Prüfsumme oder Verschlüsselung verändern die
+     * Payload pro Topic; sie werden wie bei publish() einzeln kodiert,
+     * aber ebenfalls in einem Schreibvorgang gesendet.
+     */
+    bool publishMany(const QStringList &topics, const QByteArray &message, quint8 qos = 0, bool retain = false);
+
     /**
      * @brief Abonniert ein Topic ohne Handler (nutzt messageReceived Signal)
      * @param topic MQTT-Topic das abonniert werden soll (z.B. "sensor/#")
@@ -107,11 +174,34 @@ public:
      */
     void subscribe(const QString &topic, TopicHandler handler, quint8 qos = 0);
 
+    /**
+     * @brief Abonniert ein Topic mit Handler und Inhaltsfilter
+     * @param topic MQTT-Topic (exakt, der Filter gilt nicht für Wildcards)
+     * @param handler Callback-Funktion, nur für passende Nachrichten
+     * @param filter Bedingungen an die Payload (siehe setPayloadFilter())
+     * @param qos Quality of Service Level - Standard: 0
+     */
+    void subscribe(const QString &topic, TopicHandler handler, const PayloadFilter &filter, quint8 qos = 0);
+
+    /**
+     * @brief Abonniert ein Topic mit Handler und wählt dessen Ausführungsort
+     * @param topic MQTT-Topic das abonniert werden soll
+     * @param handler Callback-Funktion
+     * @param threading Isolatable erlaubt das Verschieben in den Isolations-Worker
+     * @param qos Quality of Service Level - Standard: 0
+     *
+     * Nur so registrierte Handler werden von setHandlerBudget() isoliert.
+     * Ein Isolatable-Handler muss thread-sicher sein und darf den
+     * MqttClient nur per QMetaObject::invokeMethod() verwenden.
+     */
+    void subscribe(const QString &topic, TopicHandler handler, HandlerThreading threading, quint8 qos = 0);
+
     /**
      * @brief Meldet ein Topic ab
      * @param topic Das abzumeldende Topic
      *
-     * Sendet ein UNSUBSCRIBE-Paket und entfernt den registrierten Handler.
+     * Sendet ein UNSUBSCRIBE-Paket und entfernt den registrierten Handler
+     * sowie einen Inhaltsfilter.
      */
     void unsubscribe(const QString &topic);
 
@@ -139,6 +229,22 @@ public:
      */
     bool hasHandler(const QString &topic) const;
 
+    /**
+     * @brief Aktuelle Abonnements mit QoS
+     *
+     * Bleiben über Verbindungsabbrüche erhalten (für Snapshot und
+     * erneutes Abonnieren), unsubscribe() entfernt sie.
+     */
+    QMap<QString, quint8> subscriptions() const { return m_subscriptions; }
+
+    /**
+     * @brief Trägt empfangene Nachrichten in einen Last-Value-Cache ein
+     * @param cache Cache (nicht im Besitz des Clients, nullptr = keiner)
+     *
+     * Eingetragen wird vor dem Handler-Aufruf, auch für Topics ohne Handler.
+     */
+    void setLastValueCache(LastValueCache *cache) { m_lastValueCache = cache; }
+
     /**
      * @brief Trennt die Verbindung zum Broker
      *
@@ -153,6 +259,388 @@ public:
      */
     bool isConnected() const { return m_connected; }
 
+    /**
+     * @brief Prüft ob ein Verbindungsaufbau läuft oder der Socket noch belegt ist
+     * @return true solange DNS-Auflösung, TCP/MPTCP-Aufbau oder CONNACK ausstehen
+     *         bzw. der Socket nicht getrennt ist - connectToHost() würde ihn abbrechen
+     */
+    bool isConnecting() const;
+
+    /// true während empfangene Pakete verarbeitet werden (also auch in Topic-Handlern)
+    bool isDispatching() const { return m_reading; }
+
+    /**
+     * @brief Aktiviert den Nachrichten-Umschlag (Sequenznummer + Zeitstempel)
+     * @param enabled true = ausgehende Payloads erhalten einen MessageEnvelope
+     * @param codecId Codec-ID die in ausgehende Umschläge geschrieben wird
+     *
+     * Bei aktivem Umschlag werden empfangene Umschläge geparst, im
+     * SequenceTracker verbucht und vor dem Handler-Aufruf entfernt.
+     * Payloads ohne Umschlag werden unverändert weitergereicht.
+     *
+     * Gilt für alle Topics, auch für Befehle an Geräte ohne Umschlag -
+     * für einzelne Topics setTopicEnvelope() verwenden.
+     */
+    void setEnvelopeEnabled(bool enabled, quint8 codecId = 0);
+
+    /**
+     * @brief Aktiviert den Nachrichten-Umschlag nur für ein Topic
+     * @param topic Exaktes Topic (keine Wildcards)
+     * @param enabled true = Umschlag senden bzw. auswerten
+     *
+     * Wie setEnvelopeEnabled(), aber ohne andere Topics zu verändern.
+     * Sender und Empfänger des Topics müssen übereinstimmen.
+     */
+    void setTopicEnvelope(const QString &topic, bool enabled = true);
+
+    /// true wenn Nachrichten des Topics einen Umschlag tragen (global oder pro Topic)
+    bool hasEnvelope(const QString &topic) const { return m_envelopeEnabled || m_envelopeTopics.contains(topic); }
+
+    /**
+     * @brief Sendet ein PINGREQ außerhalb des Keep-Alive Takts
+     *
+     * Dient als Messprobe: die Antwortzeit wird über roundTripMeasured()
+     * gemeldet. Ist bereits eine Probe unbeantwortet, wird keine neue
+     * Zeitmessung gestartet.
+     */
+    void probe();
+
+    /**
+     * @brief Prüft ob ein PINGREQ noch unbeantwortet ist
+     * @return true wenn auf PINGRESP gewartet wird
+     */
+    bool isPingPending() const { return m_pingPending; }
+
+    /// true wenn der Nachrichten-Umschlag für alle Topics aktiv ist
+    bool isEnvelopeEnabled() const { return m_envelopeEnabled; }
+
+    /**
+     * @brief Schützt die Nachrichten eines Topics mit einer CRC32C-Prüfsumme
+     * @param topic Exaktes Topic (keine Wildcards)
+     * @param enabled true = Prüfsumme anhängen bzw. prüfen
+     *
+     * Ausgehende Payloads (inklusive Umschlag) erhalten 4 Bytes Prüfsumme
+     * als Anhang. Bei empfangenen Nachrichten wird der Anhang geprüft und
+     * entfernt, Nachrichten mit falscher Prüfsumme werden verworfen und
+     * in checksumFailures() gezählt.
+     */
+    void setPayloadChecksum(const QString &topic, bool enabled = true);
+
+    /// true wenn Nachrichten des Topics eine Prüfsumme tragen
+    bool hasPayloadChecksum(const QString &topic) const;
+
+    /// Anzahl wegen falscher Prüfsumme verworfener Nachrichten
+    quint64 checksumFailures() const { return m_checksumFailures; }
+
+    /**
+     * @brief Setzt die Schlüssel für Ende-zu-Ende verschlüsselte Topics
+     * @param cipher Gemeinsame Instanz (nullptr = keine Verschlüsselung)
+     *
+     * Für Topics mit Schlüssel wird die Payload beim Senden versiegelt und
+     * beim Empfang geprüft und entschlüsselt. Kann nicht verschlüsselt
+     * werden, wird nichts gesendet und error() ausgelöst. Nicht
+     * entschlüsselbare Nachrichten werden verworfen und in
+     * decryptFailures() gezählt.
+     *
+     * Mehrere Clients desselben Threads sollten sich eine Instanz teilen,
+     * damit die Nonces eines Schlüssels aus einem Zähler stammen.
+     */
+    void setPayloadCipher(std::shared_ptr<PayloadCipher> cipher);
+
+    /// Schlüssel für verschlüsselte Topics (nullptr = keine)
+    PayloadCipher* payloadCipher() const { return m_payloadCipher.get(); }
+
+    /// Anzahl verworfener Nachrichten, die nicht entschlüsselt werden konnten
+    quint64 decryptFailures() const { return m_decryptFailures; }
+
+    /**
+     * @brief Hängt einen Inhaltsfilter an ein Topic
+     * @param topic Exaktes Topic (keine Wildcards)
+     * @param filter Bedingungen an die Payload (leer = Filter entfernen)
+     *
+     * Der Filter wird im Empfangspfad direkt auf dem Paketpuffer
+     * ausgewertet, nach Prüfsumme und Umschlag. Nicht passende Nachrichten
+     * werden weder kopiert noch an Handler bzw. messageReceived()
+     * weitergegeben und in filteredMessages() gezählt. Bei verschlüsselten
+     * Topics wird nach dem Entschlüsseln gefiltert.
+     */
+    void setPayloadFilter(const QString &topic, const PayloadFilter &filter);
+
+    /// Anzahl vom Inhaltsfilter verworfener Nachrichten
+    quint64 filteredMessages() const { return m_filteredMessages; }
+
+    /// Laufzeitkennzahlen eines Topic-Handlers (nur bei gesetztem Budget)
+    struct HandlerStats {
+        quint64 calls = 0;                                   ///< Aufrufe bzw. an den Worker übergebene Nachrichten
+        quint64 overruns = 0;                                ///< Aufrufe über dem Budget
+        qint64 averageNs = 0;                                ///< Mittlere Laufzeit im I/O-Thread
+        qint64 maxNs = 0;                                    ///< Längste Laufzeit im I/O-Thread
+        bool isolated = false;                               ///< true = läuft im Isolations-Worker
+    };
+
+    /**
+     * @brief Überwacht die Laufzeit der Topic-Handler
+     * @param budgetUs Zeitbudget pro Aufruf in Mikrosekunden (0 = aus)
+     * @param strikes Anzahl Überschreitungen bis zur Isolation
+     *
+     * Jeder Handler-Aufruf wird mit dem Zykluszähler (CycleCounter)
+     * gemessen. Überschreitet ein mit HandlerThreading::Isolatable
+     * abonnierter Handler das Budget strikes-mal, wird er in den
+     * Isolations-Worker verschoben: Seine Nachrichten werden danach nur
+     * noch in dessen begrenzte Warteschlange gestellt, Keep-Alive und
+     * andere Topics werden nicht mehr aufgehalten. handlerIsolated() wird
+     * ausgelöst.
+     *
+     * Alle anderen Handler bleiben im Thread des Clients; für sie wird
+     * nur gemessen (handlerStats()) und einmalig gewarnt.
+     */
+    void setHandlerBudget(qint64 budgetUs, int strikes = 3);
+
+    /**
+     * @brief Konfiguriert den Isolations-Worker
+     * @param capacity Maximale Anzahl wartender Nachrichten
+     * @param policy Verhalten bei voller Warteschlange
+     * @param placement CPU-Bindung und Priorität des Worker-Threads
+     *
+     * Wirkt beim Anlegen des Workers, also vor der ersten Isolation.
+     */
+    void setIsolationWorker(int capacity, HandlerWorker::OverflowPolicy policy,
+                            const ThreadTuning::Placement &placement = ThreadTuning::Placement());
+
+    /// Kennzahlen des Handlers eines Topics
+    HandlerStats handlerStats(const QString &topic) const;
+
+    /// true wenn der Handler des Topics im Isolations-Worker läuft
+    bool isHandlerIsolated(const QString &topic) const;
+
+    /// Im Isolations-Worker wegen voller Warteschlange verworfene Nachrichten
+    quint64 isolationDrops() const { return m_isolationWorker ? m_isolationWorker->dropped() : 0; }
+
+    /**
+     * @brief Verlust-, Duplikat- und Latenz-Kennzahlen empfangener Umschläge
+     * @return Tracker mit Kennzahlen pro Publisher
+     */
+    const SequenceTracker& sequenceTracker() const { return *m_sequenceTracker; }
+
+    /**
+     * @brief Teilt den Sequenz-Tracker mit anderen Clients
+     * @param tracker Gemeinsamer Tracker (z.B. aller Netze eines NetworkSelector)
+     *
+     * Empfangen mehrere Verbindungen dieselben Publisher (Netzwechsel ohne
+     * Unterbrechung), erkennt ein gemeinsamer Tracker Duplikate über
+     * Verbindungsgrenzen hinweg.
+     */
+    void setSequenceTracker(std::shared_ptr<SequenceTracker> tracker);
+
+    /**
+     * @brief Verwirft als Duplikat erkannte Umschläge vor der Zustellung
+     * @param enabled Standard: false (Duplikate werden nur gezählt)
+     *
+     * Wirkt nur bei aktivem Umschlag (setEnvelopeEnabled(), setTopicEnvelope()).
+     */
+    void setDropDuplicates(bool enabled) { m_dropDuplicates = enabled; }
+
+    /// Als Duplikat verworfene Nachrichten
+    quint64 droppedDuplicates() const { return m_droppedDuplicates; }
+
+    /**
+     * @brief Geschätzter nutzungsabhängiger Speicher dieses Clients in Bytes
+     *
+     * Puffer (Restpaket, Sammelpuffer, Daten im Socket), Steuer-Warteschlange
+     * sowie Abonnements, Handler, Filter und Topic-Listen. Der Grundbedarf
+     * eines Clients (Objekt, QTcpSocket samt privatem Zustand) ist nicht
+     * enthalten - er wird über den Allocator gemessen, siehe
+     * MqttReactor::heapInUse() und MqttReactor::FootprintTarget.
+     */
+    qint64 memoryFootprint() const;
+
+    /**
+     * @brief Aktiviert das adaptive Zusammenfassen ausgehender PUBLISH-Pakete
+     * @param enabled false = jedes Paket sofort schreiben (Standard: true)
+     *
+     * Bei geringer Last wird weiterhin sofort geschrieben, siehe WriteBatchController.
+     */
+    void setWriteBatchingEnabled(bool enabled);
+
+    /// Regler für das Zusammenfassen (Konfiguration, feste Strategie, Kennzahlen)
+    WriteBatchController& writeBatchController() { return m_writeBatcher; }
+    const WriteBatchController& writeBatchController() const { return m_writeBatcher; }
+
+    /**
+     * @brief Regelt SO_SNDBUF/SO_RCVBUF nach gemessenem BDP (nur Linux)
+     * @param enabled false = Kernel-Vorgaben (Standard)
+     *
+     * Obergrenzen und Faktor über socketBufferTuner().setConfig(). Wirkt ab
+     * sofort bzw. ab der nächsten Verbindung, siehe SocketBufferTuner.
+     */
+    void setSocketBufferTuning(bool enabled);
+    bool isSocketBufferTuningEnabled() const { return m_bufferTuning; }
+
+    /// Regler für die Socketpuffer (Konfiguration, Kennzahlen)
+    SocketBufferTuner& socketBufferTuner() { return m_bufferTuner; }
+    const SocketBufferTuner& socketBufferTuner() const { return m_bufferTuner; }
+
+    /**
+     * @brief Begrenzt die ungesendeten Bytes im Kernel (TCP_NOTSENT_LOWAT, nur Linux)
+     * @param bytes Grenze in Bytes, -1 = Kernel-Vorgabe
+     *
+     * Für latenzkritische Verbindungen: Der Rückstau bleibt im Sendepuffer
+     * des Clients, wo Steuerpakete (publishBefore()) ihn überholen können.
+     * Unabhängig von setSocketBufferTuning().
+     */
+    void setNotSentLowWatermark(int bytes);
+
+    /**
+     * @brief Baut Verbindungen als Multipath-TCP auf (nur Linux)
+     * @param enabled false = normales TCP (Standard)
+     *
+     * Wirkt ab der nächsten Verbindung. Die Sitzung läuft dann über
+     * Subflows auf allen Uplinks, die der Pfadmanager des Kernels als
+     * Endpunkt kennt (siehe MptcpPathManager) - fällt einer weg, bleibt
+     * die TCP-Verbindung und damit die MQTT-Sitzung bestehen.
+     *
+     * Der Hostname wird über QHostInfo aufgelöst, alle Adressen werden
+     * der Reihe nach versucht. Bietet der Kernel kein MPTCP an, schlägt
+     * die Auflösung fehl oder ist keine Adresse erreichbar, wird normal
+     * per connectToHost() mit TCP verbunden; spricht der Broker kein
+     * MPTCP, fällt der Kernel selbst auf TCP zurück.
+     */
+    void setMultipathEnabled(bool enabled);
+    bool isMultipathEnabled() const { return m_multipath; }
+
+    /// true wenn die bestehende Verbindung MPTCP spricht (nicht auf TCP zurückgefallen, Kernel ab 5.16)
+    bool isMultipathActive() const;
+
+    /**
+     * @brief Schreibt gesammelte und zurückgehaltene Pakete sofort in den Socket
+     *
+     * Übergibt alles ohne Rücksicht auf die Reserve für Steuerpakete
+     * (z.B. vor DISCONNECT), wartende Steuerpakete gehen voran.
+     */
+    void flushPendingWrites();
+
+    /**
+     * @brief Prüft ob für ein Topic fertige Pakete geschrieben werden dürfen
+     *
+     * Nicht möglich, wenn der Client die Payload verändern würde
+     * (Umschlag, Prüfsumme oder Verschlüsselung).
+     */
+    bool canWritePreparedPacket(const QString &topic) const;
+
+    /**
+     * @brief Schreibt ein vollständig vorbereitetes MQTT-Paket
+     * @param packet Fertiges Paket (z.B. aus SwitchCommandFrame)
+     * @param size Länge in Bytes
+     * @return false wenn nicht verbunden oder der Socket den Schreibvorgang ablehnt
+     *
+     * Gesammelte PUBLISH-Pakete werden vorher geschrieben, zurückgehaltene
+     * gehen voran (das Paket wird dahinter eingereiht) - die Reihenfolge bleibt erhalten.
+     */
+    bool writePreparedPacket(const char *packet, int size);
+
+    /**
+     * @brief Publiziert eine Steuernachricht mit Frist
+     * @param topic MQTT-Topic
+     * @param message Nachrichteninhalt
+     * @param deadlineNs Frist in monotonen ns (MessageEnvelope::monotonicNs())
+     * @param expired Wird aufgerufen, wenn die Nachricht wegen abgelaufener
+     *                Frist oder Verbindungsverlust nicht gesendet wird
+     * @param qos Quality of Service Level - Standard: 0
+     * @return false wenn nicht verbunden, nicht kodierbar oder die Frist
+     *         bereits abgelaufen ist (expired wird dann nicht aufgerufen)
+     *
+     * Steuernachrichten umgehen das Sammelfenster. Ohne Limit
+     * (setControlBacklogLimit(), Standard) oder solange der Sendepuffer des
+     * Sockets darunter liegt, wird sofort geschrieben. Sonst wartet die
+     * Nachricht in einer Warteschlange nach Frist (EDF) und wird gesendet,
+     * sobald der Puffer abgebaut ist - oder verworfen, wenn ihre Frist
+     * vorher abläuft.
+     *
+     * Mit Limit füllen Massendaten (publish(), publishMany()) den Sendepuffer nur bis
+     * zu diesem Limit und nie, solange Steuernachrichten warten - der Rest
+     * bleibt im Client, wo Steuernachrichten ihn überholen. published()
+     * folgt erst, wenn die Nachricht an den Socket übergeben ist.
+     */
+    bool publishBefore(const QString &topic, const QByteArray &message, qint64 deadlineNs,
+                       ControlQueue::ExpiredCallback expired = nullptr, quint8 qos = 0);
+
+    /**
+     * @brief Schreibt ein fertiges Paket mit Frist (siehe publishBefore())
+     * @param packet Fertiges Paket (wird bei Bedarf kopiert)
+     * @param size Länge in Bytes
+     */
+    bool writePreparedPacketBefore(const char *packet, int size, qint64 deadlineNs,
+                                   ControlQueue::ExpiredCallback expired = nullptr);
+
+    /**
+     * @brief Sendepuffer-Füllstand, ab dem Steuernachrichten warten
+     * @param bytes Noch nicht an den Kernel übergebene Bytes (Standard: 0 = aus)
+     *
+     * Gleichzeitig die Grenze, bis zu der Massendaten den Sendepuffer füllen.
+     * Ohne Limit werden Massendaten nicht zurückgehalten und Steuernachrichten
+     * sofort geschrieben; nur abgelaufene Fristen werden noch verworfen.
+     * Sinnvoll sind einige KB (z.B. 16 KB) bei Clients mit Massenlast.
+     */
+    void setControlBacklogLimit(qint64 bytes) { m_controlBacklogLimit = bytes; }
+
+    /**
+     * @brief Obergrenze für gesammelte und zurückgehaltene Pakete im Client
+     * @param bytes Maximale Größe von m_pendingWrites (Standard: 4 MB, 0 = unbegrenzt)
+     *
+     * Ist sie erreicht, verwerfen publish() und publishMany() neue
+     * Nachrichten mit error(), statt den Rückstau weiter zu puffern.
+     */
+    void setPendingWriteLimit(int bytes) { m_pendingWriteLimit = bytes; }
+
+    /// Anzahl wegen vollem Sammelpuffer verworfener Nachrichten
+    quint64 droppedWrites() const { return m_droppedWrites; }
+
+    /// Anzahl wartender Steuernachrichten
+    int controlQueueDepth() const { return m_controlQueue.size(); }
+
+    /// Anzahl wegen Frist oder Verbindungsverlust verworfener Steuernachrichten
+    quint64 controlExpired() const { return m_controlExpired; }
+
+    /// Reactor, an den dieser Client gebunden ist
+    MqttReactor* reactor() const { return m_reactor; }
+
+    /**
+     * @brief Aktiviert Kernel-Empfangszeitstempel (SO_TIMESTAMPNS)
+     * @param enabled true = Zeitstempel für jedes empfangene Paket ermitteln
+     *
+     * Muss vor connectToHost() gesetzt werden. Der Socket wird dafür
+     * ungepuffert geöffnet, damit die Daten bis zum Lesen im Kernel bleiben
+     * und der Zeitstempel beim Lesen noch verfügbar ist.
+     *
+     * @note Nur unter Linux, sonst bleibt receiveTimestampNs() 0.
+     */
+    void setReceiveTimestampsEnabled(bool enabled) { m_receiveTimestamps = enabled; }
+
+    /// true wenn Kernel-Empfangszeitstempel angefordert sind
+    bool isReceiveTimestampsEnabled() const { return m_receiveTimestamps; }
+
+    /**
+     * @brief Kernel-Empfangszeit des gerade verarbeiteten Pakets
+     * @return Nanosekunden seit Epoch (Uhr wie realtimeNs()), 0 = unbekannt
+     *
+     * Gültig innerhalb der Handler bzw. messageReceived(). Gilt pro Lesevorgang
+     * für die älteste gelesene Nachricht, spätere Pakete desselben Lesevorgangs
+     * erhalten denselben Wert.
+     */
+    qint64 receiveTimestampNs() const { return m_receiveTimestampNs; }
+
+    /**
+     * @brief Zeitpunkt, zu dem das gerade verarbeitete Paket gelesen wurde
+     * @return Nanosekunden seit Epoch (Uhr wie realtimeNs())
+     *
+     * dispatch - receive = Wartezeit im Kernel,
+     * realtimeNs() - dispatch = Verarbeitung im Prozess.
+     */
+    qint64 dispatchTimestampNs() const { return m_dispatchTimestampNs; }
+
+    /// Uhr der Kernel-Zeitstempel (CLOCK_REALTIME) in Nanosekunden
+    static qint64 realtimeNs();
+
 signals:
     /**
      * @brief Signal wird ausgelöst wenn CONNACK empfangen wurde
@@ -190,6 +678,15 @@ signals:
      */
     void subscribed(const QString &topic);
 
+    /**
+     * @brief Signal wird ausgelöst wenn der Broker ein Abonnement bestätigt (SUBACK)
+     * @param topic Das bestätigte Topic
+     * @param granted false wenn der Broker das Abonnement abgelehnt hat
+     *
+     * Ab hier stellt der Broker Nachrichten des Topics über diese Verbindung zu.
+     */
+    void subscriptionAcknowledged(const QString &topic, bool granted);
+
     /**
      * @brief Signal wird ausgelöst wenn ein Topic erfolgreich abgemeldet wurde
      * @param topic Das abgemeldete Topic
@@ -202,6 +699,34 @@ signals:
      */
     void error(const QString &errorString);
 
+    /**
+     * @brief Signal bei einem Fehler des Sockets (Verbindungsaufbau oder bestehende Verbindung)
+     * @param errorString Beschreibung des Fehlers
+     *
+     * Wird zusätzlich zu error() ausgelöst. Anders als error() betrifft es
+     * immer die Verbindung selbst, nicht einzelne Aufrufe wie publish().
+     */
+    void connectionError(const QString &errorString);
+
+    /**
+     * @brief Signal wird ausgelöst wenn ein PINGRESP eingetroffen ist
+     * @param rttUs Round-Trip-Zeit PINGREQ -> PINGRESP in Mikrosekunden
+     */
+    void roundTripMeasured(qint64 rttUs);
+
+    /**
+     * @brief Signal wird ausgelöst wenn der Regler das Sammelfenster ändert
+     * @param windowMs Neues Fenster in Millisekunden (0 = sofort schreiben)
+     */
+    void writeBatchWindowChanged(int windowMs);
+
+    /**
+     * @brief Signal wird ausgelöst wenn ein Handler in den Isolations-Worker verschoben wurde
+     * @param topic Topic des Handlers
+     * @param durationNs Laufzeit des auslösenden Aufrufs
+     */
+    void handlerIsolated(const QString &topic, qint64 durationNs);
+
 private slots:
     /**
      * @brief Slot wird aufgerufen wenn TCP-Verbindung hergestellt wurde
@@ -233,6 +758,13 @@ private slots:
      */
     void onSocketError(QAbstractSocket::SocketError socketError);
 
+    /**
+     * @brief Slot wird aufgerufen wenn der Socket Daten an den Kernel übergeben hat
+     *
+     * Sendet wartende Steuernachrichten, sobald der Sendepuffer unter das Limit fällt.
+     */
+    void onBytesWritten(qint64 bytes);
+
     /**
      * @brief Slot wird vom Keep-Alive Timer aufgerufen
      *
@@ -252,14 +784,71 @@ private:
     QByteArray createConnectPacket(const QString &clientId);
 
     /**
-     * @brief Erstellt ein MQTT PUBLISH-Paket
+     * @brief Schreibt ein MQTT PUBLISH-Paket in einen Puffer
+     * @param packet Ziel-Puffer (z.B. aus dem Sende-Pool des Reactors)
      * @param topic Das Ziel-Topic
      * @param payload Die zu sendenden Daten
      * @param qos Quality of Service (0, 1 oder 2)
      * @param retain Retain-Flag
-     * @return Fertiges PUBLISH-Paket als Byte-Array
+     *
+     * Bei aktivem Umschlag wird der MessageEnvelope direkt vor die
+     * Payload geschrieben, ohne Zwischenkopie. Verschlüsselte Topics
+     * werden direkt in den Puffer versiegelt.
+     *
+     * @return false wenn nicht verschlüsselt werden konnte, der Puffer ist dann unverändert
+     */
+    bool appendPublishPacket(QByteArray &packet, const QString &topic, const QByteArray &payload, quint8 qos, bool retain);
+
+    /**
+     * @brief Schreibt Fixed Header und Topic eines PUBLISH-Pakets
+     * @param dataSize Länge aller Daten hinter dem Topic
+     * @return Offset des Topic-Felds (Beginn der authentifizierten Daten)
      */
-    QByteArray createPublishPacket(const QString &topic, const QByteArray &payload, quint8 qos, bool retain);
+    int appendPublishHeader(QByteArray &packet, const QByteArray &topicUtf8, quint32 dataSize, quint8 qos, bool retain);
+
+    /**
+     * @brief Sendet Header-Abschnitte, jeweils gefolgt von derselben Payload
+     * @param headers Header hintereinander, headerEnds markiert das Ende jedes Abschnitts
+     *
+     * Mit writev() direkt auf den Socket, solange dessen Sendepuffer leer
+     * ist; was der Kernel nicht annimmt, geht in den Sendepuffer.
+     */
+    bool writeGathered(const QByteArray &headers, const QVector<int> &headerEnds, const QByteArray &payload);
+
+    /**
+     * @brief Startet den Verbindungsaufbau über einen MPTCP-Socket
+     *
+     * Nicht blockierend - löst den Host per QHostInfo auf und fährt in
+     * onMultipathResolved() fort. Ist ein Socket verbunden, übernimmt ihn
+     * m_socket per setSocketDescriptor() in onMultipathConnected().
+     */
+    void connectMultipath(const QString &host, quint16 port, QIODevice::OpenMode mode);
+
+    /**
+     * @brief Übernimmt die aufgelösten Adressen und verbindet mit der ersten
+     */
+    void onMultipathResolved(const QHostInfo &info);
+
+    /**
+     * @brief Verbindet mit der nächsten noch nicht versuchten Adresse
+     *
+     * Sind alle Adressen erfolglos versucht oder bietet der Kernel kein
+     * MPTCP an, wird per fallbackToTcp() verbunden.
+     */
+    void connectNextMultipathAddress();
+
+    /// Bricht MPTCP ab und verbindet normal über m_socket
+    void fallbackToTcp(const QString &reason);
+
+    /**
+     * @brief Wertet das Ergebnis des MPTCP-Verbindungsaufbaus aus
+     */
+    void onMultipathConnected();
+
+    /**
+     * @brief Bricht einen laufenden MPTCP-Verbindungsaufbau ab
+     */
+    void abortMultipathConnect();
 
     /**
      * @brief Erstellt ein MQTT SUBSCRIBE-Paket
@@ -306,11 +895,12 @@ private:
      * @brief Dekodiert die "Remaining Length" nach MQTT-Spezifikation
      * @param data Quell-Daten
      * @param offset Start-Offset (wird erhöht)
-     * @return Die dekodierte Länge
+     * @param length Die dekodierte Länge (nur bei Complete gültig)
+     * @return Complete, Incomplete (Daten fehlen noch) oder Malformed
      *
      * Liest 1-4 Bytes und berechnet die tatsächliche Paketlänge.
      */
-    quint32 decodeRemainingLength(const QByteArray &data, int &offset);
+    static LengthStatus decodeRemainingLength(const QByteArray &data, int &offset, quint32 &length);
 
     /**
      * @brief Verarbeitet empfangene PUBLISH-Nachricht
@@ -322,15 +912,173 @@ private:
      */
     void handlePublishMessage(const QString &topic, const QByteArray &message);
 
+    /**
+     * @brief Ruft einen Handler mit Zeitmessung auf bzw. übergibt an den Isolations-Worker
+     */
+    void dispatchMeasured(const QString &topic, const TopicHandler &handler, const QByteArray &message);
+
+    /// Verschiebt den Handler eines Topics in den Isolations-Worker
+    void isolateHandler(const QString &topic, quint64 ticks);
+
+    /// Stellt ein Steuerpaket ein und sendet, soweit der Sendepuffer es zulässt
+    bool submitControl(const QByteArray &packet, qint64 deadlineNs, ControlQueue::ExpiredCallback expired,
+                       ControlQueue::WrittenCallback written = nullptr);
+
+    /// Bytes, die Massendaten noch in den Sendepuffer schreiben dürfen (0 solange Steuerpakete warten)
+    qint64 bulkBudget() const;
+
+    /// Noch nicht geschriebene Bytes in m_pendingWrites
+    int pendingBytes() const { return m_pendingWrites.size() - m_pendingOffset; }
+
+    /// false (mit error()) wenn der Sammelpuffer setPendingWriteLimit() erreicht hat
+    bool hasPendingCapacity(const QString &topic);
+
+    /// Schreibt zurückgehaltene Pakete im Rahmen von bulkBudget()
+    void writePendingWrites();
+
+    /// Schreibt ein Paket hinter zurückgehaltene Massendaten, ohne die Reihenfolge zu ändern
+    bool writeOrdered(const char *packet, int size);
+
+    /**
+     * @brief Sendet wartende Steuerpakete nach Frist, verwirft abgelaufene
+     *
+     * Plant bei verbleibenden Paketen einen Timer auf die früheste Frist.
+     */
+    void drainControlQueue();
+
+    /// Verwirft alle wartenden Steuerpakete (Verbindungsverlust)
+    void failControlQueue();
+
+    /**
+     * @brief Verarbeitet alle vollständigen Pakete eines Empfangspuffers
+     * @param buffer Empfangene Daten (beginnen an einer Paketgrenze)
+     * @return Anzahl verarbeiteter Bytes, der Rest ist ein unvollständiges Paket; -1 bei Protokollfehler
+     */
+    int processPackets(const QByteArray &buffer);
+
+    /**
+     * @brief Startet den periodischen Keep-Alive im Timer-Rad
+     *
+     * Intervall: 2/3 des Keep-Alive Intervalls.
+     */
+    void startKeepAlive();
+
+    /**
+     * @brief Bricht den Keep-Alive Timer ab
+     */
+    void stopKeepAlive();
+
+    /**
+     * @brief Verwirft gesammelte PUBLISH-Pakete und das Sammelfenster
+     */
+    void discardPendingWrites();
+
+    /**
+     * @brief Setzt TCP_NOTSENT_LOWAT und startet die Pufferregelung am verbundenen Socket
+     */
+    void applySocketTuning();
+
+    /**
+     * @brief Eine Auswertung der Pufferregelung (Timer)
+     */
+    void tuneSocketBuffers();
+
+    /**
+     * @brief Schaltet SO_TIMESTAMPNS am verbundenen Socket ein
+     */
+    void enableReceiveTimestamps();
+
+    /**
+     * @brief Liest den Kernel-Zeitstempel der ältesten ungelesenen Daten
+     * @return Nanosekunden seit Epoch, 0 wenn keiner vorliegt
+     *
+     * Nutzt recvmsg() mit MSG_PEEK, die Daten bleiben im Socket.
+     */
+    qint64 peekReceiveTimestamp();
+
     // Mitgliedsvariablen
+    MqttReactor *m_reactor;                                  ///< Gemeinsamer I/O-Kontext (Timer-Rad, Pufferpools)
     std::unique_ptr<QTcpSocket> m_socket;                    ///< TCP-Socket für MQTT-Kommunikation (Smart Pointer)
-    std::unique_ptr<QTimer> m_keepAliveTimer;                ///< Timer für Keep-Alive (PINGREQ) (Smart Pointer)
+    TimerWheel *m_timerWheel;                                ///< Timer-Rad des Reactors
+    TimerWheel::TimerId m_keepAliveTimer;                    ///< Timer für Keep-Alive (PINGREQ) im Timer-Rad
     QMap<QString, TopicHandler> m_topicHandlers;             ///< Map: Topic -> Handler-Funktion
     QString m_clientId;                                      ///< MQTT Client-ID
     bool m_connected;                                        ///< true wenn CONNACK empfangen wurde
     quint16 m_packetId;                                      ///< Laufende Packet-ID für SUBSCRIBE/PUBLISH QoS>0
-    QByteArray m_buffer;                                     ///< Empfangspuffer für unvollständige Pakete
+    QByteArray m_buffer;                                     ///< Rest eines unvollständigen Pakets (sonst leer)
+    bool m_reading;                                          ///< true während onReadyRead() Pakete verarbeitet
     quint16 m_keepAliveInterval;                             ///< Keep-Alive Intervall in Sekunden (Standard: 30)
+    QElapsedTimer m_pingTimer;                               ///< Zeitmessung für das ausstehende PINGREQ
+    bool m_pingPending;                                      ///< true wenn auf PINGRESP gewartet wird
+    bool m_envelopeEnabled;                                  ///< true wenn MessageEnvelope für alle Topics verwendet wird
+    QSet<QString> m_envelopeTopics;                          ///< Topics mit MessageEnvelope (zusätzlich zu m_envelopeEnabled)
+    quint8 m_envelopeCodecId;                                ///< Codec-ID für ausgehende Umschläge
+    quint32 m_publisherId;                                   ///< Publisher-ID (aus Client-ID abgeleitet)
+    quint32 m_publishSequence;                               ///< Nächste Sequenznummer für ausgehende Umschläge
+    quint8 m_publisherEpoch;                                 ///< Startkennung im Umschlag (zufällig je Instanz)
+    std::shared_ptr<SequenceTracker> m_sequenceTracker;      ///< Kennzahlen empfangener Umschläge (ggf. gemeinsam genutzt)
+    WriteBatchController m_writeBatcher;                     ///< Regler für das Sammelfenster
+    bool m_writeBatchingEnabled;                             ///< false = immer sofort schreiben
+    QByteArray m_pendingWrites;                              ///< Gesammelte oder zurückgehaltene Pakete
+    int m_pendingOffset;                                     ///< Bereits geschriebener Anfang von m_pendingWrites
+    int m_pendingMessages;                                   ///< Anzahl noch nicht verbuchter Pakete in m_pendingWrites
+    int m_lastBatchWindowMs;                                 ///< Zuletzt gemeldetes Fenster
+    TimerWheel::TimerId m_flushTimer;                        ///< Ablauf des Sammelfensters (0 = keins)
+    bool m_receiveTimestamps;                                ///< true = Kernel-Empfangszeitstempel verwenden
+    qint64 m_receiveTimestampNs;                             ///< Kernel-Empfangszeit des aktuellen Pakets
+    qint64 m_dispatchTimestampNs;                            ///< Lesezeitpunkt des aktuellen Pakets
+    qint64 m_chunkTimestampNs;                               ///< Kernel-Zeitstempel des aktuellen Lesevorgangs
+    qint64 m_chunkReadNs;                                    ///< Zeitpunkt des aktuellen Lesevorgangs
+    qint64 m_residualTimestampNs;                            ///< Kernel-Zeitstempel des Rests in m_buffer
+    qint64 m_residualReadNs;                                 ///< Lesezeitpunkt des Rests in m_buffer
+    int m_chunkStart;                                        ///< Offset der neu gelesenen Daten im Empfangspuffer
+    QSet<QString> m_checksumTopics;                          ///< Topics mit CRC32C-Anhang
+    quint64 m_checksumFailures;                              ///< Verworfene Nachrichten mit falscher Prüfsumme
+    std::shared_ptr<PayloadCipher> m_payloadCipher;          ///< Schlüssel verschlüsselter Topics (gemeinsam genutzt)
+    quint64 m_decryptFailures;                               ///< Verworfene, nicht entschlüsselbare Nachrichten
+    QHash<QString, PayloadFilter> m_payloadFilters;          ///< Map: Topic -> Inhaltsfilter
+    quint64 m_filteredMessages;                              ///< Vom Inhaltsfilter verworfene Nachrichten
+    QMap<QString, quint8> m_subscriptions;                   ///< Map: Abonniertes Topic -> QoS
+    LastValueCache *m_lastValueCache;                        ///< Empfangene Werte (nicht im Besitz)
+
+    /// Messwerte eines Handlers in Zählerschritten
+    struct HandlerTiming {
+        quint64 calls = 0;
+        quint64 measured = 0;                                ///< Im I/O-Thread gemessene Aufrufe
+        quint64 overruns = 0;
+        quint64 totalTicks = 0;
+        quint64 maxTicks = 0;
+        bool isolated = false;
+    };
+
+    quint64 m_handlerBudgetTicks;                            ///< Zeitbudget pro Handler-Aufruf (0 = keine Messung)
+    int m_handlerStrikes;                                    ///< Überschreitungen bis zur Isolation
+    QHash<QString, HandlerTiming> m_handlerTimings;          ///< Map: Topic -> Messwerte
+    QSet<QString> m_isolatableHandlers;                      ///< Topics mit HandlerThreading::Isolatable
+    std::unique_ptr<HandlerWorker> m_isolationWorker;        ///< Thread für isolierte Handler (bei Bedarf angelegt)
+    int m_isolationCapacity;                                 ///< Warteschlangengröße des Workers
+    HandlerWorker::OverflowPolicy m_isolationPolicy;         ///< Überlaufverhalten des Workers
+    ThreadTuning::Placement m_isolationPlacement;            ///< Platzierung des Worker-Threads
+    ControlQueue m_controlQueue;                             ///< Wartende Steuerpakete nach Frist
+    qint64 m_controlBacklogLimit;                            ///< Sendepuffer-Füllstand, ab dem Steuerpakete warten (0 = aus)
+    int m_pendingWriteLimit;                                 ///< Obergrenze für m_pendingWrites (0 = unbegrenzt)
+    quint64 m_droppedWrites;                                 ///< Wegen vollem Sammelpuffer verworfene Nachrichten
+    TimerWheel::TimerId m_controlTimer;                      ///< Timer auf die früheste Frist (0 = keiner)
+    quint64 m_controlExpired;                                ///< Verworfene Steuerpakete
+    bool m_bufferTuning;                                     ///< SO_SNDBUF/SO_RCVBUF regeln
+    SocketBufferTuner m_bufferTuner;                         ///< Regler für die Socketpuffer
+    TimerWheel::TimerId m_bufferTimer;                       ///< Timer der Pufferregelung (0 = keiner)
+    bool m_dropDuplicates;                                   ///< Duplikate vor der Zustellung verwerfen
+    quint64 m_droppedDuplicates;                             ///< Als Duplikat verworfene Nachrichten
+    QHash<quint16, QString> m_pendingSubscribes;             ///< Map: Packet-ID -> Topic unbestätigter SUBSCRIBEs
+    bool m_multipath;                                        ///< Verbindungen als MPTCP aufbauen
+    int m_multipathFd;                                       ///< MPTCP-Socket im Verbindungsaufbau (-1 = keiner)
+    int m_multipathLookupId;                                 ///< Laufende Namensauflösung (-1 = keine)
+    QString m_multipathHost;                                 ///< Ziel des Verbindungsaufbaus (für den TCP-Rückfall)
+    quint16 m_multipathPort;
+    QList<QHostAddress> m_multipathAddresses;                ///< Noch nicht versuchte Adressen
+    QIODevice::OpenMode m_multipathMode;                     ///< Öffnungsmodus für die Übernahme in m_socket
+    std::unique_ptr<QSocketNotifier> m_multipathNotifier;    ///< Meldet das Ende des Verbindungsaufbaus
 };
 
 #endif // MQTTCLIENT_H
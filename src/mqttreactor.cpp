@@ -0,0 +1,174 @@
+#include "mqttreactor.h"
+#include "mqttclient.h"
+#include <QDebug>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/**
+ * @brief Konstruktor - übernimmt das Timer-Rad des aktuellen Threads
+ *
+ * Empfangspuffer sind auf typische Lesemengen eines readyRead() ausgelegt,
+ * Sendepuffer auf einzelne PUBLISH-Pakete.
+ */
+MqttReactor::MqttReactor(QObject *parent)
+    : QObject(parent)
+    , m_timerWheel(TimerWheel::forCurrentThread())
+    , m_receivePool(16 * 1024, 8)
+    , m_sendPool(1024, 8)
+    , m_clientCount(0)
+{
+}
+
+/**
+ * @brief Destruktor
+ *
+ * Die eigenen Clients werden im Reactor-Thread freigegeben, bevor dieser
+ * beendet wird. Clients mit anderem Eltern-Objekt müssen vorher
+ * freigegeben worden sein.
+ */
+MqttReactor::~MqttReactor()
+{
+    auto deleteClients = [this]() {
+        const QList<MqttClient*> owned = findChildren<MqttClient*>(QString(), Qt::FindDirectChildrenOnly);
+        qDeleteAll(owned);
+    };
+
+    if (m_thread) {
+        QThread *origin = QThread::currentThread();
+        QMetaObject::invokeMethod(this, [this, deleteClients, origin]() {
+            deleteClients();
+            moveToThread(origin);
+        }, Qt::BlockingQueuedConnection);
+
+        m_thread->quit();
+        m_thread->wait();
+    } else {
+        deleteClients();
+    }
+
+    if (!m_clients.isEmpty())
+        qDebug() << "MqttReactor freigegeben, obwohl noch" << m_clients.size() << "Clients gebunden sind";
+}
+
+/**
+ * @brief Ein Reactor pro Thread, Lebensdauer an den Thread gebunden
+ *
+ * Wird nach dem TimerWheel des Threads angelegt und damit vor diesem freigegeben.
+ */
+MqttReactor* MqttReactor::forCurrentThread()
+{
+    static thread_local std::unique_ptr<MqttReactor> reactor;
+    if (!reactor)
+        reactor = std::make_unique<MqttReactor>();
+    return reactor.get();
+}
+
+/**
+ * @brief Startet den I/O-Thread und übernimmt dessen Timer-Rad
+ */
+bool MqttReactor::startThread(const QString &name)
+{
+    if (m_thread) {
+        qDebug() << "MqttReactor: Thread läuft bereits";
+        return false;
+    }
+    if (!m_clients.isEmpty()) {
+        qDebug() << "MqttReactor: Thread muss vor dem ersten Client gestartet werden";
+        return false;
+    }
+    if (parent()) {
+        qDebug() << "MqttReactor: Objekte mit Eltern-Objekt können nicht in einen Thread verschoben werden";
+        return false;
+    }
+
+    m_thread = std::make_unique<QThread>();
+    m_thread->setObjectName(name);
+    moveToThread(m_thread.get());
+    m_thread->start();
+
+    // Das Timer-Rad muss im Reactor-Thread angelegt werden
+    QMetaObject::invokeMethod(this, [this]() {
+        m_timerWheel = TimerWheel::forCurrentThread();
+        m_placementReport = ThreadTuning::describeCurrentThread();
+    }, Qt::BlockingQueuedConnection);
+
+    qDebug() << "MqttReactor: I/O-Thread gestartet:" << name << "-" << m_placementReport;
+    return true;
+}
+
+bool MqttReactor::applyPlacement(const ThreadTuning::Placement &placement)
+{
+    bool applied = false;
+    QString errorString;
+
+    auto apply = [this, &placement, &applied, &errorString]() {
+        applied = ThreadTuning::applyToCurrentThread(placement, &errorString);
+        m_placementReport = ThreadTuning::describeCurrentThread();
+    };
+
+    if (thread() == QThread::currentThread())
+        apply();
+    else
+        QMetaObject::invokeMethod(this, apply, Qt::BlockingQueuedConnection);
+
+    if (!applied)
+        qDebug() << "MqttReactor: Platzierung unvollständig:" << errorString;
+    qDebug() << "MqttReactor: Platzierung" << m_placementReport;
+    return applied;
+}
+
+MqttClient* MqttReactor::createClient()
+{
+    MqttClient *client = nullptr;
+
+    if (thread() == QThread::currentThread()) {
+        client = new MqttClient(this, this);
+    } else {
+        QMetaObject::invokeMethod(this, [this, &client]() {
+            client = new MqttClient(this, this);
+        }, Qt::BlockingQueuedConnection);
+    }
+
+    return client;
+}
+
+qint64 MqttReactor::averageClientFootprint() const
+{
+    if (m_clients.isEmpty())
+        return 0;
+
+    qint64 total = 0;
+    for (const MqttClient *client : m_clients)
+        total += client->memoryFootprint();
+    return total / m_clients.size();
+}
+
+qint64 MqttReactor::heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return (qint64)mallinfo2().uordblks;
+#elif defined(__GLIBC__)
+    return (qint64)(unsigned int)mallinfo().uordblks;  // Läuft ab 4 GB über
+#else
+    return -1;
+#endif
+}
+
+qint64 MqttReactor::sharedFootprint() const
+{
+    return sizeof(*this) + m_receivePool.pooledBytes() + m_sendPool.pooledBytes();
+}
+
+void MqttReactor::attach(MqttClient *client)
+{
+    m_clients.append(client);
+    m_clientCount.storeRelaxed(m_clients.size());
+}
+
+void MqttReactor::detach(MqttClient *client)
+{
+    m_clients.removeOne(client);
+    m_clientCount.storeRelaxed(m_clients.size());
+}
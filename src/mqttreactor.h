@@ -0,0 +1,161 @@
+#ifndef MQTTREACTOR_H
+#define MQTTREACTOR_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <memory>
+
+#include "bufferpool.h"
+#include "threadtuning.h"
+#include "timerwheel.h"
+
+class MqttClient;
+
+/**
+ * @brief Gemeinsamer I/O-Kontext für viele MqttClient-Instanzen
+ *
+ * Alle an einen Reactor gebundenen Clients laufen in dessen Thread und teilen:
+ * - die Event-Loop des Threads (ein Thread für beliebig viele Verbindungen)
+ * - das TimerWheel des Threads (Keep-Alive aller Clients)
+ * - einen Empfangs- und einen Sende-Pufferpool
+ *
+ * Ein Client hält damit im Ruhezustand keinen eigenen Empfangspuffer mehr,
+ * nur unvollständige Pakete werden bis zum nächsten readyRead() aufbewahrt.
+ *
+ * Ohne startThread() arbeitet der Reactor im Thread, in dem er angelegt
+ * wurde. Jeder Thread hat einen Standard-Reactor (forCurrentThread()), den
+ * MqttClient ohne explizite Angabe verwendet.
+ *
+ * Verwendung für ein Gateway mit vielen Mandanten:
+ * @code
+ * MqttReactor reactor;
+ * reactor.startThread();
+ * for (const QString &tenant : tenants) {
+ *     MqttClient *client = reactor.createClient();
+ *     QMetaObject::invokeMethod(client, [client, tenant]() {
+ *         client->connectToHost("broker", 1883, tenant);
+ *     });
+ * }
+ * @endcode
+ *
+ * @note Clients eines Reactors mit eigenem Thread dürfen nur aus diesem
+ *       Thread aufgerufen werden (z.B. über QMetaObject::invokeMethod).
+ */
+class MqttReactor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Zielwert für den Heap-Bedarf eines nicht verbundenen Clients in Bytes
+     *
+     * Gemessen als Zuwachs von heapInUse() über viele Clients, also samt
+     * QObject- und QTcpSocket-Interna (tests/tst_clientfootprint.cpp).
+     * Eine Verbindung belegt zusätzlich Socket-Engine und Notifier, loadgen
+     * gibt den Wert für verbundene Sessions aus.
+     */
+    static constexpr qint64 FootprintTarget = 8 * 1024;
+
+    /// Obergrenze für den internen Lesepuffer eines Sockets in Bytes
+    static constexpr qint64 SocketReadBufferLimit = 64 * 1024;
+
+    /**
+     * @brief Konstruktor - Reactor arbeitet zunächst im aktuellen Thread
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     */
+    explicit MqttReactor(QObject *parent = nullptr);
+
+    /**
+     * @brief Destruktor - gibt alle mit createClient() angelegten Clients frei
+     *        und beendet den eigenen Thread
+     */
+    ~MqttReactor() override;
+
+    /**
+     * @brief Liefert den Standard-Reactor des aktuellen Threads
+     */
+    static MqttReactor* forCurrentThread();
+
+    /**
+     * @brief Verlegt den Reactor in einen eigenen I/O-Thread
+     * @param name Thread-Name (z.B. für top -H)
+     * @return false wenn bereits Clients gebunden sind oder der Thread schon läuft
+     *
+     * Muss vor dem ersten createClient() aufgerufen werden.
+     */
+    bool startThread(const QString &name = QStringLiteral("mqtt-io"));
+
+    /**
+     * @brief Legt einen neuen Client im Thread des Reactors an
+     * @return Client, der dem Reactor gehört
+     *
+     * Aus fremden Threads blockiert der Aufruf, bis der Client angelegt ist.
+     */
+    MqttClient* createClient();
+
+    /**
+     * @brief Bindet den Reactor-Thread an CPUs und setzt ggf. SCHED_FIFO
+     * @param placement Gewünschte Platzierung (siehe ThreadTuning)
+     * @return true wenn alle Einstellungen übernommen wurden
+     *
+     * Wird im Reactor-Thread ausgeführt. Die tatsächliche Platzierung wird
+     * protokolliert und ist über placementReport() abrufbar.
+     */
+    bool applyPlacement(const ThreadTuning::Placement &placement);
+
+    /// Tatsächliche Platzierung des Reactor-Threads (nach startThread() bzw. applyPlacement())
+    QString placementReport() const { return m_placementReport; }
+
+    /// Timer-Rad des Reactor-Threads
+    TimerWheel* timerWheel() const { return m_timerWheel; }
+
+    /// Pool für Empfangspuffer
+    BufferPool& receivePool() { return m_receivePool; }
+
+    /// Pool für Sendepuffer
+    BufferPool& sendPool() { return m_sendPool; }
+
+    /// Anzahl gebundener Clients
+    int clientCount() const { return m_clientCount.loadRelaxed(); }
+
+    /**
+     * @brief Durchschnittlicher nutzungsabhängiger Speicher der gebundenen Clients
+     * @return Bytes pro Client (siehe MqttClient::memoryFootprint())
+     *
+     * Nur aus dem Reactor-Thread aufrufen.
+     */
+    qint64 averageClientFootprint() const;
+
+    /**
+     * @brief Vom Allocator belegter Heap des Prozesses in Bytes
+     * @return -1 wenn der Allocator keine Auskunft gibt (nur mit glibc verfügbar)
+     *
+     * Die Differenz vor und nach dem Anlegen vieler Clients ergibt deren
+     * tatsächlichen Bedarf. Gilt für alle Threads des Prozesses.
+     */
+    static qint64 heapInUse();
+
+    /**
+     * @brief Gemeinsamer Speicher des Reactors (vorgehaltene Puffer)
+     */
+    qint64 sharedFootprint() const;
+
+private:
+    friend class MqttClient;
+
+    void attach(MqttClient *client);
+    void detach(MqttClient *client);
+
+    TimerWheel *m_timerWheel;                                ///< Timer-Rad des Reactor-Threads
+    BufferPool m_receivePool;                                ///< Gemeinsame Empfangspuffer
+    BufferPool m_sendPool;                                   ///< Gemeinsame Sendepuffer
+    QVector<MqttClient*> m_clients;                          ///< Gebundene Clients (nur im Reactor-Thread)
+    QAtomicInt m_clientCount;                                ///< Anzahl gebundener Clients (threadsicher lesbar)
+    std::unique_ptr<QThread> m_thread;                       ///< Eigener I/O-Thread (nullptr = Thread des Erzeugers)
+    QString m_placementReport;                               ///< Zuletzt ermittelte Platzierung des Threads
+};
+
+#endif // MQTTREACTOR_H
@@ -0,0 +1,353 @@
+#include "networkregistry.h"
+#include <QDebug>
+
+/**
+ * @brief Konstruktor - Standard-Policy ist die feste Rangfolge
+ */
+NetworkRegistry::NetworkRegistry(QObject *parent)
+    : QObject(parent)
+    , m_policy(std::make_unique<PriorityPolicy>())
+    , m_probeTimer(0)
+    , m_settleTimer(0)
+    , m_best(-1)
+    , m_settled(false)
+{
+}
+
+/**
+ * @brief Destruktor - gibt die Verbindungen aller Netze frei
+ */
+NetworkRegistry::~NetworkRegistry()
+{
+    TimerWheel *wheel = TimerWheel::forCurrentThread();
+    wheel->cancel(m_probeTimer);
+    wheel->cancel(m_settleTimer);
+    for (NetworkEntry &network : m_networks) {
+        wheel->cancel(network.reconnectTimer);
+        delete network.client;
+    }
+}
+
+/**
+ * @brief Legt ein Netz an und verbindet die Signale seines MqttClients
+ *
+ * Alle Lambdas halten nur die ID, da sich die Adresse der Einträge
+ * beim Wachsen des Vektors ändert.
+ */
+int NetworkRegistry::addNetwork(const NetworkEntry &config)
+{
+    const int id = (int)m_networks.size();
+
+    NetworkEntry network;
+    network.name = config.name;
+    network.interfaceName = config.interfaceName;
+    network.host = config.host;
+    network.port = config.port;
+    network.priority = config.priority;
+    network.weight = config.weight;
+    network.activate = config.activate;
+    network.tuneSocketBuffers = config.tuneSocketBuffers;
+    network.notSentLowWatermark = config.notSentLowWatermark;
+    network.multipath = config.multipath;
+    network.localAddress = config.localAddress;
+    network.client = new MqttClient(this);
+    network.client->setSocketBufferTuning(config.tuneSocketBuffers);
+    network.client->setNotSentLowWatermark(config.notSentLowWatermark);
+    network.client->setMultipathEnabled(config.multipath);
+    m_networks.push_back(network);
+
+    MqttClient *client = network.client;
+    connect(client, &MqttClient::connected, this, [this, id]() {
+        NetworkEntry &entry = m_networks[id];
+        entry.connected = true;
+        entry.missedProbes = 0;
+        entry.reconnectDelayMs = 0;
+        TimerWheel::forCurrentThread()->cancel(entry.reconnectTimer);
+        entry.reconnectTimer = 0;
+        update(id);
+        markAttempted(id);
+        emit networkConnected(id);
+    });
+    connect(client, &MqttClient::disconnected, this, [this, id]() {
+        m_networks[id].connected = false;
+        update(id);
+        markAttempted(id);
+        scheduleReconnect(id);
+    });
+    // Nur Fehler der Verbindung selbst - error() meldet auch z.B. ein publish() ohne Verbindung
+    connect(client, &MqttClient::connectionError, this, [this, id](const QString &) {
+        m_networks[id].connected = m_networks[id].client->isConnected();
+        update(id);
+        if (!m_networks[id].connected) {
+            markAttempted(id);
+            scheduleReconnect(id);
+        }
+    });
+    connect(client, &MqttClient::roundTripMeasured, this, [this, id](qint64 rttUs) {
+        NetworkEntry &entry = m_networks[id];
+        const double sample = rttUs / 1000.0;
+        // EWMA mit alpha = 1/4 - reagiert schnell, glättet Ausreißer
+        entry.rttMs = entry.rttMs < 0.0 ? sample : entry.rttMs + (sample - entry.rttMs) / 4.0;
+        entry.rttWindow.add(rttUs);
+        entry.missedProbes = 0;
+        update(id);
+    });
+
+    qDebug() << "Netz registriert:" << config.name << "ID" << id;
+    update(id);
+
+    // Nach connectAll() hinzugefügte Netze sofort verbinden
+    reconnect(id);
+    return id;
+}
+
+int NetworkRegistry::networkForInterface(const QString &interfaceName) const
+{
+    for (int id = 0; id < count(); ++id) {
+        if (!m_networks[id].interfaceName.isEmpty() && m_networks[id].interfaceName == interfaceName)
+            return id;
+    }
+    return -1;
+}
+
+void NetworkRegistry::setInterface(int id, const QString &interfaceName)
+{
+    if (id >= 0 && id < count())
+        m_networks[id].interfaceName = interfaceName;
+}
+
+void NetworkRegistry::setLocalAddress(int id, const QString &address)
+{
+    if (id >= 0 && id < count())
+        m_networks[id].localAddress = address;
+}
+
+/*
+ * disconnect() bricht auch einen laufenden Verbindungsaufbau ab, reconnect()
+ * baut die Verbindung danach mit dem neuen Protokoll auf.
+ */
+void NetworkRegistry::setMultipathEnabled(bool enabled)
+{
+    for (int id = 0; id < count(); ++id) {
+        NetworkEntry &network = m_networks[id];
+        if (network.multipath == enabled)
+            continue;
+
+        network.multipath = enabled;
+        network.client->setMultipathEnabled(enabled);
+        network.client->disconnect();
+        reconnect(id);
+    }
+}
+
+void NetworkRegistry::setPolicy(std::unique_ptr<SelectionPolicy> policy)
+{
+    if (!policy)
+        return;
+
+    m_policy = std::move(policy);
+    qDebug() << "Selection-Policy:" << m_policy->name();
+
+    for (NetworkEntry &network : m_networks)
+        network.score = m_policy->score(network);
+    rescan();
+}
+
+/*
+ * Startet auch die Startphase: bestNetworkChanged() bleibt aus, bis alle
+ * Netze ihren ersten Versuch beendet haben oder SettleTimeoutMs abläuft.
+ */
+void NetworkRegistry::connectAll(const QString &clientId)
+{
+    m_clientId = clientId;
+    for (int id = 0; id < count(); ++id)
+        reconnect(id);
+
+    if (!m_settled && !m_settleTimer) {
+        m_settleTimer = TimerWheel::forCurrentThread()->schedule(SettleTimeoutMs, [this]() {
+            m_settleTimer = 0;
+            qDebug() << "Startphase beendet nach Timeout";
+            settle();
+        });
+    }
+}
+
+void NetworkRegistry::startProbing(int intervalMs)
+{
+    TimerWheel *wheel = TimerWheel::forCurrentThread();
+    wheel->cancel(m_probeTimer);
+    m_probeTimer = wheel->scheduleRepeating(intervalMs, [this]() { onProbeTimer(); });
+}
+
+void NetworkRegistry::setLinkUp(int id, bool up)
+{
+    if (id < 0 || id >= count() || m_networks[id].linkUp == up)
+        return;
+
+    m_networks[id].linkUp = up;
+    update(id);
+
+    // Verbindung sofort vorbereiten, damit das Netz beim Failover bereitsteht
+    if (up && !m_networks[id].connected) {
+        TimerWheel::forCurrentThread()->cancel(m_networks[id].reconnectTimer);
+        m_networks[id].reconnectTimer = 0;
+        m_networks[id].reconnectDelayMs = 0;
+        reconnect(id);
+    } else if (!up) {
+        // Ohne Link keine Versuche, ein Netz ohne Link zählt für die Startphase nicht
+        markAttempted(id);
+    }
+}
+
+void NetworkRegistry::setRouteUp(int id, bool up)
+{
+    if (id < 0 || id >= count() || m_networks[id].routeUp == up)
+        return;
+
+    m_networks[id].routeUp = up;
+    update(id);
+}
+
+/**
+ * @brief Sendet eine Probe über jede Verbindung
+ *
+ * Ist die vorige Probe noch unbeantwortet, zählt sie als verloren.
+ */
+void NetworkRegistry::onProbeTimer()
+{
+    for (int id = 0; id < count(); ++id) {
+        NetworkEntry &network = m_networks[id];
+        if (!network.connected)
+            continue;
+
+        if (network.client->isPingPending()) {
+            network.missedProbes++;
+            update(id);
+        }
+        network.client->probe();
+    }
+}
+
+void NetworkRegistry::reconnect(int id)
+{
+    NetworkEntry &network = m_networks[id];
+    if (m_clientId.isEmpty() || network.host.isEmpty() || !network.linkUp || network.client->isConnected())
+        return;
+
+    // Laufenden Aufbau nicht abbrechen - dessen Ende meldet connected() oder connectionError()
+    if (network.client->isConnecting())
+        return;
+
+    network.client->connectToHost(network.host, network.port, m_clientId + "-" + network.name);
+}
+
+/**
+ * @brief Plant nach Trennung oder Fehlschlag den nächsten Versuch
+ *
+ * Der Abstand verdoppelt sich von ReconnectMinMs bis ReconnectMaxMs und
+ * wird mit dem nächsten CONNACK zurückgesetzt. Ohne Link wird nichts
+ * geplant, setLinkUp() verbindet bei Rückkehr sofort.
+ */
+void NetworkRegistry::scheduleReconnect(int id)
+{
+    NetworkEntry &network = m_networks[id];
+    if (m_clientId.isEmpty() || network.host.isEmpty() || !network.linkUp || network.reconnectTimer)
+        return;
+
+    network.reconnectDelayMs = network.reconnectDelayMs <= 0
+        ? ReconnectMinMs
+        : qMin(network.reconnectDelayMs * 2, ReconnectMaxMs);
+
+    qDebug() << "Neuer Verbindungsversuch für" << network.name << "in" << network.reconnectDelayMs << "ms";
+    network.reconnectTimer = TimerWheel::forCurrentThread()->schedule(network.reconnectDelayMs, [this, id]() {
+        m_networks[id].reconnectTimer = 0;
+        reconnect(id);
+    });
+}
+
+/**
+ * @brief Erster Verbindungsversuch eines Netzes ist beendet
+ *
+ * Haben alle Netze mit Link ihren ersten Versuch hinter sich, ist die
+ * Startphase vor dem Timeout abgeschlossen.
+ */
+void NetworkRegistry::markAttempted(int id)
+{
+    m_networks[id].attempted = true;
+    if (m_settled || m_clientId.isEmpty())
+        return;
+
+    for (const NetworkEntry &network : m_networks) {
+        if (!network.attempted && network.linkUp && !network.host.isEmpty())
+            return;
+    }
+    settle();
+}
+
+/**
+ * @brief Beendet die Startphase und meldet das bis dahin beste Netz
+ */
+void NetworkRegistry::settle()
+{
+    if (m_settled)
+        return;
+
+    TimerWheel::forCurrentThread()->cancel(m_settleTimer);
+    m_settleTimer = 0;
+    m_settled = true;
+    qDebug() << "Startphase abgeschlossen, bestes Netz:" << (m_best >= 0 ? m_networks[m_best].name : QString("keines"));
+    emit bestNetworkChanged(m_best);
+}
+
+/**
+ * @brief Inkrementelle Neubewertung eines Netzes
+ *
+ * - Netz wird besser als der Favorit -> neuer Favorit, O(1)
+ * - Favorit selbst wird schlechter   -> rescan(), O(N)
+ * - sonst                             -> keine Änderung, O(1)
+ */
+void NetworkRegistry::update(int id)
+{
+    NetworkEntry &network = m_networks[id];
+    network.health = network.isUsable() ? 1.0 / (1 + network.missedProbes) : 0.0;
+    const double previousScore = network.score;
+    network.score = m_policy->score(network);
+
+    emit networkChanged(id);
+
+    if (id == m_best) {
+        if (!network.isUsable() || network.score > previousScore)
+            rescan();
+        return;
+    }
+
+    if (network.isUsable() && (m_best < 0 || isBetter(id, m_best))) {
+        m_best = id;
+        qDebug() << "Bestes Netz:" << network.name;
+        if (m_settled)
+            emit bestNetworkChanged(m_best);
+    }
+}
+
+void NetworkRegistry::rescan()
+{
+    int best = -1;
+    for (int id = 0; id < count(); ++id) {
+        if (m_networks[id].isUsable() && (best < 0 || isBetter(id, best)))
+            best = id;
+    }
+
+    if (best != m_best) {
+        m_best = best;
+        qDebug() << "Bestes Netz:" << (best >= 0 ? m_networks[best].name : QString("keines"));
+        if (m_settled)
+            emit bestNetworkChanged(m_best);
+    }
+}
+
+bool NetworkRegistry::isBetter(int a, int b) const
+{
+    const double scoreA = m_networks[a].score;
+    const double scoreB = m_networks[b].score;
+    return scoreA < scoreB || (scoreA == scoreB && a < b);
+}
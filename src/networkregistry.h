@@ -0,0 +1,200 @@
+#ifndef NETWORKREGISTRY_H
+#define NETWORKREGISTRY_H
+
+#include "healthsnapshot.h"
+#include "mqttclient.h"
+#include "selectionpolicy.h"
+#include "timerwheel.h"
+
+#include <QObject>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Ein Netz (Uplink) im NetworkRegistry
+ *
+ * Der obere Teil wird beim Anlegen konfiguriert, der untere Teil
+ * (Live-Metriken) wird vom Registry gepflegt.
+ */
+struct NetworkEntry
+{
+    // Konfiguration
+    QString name;                                            ///< Anzeigename (z.B. "secure")
+    QString interfaceName;                                   ///< Interface für rtnetlink-Überwachung (leer = keins)
+    QString host;                                            ///< Broker über dieses Netz
+    quint16 port = 1883;                                     ///< Broker-Port
+    int priority = 0;                                        ///< Rang für PriorityPolicy (kleiner = bevorzugt)
+    double weight = 1.0;                                     ///< Gewicht für WeightedPolicy
+    bool tuneSocketBuffers = false;                          ///< SO_SNDBUF/SO_RCVBUF nach BDP regeln (siehe SocketBufferTuner)
+    int notSentLowWatermark = -1;                            ///< TCP_NOTSENT_LOWAT für latenzkritische Netze (-1 = Kernel-Vorgabe)
+    bool multipath = false;                                  ///< Verbindung als Multipath-TCP aufbauen (siehe MptcpPathManager)
+    QString localAddress;                                    ///< Eigene Adresse auf diesem Uplink, MPTCP-Endpunkt (leer = keiner)
+    std::function<void(int timeoutMs, std::function<void(bool)> done)> activate;  ///< Optional: schaltet das Netz physisch auf (z.B. Umschalter), ruft done genau einmal
+
+    // Live-Metriken
+    MqttClient *client = nullptr;                            ///< Eigene Broker-Verbindung über dieses Netz
+    bool linkUp = true;                                      ///< Link laut rtnetlink vorhanden
+    bool routeUp = true;                                     ///< Default-Route laut rtnetlink vorhanden
+    bool connected = false;                                  ///< MQTT-Sitzung aktiv (CONNACK empfangen)
+    double rttMs = -1.0;                                     ///< Geglättete Round-Trip-Zeit (-1 = unbekannt)
+    RttWindow rttWindow;                                     ///< Letzte Round-Trip-Zeiten für Perzentile
+    int missedProbes = 0;                                    ///< Aufeinanderfolgende unbeantwortete Proben
+    double health = 0.0;                                     ///< Gesundheitswert 0..1
+    double score = 0.0;                                      ///< Letzte Bewertung der aktiven Policy
+    bool attempted = false;                                  ///< Erster Verbindungsversuch abgeschlossen (Erfolg oder Fehler)
+    int reconnectDelayMs = 0;                                ///< Wartezeit vor dem nächsten Verbindungsversuch (0 = sofort)
+    TimerWheel::TimerId reconnectTimer = 0;                  ///< Geplanter Verbindungsversuch (0 = keiner)
+
+    /// Nutzbar, wenn Link, Route und Sitzung stehen und die Proben beantwortet werden
+    bool isUsable() const { return linkUp && routeUp && connected && missedProbes < 3; }
+};
+
+/**
+ * @brief Verwaltet beliebig viele Netze mit eigener Verbindung und Messprobe
+ *
+ * Jedes Netz erhält einen eigenen MqttClient. Ein gemeinsamer Probe-Timer
+ * sendet periodisch PINGREQs über alle Verbindungen und pflegt RTT und
+ * Gesundheitswert.
+ *
+ * Die Wahl des besten Netzes erfolgt über eine austauschbare SelectionPolicy
+ * und wird inkrementell berechnet: jede Metrik-Änderung bewertet nur das
+ * betroffene Netz neu und vergleicht es mit dem aktuellen Favoriten (O(1)).
+ * Nur wenn sich der Favorit selbst verschlechtert, werden alle Netze neu
+ * verglichen (O(N), bei einer Handvoll Uplinks vernachlässigbar).
+ *
+ * bestNetworkChanged() wird erst gemeldet, wenn der Start abgeschlossen
+ * ist: Jedes Netz hat seinen ersten Verbindungsversuch beendet oder
+ * SettleTimeoutMs ist abgelaufen. Sonst würde das Netz mit dem schnellsten
+ * CONNACK kurz zum Favoriten und das Umschaltgerät unnötig hin und her
+ * geschaltet.
+ *
+ * Getrennte Verbindungen werden mit exponentiell wachsendem Abstand
+ * (ReconnectMinMs bis ReconnectMaxMs) neu aufgebaut, solange der Link steht.
+ */
+class NetworkRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SettleTimeoutMs = 5000;             ///< Höchste Wartezeit auf die ersten Verbindungsversuche
+    static constexpr int ReconnectMinMs = 500;               ///< Erster Abstand nach einer Trennung
+    static constexpr int ReconnectMaxMs = 30000;             ///< Obergrenze des Abstands
+
+    /**
+     * @brief Konstruktor - verwendet standardmäßig die PriorityPolicy
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     */
+    explicit NetworkRegistry(QObject *parent = nullptr);
+    ~NetworkRegistry() override;
+
+    /**
+     * @brief Registriert ein Netz und erstellt dessen Verbindung
+     * @param config Konfiguration (Live-Metriken werden ignoriert)
+     * @return ID des Netzes (fortlaufend ab 0)
+     */
+    int addNetwork(const NetworkEntry &config);
+
+    /// Anzahl registrierter Netze
+    int count() const { return (int)m_networks.size(); }
+
+    /// Zugriff auf ein Netz
+    const NetworkEntry& network(int id) const { return m_networks[id]; }
+
+    /**
+     * @brief Sucht das Netz zu einem Interface-Namen
+     * @return ID oder -1
+     */
+    int networkForInterface(const QString &interfaceName) const;
+
+    /// Ordnet einem Netz nachträglich sein Interface zu
+    void setInterface(int id, const QString &interfaceName);
+
+    /// Ordnet einem Netz nachträglich seine lokale Adresse zu
+    void setLocalAddress(int id, const QString &address);
+
+    /**
+     * @brief Schaltet Multipath-TCP für alle Verbindungen um
+     *
+     * Bestehende Verbindungen werden getrennt und sofort neu aufgebaut,
+     * da sich das Protokoll eines Sockets nicht nachträglich ändern lässt.
+     */
+    void setMultipathEnabled(bool enabled);
+
+    /**
+     * @brief Tauscht die Selection-Policy aus
+     *
+     * Alle Netze werden mit der neuen Policy neu bewertet.
+     */
+    void setPolicy(std::unique_ptr<SelectionPolicy> policy);
+
+    /// Aktuell bestes nutzbares Netz (-1 wenn keines nutzbar)
+    int bestNetwork() const { return m_best; }
+
+    /// true wenn der Start abgeschlossen ist und bestNetworkChanged() gemeldet wird
+    bool isSettled() const { return m_settled; }
+
+    /**
+     * @brief Baut die Verbindungen aller Netze auf
+     * @param clientId Basis-Client-ID, pro Netz wird "-<name>" angehängt
+     */
+    void connectAll(const QString &clientId);
+
+    /**
+     * @brief Startet die periodischen Messproben
+     * @param intervalMs Abstand der Proben in Millisekunden
+     */
+    void startProbing(int intervalMs = 2000);
+
+    /// Link-Zustand aus rtnetlink übernehmen (verbindet bei Rückkehr sofort neu)
+    void setLinkUp(int id, bool up);
+
+    /// Zustand der Default-Route aus rtnetlink übernehmen
+    void setRouteUp(int id, bool up);
+
+signals:
+    /**
+     * @brief Das beste Netz hat gewechselt
+     * @param id Neues bestes Netz oder -1 wenn keines nutzbar ist
+     *
+     * Beim Abschluss des Starts einmal mit dem dann besten Netz.
+     */
+    void bestNetworkChanged(int id);
+
+    /// Metriken oder Zustand eines Netzes haben sich geändert
+    void networkChanged(int id);
+
+    /// Verbindung eines Netzes ist hergestellt
+    void networkConnected(int id);
+
+private:
+    void onProbeTimer();
+    void reconnect(int id);
+    void scheduleReconnect(int id);
+    void markAttempted(int id);
+    void settle();
+
+    /**
+     * @brief Bewertet ein Netz neu und aktualisiert den Favoriten
+     *
+     * Kernstück der inkrementellen Auswahl.
+     */
+    void update(int id);
+
+    /// Vergleicht alle Netze (nur wenn der Favorit schlechter wird)
+    void rescan();
+
+    /// true wenn Netz a besser als Netz b ist (Gleichstand: kleinere ID gewinnt)
+    bool isBetter(int a, int b) const;
+
+    std::vector<NetworkEntry> m_networks;                    ///< Alle Netze, Index = ID
+    std::unique_ptr<SelectionPolicy> m_policy;               ///< Aktive Auswahl-Strategie
+    TimerWheel::TimerId m_probeTimer;                        ///< Gemeinsamer Timer für alle Messproben (Timer-Rad)
+    TimerWheel::TimerId m_settleTimer;                       ///< Ende der Startphase (0 = keins)
+    QString m_clientId;                                      ///< Basis-Client-ID
+    int m_best;                                              ///< Aktuell bestes Netz (-1 = keines)
+    bool m_settled;                                          ///< Startphase abgeschlossen
+};
+
+#endif // NETWORKREGISTRY_H
@@ -1,54 +1,842 @@
 #include "networkselector.h"
+#include "messageenvelope.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QEventLoop>
+#include <cstring>
+#include <iostream>
 
 /*
  *
  */
 NetworkSelector::NetworkSelector()
 {
+    m_uptime.start();
 
     // Mqtt
     QString host     = "localhost";
     quint16 port     = 1883;
-    QString clientId = "NetworkSwitch";
+    m_clientId       = "NetworkSwitch";
+
+    // Zustandsautomat für das Umschaltgerät
+    m_switchController = new SwitchController(this);
+    m_switchController->setTargetName(Secure,   "secure");
+    m_switchController->setTargetName(Unsecure, "unsecure");
+    m_switchController->setCommandSender([this](const SwitchController::Command &command) { return sendSwitchCommand(command); });
+
+    // Netze des Umschalters - jedes Netz hat eine eigene Broker-Verbindung
+    m_registry = new NetworkRegistry(this);
+    connect(m_registry, &NetworkRegistry::networkConnected,   this, &NetworkSelector::onMqttConnected);
+    connect(m_registry, &NetworkRegistry::bestNetworkChanged, this, &NetworkSelector::onBestNetworkChanged);
+    connect(m_registry, &NetworkRegistry::networkChanged,     this, &NetworkSelector::publishHealth);
+    connect(m_registry, &NetworkRegistry::bestNetworkChanged, this, &NetworkSelector::publishHealth);
+
+    NetworkEntry secure;
+    secure.name     = "secure";
+    secure.host     = host;
+    secure.port     = port;
+    secure.priority = 0;
+    secure.activate = [this](int timeoutMs, std::function<void(bool)> done) { requestDeviceSwitch(Secure, timeoutMs, done); };
+    m_registry->addNetwork(secure);
+
+    NetworkEntry unsecure;
+    unsecure.name     = "unsecure";
+    unsecure.host     = host;
+    unsecure.port     = port;
+    unsecure.priority = 1;
+    unsecure.activate = [this](int timeoutMs, std::function<void(bool)> done) { requestDeviceSwitch(Unsecure, timeoutMs, done); };
+    m_registry->addNetwork(unsecure);
+
+    // Gemeinsamer Tracker - während eines Netzwechsels empfangen zwei Verbindungen dieselben Nachrichten
+    m_sequenceTracker = std::make_shared<SequenceTracker>();
+    for (int id = 0; id < m_registry->count(); ++id)
+        watchClient(id);
+
+    // Gemeinsame Schlüssel für alle Verbindungen - eine Nonce-Folge pro Schlüssel
+    m_payloadCipher = std::make_shared<PayloadCipher>();
+    for (int id = 0; id < m_registry->count(); ++id)
+        m_registry->network(id).client->setPayloadCipher(m_payloadCipher);
+
+    // Letzte Werte aller Verbindungen (Grundlage für Snapshots)
+    for (int id = 0; id < m_registry->count(); ++id)
+        m_registry->network(id).client->setLastValueCache(&m_lastValues);
 
-    m_mqttClient = new MqttClient(this);
-    connect(m_mqttClient, &MqttClient::connected, this, &NetworkSelector::onMqttConnected);
-    connect(m_mqttClient, &MqttClient::error,     this, &NetworkSelector::onMqttError);
-    m_mqttClient->connectToHost(host, port, clientId);
+    m_registry->connectAll(m_clientId);
+    m_registry->startProbing();
 
+    // Link-Überwachung (rtnetlink)
+    m_linkMonitor = new LinkMonitor(this);
+    connect(m_linkMonitor, &LinkMonitor::linkChanged,  this, &NetworkSelector::onLinkChanged);
+    connect(m_linkMonitor, &LinkMonitor::routeChanged, this, &NetworkSelector::onRouteChanged);
+    connect(m_linkMonitor, &LinkMonitor::error,        this, &NetworkSelector::onMqttError);
+
+    publishHealth();
 }
 
 NetworkSelector::~NetworkSelector()
 {
-    delete m_mqttClient;
+    TimerWheel::forCurrentThread()->cancel(m_snapshotTimer);
+    TimerWheel::forCurrentThread()->cancel(m_handoverTimer);
+    if (!m_snapshotPath.isEmpty())
+        writeSnapshot();
+
+    delete m_linkMonitor;
+    disconnect(m_registry, nullptr, this, nullptr);
+    delete m_registry;
+    delete m_switchController;
 }
 
-void NetworkSelector::onMqttConnected()
+/*
+ * Nachrichten werden nur über die Verbindung des aktiven Netzes abonniert,
+ * die übrigen Verbindungen dienen als Messprobe und Reserve.
+ * Zustandsmeldungen des Umschalters werden auf allen Verbindungen
+ * empfangen, da die Bestätigung über jedes Netz eintreffen kann.
+ */
+void NetworkSelector::onMqttConnected(int network)
 {
-    qDebug() << "ERFOLGREICH VERBUNDEN!";
-    if (m_mqttClient->isConnected())
-    {
-        m_mqttClient->subscribe("message/new", [this](const QByteArray &msg) {
-            std::cout << QString(msg) << std::endl;
-        });
-        m_mqttClient->subscribe("message/err", [this](const QByteArray &msg) {
-            std::cout << QString(msg) << std::endl;
-        });
+    qDebug() << "ERFOLGREICH VERBUNDEN!" << m_registry->network(network).name;
+    MqttClient *client = m_registry->network(network).client;
+    if (!client->isConnected())
+        return;
+
+    client->subscribe(SwitchController::StateTopic, [this](const QByteArray &msg) {
+        markUseful(true);
+        m_switchController->handleStateMessage(msg);
+    });
+
+    if (network == m_activeNetwork)
+        subscribeMessageTopics(network);
+    restoreSubscriptions(network);
+}
+
+/*
+ * Nur die Nachrichten-Topics des aktiven Netzes - beim Verbindungsaufbau
+ * und beim Wechsel auf ein bereits verbundenes Netz.
+ */
+void NetworkSelector::subscribeMessageTopics(int network)
+{
+    MqttClient *client = m_registry->network(network).client;
+    client->subscribe("message/new", [this, network](const QByteArray &msg) {
+        deliverMessage(network, "message/new", msg);
+    });
+    client->subscribe("message/err", [this, network](const QByteArray &msg) {
+        deliverMessage(network, "message/err", msg);
+    });
+
+    // Altes Netz bleibt abonniert, bis der Broker das neue bestätigt hat
+    if (m_handoverFrom >= 0) {
+        m_handoverPending.clear();
+        m_handoverPending.insert("message/new");
+        m_handoverPending.insert("message/err");
+    }
+}
+
+/*
+ * Abonnements aus dem Snapshot einmalig nachholen (ohne Handler, Werte
+ * gehen in den Cache).
+ */
+void NetworkSelector::restoreSubscriptions(int network)
+{
+    MqttClient *client = m_registry->network(network).client;
+    const QMap<QString, quint8> current = client->subscriptions();
+    for (int i = m_restoredSubscriptions.size() - 1; i >= 0; --i) {
+        const ClientSnapshot::Subscription &subscription = m_restoredSubscriptions.at(i);
+        if (subscription.network != network)
+            continue;
+        if (!current.contains(subscription.topic))
+            client->subscribe(subscription.topic, subscription.qos);
+        m_restoredSubscriptions.removeAt(i);
     }
 }
 
+/*
+ * Ein vorhandener Snapshot wird sofort eingeblendet: letzte Werte stehen
+ * ohne Verbindung zur Verfügung, das zuletzt aktive Netz wird übernommen
+ * und dessen Abonnements beim Verbindungsaufbau nachgeholt.
+ */
+void NetworkSelector::enableSnapshots(const QString &path, int intervalMs)
+{
+    TimerWheel *wheel = TimerWheel::forCurrentThread();
+    wheel->cancel(m_snapshotTimer);
+    m_snapshotTimer = 0;
+    m_snapshotPath = path;
+    if (path.isEmpty())
+        return;
+
+    restoreSnapshot();
+    if (intervalMs > 0)
+        m_snapshotTimer = wheel->scheduleRepeating(intervalMs, [this]() { writeSnapshot(); });
+}
+
+/*
+ * Der zwischengespeicherte Gerätezustand wird nur zum Lesen angeboten und
+ * nicht an den SwitchController gegeben - ein veralteter Zustand könnte
+ * sonst einen nötigen Umschaltbefehl unterdrücken.
+ */
+void NetworkSelector::restoreSnapshot()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    auto snapshot = std::make_shared<ClientSnapshot>();
+    QString error;
+    if (!snapshot->open(m_snapshotPath, &error)) {
+        qDebug() << "Kein Snapshot geladen:" << error;
+        return;
+    }
+
+    const ClientSnapshot::Session session = snapshot->session();
+    bool connected = false;
+    for (int id = 0; id < m_registry->count(); ++id)
+        connected = connected || m_registry->network(id).client->isConnected();
+    if (!connected && session.activeNetwork >= 0 && session.activeNetwork < m_registry->count())
+        m_activeNetwork = session.activeNetwork;
+
+    m_restoredSubscriptions = snapshot->subscriptions();
+    m_lastValues.setSnapshot(snapshot);
+
+    qDebug() << "Snapshot geladen:" << snapshot->valueCount() << "Werte," << m_restoredSubscriptions.size()
+             << "Abonnements," << snapshot->size() << "Bytes in" << timer.nsecsElapsed() / 1000 << "us";
+
+    if (m_lastValues.contains(SwitchController::StateTopic))
+        markUseful(false);
+
+    // Bereits verbundene Netze sofort nachziehen - deren übrige Abonnements bestehen schon
+    for (int id = 0; id < m_registry->count(); ++id) {
+        if (m_registry->network(id).client->isConnected())
+            restoreSubscriptions(id);
+    }
+}
+
+/*
+ * Schreibt Sitzung, Abonnements des aktiven Netzes und letzte Werte.
+ * Topics aus dem alten Snapshot ohne neuen Wert bleiben erhalten.
+ *
+ * Während eines Netzwechsels sind Abonnements auf beiden Netzen offen;
+ * ein Snapshot davon würde sie nach dem Neustart auch auf dem alten Netz
+ * wiederherstellen. Geschrieben wird dann erst nach finishHandover().
+ */
+bool NetworkSelector::writeSnapshot()
+{
+    if (m_snapshotPath.isEmpty())
+        return false;
+
+    if (m_handoverFrom >= 0) {
+        qDebug() << "Snapshot zurückgestellt - Netzwechsel läuft";
+        return false;
+    }
+
+    ClientSnapshot::Session session;
+    session.clientId = m_clientId;
+    session.activeNetwork = m_activeNetwork;
+    session.createdMs = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<ClientSnapshot::Subscription> subscriptions;
+    for (const ClientSnapshot::Subscription &restored : m_restoredSubscriptions) {
+        if (restored.network == m_activeNetwork)
+            subscriptions.append(restored);
+    }
+    if (m_activeNetwork >= 0 && m_activeNetwork < m_registry->count()) {
+        const QMap<QString, quint8> current = m_registry->network(m_activeNetwork).client->subscriptions();
+        for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+            ClientSnapshot::Subscription subscription;
+            subscription.topic = it.key();
+            subscription.qos = it.value();
+            subscription.network = m_activeNetwork;
+            subscriptions.append(subscription);
+        }
+    }
+
+    QString error;
+    if (!ClientSnapshot::write(m_snapshotPath, session, subscriptions, m_lastValues.collect(), &error)) {
+        onMqttError(error);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Misst die Zeit bis zum bekannten Gerätezustand - zuerst aus dem
+ * Snapshot, dann mit der ersten Live-Meldung.
+ */
+void NetworkSelector::markUseful(bool live)
+{
+    const qint64 elapsedMs = m_uptime.elapsed();
+    if (m_timeToUsefulMs < 0) {
+        m_timeToUsefulMs = elapsedMs;
+        qDebug() << "Gerätezustand bekannt nach" << elapsedMs << "ms" << (live ? "(live)" : "(Snapshot)");
+    }
+    if (live && m_timeToLiveMs < 0) {
+        m_timeToLiveMs = elapsedMs;
+        qDebug() << "Erste Live-Zustandsmeldung nach" << elapsedMs << "ms";
+    }
+}
+
+/*
+ * Verbindet die Signale eines Clients und teilt den Sequenz-Tracker.
+ * Der Tracker erkennt Duplikate nur bei Topics mit Umschlag
+ * (setTopicEnvelope()), alle übrigen führt deliverMessage() zusammen.
+ */
+void NetworkSelector::watchClient(int network)
+{
+    MqttClient *client = m_registry->network(network).client;
+    connect(client, &MqttClient::error, this, &NetworkSelector::onMqttError);
+    connect(client, &MqttClient::subscriptionAcknowledged, this, [this, network](const QString &topic, bool granted) {
+        if (granted)
+            onSubscriptionAcknowledged(network, topic);
+    });
+    client->setSequenceTracker(m_sequenceTracker);
+    client->setDropDuplicates(true);
+}
+
+/*
+ * Während der Überlappung liefern altes und neues Netz dieselben
+ * Nachrichten. Die Publisher setzen keinen Umschlag, daher werden die
+ * beiden Ströme über den Inhalt zusammengeführt (MessageDeduplicator):
+ * eine Nachricht, die ein Netz bereits geliefert hat, wird vom anderen
+ * verworfen. Gleicher Inhalt vom selben Netz bleibt eine neue Nachricht.
+ */
+void NetworkSelector::deliverMessage(int network, const QString &topic, const QByteArray &message)
+{
+    if (m_handoverFrom >= 0 && (network == m_handoverFrom || network == m_activeNetwork)
+        && !m_handoverDedup.accept(network == m_activeNetwork ? 1 : 0, topic, message))
+        return;
+
+    std::cout << message.toStdString() << std::endl;
+}
+
+void NetworkSelector::onSubscriptionAcknowledged(int network, const QString &topic)
+{
+    if (m_handoverFrom < 0 || network != m_activeNetwork || !m_handoverPending.contains(topic))
+        return;
+    m_handoverPending.remove(topic);
+    if (m_handoverPending.isEmpty())
+        finishHandover();
+}
+
+/*
+ * Meldet die Nachrichten-Topics am vorherigen Netz ab. Bis hierhin haben
+ * beide Verbindungen zugestellt; bereits gesendete Pakete der alten
+ * Verbindung laufen weiter ab, da sie nicht getrennt wird.
+ */
+void NetworkSelector::finishHandover()
+{
+    TimerWheel::forCurrentThread()->cancel(m_handoverTimer);
+    m_handoverTimer = 0;
+    m_handoverPending.clear();
+    m_handoverDedup.clear();
+
+    const int previous = m_handoverFrom;
+    m_handoverFrom = -1;
+    if (previous < 0 || previous == m_activeNetwork)
+        return;
+
+    MqttClient *previousClient = m_registry->network(previous).client;
+    if (previousClient->isConnected()) {
+        previousClient->unsubscribe("message/new");
+        previousClient->unsubscribe("message/err");
+    }
+
+    m_lastHandoverUs = ((qint64)MessageEnvelope::monotonicNs() - m_handoverStartNs) / 1000;
+    qDebug() << "Netzwechsel abgeschlossen:" << m_registry->network(previous).name << "->"
+             << m_registry->network(m_activeNetwork).name << "in" << m_lastHandoverUs << "us";
+
+    // Während des Wechsels zurückgestellten Snapshot nachholen
+    if (!m_snapshotPath.isEmpty())
+        writeSnapshot();
+}
+
 void NetworkSelector::onMqttError(const QString &error)
 {
     qDebug() << "MQTT Fehler: " << error;
 }
 
+/*
+ * Registriert einen weiteren Uplink. Das Registry verbindet ihn sofort,
+ * da connectAll() bereits im Konstruktor aufgerufen wurde.
+ */
+int NetworkSelector::addNetwork(const NetworkEntry &config)
+{
+    int id = m_registry->addNetwork(config);
+    MqttClient *client = m_registry->network(id).client;
+    watchClient(id);
+    client->setPayloadChecksum(SwitchController::CommandTopic, m_commandChecksum);
+    client->setPayloadChecksum(SwitchController::StateTopic, m_commandChecksum);
+    client->setPayloadCipher(m_payloadCipher);
+    client->setLastValueCache(&m_lastValues);
+
+    if (!config.interfaceName.isEmpty())
+        setNetworkInterface(id, config.interfaceName);
+    return id;
+}
+
+/*
+ * Schützt Befehle und Bestätigungen auf allen Verbindungen, auch auf
+ * Pfaden ohne TLS. Beschädigte Zustandsmeldungen werden verworfen und
+ * führen damit zum Timeout statt zu einem falschen Zustand.
+ */
+void NetworkSelector::setCommandChecksumEnabled(bool enabled)
+{
+    m_commandChecksum = enabled;
+    for (int id = 0; id < m_registry->count(); ++id) {
+        MqttClient *client = m_registry->network(id).client;
+        client->setPayloadChecksum(SwitchController::CommandTopic, enabled);
+        client->setPayloadChecksum(SwitchController::StateTopic, enabled);
+    }
+}
+
+/*
+ * Verschlüsselt ein Topic über alle Netze, damit auch ein nicht
+ * vertrauenswürdiger Broker die Inhalte weder lesen noch verändern kann.
+ * Beim Wechsel bleibt der vorherige Schlüssel zum Empfang gültig,
+ * bis retirePreviousPayloadKey() aufgerufen wird.
+ */
+bool NetworkSelector::setPayloadKey(const QString &topic, quint32 keyId, const QByteArray &key)
+{
+    return m_payloadCipher->setKey(topic, keyId, key);
+}
+
+void NetworkSelector::retirePreviousPayloadKey(const QString &topic)
+{
+    m_payloadCipher->retirePreviousKey(topic);
+}
+
+void NetworkSelector::removePayloadKey(const QString &topic)
+{
+    m_payloadCipher->removeTopic(topic);
+}
+
+void NetworkSelector::setSelectionPolicy(std::unique_ptr<SelectionPolicy> policy)
+{
+    m_registry->setPolicy(std::move(policy));
+}
+
+/*
+ * Ordnet einem Netz das Interface zu, über das es erreicht wird.
+ * Der LinkMonitor wird beim ersten Interface gestartet.
+ */
+void NetworkSelector::setNetworkInterface(int network, const QString &interfaceName)
+{
+    if (network < 0 || network >= m_registry->count())
+        return;
+
+    m_registry->setInterface(network, interfaceName);
+
+    if (!interfaceName.isEmpty() && !m_linkMonitor->isRunning())
+        m_linkMonitor->start();
+}
+
+/*
+ * Lokale Adresse eines Netzes für Multipath-TCP. Muss vor enableMultipath()
+ * gesetzt sein, spätere Änderungen erreichen den Pfadmanager nicht.
+ */
+void NetworkSelector::setNetworkLocalAddress(int network, const QString &address)
+{
+    m_registry->setLocalAddress(network, address);
+}
+
+/*
+ * Eine Broker-Sitzung über alle Uplinks: Jedes Netz mit lokaler Adresse
+ * wird Endpunkt des Kernel-Pfadmanagers, das aktive sendet, die übrigen
+ * sind Reserve. Fällt das aktive Netz weg, trägt ein Reserve-Subflow
+ * dieselbe TCP-Verbindung weiter - ohne Neuaufbau und erneutes Abonnieren.
+ * Bereits vorhandene Endpunkte (ip mptcp endpoint) werden übernommen,
+ * die Grenzen des Pfadmanagers gelten für den ganzen Namespace.
+ */
+bool NetworkSelector::enableMultipath(QString *errorString)
+{
+    if (!MptcpPathManager::isSupported()) {
+        if (errorString)
+            *errorString = "Kernel bietet kein MPTCP an (net.mptcp.enabled?)";
+        return false;
+    }
+    if (!m_pathManager.open(errorString))
+        return false;
+
+    int endpoints = 0;
+    for (int id = 0; id < m_registry->count(); ++id) {
+        if (!m_registry->network(id).localAddress.isEmpty())
+            endpoints++;
+    }
+    const int limit = qMin(endpoints, 8);
+    if (!m_pathManager.setLimits(limit, limit, errorString)) {
+        m_pathManager.close();
+        return false;
+    }
+
+    for (int id = 0; id < m_registry->count(); ++id) {
+        const NetworkEntry &entry = m_registry->network(id);
+        if (entry.localAddress.isEmpty())
+            continue;
+        if (!entry.linkUp || !entry.routeUp) {
+            m_withdrawnSubflows.insert(id);
+            continue;
+        }
+
+        // Vorhandene Endpunkte übernehmen, sonst anlegen
+        const bool ok = m_pathManager.endpoint(entry.localAddress, nullptr)
+            ? m_pathManager.setBackup(entry.localAddress, id != m_activeNetwork, errorString)
+            : addSubflowEndpoint(id, errorString);
+        if (!ok) {
+            m_pathManager.close();
+            m_withdrawnSubflows.clear();
+            return false;
+        }
+    }
+
+    m_registry->setMultipathEnabled(true);
+    qDebug() << "Multipath-TCP aktiv über" << endpoints << "Netze";
+    return true;
+}
+
+bool NetworkSelector::setSubflowActive(int network, bool active, QString *errorString)
+{
+    if (!m_pathManager.isOpen()) {
+        if (errorString)
+            *errorString = "Multipath-TCP ist nicht aktiv";
+        return false;
+    }
+    if (network < 0 || network >= m_registry->count() || m_registry->network(network).localAddress.isEmpty()) {
+        if (errorString)
+            *errorString = "Netz ohne lokale Adresse";
+        return false;
+    }
+    return m_pathManager.setBackup(m_registry->network(network).localAddress, !active, errorString);
+}
+
+/*
+ * Subflows von der Adresse des Netzes, außer für das aktive nur als Reserve
+ */
+bool NetworkSelector::addSubflowEndpoint(int network, QString *errorString)
+{
+    const NetworkEntry &entry = m_registry->network(network);
+    int flags = MptcpPathManager::Subflow;
+    if (network != m_activeNetwork)
+        flags |= MptcpPathManager::Backup;
+    return m_pathManager.addEndpoint(entry.localAddress, entry.interfaceName, flags, errorString);
+}
+
+/*
+ * Erst das neue Netz aktiv schalten, dann die übrigen zur Reserve - so
+ * gibt es keinen Moment ohne aktiven Subflow. Zurückgezogene Netze haben
+ * keinen Endpunkt und erhalten die Rolle bei restoreSubflows().
+ */
+void NetworkSelector::updateSubflowPriorities()
+{
+    QString errorString;
+    if (!m_registry->network(m_activeNetwork).localAddress.isEmpty() && !m_withdrawnSubflows.contains(m_activeNetwork)
+        && !setSubflowActive(m_activeNetwork, true, &errorString))
+        onMqttError(errorString);
+
+    for (int id = 0; id < m_registry->count(); ++id) {
+        if (id == m_activeNetwork || m_registry->network(id).localAddress.isEmpty() || m_withdrawnSubflows.contains(id))
+            continue;
+        if (!setSubflowActive(id, false, &errorString))
+            onMqttError(errorString);
+    }
+}
+
+/*
+ * Uplink weg: Endpunkt sofort zurückziehen. Der Kernel schließt die
+ * Subflows und meldet das dem Broker per REMOVE_ADDR über die übrigen -
+ * beide Seiten senden ab dann über die Reserve. Im Namespace gemessen:
+ * unter 25 ms Stillstand, ohne Zurückziehen rund 250 ms (Erkennung per
+ * RTO), mit nur umgeschaltetem Backup-Flag bis über 1 s - der Broker
+ * bedient den toten Subflow dann weiter als aktiven.
+ */
+void NetworkSelector::withdrawSubflows(int network)
+{
+    if (!m_pathManager.isOpen() || m_registry->network(network).localAddress.isEmpty()
+        || m_withdrawnSubflows.contains(network))
+        return;
+
+    QString errorString;
+    if (!m_pathManager.removeEndpoint(m_registry->network(network).localAddress, &errorString))
+        onMqttError(errorString);
+    m_withdrawnSubflows.insert(network);
+}
+
+/*
+ * Uplink zurück: Der Kernel baut für bestehende Verbindungen sofort
+ * wieder einen Subflow über die Adresse auf.
+ */
+void NetworkSelector::restoreSubflows(int network)
+{
+    if (!m_pathManager.isOpen() || !m_withdrawnSubflows.contains(network))
+        return;
+
+    const NetworkEntry &entry = m_registry->network(network);
+    if (!entry.linkUp || !entry.routeUp)
+        return;
+
+    QString errorString;
+    if (!addSubflowEndpoint(network, &errorString)) {
+        onMqttError(errorString);
+        return;
+    }
+    m_withdrawnSubflows.remove(network);
+}
+
+void NetworkSelector::onLinkChanged(const QString &interfaceName, bool up)
+{
+    int network = m_registry->networkForInterface(interfaceName);
+    if (network < 0)
+        return;
+
+    qDebug() << "Netz" << (up ? "verfügbar:" : "verloren:") << m_registry->network(network).name;
+    if (up) {
+        emit networkAvailable(network);
+    } else {
+        withdrawSubflows(network);
+        emit networkLost(network);
+    }
+
+    // Registry bewertet neu und baut bei Rückkehr die Verbindung sofort auf
+    m_registry->setLinkUp(network, up);
+    if (up)
+        restoreSubflows(network);
+}
+
+void NetworkSelector::onRouteChanged(const QString &interfaceName, bool added)
+{
+    int network = m_registry->networkForInterface(interfaceName);
+    if (network < 0)
+        return;
+
+    // Ohne Default-Route ist das Netz nicht nutzbar, auch wenn der Link steht
+    if (!added) {
+        withdrawSubflows(network);
+        emit networkLost(network);
+    }
+    m_registry->setRouteUp(network, added);
+    if (added)
+        restoreSubflows(network);
+}
+
+/*
+ * Sofortiges Failover, sobald die Policy ein anderes Netz bevorzugt -
+ * ohne auf Socket-Fehler oder Keep-Alive zu warten. Das Registry meldet
+ * erst nach seiner Startphase, der erste Aufruf gleicht das Gerät mit
+ * dem dann besten Netz ab.
+ */
+void NetworkSelector::onBestNetworkChanged(int network)
+{
+    if (network < 0) {
+        qDebug() << "Kein nutzbares Netz verfügbar";
+        return;
+    }
+
+    if (network == m_activeNetwork)
+        return;
+
+    QString name = m_registry->network(network).name;
+    switchToAsync(network, 10000, [name](bool success) {
+        qDebug() << (success ? "Umgeschaltet auf" : "Umschalten fehlgeschlagen:") << name;
+    });
+}
+
+/*
+ * Schaltet das Netz über seinen activate-Hook auf (z.B. den Umschalter)
+ * und übernimmt danach dessen Verbindung für die Abonnements.
+ */
+void NetworkSelector::switchToAsync(int network, int timeoutMs, std::function<void(bool)> done)
+{
+    if (network < 0 || network >= m_registry->count()) {
+        done(false);
+        return;
+    }
+
+    const NetworkEntry &entry = m_registry->network(network);
+    if (!entry.activate) {
+        makeActive(network);
+        done(true);
+        return;
+    }
+
+    const int from = m_activeNetwork;
+    const qint64 startNs = (qint64)MessageEnvelope::monotonicNs();
+    entry.activate(timeoutMs, [this, network, from, startNs, done](bool success) {
+        const qint64 nowNs = (qint64)MessageEnvelope::monotonicNs();
+        m_switchCount++;
+        m_lastSwitchFrom = from;
+        m_lastSwitchTo = network;
+        m_lastSwitchNs = nowNs;
+        m_lastSwitchDurationNs = nowNs - startNs;
+        m_lastSwitchSucceeded = success;
+
+        if (success)
+            makeActive(network);
+        publishHealth();
+        done(success);
+    });
+}
+
+/*
+ * Blockierende Variante - wartet in einer lokalen Event-Loop auf das Ergebnis
+ */
+bool NetworkSelector::switchTo(int network, int timeoutMs)
+{
+    // Aus einem Handler heraus würde die Bestätigung erst nach dessen Rückkehr
+    // gelesen - die Event-Loop liefe bis zum Timeout ins Leere
+    for (int i = 0; i < m_registry->count(); ++i) {
+        const MqttClient *client = m_registry->network(i).client;
+        if (client && client->isDispatching()) {
+            Q_ASSERT_X(false, "NetworkSelector::switchTo", "blockierender Aufruf aus einem Topic-Handler");
+            qDebug() << "switchTo() aus einem Topic-Handler aufgerufen - switchToAsync() verwenden";
+            return false;
+        }
+    }
+
+    bool finished = false;
+    bool result = false;
+    QEventLoop loop;
+
+    switchToAsync(network, timeoutMs, [&](bool success) {
+        result = success;
+        finished = true;
+        loop.quit();
+    });
+
+    if (!finished)
+        loop.exec();
+    return result;
+}
+
+void NetworkSelector::makeActive(int network)
+{
+    int previous = m_activeNetwork;
+    m_activeNetwork = network;
+    if (previous == network)
+        return;
+
+    // Make-before-break: erst das neue Netz abonnieren, das alte erst nach dessen SUBACK
+    // abmelden (finishHandover). Eine noch laufende Übergabe wird vorher abgeschlossen.
+    if (m_handoverFrom >= 0)
+        finishHandover();
+    m_handoverFrom = previous;
+    m_handoverStartNs = (qint64)MessageEnvelope::monotonicNs();
+
+    // Auch ohne Verbindung des neuen Netzes begrenzen - sonst bliebe die
+    // Übergabe (und damit jeder Snapshot) dauerhaft offen
+    if (m_handoverFrom >= 0) {
+        TimerWheel *wheel = TimerWheel::forCurrentThread();
+        wheel->cancel(m_handoverTimer);
+        m_handoverTimer = wheel->schedule(HandoverTimeoutMs, [this]() {
+            m_handoverTimer = 0;
+            qDebug() << "Netzwechsel: keine Bestätigung des neuen Netzes, altes wird abgemeldet";
+            finishHandover();
+        });
+    }
+
+    if (m_pathManager.isOpen())
+        updateSubflowPriorities();
+
+    if (m_registry->network(network).client->isConnected())
+        subscribeMessageTopics(network);
+    publishHealth();
+    emit activeNetworkChanged(network);
+}
+
+/*
+ * Baut die Momentaufnahme aus Registry und Umschaltzeiten auf. Läuft bei
+ * jeder Metrik-Änderung im I/O-Thread und kostet nur das Kopieren
+ * weniger hundert Bytes sowie das Sortieren der RTT-Fenster.
+ */
+void NetworkSelector::publishHealth()
+{
+    HealthSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.publishedNs = (qint64)MessageEnvelope::monotonicNs();
+    snapshot.activeNetwork = m_activeNetwork;
+    snapshot.bestNetwork = m_registry->bestNetwork();
+    snapshot.networkCount = qMin(m_registry->count(), (int)HealthSnapshot::MaxNetworks);
+    snapshot.switchCount = m_switchCount;
+    snapshot.lastSwitchFrom = m_lastSwitchFrom;
+    snapshot.lastSwitchTo = m_lastSwitchTo;
+    snapshot.lastSwitchNs = m_lastSwitchNs;
+    snapshot.lastSwitchDurationNs = m_lastSwitchDurationNs;
+    snapshot.lastSwitchSucceeded = m_lastSwitchSucceeded;
+
+    for (int id = 0; id < snapshot.networkCount; ++id) {
+        const NetworkEntry &entry = m_registry->network(id);
+        NetworkHealth &health = snapshot.networks[id];
+        health.linkUp = entry.linkUp;
+        health.routeUp = entry.routeUp;
+        health.connected = entry.connected;
+        health.usable = entry.isUsable();
+        health.missedProbes = entry.missedProbes;
+        health.health = entry.health;
+        health.rttUs = entry.rttMs < 0.0 ? -1 : (qint64)(entry.rttMs * 1000.0);
+        entry.rttWindow.percentiles(&health.rttP50Us, &health.rttP90Us, &health.rttP99Us);
+    }
+
+    m_health.publish(snapshot);
+}
+
+HealthSnapshot NetworkSelector::health() const
+{
+    HealthSnapshot snapshot;
+    if (!m_health.read(&snapshot)) {
+        memset(&snapshot, 0, sizeof(snapshot));
+        snapshot.activeNetwork = -1;
+        snapshot.bestNetwork = -1;
+    }
+    return snapshot;
+}
+
+/*
+ * Übergibt die Anfrage an den Zustandsautomaten. Bereits aktive Ziele
+ * werden ohne Befehl bestätigt, Bursts auf das letzte Ziel reduziert.
+ * Erfolg nur, wenn das Gerät genau dieses Netz bestätigt hat - sonst
+ * würde makeActive() auf ein nie erreichtes Netz wechseln.
+ */
+void NetworkSelector::requestDeviceSwitch(int network, int timeoutMs, std::function<void(bool)> done)
+{
+    m_switchController->request(network, timeoutMs, [this, network, done](bool success) {
+        done(success && m_switchController->confirmedTarget() == network);
+    });
+}
+
+/*
+ * Befehle gehen über die Verbindung des aktiven Netzes,
+ * bei deren Ausfall über die erste verbundene Reserve.
+ * Vorbereitete Pakete werden unverändert geschrieben, solange der Client
+ * die Payload nicht verändern muss (Prüfsumme, Verschlüsselung, Umschlag).
+ */
+bool NetworkSelector::sendSwitchCommand(const SwitchController::Command &command)
+{
+    MqttClient *client = mqttClient();
+    for (int id = 0; !client->isConnected() && id < m_registry->count(); ++id)
+        client = m_registry->network(id).client;
+
+    if (!client->isConnected())
+        return false;
+
+    const bool prepared = command.frame && client->canWritePreparedPacket(SwitchController::CommandTopic);
+
+    // Mit Frist: wartet bei gestautem Sendepuffer vor allen anderen Daten und
+    // wird verworfen, wenn die Bestätigung ohnehin nicht mehr rechtzeitig käme
+    if (command.deadlineNs > 0) {
+        auto expired = []() { qDebug() << "Umschaltbefehl verworfen - Frist abgelaufen"; };
+        if (prepared)
+            return client->writePreparedPacketBefore(command.frame, command.frameSize, command.deadlineNs, expired);
+        return client->publishBefore(SwitchController::CommandTopic, command.payload, command.deadlineNs, expired);
+    }
+
+    if (prepared)
+        return client->writePreparedPacket(command.frame, command.frameSize);
+
+    client->publish(SwitchController::CommandTopic, command.payload);
+    return true;
+}
+
 /*
  *
  */
 bool NetworkSelector::switchToUnsecure(int timeoutMs)
 {
-    // Externe Implementierung
-    return // gibt zurück ob das Umschalten erfolgreich war!
+    return switchTo(Unsecure, timeoutMs); // gibt zurück ob das Umschalten erfolgreich war!
 }
 
 /*
@@ -56,6 +844,5 @@ bool NetworkSelector::switchToUnsecure(int timeoutMs)
  */
 bool NetworkSelector::switchToSecure(int timeoutMs)
 {
-    // Externe Implementierung
-    return // gibt zurück ob das Umschalten erfolgreich war!
-}
\ No newline at end of file
+    return switchTo(Secure, timeoutMs); // gibt zurück ob das Umschalten erfolgreich war!
+}
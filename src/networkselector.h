@@ -1,19 +1,102 @@
 #ifndef NETWORKSELECTOR_H
 #define NETWORKSELECTOR_H
 
+#include "clientsnapshot.h"
+#include "healthsnapshot.h"
+#include "lastvaluecache.h"
 #include "mqttclient.h"
+#include "linkmonitor.h"
+#include "messagededuplicator.h"
+#include "mptcppathmanager.h"
+#include "networkregistry.h"
+#include "switchcontroller.h"
 
+#include <QElapsedTimer>
 #include <QObject>
 
 
 class NetworkSelector : public QObject
 {
     Q_OBJECT
-    MqttClient* m_mqttClient = nullptr;
 
-    void onMqttConnected();
+public:
+    // IDs der beiden Netze des Umschalters im Registry
+    enum Network { Secure = 0, Unsecure = 1 };
+
+private:
+    NetworkRegistry* m_registry = nullptr;
+    LinkMonitor* m_linkMonitor = nullptr;
+    SwitchController* m_switchController = nullptr;
+
+    QString m_clientId;
+
+    int m_activeNetwork = Secure;
+    bool m_commandChecksum = false;
+    std::shared_ptr<PayloadCipher> m_payloadCipher;
+
+    // Zustand für den schnellen Neustart
+    LastValueCache m_lastValues;
+    QString m_snapshotPath;
+    TimerWheel::TimerId m_snapshotTimer = 0;
+    QVector<ClientSnapshot::Subscription> m_restoredSubscriptions;
+    QElapsedTimer m_uptime;
+    qint64 m_timeToUsefulMs = -1;
+    qint64 m_timeToLiveMs = -1;
+
+    void restoreSnapshot();
+    void markUseful(bool live);
+
+    // Zustand für andere Threads (Seqlock)
+    HealthPublisher m_health;
+    quint32 m_switchCount = 0;
+    int m_lastSwitchFrom = -1;
+    int m_lastSwitchTo = -1;
+    qint64 m_lastSwitchNs = 0;
+    qint64 m_lastSwitchDurationNs = 0;
+    bool m_lastSwitchSucceeded = false;
+
+    void publishHealth();
+
+    // Netzwechsel ohne Unterbrechung (make-before-break), Duplikate der Überlappung über den Inhalt erkannt
+    std::shared_ptr<SequenceTracker> m_sequenceTracker;
+    MessageDeduplicator m_handoverDedup{1024};
+    int m_handoverFrom = -1;
+    QSet<QString> m_handoverPending;
+    TimerWheel::TimerId m_handoverTimer = 0;
+    qint64 m_handoverStartNs = 0;
+    qint64 m_lastHandoverUs = -1;
+
+    void watchClient(int network);
+    void deliverMessage(int network, const QString &topic, const QByteArray &message);
+    void onSubscriptionAcknowledged(int network, const QString &topic);
+    void finishHandover();
+
+    // Multipath-TCP: eine Sitzung über alle Uplinks, Subflows des aktiven Netzes senden, die übrigen sind Reserve
+    MptcpPathManager m_pathManager;
+    QSet<int> m_withdrawnSubflows;
+
+    bool addSubflowEndpoint(int network, QString *errorString);
+    void updateSubflowPriorities();
+    void withdrawSubflows(int network);
+    void restoreSubflows(int network);
+
+    void onMqttConnected(int network);
+    void subscribeMessageTopics(int network);
+    void restoreSubscriptions(int network);
     void onMqttError(const QString &error);
 
+    // rtnetlink Ereignisse
+    void onLinkChanged(const QString &interfaceName, bool up);
+    void onRouteChanged(const QString &interfaceName, bool added);
+
+    // Entscheidung der Selection-Policy
+    void onBestNetworkChanged(int network);
+
+    // Umschaltgerät über MQTT ansteuern
+    void requestDeviceSwitch(int network, int timeoutMs, std::function<void(bool)> done);
+    bool sendSwitchCommand(const SwitchController::Command &command);
+    void makeActive(int network);
+
 public:
     explicit NetworkSelector();
     virtual ~NetworkSelector();
@@ -22,6 +105,78 @@ public:
     bool switchToSecure(int timeoutMs = 10000);
     bool switchToUnsecure(int timeoutMs = 10000);
 
+    // Schaltet auf ein beliebiges registriertes Netz (blockiert bis zum Ergebnis).
+    // Nicht aus einem Topic-Handler aufrufen - dort switchToAsync() verwenden.
+    bool switchTo(int network, int timeoutMs = 10000);
+
+    // Asynchrone Variante - gleichzeitige Anfragen werden zusammengefasst
+    void switchToAsync(int network, int timeoutMs, std::function<void(bool)> done);
+
+    // Weitere Uplinks registrieren, gibt die ID des Netzes zurück
+    int addNetwork(const NetworkEntry &config);
+    void setSelectionPolicy(std::unique_ptr<SelectionPolicy> policy);
+
+    // Interface das ein Netz bereitstellt - wird per rtnetlink überwacht
+    void setNetworkInterface(int network, const QString &interfaceName);
+
+    // Eigene Adresse eines Netzes - wird mit enableMultipath() zum MPTCP-Endpunkt
+    void setNetworkLocalAddress(int network, const QString &address);
+
+    // Multipath-TCP über alle Netze mit lokaler Adresse; verbindet neu, benötigt CAP_NET_ADMIN (z.B. unshare -rn)
+    bool enableMultipath(QString *errorString = nullptr);
+    bool isMultipathEnabled() const { return m_pathManager.isOpen(); }
+
+    // Subflows über ein Netz senden lassen (true) oder nur als Reserve führen (false) - makeActive() setzt das selbst
+    bool setSubflowActive(int network, bool active, QString *errorString = nullptr);
+
+    // CRC32C-Prüfsumme für Umschaltbefehle und Zustandsmeldungen (Gerät muss sie ebenfalls verwenden)
+    void setCommandChecksumEnabled(bool enabled);
+    bool isCommandChecksumEnabled() const { return m_commandChecksum; }
+
+    // Ende-zu-Ende Verschlüsselung pro Topic auf allen Verbindungen (Schlüsselwechsel: neue keyId setzen)
+    bool setPayloadKey(const QString &topic, quint32 keyId, const QByteArray &key);
+    void retirePreviousPayloadKey(const QString &topic);
+    void removePayloadKey(const QString &topic);
+
+    // Periodischer Snapshot von Abonnements, letzten Werten und Sitzung; stellt einen vorhandenen sofort wieder her
+    void enableSnapshots(const QString &path, int intervalMs = 5000);
+    // Schreibt nur den abgeschlossenen Zustand des aktiven Netzes (false während eines Netzwechsels)
+    bool writeSnapshot();
+
+    // Letzter Wert eines Topics - nach einem Neustart auch vor dem Verbindungsaufbau (aus dem Snapshot)
+    QByteArray lastValue(const QString &topic) const { return m_lastValues.value(topic); }
+    const LastValueCache& lastValueCache() const { return m_lastValues; }
+
+    // Zeit ab Start bis zum bekannten Gerätezustand (aus Snapshot oder live) bzw. bis zur ersten Live-Meldung, -1 = noch nicht
+    qint64 timeToUsefulMs() const { return m_timeToUsefulMs; }
+    qint64 timeToLiveMs() const { return m_timeToLiveMs; }
+
+    // Aktives Netz, Zustand und RTT-Perzentile je Netz, letztes Umschalten - aus jedem Thread ohne Sperre lesbar
+    const HealthPublisher& healthPublisher() const { return m_health; }
+    HealthSnapshot health() const;
+
+    // Höchstdauer der Überlappung beim Netzwechsel, danach wird das alte Netz auch ohne SUBACK abgemeldet
+    static constexpr int HandoverTimeoutMs = 3000;
+
+    // Dauer der letzten Übergabe vom Wechsel bis zum Abmelden des alten Netzes (-1 = noch keine)
+    qint64 lastHandoverUs() const { return m_lastHandoverUs; }
+
+    // Gemeinsame Verlust-/Duplikatzählung aller Verbindungen (Umschläge)
+    const SequenceTracker& sequenceTracker() const { return *m_sequenceTracker; }
+
+    int activeNetwork() const { return m_activeNetwork; }
+    MqttClient* mqttClient() const { return m_registry->network(m_activeNetwork).client; }
+    const NetworkRegistry* registry() const { return m_registry; }
+    const SwitchController* switchController() const { return m_switchController; }
+
+signals:
+    // Link, Träger oder Default-Route eines Netzes ist weggefallen
+    void networkLost(int network);
+    // Netz ist wieder verfügbar
+    void networkAvailable(int network);
+    // Aktives Netz wurde gewechselt
+    void activeNetworkChanged(int network);
+
 };
 
 #endif // NETWORKSELECTOR_H
@@ -0,0 +1,254 @@
+#include "payloadcipher.h"
+
+#include <QDebug>
+#include <cstring>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#if defined(Q_PROCESSOR_ARM_64) && defined(Q_OS_LINUX)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+/**
+ * @brief Schlüssel mit vorbereiteten Kontexten
+ *
+ * Die Kontexte werden einmal mit Schlüssel initialisiert, pro Nachricht
+ * wird nur die Nonce gesetzt - der Schlüsselplan wird nicht neu berechnet.
+ */
+struct PayloadCipher::Key
+{
+    quint32 id = 0;
+    Algorithm algorithm = Aes256Gcm;
+    EVP_CIPHER_CTX *encrypt = nullptr;
+    EVP_CIPHER_CTX *decrypt = nullptr;
+    quint8 nonceBase[NonceSize] = {};                        ///< Zufälliger Startwert dieser Installation
+    quint64 counter = 0;
+
+    ~Key()
+    {
+        EVP_CIPHER_CTX_free(encrypt);
+        EVP_CIPHER_CTX_free(decrypt);
+    }
+};
+
+static const EVP_CIPHER* cipherFor(PayloadCipher::Algorithm algorithm)
+{
+    switch (algorithm) {
+    case PayloadCipher::Aes256Gcm:        return EVP_aes_256_gcm();
+    case PayloadCipher::ChaCha20Poly1305: return EVP_chacha20_poly1305();
+    }
+    return nullptr;
+}
+
+static void writeBigEndian32(quint8 *out, quint32 value)
+{
+    out[0] = (quint8)(value >> 24);
+    out[1] = (quint8)(value >> 16);
+    out[2] = (quint8)(value >> 8);
+    out[3] = (quint8)value;
+}
+
+/// nonce = base + counter als 96-Bit-Zahl (Big Endian, Überlauf modulo 2^96)
+static void deriveNonce(quint8 *nonce, const quint8 *base, quint64 counter)
+{
+    unsigned carry = 0;
+    for (int i = PayloadCipher::NonceSize - 1; i >= 0; --i) {
+        const unsigned sum = base[i] + (unsigned)(counter & 0xFF) + carry;
+        nonce[i] = (quint8)sum;
+        carry = sum >> 8;
+        counter >>= 8;
+    }
+}
+
+PayloadCipher::PayloadCipher()
+{
+}
+
+PayloadCipher::~PayloadCipher()
+{
+}
+
+bool PayloadCipher::setKey(const QString &topic, quint32 keyId, const QByteArray &key, Algorithm algorithm)
+{
+    const EVP_CIPHER *cipher = cipherFor(algorithm);
+    if (key.size() != KeySize || !cipher) {
+        qDebug() << "PayloadCipher: ungültiger Schlüssel für" << topic;
+        return false;
+    }
+
+    auto entry = std::make_unique<Key>();
+    entry->id = keyId;
+    entry->algorithm = algorithm;
+    entry->encrypt = EVP_CIPHER_CTX_new();
+    entry->decrypt = EVP_CIPHER_CTX_new();
+
+    const unsigned char *keyData = reinterpret_cast<const unsigned char*>(key.constData());
+    if (!entry->encrypt || !entry->decrypt
+        || EVP_EncryptInit_ex(entry->encrypt, cipher, nullptr, keyData, nullptr) != 1
+        || EVP_DecryptInit_ex(entry->decrypt, cipher, nullptr, keyData, nullptr) != 1
+        || RAND_bytes(entry->nonceBase, sizeof(entry->nonceBase)) != 1) {
+        qDebug() << "PayloadCipher: Schlüssel konnte nicht initialisiert werden für" << topic;
+        return false;
+    }
+
+    TopicKeys &keys = m_topics[topic];
+    if (keys.current && keys.current->id == keyId) {
+        // Gleiche ID erneut gesetzt: ersetzen, ohne den Vorgänger zu verlieren
+        keys.current = std::move(entry);
+    } else {
+        keys.previous = std::move(keys.current);
+        keys.current = std::move(entry);
+    }
+
+    qDebug() << "PayloadCipher: Schlüssel" << keyId << "für" << topic << "aktiv (" << algorithmName(algorithm) << ")";
+    return true;
+}
+
+void PayloadCipher::retirePreviousKey(const QString &topic)
+{
+    auto it = m_topics.find(topic);
+    if (it != m_topics.end())
+        it->second.previous.reset();
+}
+
+void PayloadCipher::removeTopic(const QString &topic)
+{
+    m_topics.erase(topic);
+}
+
+bool PayloadCipher::hasKey(const QString &topic) const
+{
+    return m_topics.find(topic) != m_topics.end();
+}
+
+bool PayloadCipher::needsRotation(const QString &topic) const
+{
+    auto it = m_topics.find(topic);
+    return it != m_topics.end() && it->second.current->counter >= RotationThreshold / 2;
+}
+
+PayloadCipher::Key* PayloadCipher::findKey(const QString &topic, quint32 keyId)
+{
+    auto it = m_topics.find(topic);
+    if (it == m_topics.end())
+        return nullptr;
+
+    TopicKeys &keys = it->second;
+    if (keys.current->id == keyId)
+        return keys.current.get();
+    if (keys.previous && keys.previous->id == keyId)
+        return keys.previous.get();
+    return nullptr;
+}
+
+/**
+ * @brief Verschlüsselt direkt aus der Payload in den Paketpuffer
+ *
+ * Der Puffer wird einmal auf die Endgröße gebracht (Pool-Puffer haben
+ * die Kapazität bereits), danach schreibt OpenSSL Chiffrat und Tag an
+ * ihre endgültige Position.
+ */
+bool PayloadCipher::seal(const QString &topic, QByteArray &packet, int aadStart, const QByteArray &payload)
+{
+    auto it = m_topics.find(topic);
+    if (it == m_topics.end())
+        return false;
+
+    Key *key = it->second.current.get();
+    if (key->counter >= RotationThreshold) {
+        qDebug() << "PayloadCipher: Nonce-Zähler erschöpft für" << topic << "- neuer Schlüssel nötig";
+        return false;
+    }
+
+    const int headerPos = packet.size();
+    packet.resize(headerPos + HeaderSize + payload.size() + TagSize);
+    quint8 *header = reinterpret_cast<quint8*>(packet.data() + headerPos);
+
+    // Header: Algorithmus, Reserviert, Schlüssel-ID, Nonce
+    header[0] = key->algorithm;
+    header[1] = 0;
+    writeBigEndian32(header + 2, key->id);
+    quint8 *nonce = header + 6;
+    deriveNonce(nonce, key->nonceBase, key->counter++);
+
+    unsigned char *ciphertext = header + HeaderSize;
+    const unsigned char *aad = reinterpret_cast<const unsigned char*>(packet.constData() + aadStart);
+    const int aadSize = headerPos + HeaderSize - aadStart;
+    int length = 0;
+
+    if (EVP_EncryptInit_ex(key->encrypt, nullptr, nullptr, nullptr, nonce) != 1
+        || EVP_EncryptUpdate(key->encrypt, nullptr, &length, aad, aadSize) != 1
+        || EVP_EncryptUpdate(key->encrypt, ciphertext, &length,
+                             reinterpret_cast<const unsigned char*>(payload.constData()), payload.size()) != 1
+        || EVP_EncryptFinal_ex(key->encrypt, ciphertext + length, &length) != 1
+        || EVP_CIPHER_CTX_ctrl(key->encrypt, EVP_CTRL_AEAD_GET_TAG, TagSize, ciphertext + payload.size()) != 1) {
+        packet.resize(headerPos);
+        qDebug() << "PayloadCipher: Verschlüsselung fehlgeschlagen für" << topic;
+        return false;
+    }
+
+    return true;
+}
+
+bool PayloadCipher::open(const QString &topic, const char *aadStart, const char *sealed, int sealedSize, QByteArray &plaintext)
+{
+    if (sealedSize < Overhead)
+        return false;
+
+    const quint8 *header = reinterpret_cast<const quint8*>(sealed);
+    const quint32 keyId = (quint32)header[2] << 24 | (quint32)header[3] << 16 | (quint32)header[4] << 8 | header[5];
+    Key *key = findKey(topic, keyId);
+    if (!key || key->algorithm != header[0])
+        return false;
+
+    const int size = sealedSize - Overhead;
+    const unsigned char *ciphertext = header + HeaderSize;
+    const unsigned char *aad = reinterpret_cast<const unsigned char*>(aadStart);
+    const int aadSize = (int)(sealed + HeaderSize - aadStart);
+
+    plaintext.resize(size);
+    unsigned char *out = reinterpret_cast<unsigned char*>(plaintext.data());
+    int length = 0;
+
+    const bool ok = EVP_DecryptInit_ex(key->decrypt, nullptr, nullptr, nullptr, header + 6) == 1
+        && EVP_DecryptUpdate(key->decrypt, nullptr, &length, aad, aadSize) == 1
+        && EVP_DecryptUpdate(key->decrypt, out, &length, ciphertext, size) == 1
+        && EVP_CIPHER_CTX_ctrl(key->decrypt, EVP_CTRL_AEAD_SET_TAG, TagSize,
+                               const_cast<unsigned char*>(ciphertext + size)) == 1
+        && EVP_DecryptFinal_ex(key->decrypt, out + length, &length) == 1;
+
+    if (!ok) {
+        // Keinen unbestätigten Klartext weitergeben
+        OPENSSL_cleanse(plaintext.data(), plaintext.size());
+        plaintext.clear();
+    }
+    return ok;
+}
+
+const char* PayloadCipher::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Aes256Gcm:        return "AES-256-GCM";
+    case ChaCha20Poly1305: return "ChaCha20-Poly1305";
+    }
+    return "?";
+}
+
+bool PayloadCipher::hasAesAcceleration()
+{
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_CLANG))
+    return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul");
+#elif defined(Q_PROCESSOR_ARM_64) && defined(Q_OS_LINUX)
+    return (getauxval(AT_HWCAP) & HWCAP_AES) && (getauxval(AT_HWCAP) & HWCAP_PMULL);
+#else
+    return false;
+#endif
+}
+
+PayloadCipher::Algorithm PayloadCipher::preferredAlgorithm()
+{
+    return hasAesAcceleration() ? Aes256Gcm : ChaCha20Poly1305;
+}
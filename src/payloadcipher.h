@@ -0,0 +1,136 @@
+#ifndef PAYLOADCIPHER_H
+#define PAYLOADCIPHER_H
+
+#include <QByteArray>
+#include <QString>
+#include <map>
+#include <memory>
+
+/**
+ * @brief Ende-zu-Ende Verschlüsselung von MQTT-Payloads (AEAD) pro Topic
+ *
+ * Der Broker sieht nur Topic, Umschlag und Chiffrat. Verwendet werden
+ * AES-256-GCM oder ChaCha20-Poly1305 aus OpenSSL, das automatisch AES-NI
+ * bzw. die ARMv8 Crypto-Erweiterung nutzt. Ohne AES-Hardware ist
+ * ChaCha20-Poly1305 schneller und wird von preferredAlgorithm() gewählt.
+ *
+ * Aufbau einer versiegelten Payload (hinter einem evtl. Umschlag):
+ * - Byte 0:      Algorithmus (1 = AES-256-GCM, 2 = ChaCha20-Poly1305)
+ * - Byte 1:      Reserviert (0)
+ * - Byte 2-5:    Schlüssel-ID (Big Endian)
+ * - Byte 6-17:   Nonce (96 Bit Zufallsstartwert + Nachrichtenzähler)
+ * - danach:      Chiffrat (gleiche Länge wie der Klartext)
+ * - letzte 16:   Authentifizierungs-Tag
+ *
+ * Topic, Umschlag und Header gehen als zusätzliche authentifizierte Daten
+ * ein - eine Nachricht kann nicht unbemerkt auf ein anderes Topic
+ * umgeleitet oder mit fremdem Umschlag versehen werden.
+ *
+ * Schlüsselwechsel: setKey() mit neuer ID macht den neuen Schlüssel zum
+ * Sendeschlüssel, der bisherige bleibt zum Entschlüsseln gültig, bis
+ * retirePreviousKey() aufgerufen wird. So können Sender und Empfänger
+ * nacheinander umgestellt werden.
+ *
+ * Nonces: Jede Installation eines Schlüssels (auch nach einem Neustart
+ * mit demselben Schlüssel) zieht einen zufälligen 96-Bit-Startwert, pro
+ * Nachricht wird der Zähler modulo 2^96 aufaddiert. Zwei Installationen
+ * überschneiden sich nur, wenn ihre Startwerte weniger als
+ * RotationThreshold auseinanderliegen - ein 32-Bit-Präfix mit Zähler ab 0
+ * wiederholte dagegen schon nach etwa 2^16 Neustarts eine Nonce. Nach
+ * RotationThreshold Nachrichten verweigert seal() die Verschlüsselung,
+ * bis ein neuer Schlüssel gesetzt wird.
+ *
+ * @note Nicht threadsicher. Clients in verschiedenen Threads benötigen
+ *       eigene Instanzen.
+ */
+class PayloadCipher
+{
+public:
+    enum Algorithm : quint8 {
+        Aes256Gcm = 1,
+        ChaCha20Poly1305 = 2
+    };
+
+    static constexpr int KeySize = 32;                       ///< Schlüssellänge beider Verfahren
+    static constexpr int NonceSize = 12;                     ///< 96 Bit Nonce
+    static constexpr int TagSize = 16;                       ///< Authentifizierungs-Tag
+    static constexpr int HeaderSize = 6 + NonceSize;         ///< Algorithmus, Reserviert, Schlüssel-ID, Nonce
+    static constexpr int Overhead = HeaderSize + TagSize;    ///< Zusätzliche Bytes pro Nachricht
+    static constexpr quint64 RotationThreshold = 1ULL << 32; ///< Maximale Nachrichten pro Schlüssel
+
+    PayloadCipher();
+    ~PayloadCipher();
+
+    PayloadCipher(const PayloadCipher&) = delete;
+    PayloadCipher& operator=(const PayloadCipher&) = delete;
+
+    /**
+     * @brief Setzt den Sendeschlüssel eines Topics
+     * @param topic Exaktes Topic
+     * @param keyId Kennung des Schlüssels (muss sich beim Wechsel ändern)
+     * @param key 32 Byte Schlüsselmaterial
+     * @param algorithm Verfahren für ausgehende Nachrichten
+     * @return false bei ungültigem Schlüssel
+     */
+    bool setKey(const QString &topic, quint32 keyId, const QByteArray &key, Algorithm algorithm = preferredAlgorithm());
+
+    /// Verwirft den Vorgänger-Schlüssel nach abgeschlossenem Wechsel
+    void retirePreviousKey(const QString &topic);
+
+    /// Entfernt alle Schlüssel eines Topics (Nachrichten bleiben unverschlüsselt)
+    void removeTopic(const QString &topic);
+
+    /// true wenn für das Topic ein Schlüssel gesetzt ist
+    bool hasKey(const QString &topic) const;
+
+    /// true wenn kein Topic einen Schlüssel hat (schnelle Prüfung im Sendepfad)
+    bool isEmpty() const { return m_topics.empty(); }
+
+    /// true wenn der Sendeschlüssel des Topics gewechselt werden sollte
+    bool needsRotation(const QString &topic) const;
+
+    /**
+     * @brief Hängt eine versiegelte Payload an einen Paketpuffer an
+     * @param topic Topic der Nachricht (bestimmt den Schlüssel)
+     * @param packet Ziel-Puffer, wird um payload.size() + Overhead erweitert
+     * @param aadStart Beginn der authentifizierten Daten im Puffer (reicht bis zum Header)
+     * @param payload Klartext
+     * @return false wenn kein Schlüssel gesetzt ist oder der Nonce-Zähler erschöpft ist
+     *
+     * Der Klartext wird direkt in den Puffer verschlüsselt, ohne Zwischenkopie.
+     */
+    bool seal(const QString &topic, QByteArray &packet, int aadStart, const QByteArray &payload);
+
+    /**
+     * @brief Prüft und entschlüsselt eine versiegelte Payload
+     * @param topic Topic der Nachricht
+     * @param aadStart Beginn der authentifizierten Daten (endet am Header bei sealed)
+     * @param sealed Header, Chiffrat und Tag
+     * @param sealedSize Länge von sealed
+     * @param plaintext Ergebnis (nur bei Rückgabe true gültig)
+     * @return false bei unbekanntem Schlüssel oder beschädigter Nachricht
+     */
+    bool open(const QString &topic, const char *aadStart, const char *sealed, int sealedSize, QByteArray &plaintext);
+
+    /// Name eines Verfahrens für Diagnose und Benchmarks
+    static const char* algorithmName(Algorithm algorithm);
+
+    /// true wenn die CPU AES-Instruktionen bietet (AES-NI bzw. ARMv8 AES)
+    static bool hasAesAcceleration();
+
+    /// AES-256-GCM mit AES-Hardware, sonst ChaCha20-Poly1305
+    static Algorithm preferredAlgorithm();
+
+private:
+    struct Key;
+    struct TopicKeys {
+        std::unique_ptr<Key> current;
+        std::unique_ptr<Key> previous;
+    };
+
+    Key* findKey(const QString &topic, quint32 keyId);
+
+    std::map<QString, TopicKeys> m_topics;                   ///< Topic -> aktueller und vorheriger Schlüssel
+};
+
+#endif // PAYLOADCIPHER_H
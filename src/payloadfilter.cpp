@@ -0,0 +1,137 @@
+#include "payloadfilter.h"
+#include "jsonview.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+PayloadFilter PayloadFilter::prefix(const QByteArray &bytes)
+{
+    return PayloadFilter(Rule{Prefix, bytes, QByteArray(), 0});
+}
+
+PayloadFilter PayloadFilter::contains(const QByteArray &bytes)
+{
+    return PayloadFilter(Rule{Contains, bytes, QByteArray(), 0});
+}
+
+PayloadFilter PayloadFilter::jsonEquals(const QByteArray &field, const QByteArray &value)
+{
+    return PayloadFilter(Rule{JsonString, value, field, 0});
+}
+
+PayloadFilter PayloadFilter::jsonEquals(const QByteArray &field, qint64 value)
+{
+    return PayloadFilter(Rule{JsonInteger, QByteArray(), field, value});
+}
+
+/**
+ * @brief Übernimmt die Regeln des anderen Filters
+ *
+ * Stabil nach Kosten sortiert: Präfix vor Suche vor JSON.
+ */
+PayloadFilter &PayloadFilter::andAlso(const PayloadFilter &other)
+{
+    for (const Rule &rule : other.m_rules)
+        m_rules.append(rule);
+    std::stable_sort(m_rules.begin(), m_rules.end(), [](const Rule &a, const Rule &b) {
+        return a.kind < b.kind;
+    });
+    return *this;
+}
+
+/**
+ * @brief Prüft alle Regeln, bricht bei der ersten Abweichung ab
+ *
+ * Für JSON-Regeln wird eine gemeinsame JsonView verwendet.
+ */
+bool PayloadFilter::matches(const char *data, int size) const
+{
+    const JsonView json(data, size);
+
+    for (const Rule &rule : m_rules) {
+        switch (rule.kind) {
+        case Prefix:
+            if (size < rule.bytes.size() || memcmp(data, rule.bytes.constData(), rule.bytes.size()) != 0)
+                return false;
+            break;
+        case Contains:
+            if (!find(data, size, rule.bytes.constData(), rule.bytes.size()))
+                return false;
+            break;
+        case JsonString: {
+            const JsonView::Value value = json.value(rule.field.constData());
+            if (value.type() != JsonView::String || value.hasEscapes() || value.rawString() != rule.bytes)
+                return false;
+            break;
+        }
+        case JsonInteger: {
+            const JsonView::Value value = json.value(rule.field.constData());
+            bool ok = false;
+            if (value.type() != JsonView::Number || value.toInteger(0, &ok) != rule.integer || !ok)
+                return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+const char *PayloadFilter::find(const char *data, int size, const char *needle, int needleSize)
+{
+    if (needleSize == 0)
+        return data;
+    if (needleSize > size)
+        return nullptr;
+    if (needleSize == 1)
+        return static_cast<const char*>(memchr(data, needle[0], size));
+
+    const char *p = data;
+    const char *last = data + size - needleSize;             // letzte mögliche Startposition
+
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i final = _mm_set1_epi8(needle[needleSize - 1]);
+    while (last - p >= 15) {
+        const __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i blockFinal = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + needleSize - 1));
+        int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockFinal, final)));
+        while (mask) {
+            const int bit = __builtin_ctz(mask);
+            if (memcmp(p + bit + 1, needle + 1, needleSize - 2) == 0)
+                return p + bit;
+            mask &= mask - 1;
+        }
+        p += 16;
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t first = vdupq_n_u8((uint8_t)needle[0]);
+    const uint8x16_t final = vdupq_n_u8((uint8_t)needle[needleSize - 1]);
+    while (last - p >= 15) {
+        const uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t blockFinal = vld1q_u8(reinterpret_cast<const uint8_t*>(p + needleSize - 1));
+        const uint8x16_t hits = vandq_u8(vceqq_u8(blockFirst, first), vceqq_u8(blockFinal, final));
+        if (vmaxvq_u8(hits)) {
+            // 4 Bit pro Position
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+            while (mask) {
+                const int bit = __builtin_ctzll(mask) >> 2;
+                if (memcmp(p + bit + 1, needle + 1, needleSize - 2) == 0)
+                    return p + bit;
+                mask &= ~(0xFULL << (bit * 4));
+            }
+        }
+        p += 16;
+    }
+#endif
+    for (; p <= last; ++p) {
+        if (p[0] == needle[0] && memcmp(p + 1, needle + 1, needleSize - 1) == 0)
+            return p;
+    }
+    return nullptr;
+}
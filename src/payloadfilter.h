@@ -0,0 +1,90 @@
+#ifndef PAYLOADFILTER_H
+#define PAYLOADFILTER_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief Inhaltsfilter für empfangene Nachrichten
+ *
+ * Viele Handler verwerfen Nachrichten sofort, wenn die Payload nicht mit
+ * einem Präfix beginnt oder ein JSON-Feld nicht den erwarteten Wert hat.
+ * Ein PayloadFilter wird im MqttClient an ein Topic gehängt und direkt auf
+ * dem Empfangspuffer ausgewertet - abgelehnte Nachrichten werden weder
+ * kopiert noch an Handler oder messageReceived() weitergegeben.
+ *
+ * Regeln (alle müssen zutreffen):
+ * - prefix(): Payload beginnt mit den Bytes
+ * - contains(): Bytefolge kommt in der Payload vor (SSE2/NEON-Suche)
+ * - jsonEquals(): Feld der obersten Ebene hat den String- bzw. Ganzzahlwert
+ *
+ * Die Regeln werden beim Verknüpfen nach Kosten sortiert, so dass billige
+ * Prüfungen zuerst laufen und teure meist gar nicht erreicht werden.
+ *
+ * Verwendung:
+ * @code
+ * client.setPayloadFilter("message/err",
+ *     PayloadFilter::jsonEquals("level", "error").andAlso(PayloadFilter::contains("eth1")));
+ * @endcode
+ */
+class PayloadFilter
+{
+public:
+    /// Leerer Filter - jede Nachricht passt
+    PayloadFilter() = default;
+
+    /// Payload beginnt mit bytes
+    static PayloadFilter prefix(const QByteArray &bytes);
+
+    /// Payload enthält bytes
+    static PayloadFilter contains(const QByteArray &bytes);
+
+    /// JSON-Feld ist ein String mit genau diesem Inhalt (ohne Escape-Sequenzen)
+    static PayloadFilter jsonEquals(const QByteArray &field, const QByteArray &value);
+
+    /// JSON-Feld ist eine Zahl mit diesem ganzzahligen Wert
+    static PayloadFilter jsonEquals(const QByteArray &field, qint64 value);
+
+    /**
+     * @brief Verknüpft mit einem weiteren Filter (UND)
+     * @return *this
+     */
+    PayloadFilter &andAlso(const PayloadFilter &other);
+
+    /// true wenn keine Regel gesetzt ist
+    bool isEmpty() const { return m_rules.isEmpty(); }
+
+    /**
+     * @brief Wertet den Filter aus
+     * @param data Payload (nur gelesen, keine Kopie)
+     * @param size Länge der Payload
+     * @return true wenn alle Regeln zutreffen
+     */
+    bool matches(const char *data, int size) const;
+
+    /**
+     * @brief Sucht eine Bytefolge (memmem), 16 Bytes pro Schritt
+     * @return Zeiger auf den ersten Treffer oder nullptr
+     *
+     * Vergleicht erstes und letztes Byte der Folge parallel für 16
+     * Positionen und prüft nur Kandidaten mit memcmp.
+     */
+    static const char *find(const char *data, int size, const char *needle, int needleSize);
+
+private:
+    /// Regelarten, aufsteigend nach Kosten (Reihenfolge der Auswertung)
+    enum Kind { Prefix, Contains, JsonString, JsonInteger };
+
+    struct Rule {
+        Kind kind;
+        QByteArray bytes;                                    ///< Präfix, Suchfolge bzw. erwarteter String
+        QByteArray field;                                    ///< JSON-Feldname
+        qint64 integer;                                      ///< Erwarteter Ganzzahlwert
+    };
+
+    explicit PayloadFilter(const Rule &rule) : m_rules{rule} {}
+
+    QVector<Rule> m_rules;
+};
+
+#endif // PAYLOADFILTER_H
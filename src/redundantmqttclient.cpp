@@ -0,0 +1,167 @@
+#include "redundantmqttclient.h"
+#include <QDebug>
+
+/**
+ * @brief Konstruktor - Erstellt beide Broker-Verbindungen
+ *
+ * Beide Clients leiten empfangene Nachrichten ohne Handler über
+ * dispatch() durch den Duplikatfilter.
+ */
+RedundantMqttClient::RedundantMqttClient(QObject *parent, int dedupWindow)
+    : QObject(parent)
+    , m_dedup(dedupWindow)
+{
+    for (Broker broker : {Primary, Secondary}) {
+        m_clients[broker] = std::make_unique<MqttClient>(this);
+        MqttClient *client = m_clients[broker].get();
+
+        connect(client, &MqttClient::connected, this, [this, broker]() { onClientConnected(broker); });
+        connect(client, &MqttClient::disconnected, this, [this, broker]() { onClientDisconnected(broker); });
+        connect(client, &MqttClient::messageReceived, this,
+                [this, broker](const QString &topic, const QByteArray &message) { dispatch(broker, topic, message); });
+        connect(client, &MqttClient::error, this,
+                [this, broker](const QString &errorString) { emit error(broker, errorString); });
+    }
+}
+
+/**
+ * @brief Destruktor
+ *
+ * Die MqttClient-Destruktoren trennen die Verbindungen selbst.
+ */
+RedundantMqttClient::~RedundantMqttClient() = default;
+
+/**
+ * @brief Startet beide TCP-Verbindungen parallel
+ */
+void RedundantMqttClient::connectToHosts(const QString &primaryHost, quint16 primaryPort,
+                                         const QString &secondaryHost, quint16 secondaryPort,
+                                         const QString &clientId)
+{
+    m_clients[Primary]->connectToHost(primaryHost, primaryPort, clientId);
+    m_clients[Secondary]->connectToHost(secondaryHost, secondaryPort, clientId);
+}
+
+/**
+ * @brief Publiziert über jeden verbundenen Broker
+ *
+ * Erst beide Kopien machen das Senden redundant - fällt ein Broker
+ * zwischen Annahme und Weiterleitung aus, liefert der andere.
+ */
+void RedundantMqttClient::publish(const QString &topic, const QByteArray &message, quint8 qos, bool retain)
+{
+    bool sent = false;
+    for (Broker broker : {Primary, Secondary}) {
+        if (m_clients[broker]->isConnected()) {
+            m_clients[broker]->publish(topic, message, qos, retain);
+            sent = true;
+        }
+    }
+    if (!sent)
+        emit error(Primary, "Kein Broker verbunden!");
+}
+
+/**
+ * @brief Speichert das Abonnement und sendet es an alle verbundenen Broker
+ */
+void RedundantMqttClient::subscribe(const QString &topic, MqttClient::TopicHandler handler, quint8 qos)
+{
+    m_subscriptions[topic] = Subscription{handler, qos};
+
+    for (Broker broker : {Primary, Secondary}) {
+        if (m_clients[broker]->isConnected())
+            subscribeOn(broker, topic, qos);
+    }
+}
+
+/**
+ * @brief Entfernt das Abonnement auf beiden Brokern
+ */
+void RedundantMqttClient::unsubscribe(const QString &topic)
+{
+    m_subscriptions.remove(topic);
+
+    for (Broker broker : {Primary, Secondary}) {
+        if (m_clients[broker]->isConnected())
+            m_clients[broker]->unsubscribe(topic);
+    }
+}
+
+/**
+ * @brief Trennt beide Broker-Verbindungen
+ */
+void RedundantMqttClient::disconnect()
+{
+    for (Broker broker : {Primary, Secondary})
+        m_clients[broker]->disconnect();
+}
+
+bool RedundantMqttClient::isConnected() const
+{
+    return m_clients[Primary]->isConnected() || m_clients[Secondary]->isConnected();
+}
+
+/**
+ * @brief Broker hat CONNACK gesendet - alle Abonnements erneut senden
+ *
+ * connected() wird nur für den ersten verbundenen Broker ausgelöst.
+ */
+void RedundantMqttClient::onClientConnected(Broker broker)
+{
+    qDebug() << "Redundanz: Broker" << broker << "verbunden";
+
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it)
+        subscribeOn(broker, it.key(), it.value().qos);
+
+    const Broker other = (broker == Primary) ? Secondary : Primary;
+    if (!m_clients[other]->isConnected())
+        emit connected();
+}
+
+/**
+ * @brief Broker-Verbindung verloren
+ *
+ * Fällt ein Broker aus, schuldet er keine Kopien mehr - das Fenster wird
+ * geleert, damit spätere Nachrichten des verbliebenen Brokers nicht
+ * fälschlich als Duplikate verworfen werden.
+ */
+void RedundantMqttClient::onClientDisconnected(Broker broker)
+{
+    qDebug() << "Redundanz: Broker" << broker << "getrennt";
+    m_dedup.clear();
+
+    if (!isConnected())
+        emit disconnected();
+}
+
+/**
+ * @brief Abonniert ein Topic auf einem Broker mit Dedup-Handler
+ *
+ * Der Handler des Brokers leitet jede Nachricht an dispatch() weiter,
+ * der Topic-Name wird im Lambda festgehalten.
+ */
+void RedundantMqttClient::subscribeOn(Broker broker, const QString &topic, quint8 qos)
+{
+    m_clients[broker]->subscribe(topic, [this, broker, topic](const QByteArray &message) {
+        dispatch(broker, topic, message);
+    }, qos);
+}
+
+/**
+ * @brief Führt beide Empfangsströme zusammen
+ *
+ * Duplikate werden verworfen, sonst wird der gespeicherte Handler aufgerufen
+ * oder messageReceived() ausgelöst.
+ */
+void RedundantMqttClient::dispatch(Broker broker, const QString &topic, const QByteArray &message)
+{
+    if (!m_dedup.accept(broker, topic, message))
+        return;
+
+    auto it = m_subscriptions.constFind(topic);
+    if (it != m_subscriptions.constEnd() && it.value().handler) {
+        it.value().handler(message);
+    } else {
+        emit messageReceived(topic, message);
+    }
+}
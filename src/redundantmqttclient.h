@@ -0,0 +1,136 @@
+#ifndef REDUNDANTMQTTCLIENT_H
+#define REDUNDANTMQTTCLIENT_H
+
+#include "mqttclient.h"
+#include "messagededuplicator.h"
+
+#include <QObject>
+#include <QMap>
+#include <memory>
+
+/**
+ * @brief Active-Active Betrieb mit zwei MQTT-Brokern
+ *
+ * Hält gleichzeitig je eine Sitzung zu zwei Brokern, abonniert alle Topics
+ * auf beiden und führt die Empfangsströme über einen MessageDeduplicator
+ * zusammen. Handler sehen jede Nachricht genau einmal - von dem Broker,
+ * der sie zuerst geliefert hat.
+ *
+ * Publiziert wird über alle verbundenen Broker, damit eine Nachricht auch
+ * den Ausfall eines Brokers übersteht. Empfänger, die beide Broker
+ * abonnieren, benötigen dafür ebenfalls einen Duplikatfilter.
+ *
+ * Verwendung:
+ * @code
+ * RedundantMqttClient client;
+ * client.connectToHosts("broker-a", 1883, "broker-b", 1883, "MeinClient");
+ * client.subscribe("sensor/temperature", [](const QByteArray &data) {
+ *     qDebug() << "Temperatur:" << data;
+ * });
+ * @endcode
+ *
+ * @note Abonnements werden gespeichert und nach jedem (Wieder-)Verbinden
+ *       eines Brokers automatisch erneut gesendet.
+ */
+class RedundantMqttClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Index der beiden Broker
+    enum Broker { Primary = 0, Secondary = 1 };
+
+    /**
+     * @brief Konstruktor
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     * @param dedupWindow Größe des Duplikatfensters in Nachrichten
+     */
+    explicit RedundantMqttClient(QObject *parent = nullptr, int dedupWindow = 4096);
+    ~RedundantMqttClient() override;
+
+    /**
+     * @brief Verbindet zu beiden Brokern
+     * @param primaryHost Hostname des Primär-Brokers
+     * @param primaryPort Port des Primär-Brokers
+     * @param secondaryHost Hostname des Sekundär-Brokers
+     * @param secondaryPort Port des Sekundär-Brokers
+     * @param clientId Client-ID (wird für beide Broker verwendet)
+     */
+    void connectToHosts(const QString &primaryHost, quint16 primaryPort,
+                        const QString &secondaryHost, quint16 secondaryPort,
+                        const QString &clientId);
+
+    /**
+     * @brief Publiziert über alle verbundenen Broker
+     *
+     * Löst error() aus, wenn keiner der Broker verbunden ist.
+     */
+    void publish(const QString &topic, const QByteArray &message, quint8 qos = 0, bool retain = false);
+
+    /**
+     * @brief Abonniert ein Topic auf beiden Brokern
+     * @param topic MQTT-Topic
+     * @param handler Callback, wird pro Nachricht genau einmal aufgerufen
+     * @param qos Quality of Service Level
+     *
+     * Ohne Handler (nullptr) werden Nachrichten über messageReceived() gemeldet.
+     */
+    void subscribe(const QString &topic, MqttClient::TopicHandler handler = nullptr, quint8 qos = 0);
+
+    /**
+     * @brief Meldet ein Topic auf beiden Brokern ab
+     */
+    void unsubscribe(const QString &topic);
+
+    /**
+     * @brief Trennt beide Verbindungen
+     */
+    void disconnect();
+
+    /// true wenn mindestens ein Broker verbunden ist
+    bool isConnected() const;
+
+    /// Zugriff auf die einzelne Broker-Verbindung (z.B. für Statusabfragen)
+    MqttClient* client(Broker broker) const { return m_clients[broker].get(); }
+
+    /// Anzahl verworfener Duplikate
+    quint64 duplicatesDropped() const { return m_dedup.duplicatesDropped(); }
+
+    /// Anzahl ausgelieferter Nachrichten, die zuerst von diesem Broker kamen
+    quint64 deliveredFrom(Broker broker) const { return m_dedup.deliveredFrom(broker); }
+
+signals:
+    /// Erster Broker ist verbunden
+    void connected();
+
+    /// Beide Broker sind getrennt
+    void disconnected();
+
+    /// Nachricht ohne registrierten Handler (bereits dedupliziert)
+    void messageReceived(const QString &topic, const QByteArray &message);
+
+    /**
+     * @brief Fehler einer der beiden Verbindungen
+     * @param broker Betroffener Broker
+     * @param errorString Beschreibung des Fehlers
+     */
+    void error(RedundantMqttClient::Broker broker, const QString &errorString);
+
+private:
+    /// Gespeichertes Abonnement für erneutes Senden nach Reconnect
+    struct Subscription {
+        MqttClient::TopicHandler handler;
+        quint8 qos = 0;
+    };
+
+    void onClientConnected(Broker broker);
+    void onClientDisconnected(Broker broker);
+    void subscribeOn(Broker broker, const QString &topic, quint8 qos);
+    void dispatch(Broker broker, const QString &topic, const QByteArray &message);
+
+    std::unique_ptr<MqttClient> m_clients[2];                ///< Verbindungen zu Primär- und Sekundär-Broker
+    QMap<QString, Subscription> m_subscriptions;             ///< Map: Topic -> Handler + QoS
+    MessageDeduplicator m_dedup;                             ///< Duplikatfilter für beide Empfangsströme
+};
+
+#endif // REDUNDANTMQTTCLIENT_H
@@ -0,0 +1,32 @@
+#include "selectionpolicy.h"
+#include "networkregistry.h"
+
+namespace {
+
+// Ersatzwert für Netze ohne RTT-Messung (ms)
+constexpr double UnmeasuredRttMs = 1000.0;
+
+inline double effectiveRttMs(const NetworkEntry &network)
+{
+    const double rtt = network.rttMs >= 0.0 ? network.rttMs : UnmeasuredRttMs;
+    // Jede unbeantwortete Probe verdoppelt die effektive Latenz
+    return rtt * (1 << qMin(network.missedProbes, 10));
+}
+
+} // namespace
+
+double PriorityPolicy::score(const NetworkEntry &network) const
+{
+    return network.priority;
+}
+
+double LowestLatencyPolicy::score(const NetworkEntry &network) const
+{
+    return effectiveRttMs(network);
+}
+
+double WeightedPolicy::score(const NetworkEntry &network) const
+{
+    const double weight = network.weight > 0.0 ? network.weight : 1.0;
+    return effectiveRttMs(network) / weight;
+}
@@ -0,0 +1,70 @@
+#ifndef SELECTIONPOLICY_H
+#define SELECTIONPOLICY_H
+
+struct NetworkEntry;
+
+/**
+ * @brief Schnittstelle für die Netzwahl im NetworkRegistry
+ *
+ * Eine Policy bewertet ein einzelnes Netz anhand seiner Live-Metriken.
+ * Kleinere Werte sind besser. Die Bewertung muss in O(1) und nur aus dem
+ * übergebenen Eintrag berechnet werden - das Registry vergleicht dann
+ * inkrementell gegen das aktuell beste Netz.
+ *
+ * Nicht nutzbare Netze (kein Link, keine Verbindung) werden vom Registry
+ * bereits vorher ausgeschlossen.
+ */
+class SelectionPolicy
+{
+public:
+    virtual ~SelectionPolicy() = default;
+
+    /// Name der Policy für Diagnoseausgaben
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Bewertet ein Netz
+     * @param network Eintrag mit Konfiguration und Live-Metriken
+     * @return Bewertung, kleiner ist besser
+     */
+    virtual double score(const NetworkEntry &network) const = 0;
+};
+
+/**
+ * @brief Feste Rangfolge: das nutzbare Netz mit der kleinsten Priorität gewinnt
+ */
+class PriorityPolicy : public SelectionPolicy
+{
+public:
+    const char* name() const override { return "priority"; }
+    double score(const NetworkEntry &network) const override;
+};
+
+/**
+ * @brief Das Netz mit der geringsten gemessenen Round-Trip-Zeit gewinnt
+ *
+ * Verlorene Proben erhöhen die Bewertung, Netze ohne Messwert werden
+ * hinter gemessene Netze einsortiert.
+ */
+class LowestLatencyPolicy : public SelectionPolicy
+{
+public:
+    const char* name() const override { return "lowest-latency"; }
+    double score(const NetworkEntry &network) const override;
+};
+
+/**
+ * @brief Latenz geteilt durch das konfigurierte Gewicht
+ *
+ * Ein Netz mit Gewicht 2 wird gegenüber einem Netz mit Gewicht 1 bevorzugt,
+ * solange seine Latenz weniger als doppelt so hoch ist (z.B. für kostenlose
+ * gegenüber getakteten Uplinks).
+ */
+class WeightedPolicy : public SelectionPolicy
+{
+public:
+    const char* name() const override { return "weighted"; }
+    double score(const NetworkEntry &network) const override;
+};
+
+#endif // SELECTIONPOLICY_H
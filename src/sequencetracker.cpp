@@ -0,0 +1,151 @@
+#include "sequencetracker.h"
+
+/**
+ * @brief Verbucht eine Sequenznummer im Empfangsfenster
+ *
+ * Der Abstand zur höchsten Sequenz wird mit Vorzeichen (Serial Number
+ * Arithmetik) berechnet, damit ein Überlauf der 32-Bit Sequenz keinen
+ * Massenverlust vortäuscht.
+ */
+bool SequenceTracker::record(const MessageEnvelope::View &view, quint64 receiveNs)
+{
+    auto it = m_publishers.find(view.publisherId);
+    if (it == m_publishers.end()) {
+        // Erster Kontakt - Fenster mit dieser Sequenz beginnen
+        PublisherState state;
+        state.highest = view.sequence;
+        state.window = 1;
+        state.epoch = view.epoch;
+        state.stats.received = 1;
+        recordLatency(state.stats, (qint64)(receiveNs - view.sendTimestampNs));
+        m_publishers.insert(view.publisherId, state);
+        return true;
+    }
+
+    PublisherState &state = *it;
+    Stats &stats = state.stats;
+
+    if (view.epoch != state.epoch && view.epoch != 0) {
+        // Nachzügler aus der Zeit vor dem Neustart (z.B. über das zweite Netz).
+        // Nur im alten Fenster - die Epoch hat 255 Werte, ein erneuter
+        // Neustart kann die vorige wieder ziehen (A -> B -> A)
+        const qint32 age = (qint32)(state.previousHighest - view.sequence);
+        if (view.epoch == state.previousEpoch && age >= 0 && age < 64) {
+            stats.duplicates++;
+            return false;
+        }
+        // Neue Epoch - Publisher hat neu gestartet, unabhängig von der Sequenz
+        restart(state, view);
+        stats.received++;
+        recordLatency(stats, (qint64)(receiveNs - view.sendTimestampNs));
+        return true;
+    }
+
+    const qint32 delta = (qint32)(view.sequence - state.highest);
+
+    if (view.sequence == 0 && state.highest != 0 && delta < 0) {
+        // Publisher ohne Epoch hat neu gestartet
+        restart(state, view);
+    } else if (delta > 0) {
+        // Neue höchste Sequenz - Lücke als Verlust zählen
+        stats.lost += (quint64)(delta - 1);
+        state.window = (delta >= 64) ? 1 : ((state.window << delta) | 1);
+        state.highest = view.sequence;
+    } else if (-delta < 64) {
+        const quint64 bit = 1ULL << (-delta);
+        if (state.window & bit) {
+            stats.duplicates++;
+            return false;
+        }
+        // Nachzügler - wurde beim Sprung als verloren gezählt
+        state.window |= bit;
+        if (stats.lost > 0)
+            stats.lost--;
+        stats.reordered++;
+    } else {
+        // Älter als das Fenster - nicht mehr unterscheidbar, als Duplikat werten
+        stats.duplicates++;
+        return false;
+    }
+
+    stats.received++;
+    recordLatency(stats, (qint64)(receiveNs - view.sendTimestampNs));
+    return true;
+}
+
+/**
+ * @brief Beginnt das Fenster eines neu gestarteten Publishers
+ *
+ * Die neue Folge beginnt bei 0, davor fehlende Nummern zählen als verloren.
+ */
+void SequenceTracker::restart(PublisherState &state, const MessageEnvelope::View &view)
+{
+    if (view.epoch != state.epoch) {
+        state.previousEpoch = state.epoch;
+        state.previousHighest = state.highest;
+        state.epoch = view.epoch;
+    }
+    state.stats.resets++;
+    state.stats.lost += view.sequence;
+    state.highest = view.sequence;
+    state.window = 1;
+}
+
+SequenceTracker::Stats SequenceTracker::stats(quint32 publisherId) const
+{
+    auto it = m_publishers.constFind(publisherId);
+    return it != m_publishers.constEnd() ? it->stats : Stats();
+}
+
+SequenceTracker::Stats SequenceTracker::totals() const
+{
+    Stats total;
+    quint64 latencySamples = 0;
+
+    for (auto it = m_publishers.constBegin(); it != m_publishers.constEnd(); ++it) {
+        const Stats &s = it->stats;
+        total.received += s.received;
+        total.lost += s.lost;
+        total.duplicates += s.duplicates;
+        total.reordered += s.reordered;
+        total.resets += s.resets;
+
+        if (s.minLatencyNs >= 0) {
+            if (total.minLatencyNs < 0 || s.minLatencyNs < total.minLatencyNs)
+                total.minLatencyNs = s.minLatencyNs;
+            if (s.maxLatencyNs > total.maxLatencyNs)
+                total.maxLatencyNs = s.maxLatencyNs;
+            total.lastLatencyNs = s.lastLatencyNs;
+            total.avgLatencyNs += s.avgLatencyNs;
+            latencySamples++;
+        }
+    }
+
+    if (latencySamples > 0)
+        total.avgLatencyNs /= latencySamples;
+
+    return total;
+}
+
+/**
+ * @brief Aktualisiert die Latenzwerte
+ *
+ * Negative Werte entstehen bei unterschiedlichen Uhren von Sender und
+ * Empfänger und werden ignoriert.
+ */
+void SequenceTracker::recordLatency(Stats &stats, qint64 latencyNs)
+{
+    if (latencyNs < 0)
+        return;
+
+    stats.lastLatencyNs = latencyNs;
+    if (stats.minLatencyNs < 0 || latencyNs < stats.minLatencyNs)
+        stats.minLatencyNs = latencyNs;
+    if (latencyNs > stats.maxLatencyNs)
+        stats.maxLatencyNs = latencyNs;
+
+    if (stats.avgLatencyNs == 0.0)
+        stats.avgLatencyNs = latencyNs;
+    else
+        stats.avgLatencyNs += (latencyNs - stats.avgLatencyNs) / 16.0;
+}
@@ -0,0 +1,75 @@
+#ifndef SEQUENCETRACKER_H
+#define SEQUENCETRACKER_H
+
+#include "messageenvelope.h"
+
+#include <QHash>
+
+/**
+ * @brief Verlust- und Duplikaterkennung pro Publisher
+ *
+ * Wertet die Sequenznummern aus MessageEnvelope aus. Pro Publisher wird die
+ * höchste gesehene Sequenznummer und ein 64-Bit Empfangsfenster geführt
+ * (wie beim Anti-Replay-Fenster von IPsec):
+ * - Sprung nach vorne  -> fehlende Nummern werden als verloren gezählt
+ * - Nachzügler im Fenster -> war als verloren gezählt, wird als umsortiert verbucht
+ * - Bereits gesehene Nummer -> Duplikat
+ * - Neue Epoch im Umschlag -> Neustart des Publishers, auch wenn Sequenz 0
+ *   verloren ging; Nachzügler der vorigen Epoch innerhalb ihres letzten
+ *   Fensters gelten als Duplikat, außerhalb als erneuter Neustart (A -> B -> A)
+ * - Sequenz 0 nach höheren Nummern -> Neustart (Sender ohne Epoch)
+ */
+class SequenceTracker
+{
+public:
+    /// Kennzahlen eines Publishers (oder Summe über alle)
+    struct Stats {
+        quint64 received = 0;                                ///< Empfangene Nachrichten (ohne Duplikate)
+        quint64 lost = 0;                                    ///< Fehlende Sequenznummern
+        quint64 duplicates = 0;                              ///< Doppelt empfangene Nachrichten
+        quint64 reordered = 0;                               ///< Verspätet eingetroffene Nachrichten
+        quint64 resets = 0;                                  ///< Erkannte Publisher-Neustarts
+        qint64 lastLatencyNs = -1;                           ///< Letzte Einweg-Latenz (-1 = unbekannt)
+        qint64 minLatencyNs = -1;                            ///< Minimale Einweg-Latenz
+        qint64 maxLatencyNs = -1;                            ///< Maximale Einweg-Latenz
+        double avgLatencyNs = 0.0;                           ///< Gleitender Mittelwert (EWMA, alpha = 1/16)
+    };
+
+    /**
+     * @brief Verbucht einen empfangenen Umschlag
+     * @param view Geparster Umschlag
+     * @param receiveNs Empfangszeitpunkt (MessageEnvelope::monotonicNs())
+     * @return false wenn die Nachricht ein Duplikat ist
+     */
+    bool record(const MessageEnvelope::View &view, quint64 receiveNs);
+
+    /// Kennzahlen eines einzelnen Publishers
+    Stats stats(quint32 publisherId) const;
+
+    /// Summe über alle Publisher (Latenzen: Minimum/Maximum über alle)
+    Stats totals() const;
+
+    /// IDs aller bekannten Publisher
+    QList<quint32> publishers() const { return m_publishers.keys(); }
+
+    /// Vergisst alle Publisher
+    void clear() { m_publishers.clear(); }
+
+private:
+    struct PublisherState {
+        Stats stats;
+        quint32 highest = 0;                                 ///< Höchste gesehene Sequenznummer
+        quint64 window = 0;                                  ///< Bit i = Sequenz (highest - i) empfangen
+        quint8 epoch = 0;                                    ///< Aktuelle Epoch des Publishers (0 = ohne)
+        quint8 previousEpoch = 0;                            ///< Epoch vor dem letzten Neustart
+        quint32 previousHighest = 0;                         ///< Höchste Sequenz der vorigen Epoch
+    };
+
+    static void restart(PublisherState &state, const MessageEnvelope::View &view);
+
+    static void recordLatency(Stats &stats, qint64 latencyNs);
+
+    QHash<quint32, PublisherState> m_publishers;             ///< Map: Publisher-ID -> Zustand
+};
+
+#endif // SEQUENCETRACKER_H
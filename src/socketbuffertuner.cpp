@@ -0,0 +1,182 @@
+#include "socketbuffertuner.h"
+
+#include <cmath>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <linux/tcp.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+/// Abklingfaktor der Spitzenrate pro Auswertung
+constexpr double RateDecay = 0.75;
+
+}
+
+SocketBufferTuner::SocketBufferTuner()
+    : SocketBufferTuner(Config())
+{
+}
+
+SocketBufferTuner::SocketBufferTuner(const Config &config)
+    : m_config(config)
+{
+}
+
+void SocketBufferTuner::reset(int sendBuffer, int receiveBuffer)
+{
+    m_metrics = Metrics();
+    m_metrics.sendBuffer = sendBuffer;
+    m_metrics.receiveBuffer = receiveBuffer;
+    m_last = Sample();
+}
+
+/**
+ * @brief Raten aus den Bytezählern, BDP und Zielgrößen
+ *
+ * Die erste Messung einer Verbindung dient nur als Bezugspunkt. Ohne
+ * Datenverkehr ist das BDP 0 und es wird nichts gesetzt.
+ */
+bool SocketBufferTuner::update(const Sample &sample)
+{
+    const Sample last = m_last;
+    m_last = sample;
+    if (sample.rttUs > 0)
+        m_metrics.rttUs = sample.rttUs;
+    if (last.nowNs == 0 || sample.nowNs <= last.nowNs)
+        return false;
+
+    const double seconds = (sample.nowNs - last.nowNs) / 1e9;
+    double sendRate = sample.bytesAcked >= last.bytesAcked ? (sample.bytesAcked - last.bytesAcked) / seconds : 0.0;
+    const double receiveRate = sample.bytesReceived >= last.bytesReceived ? (sample.bytesReceived - last.bytesReceived) / seconds : 0.0;
+    if (sample.deliveryRate > 0)
+        sendRate = qMax(sendRate, (double)sample.deliveryRate);
+
+    m_metrics.sendRate = qMax(sendRate, m_metrics.sendRate * RateDecay);
+    m_metrics.receiveRate = qMax(receiveRate, m_metrics.receiveRate * RateDecay);
+
+    if (m_metrics.rttUs <= 0)
+        return false;
+
+    m_metrics.sendBdp = (qint64)(m_metrics.sendRate * m_metrics.rttUs / 1e6);
+    m_metrics.receiveBdp = (qint64)(m_metrics.receiveRate * m_metrics.rttUs / 1e6);
+
+    const bool sendGrown = grow(m_metrics.sendBuffer, m_metrics.sendPinned, sample.sendBuffer,
+                                m_metrics.sendBdp, m_config.maxSendBuffer);
+    const bool receiveGrown = grow(m_metrics.receiveBuffer, m_metrics.receivePinned, sample.receiveBuffer,
+                                   m_metrics.receiveBdp, m_config.maxReceiveBuffer);
+    if (!sendGrown && !receiveGrown)
+        return false;
+
+    m_metrics.adjustments++;
+    return true;
+}
+
+bool SocketBufferTuner::grow(int &buffer, bool &pinned, int kernelBuffer, qint64 bdp, int maximum) const
+{
+    // Ungepinnt regelt der Kernel selbst - dessen Größe ist die Untergrenze
+    if (!pinned && kernelBuffer > 0)
+        buffer = kernelBuffer;
+    if (bdp <= 0)
+        return false;
+
+    const qint64 wanted = qMin<qint64>((qint64)std::ceil(bdp * m_config.headroom), maximum);
+    if (wanted <= (qint64)buffer * (1.0 + m_config.hysteresis))
+        return false;
+
+    buffer = (int)wanted;
+    pinned = true;
+    return true;
+}
+
+bool SocketBufferTuner::readTcpInfo(int fd, Sample *sample)
+{
+#ifdef Q_OS_LINUX
+    tcp_info info;
+    memset(&info, 0, sizeof(info));
+    socklen_t size = sizeof(info);
+    if (::getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &size) != 0)
+        return false;
+
+    // Ältere Kernel liefern eine kürzere Struktur
+    const auto has = [size](size_t offset, size_t fieldSize) { return (size_t)size >= offset + fieldSize; };
+    sample->rttUs = info.tcpi_rtt > 0 ? (qint64)info.tcpi_rtt : -1;
+    if (has(offsetof(tcp_info, tcpi_bytes_acked), sizeof(info.tcpi_bytes_acked)))
+        sample->bytesAcked = info.tcpi_bytes_acked;
+    if (has(offsetof(tcp_info, tcpi_bytes_received), sizeof(info.tcpi_bytes_received)))
+        sample->bytesReceived = info.tcpi_bytes_received;
+    if (has(offsetof(tcp_info, tcpi_delivery_rate), sizeof(info.tcpi_delivery_rate)) && !info.tcpi_delivery_rate_app_limited)
+        sample->deliveryRate = (qint64)info.tcpi_delivery_rate;
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(sample)
+    return false;
+#endif
+}
+
+bool SocketBufferTuner::readBuffers(int fd, int *sendBuffer, int *receiveBuffer)
+{
+#ifdef Q_OS_LINUX
+    int value = 0;
+    socklen_t size = sizeof(value);
+    if (::getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &value, &size) != 0)
+        return false;
+    *sendBuffer = value / 2;    // Kernel verdoppelt für Verwaltungsdaten
+    size = sizeof(value);
+    if (::getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &value, &size) != 0)
+        return false;
+    *receiveBuffer = value / 2;
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(sendBuffer)
+    Q_UNUSED(receiveBuffer)
+    return false;
+#endif
+}
+
+bool SocketBufferTuner::applyBuffers(int fd, int sendBuffer, int receiveBuffer, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    if ((sendBuffer > 0 && ::setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer)) != 0)
+        || (receiveBuffer > 0 && ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer)) != 0)) {
+        if (errorString)
+            *errorString = "Socketpuffer konnten nicht gesetzt werden: " + QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(sendBuffer)
+    Q_UNUSED(receiveBuffer)
+    if (errorString)
+        *errorString = "Socketpuffer-Regelung wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+bool SocketBufferTuner::applyNotSentLowWatermark(int fd, int bytes, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    // 0xFFFFFFFF = unbegrenzt (Standardwert von net.ipv4.tcp_notsent_lowat)
+    const unsigned int value = bytes < 0 ? 0xFFFFFFFFu : (unsigned int)bytes;
+    if (::setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &value, sizeof(value)) != 0) {
+        if (errorString)
+            *errorString = "TCP_NOTSENT_LOWAT konnte nicht gesetzt werden: " + QString::fromLocal8Bit(strerror(errno));
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(fd)
+    Q_UNUSED(bytes)
+    if (errorString)
+        *errorString = "TCP_NOTSENT_LOWAT wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
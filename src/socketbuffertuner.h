@@ -0,0 +1,126 @@
+#ifndef SOCKETBUFFERTUNER_H
+#define SOCKETBUFFERTUNER_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief Regler für die Kernel-Socketpuffer einer Verbindung
+ *
+ * Vergrößert SO_SNDBUF und SO_RCVBUF nach dem Bandbreiten-Verzögerungs-
+ * Produkt (BDP = Datenrate x RTT), wenn die Autotuning-Logik des Kernels
+ * dahinter zurückbleibt - etwa auf einem Uplink mit hoher Latenz, wo ein
+ * zu kleiner Puffer den Durchsatz begrenzt.
+ *
+ * Eingangsgrößen (alle EvaluationIntervalMs aus TCP_INFO gelesen):
+ * - RTT des Kernels (tcpi_rtt)
+ * - bestätigte und empfangene Bytes (tcpi_bytes_acked, tcpi_bytes_received)
+ * - Zustellrate des Kernels (tcpi_delivery_rate), falls vorhanden
+ * - aktuelle Puffergrößen des Kernels (SO_SNDBUF, SO_RCVBUF)
+ *
+ * Die Rate wird als Spitzenwert mit Abklingen geführt. Zielgröße ist
+ * headroom x BDP bis zur Obergrenze; ein Puffer, der den Durchsatz
+ * begrenzt, misst ein BDP nahe seiner eigenen Größe und wächst damit
+ * um den Faktor headroom pro Auswertung.
+ *
+ * Ein explizit gesetzter Puffer schaltet das Autotuning des Kernels für
+ * diese Richtung ab. Der Regler setzt daher nur, wenn ein echtes BDP
+ * gemessen wurde (Datenverkehr und RTT) und die Zielgröße die aktuelle
+ * Größe des Kernels um mehr als hysteresis übersteigt - nie kleiner.
+ * Solange nichts gesetzt ist, folgt die Zielgröße dem Kernel. Die
+ * Obergrenze des Kernels (net.core.wmem_max / rmem_max) gilt weiterhin.
+ *
+ * TCP_NOTSENT_LOWAT begrenzt zusätzlich die noch nicht gesendeten Bytes
+ * im Kernel - der Rückstau bleibt im Sendepuffer des MqttClient, wo ihn
+ * Sammelfenster und Steuer-Warteschlange sehen.
+ */
+class SocketBufferTuner
+{
+public:
+    /// Konfiguration des Reglers
+    struct Config {
+        int maxSendBuffer = 4 * 1024 * 1024;                 ///< Obergrenze SO_SNDBUF (Bytes)
+        int maxReceiveBuffer = 4 * 1024 * 1024;              ///< Obergrenze SO_RCVBUF (Bytes)
+        double headroom = 2.0;                               ///< Puffer als Vielfaches des BDP
+        double hysteresis = 0.25;                            ///< Relative Vergrößerung, ab der gesetzt wird
+        int notSentLowWatermark = -1;                        ///< TCP_NOTSENT_LOWAT in Bytes (-1 = Kernel-Vorgabe)
+    };
+
+    /// Messwerte einer Auswertung
+    struct Sample {
+        qint64 nowNs = 0;                                    ///< Monotone Zeit
+        qint64 rttUs = -1;                                   ///< Geglättete RTT des Kernels (-1 = unbekannt)
+        quint64 bytesAcked = 0;                              ///< Vom Empfänger bestätigte Bytes (kumuliert)
+        quint64 bytesReceived = 0;                           ///< Empfangene Bytes (kumuliert)
+        qint64 deliveryRate = -1;                            ///< Zustellrate des Kernels in Bytes/s (-1 = unbekannt)
+        int sendBuffer = 0;                                  ///< Aktuelle Größe SO_SNDBUF im Kernel (0 = unbekannt)
+        int receiveBuffer = 0;                               ///< Aktuelle Größe SO_RCVBUF im Kernel (0 = unbekannt)
+    };
+
+    /// Kennzahlen für Monitoring
+    struct Metrics {
+        qint64 rttUs = -1;
+        double sendRate = 0.0;                               ///< Spitzenrate senden (Bytes/s, abklingend)
+        double receiveRate = 0.0;                            ///< Spitzenrate empfangen (Bytes/s, abklingend)
+        qint64 sendBdp = 0;                                  ///< BDP Senderichtung (Bytes)
+        qint64 receiveBdp = 0;                               ///< BDP Empfangsrichtung (Bytes)
+        int sendBuffer = 0;                                  ///< Aktuelle Größe SO_SNDBUF (Kernel oder gesetzt)
+        int receiveBuffer = 0;                               ///< Aktuelle Größe SO_RCVBUF (Kernel oder gesetzt)
+        bool sendPinned = false;                             ///< SO_SNDBUF gesetzt, Kernel-Autotuning aus
+        bool receivePinned = false;                          ///< SO_RCVBUF gesetzt, Kernel-Autotuning aus
+        quint64 adjustments = 0;                             ///< Anzahl vergrößerter Zielgrößen
+    };
+
+    static constexpr int EvaluationIntervalMs = 1000;        ///< Abstand der Auswertungen
+
+    SocketBufferTuner();
+    explicit SocketBufferTuner(const Config &config);
+
+    void setConfig(const Config &config) { m_config = config; }
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief Startet die Messung für eine neue Verbindung
+     * @param sendBuffer Aktuelle Größe SO_SNDBUF (Ausgangswert)
+     * @param receiveBuffer Aktuelle Größe SO_RCVBUF (Ausgangswert)
+     */
+    void reset(int sendBuffer, int receiveBuffer);
+
+    /**
+     * @brief Wertet eine Messung aus
+     * @return true wenn eine Zielgröße gewachsen ist (gepinnte Puffer neu setzen)
+     */
+    bool update(const Sample &sample);
+
+    int sendBuffer() const { return m_metrics.sendBuffer; }
+    int receiveBuffer() const { return m_metrics.receiveBuffer; }
+
+    const Metrics& metrics() const { return m_metrics; }
+
+    // Socket-Zugriff (nur Linux, sonst false mit Fehlermeldung)
+
+    /// Liest RTT, Bytezähler und Zustellrate aus TCP_INFO
+    static bool readTcpInfo(int fd, Sample *sample);
+
+    /// Liest die aktuellen Puffergrößen (ohne die Verdopplung durch den Kernel)
+    static bool readBuffers(int fd, int *sendBuffer, int *receiveBuffer);
+
+    /// Setzt SO_SNDBUF und SO_RCVBUF (0 = Richtung nicht anfassen)
+    static bool applyBuffers(int fd, int sendBuffer, int receiveBuffer, QString *errorString = nullptr);
+
+    /// Setzt TCP_NOTSENT_LOWAT (bytes < 0: Kernel-Vorgabe wiederherstellen)
+    static bool applyNotSentLowWatermark(int fd, int bytes, QString *errorString = nullptr);
+
+private:
+    /**
+     * @brief Passt eine Richtung an
+     * @return true wenn die Zielgröße über die aktuelle Größe gewachsen ist
+     */
+    bool grow(int &buffer, bool &pinned, int kernelBuffer, qint64 bdp, int maximum) const;
+
+    Config m_config;
+    Metrics m_metrics;
+    Sample m_last;                                           ///< Vorherige Messung (nowNs = 0: keine)
+};
+
+#endif // SOCKETBUFFERTUNER_H
@@ -0,0 +1,132 @@
+#ifndef SWITCHCOMMANDFRAME_H
+#define SWITCHCOMMANDFRAME_H
+
+#include <QtGlobal>
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Zur Compile-Zeit erzeugte PUBLISH-Pakete für Umschaltbefehle
+ *
+ * Die Befehle an das Umschaltgerät bilden eine kleine feste Menge. Das
+ * vollständige MQTT-Paket (Fixed Header, Topic, JSON-Payload) wird deshalb
+ * als constexpr Byte-Array erzeugt. Zur Laufzeit wird nur die
+ * Korrelations-ID eingetragen:
+ * @code
+ * 0x30 <len> <topic len> switch/set {"target":"secure","id":        42}
+ * @endcode
+ *
+ * Die ID steht rechtsbündig in einem Feld fester Breite, davor Leerzeichen
+ * (gültiges JSON). Paketlänge und alle Offsets bleiben damit konstant.
+ *
+ * Verwendung:
+ * @code
+ * static constexpr auto Secure = SwitchCommandFrame::make("switch/set", "secure");
+ * std::array<char, Secure.bytes.size()> frame = Secure.bytes;
+ * SwitchCommandFrame::patchId(frame.data() + Secure.idOffset, 42);
+ * socket->write(frame.data(), frame.size());
+ * @endcode
+ */
+namespace SwitchCommandFrame
+{
+    constexpr int IdDigits = 10;                             ///< Stellen für eine quint32-ID
+
+    constexpr char PayloadPrefix[] = "{\"target\":\"";
+    constexpr char PayloadMiddle[] = "\",\"id\":";
+    constexpr char PayloadSuffix[] = "}";
+
+    /// Länge eines Literals ohne Nullterminator
+    template <std::size_t N>
+    constexpr int literalSize(const char (&)[N]) { return (int)N - 1; }
+
+    /// Größe der JSON-Payload für einen Zielnamen der Länge nameSize
+    constexpr int payloadSize(int nameSize)
+    {
+        return literalSize(PayloadPrefix) + nameSize + literalSize(PayloadMiddle) + IdDigits + literalSize(PayloadSuffix);
+    }
+
+    /// Remaining Length des PUBLISH-Pakets (Topic-Länge, Topic, Payload)
+    constexpr int remainingLength(int topicSize, int nameSize)
+    {
+        return 2 + topicSize + payloadSize(nameSize);
+    }
+
+    /// Gesamtgröße (Fixed Header mit einem Längenbyte + Remaining Length)
+    constexpr std::size_t frameSize(int topicSize, int nameSize)
+    {
+        return (std::size_t)(2 + remainingLength(topicSize, nameSize));
+    }
+
+    /**
+     * @brief Vorbereitetes Paket mit den Offsets der Laufzeitfelder
+     */
+    template <std::size_t Size>
+    struct Frame {
+        std::array<char, Size> bytes{};
+        int payloadOffset = 0;                               ///< Beginn der JSON-Payload
+        int payloadSize = 0;                                 ///< Länge der JSON-Payload
+        int idOffset = 0;                                    ///< Beginn des ID-Felds (IdDigits Zeichen)
+    };
+
+    /**
+     * @brief Erzeugt das Paket für Topic und Zielnamen
+     * @param topic Befehls-Topic (Literal)
+     * @param name Zielname im Geräteprotokoll (Literal)
+     *
+     * QoS 0, kein Retain. Die ID ist mit 0 vorbelegt.
+     */
+    template <std::size_t TopicN, std::size_t NameN>
+    constexpr Frame<frameSize((int)TopicN - 1, (int)NameN - 1)> make(const char (&topic)[TopicN], const char (&name)[NameN])
+    {
+        constexpr int topicSize = (int)TopicN - 1;
+        constexpr int nameSize = (int)NameN - 1;
+        static_assert(remainingLength(topicSize, nameSize) < 128, "Remaining Length muss in ein Byte passen");
+
+        Frame<frameSize(topicSize, nameSize)> frame;
+        int pos = 0;
+
+        frame.bytes[pos++] = (char)0x30;                     // PUBLISH, QoS 0
+        frame.bytes[pos++] = (char)remainingLength(topicSize, nameSize);
+        frame.bytes[pos++] = (char)(topicSize >> 8);
+        frame.bytes[pos++] = (char)(topicSize & 0xFF);
+        for (int i = 0; i < topicSize; ++i)
+            frame.bytes[pos++] = topic[i];
+
+        frame.payloadOffset = pos;
+        frame.payloadSize = payloadSize(nameSize);
+        for (int i = 0; i < literalSize(PayloadPrefix); ++i)
+            frame.bytes[pos++] = PayloadPrefix[i];
+        for (int i = 0; i < nameSize; ++i)
+            frame.bytes[pos++] = name[i];
+        for (int i = 0; i < literalSize(PayloadMiddle); ++i)
+            frame.bytes[pos++] = PayloadMiddle[i];
+
+        frame.idOffset = pos;
+        for (int i = 0; i < IdDigits - 1; ++i)
+            frame.bytes[pos++] = ' ';
+        frame.bytes[pos++] = '0';
+
+        for (int i = 0; i < literalSize(PayloadSuffix); ++i)
+            frame.bytes[pos++] = PayloadSuffix[i];
+
+        return frame;
+    }
+
+    /**
+     * @brief Trägt die ID rechtsbündig in das Feld ein
+     * @param field Zeiger auf das ID-Feld (IdDigits Zeichen)
+     * @param id Korrelations-ID
+     */
+    inline void patchId(char *field, quint32 id)
+    {
+        char *p = field + IdDigits;
+        do {
+            *--p = (char)('0' + id % 10);
+            id /= 10;
+        } while (id != 0);
+        while (p > field)
+            *--p = ' ';
+    }
+}
+
+#endif // SWITCHCOMMANDFRAME_H
@@ -0,0 +1,288 @@
+#include "switchcontroller.h"
+#include "jsonview.h"
+#include "messageenvelope.h"
+#include "switchcommandframe.h"
+#include <QDebug>
+
+namespace {
+
+constexpr bool sameText(const char *a, const char *b)
+{
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+static_assert(sameText(SwitchController::CommandTopic, "switch/set"), "Vorbereitete Pakete passen nicht zu CommandTopic");
+
+constexpr auto SecureFrame = SwitchCommandFrame::make("switch/set", "secure");
+constexpr auto UnsecureFrame = SwitchCommandFrame::make("switch/set", "unsecure");
+
+/// Typunabhängige Sicht auf ein constexpr Paket
+struct KnownFrame {
+    const char *name;
+    const char *bytes;
+    int size;
+    int payloadOffset;
+    int payloadSize;
+    int idOffset;
+};
+
+template <typename Frame>
+KnownFrame known(const char *name, const Frame &frame)
+{
+    return {name, frame.bytes.data(), (int)frame.bytes.size(), frame.payloadOffset, frame.payloadSize, frame.idOffset};
+}
+
+const KnownFrame KnownFrames[] = {
+    known("secure", SecureFrame),
+    known("unsecure", UnsecureFrame),
+};
+
+} // namespace
+
+/**
+ * @brief Konstruktor - Zustand des Geräts ist zunächst unbekannt
+ */
+SwitchController::SwitchController(QObject *parent)
+    : QObject(parent)
+    , m_timerWheel(TimerWheel::forCurrentThread())
+    , m_deadlineTimer(0)
+    , m_commandId(0)
+    , m_confirmed(-1)
+    , m_commandsSent(0)
+    , m_shortCircuited(0)
+    , m_coalesced(0)
+{
+}
+
+SwitchController::~SwitchController()
+{
+    m_timerWheel->cancel(m_deadlineTimer);
+}
+
+/**
+ * @brief Nimmt eine Anfrage an und ordnet sie einer Gruppe zu
+ *
+ * Ablauf:
+ * - Kein Befehl unterwegs, Ziel bestätigt   -> sofort true
+ * - Kein Befehl unterwegs                  -> Befehl senden
+ * - Ziel == laufender Befehl               -> laufender Gruppe beitreten,
+ *                                             vorgemerktes Ziel ist überholt
+ * - Ziel == vorgemerktes Ziel              -> vorgemerkter Gruppe beitreten
+ * - sonst                                  -> vorgemerktes Ziel ersetzen
+ *
+ * Aufrufer eines überholten Ziels erhalten false - ihr Ziel wird nicht
+ * mehr angefahren und darf nicht als erreicht gelten.
+ */
+void SwitchController::request(int target, int timeoutMs, Callback callback)
+{
+    if (!isSwitching()) {
+        if (target == m_confirmed) {
+            m_shortCircuited++;
+            qDebug() << "Umschalten nicht nötig - Ziel bereits aktiv:" << m_names.value(target);
+            callback(true);
+            return;
+        }
+
+        Batch batch;
+        batch.target = target;
+        batch.timeoutMs = timeoutMs;
+        batch.waiters.append(callback);
+        start(batch);
+        return;
+    }
+
+    m_coalesced++;
+
+    if (target == m_inFlight.target) {
+        // Letzter Wunsch entspricht dem laufenden Befehl - Vormerkung entfällt
+        m_inFlight.waiters.append(callback);
+        supersedePending();
+        return;
+    }
+
+    if (target == m_pending.target) {
+        m_pending.timeoutMs = timeoutMs;
+        m_pending.waiters.append(callback);
+        return;
+    }
+
+    // Nur das letzte Ziel wird nach dem laufenden Befehl gesendet
+    supersedePending();
+    m_pending.target = target;
+    m_pending.timeoutMs = timeoutMs;
+    m_pending.waiters.append(callback);
+    qDebug() << "Umschalten vorgemerkt:" << m_names.value(target);
+}
+
+/**
+ * @brief Verwirft das vorgemerkte Ziel, dessen Aufrufer erhalten false
+ *
+ * Die Vormerkung ist vor den Callbacks bereits geleert, erneute Anfragen
+ * aus einem Callback werden normal einsortiert.
+ */
+void SwitchController::supersedePending()
+{
+    if (m_pending.target < 0)
+        return;
+
+    qDebug() << "Vorgemerktes Ziel überholt:" << m_names.value(m_pending.target);
+    Batch superseded = std::move(m_pending);
+    m_pending = Batch();
+    for (const Callback &waiter : superseded.waiters)
+        waiter(false);
+}
+
+/**
+ * @brief Wertet die Zustandsmeldung des Geräts aus
+ *
+ * Jede Meldung aktualisiert den bestätigten Zustand. Ein laufender Befehl
+ * ist erfolgreich, sobald das Gerät sein Ziel meldet. Meldet das Gerät mit
+ * passender ID einen anderen Zustand, wurde der Befehl abgelehnt.
+ *
+ * Es werden nur die Felder "state" und "id" gelesen, ohne das Dokument
+ * vollständig zu parsen.
+ */
+void SwitchController::handleStateMessage(const QByteArray &payload)
+{
+    JsonView state(payload);
+    const JsonView::Value stateValue = state.value("state");
+    if (stateValue.isMissing())
+        return;
+
+    const QString name = stateValue.toString();
+    m_confirmed = m_names.key(name, -1);
+    qDebug() << "Umschalter meldet Zustand:" << name;
+
+    if (!isSwitching())
+        return;
+
+    const JsonView::Value idValue = state.value("id");
+    const bool hasId = !idValue.isMissing();
+    bool idValid = false;
+    if (hasId && ((quint32)idValue.toInteger(0, &idValid) != m_commandId || !idValid))
+        return;  // Meldung zu einem älteren Befehl (oder ungültige ID)
+
+    if (m_confirmed == m_inFlight.target)
+        finish(true);
+    else if (hasId)
+        finish(false);
+}
+
+/**
+ * @brief Sendet den Befehl für eine Gruppe und startet das Timeout
+ */
+void SwitchController::start(Batch batch)
+{
+    m_inFlight = std::move(batch);
+    m_commandId++;
+
+    Command command;
+    auto prepared = m_prepared.find(m_inFlight.target);
+    if (prepared != m_prepared.end()) {
+        // Nur die ID eintragen, das Paket liegt fertig vor
+        char *frame = prepared->frame.data();
+        SwitchCommandFrame::patchId(frame + prepared->idOffset, m_commandId);
+        command.frame = frame;
+        command.frameSize = prepared->frame.size();
+        command.payload = QByteArray::fromRawData(frame + prepared->payloadOffset, prepared->payloadSize);
+    } else {
+        command.payload = createCommandPayload(m_inFlight.target, m_commandId);
+    }
+    command.deadlineNs = (qint64)MessageEnvelope::monotonicNs() + (qint64)m_inFlight.timeoutMs * 1000000;
+
+    if (!m_sender || !m_sender(command)) {
+        qDebug() << "Umschaltbefehl konnte nicht gesendet werden";
+        finish(false);
+        return;
+    }
+
+    m_commandsSent++;
+    m_deadlineTimer = m_timerWheel->schedule(m_inFlight.timeoutMs, [this]() {
+        m_deadlineTimer = 0;
+        onDeadline();
+    });
+    qDebug() << "Umschaltbefehl gesendet:" << m_names.value(m_inFlight.target) << "ID" << m_commandId;
+}
+
+/**
+ * @brief Schließt den laufenden Befehl ab und startet ggf. das vorgemerkte Ziel
+ *
+ * Das vorgemerkte Ziel wird vor den Callbacks gestartet, damit erneute
+ * Anfragen aus einem Callback korrekt in die neue Gruppe einsortiert werden.
+ */
+void SwitchController::finish(bool success)
+{
+    m_timerWheel->cancel(m_deadlineTimer);
+    m_deadlineTimer = 0;
+
+    Batch done = std::move(m_inFlight);
+    m_inFlight = Batch();
+    Batch next = std::move(m_pending);
+    m_pending = Batch();
+
+    if (next.target >= 0 && next.target != m_confirmed) {
+        start(next);
+        next = Batch();
+    }
+
+    emit switched(done.target, success);
+    for (const Callback &waiter : done.waiters)
+        waiter(success);
+
+    // Vorgemerktes Ziel wurde bereits durch den abgeschlossenen Befehl erreicht
+    if (next.target >= 0) {
+        m_shortCircuited += next.waiters.size();
+        for (const Callback &waiter : next.waiters)
+            waiter(true);
+    }
+}
+
+/**
+ * @brief Keine Bestätigung innerhalb des Timeouts
+ *
+ * Der Zustand des Geräts ist danach unbekannt, damit der nächste
+ * Befehl auf jeden Fall gesendet wird.
+ */
+void SwitchController::onDeadline()
+{
+    qDebug() << "Umschalten Timeout - keine Bestätigung für ID" << m_commandId;
+    m_confirmed = -1;
+    finish(false);
+}
+
+/**
+ * @brief Übernimmt für bekannte Zielnamen das constexpr Paket
+ *
+ * Die Kopie gehört dem Controller allein, das Eintragen der ID
+ * verändert sie daher ohne Kopieren.
+ */
+void SwitchController::setTargetName(int target, const QString &name)
+{
+    m_names[target] = name;
+    m_prepared.remove(target);
+
+    for (const KnownFrame &known : KnownFrames) {
+        if (name == known.name) {
+            PreparedCommand prepared;
+            prepared.frame = QByteArray(known.bytes, known.size);
+            prepared.payloadOffset = known.payloadOffset;
+            prepared.payloadSize = known.payloadSize;
+            prepared.idOffset = known.idOffset;
+            m_prepared.insert(target, prepared);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Erstellt die JSON-Payload eines Umschaltbefehls (Ziele ohne vorbereitetes Paket)
+ */
+QByteArray SwitchController::createCommandPayload(int target, quint32 commandId) const
+{
+    return "{\"target\":\"" + m_names.value(target).toUtf8()
+         + "\",\"id\":" + QByteArray::number(commandId) + "}";
+}
@@ -0,0 +1,161 @@
+#ifndef SWITCHCONTROLLER_H
+#define SWITCHCONTROLLER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <memory>
+
+#include "timerwheel.h"
+
+/**
+ * @brief Zustandsautomat für Umschaltbefehle an das Umschaltgerät
+ *
+ * Befehle werden als PUBLISH auf CommandTopic gesendet, das Gerät bestätigt
+ * den tatsächlichen Zustand auf StateTopic:
+ * @code
+ * switch/set   {"target":"secure","id":42}
+ * switch/state {"state":"secure","id":42}
+ * @endcode
+ *
+ * Der Automat verhindert unnötige Befehle:
+ * - Ziel bereits bestätigt und kein Befehl unterwegs -> sofort Erfolg, nichts senden
+ * - Gleiches Ziel wie der laufende Befehl -> Aufrufer wartet auf dessen Ergebnis
+ * - Anderes Ziel während ein Befehl läuft -> wird vorgemerkt; spätere Anfragen
+ *   ersetzen das vorgemerkte Ziel, es wird nur das letzte gesendet
+ *
+ * Alle Aufrufer einer Gruppe (laufend bzw. vorgemerkt) erhalten dasselbe
+ * Ergebnis. Eine Gruppe enthält nur Aufrufer mit demselben Ziel; wird ein
+ * vorgemerktes Ziel überholt, erhalten dessen Aufrufer false.
+ *
+ * Für die Zielnamen "secure" und "unsecure" liegen die vollständigen
+ * PUBLISH-Pakete bereits zur Compile-Zeit vor (SwitchCommandFrame), beim
+ * Senden wird nur die ID eingetragen.
+ */
+class SwitchController : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Ergebnis-Callback: true wenn das Gerät das Ziel bestätigt hat
+    using Callback = std::function<void(bool success)>;
+
+    /**
+     * @brief Ein zu sendender Befehl
+     *
+     * frame ist nur bis zur Rückkehr des CommandSender gültig.
+     */
+    struct Command {
+        QByteArray payload;                                  ///< JSON-Payload (bei frame eine Sicht darauf)
+        const char *frame = nullptr;                         ///< Fertiges PUBLISH-Paket auf CommandTopic (nullptr = keins)
+        int frameSize = 0;
+        qint64 deadlineNs = 0;                               ///< Ende der Wartezeit (MessageEnvelope::monotonicNs()), danach zwecklos
+    };
+
+    /// Versendet einen Befehl, liefert false wenn kein Versand möglich war
+    using CommandSender = std::function<bool(const Command &command)>;
+
+    static constexpr const char *CommandTopic = "switch/set";     ///< Topic für Umschaltbefehle
+    static constexpr const char *StateTopic = "switch/state";     ///< Topic für Zustandsmeldungen des Geräts
+
+    /**
+     * @brief Konstruktor
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     */
+    explicit SwitchController(QObject *parent = nullptr);
+    ~SwitchController() override;
+
+    /**
+     * @brief Legt fest, wie Befehle versendet werden
+     */
+    void setCommandSender(CommandSender sender) { m_sender = std::move(sender); }
+
+    /**
+     * @brief Ordnet einem Ziel den Namen im Geräteprotokoll zu
+     * @param target Ziel-ID (z.B. NetworkSelector::Secure)
+     * @param name Name im Protokoll (z.B. "secure")
+     *
+     * Für bekannte Namen wird das vorbereitete Paket übernommen.
+     */
+    void setTargetName(int target, const QString &name);
+
+    /**
+     * @brief Fordert eine Umschaltung an
+     * @param target Ziel-ID
+     * @param timeoutMs Maximale Wartezeit auf die Bestätigung
+     * @param callback Wird genau einmal mit dem Ergebnis aufgerufen
+     *
+     * Der Callback kann noch innerhalb dieses Aufrufs ausgelöst werden
+     * (bestätigtes Ziel oder Versandfehler).
+     */
+    void request(int target, int timeoutMs, Callback callback);
+
+    /**
+     * @brief Verarbeitet eine Zustandsmeldung des Geräts (StateTopic)
+     * @param payload JSON mit "state" und optional "id"
+     */
+    void handleStateMessage(const QByteArray &payload);
+
+    /// Vom Gerät bestätigter Zustand (-1 = unbekannt)
+    int confirmedTarget() const { return m_confirmed; }
+
+    /// true wenn ein Befehl auf Bestätigung wartet
+    bool isSwitching() const { return m_inFlight.target >= 0; }
+
+    /// Anzahl tatsächlich gesendeter Befehle
+    quint64 commandsSent() const { return m_commandsSent; }
+
+    /// Anzahl Anfragen, die ohne Befehl sofort erfolgreich waren
+    quint64 shortCircuited() const { return m_shortCircuited; }
+
+    /// Anzahl Anfragen, die einer laufenden oder vorgemerkten Gruppe beigetreten sind
+    quint64 coalesced() const { return m_coalesced; }
+
+signals:
+    /**
+     * @brief Eine Umschaltung ist abgeschlossen
+     * @param target Ziel der Umschaltung
+     * @param success true wenn bestätigt
+     */
+    void switched(int target, bool success);
+
+private:
+    /// Ziel mit allen wartenden Aufrufern
+    struct Batch {
+        int target = -1;
+        int timeoutMs = 0;
+        QVector<Callback> waiters;
+    };
+
+    /// Vorbereitetes Paket eines Ziels (veränderliche Kopie des constexpr Pakets)
+    struct PreparedCommand {
+        QByteArray frame;
+        int payloadOffset = 0;
+        int payloadSize = 0;
+        int idOffset = 0;
+    };
+
+    void start(Batch batch);
+    void finish(bool success);
+    void supersedePending();
+    void onDeadline();
+    QByteArray createCommandPayload(int target, quint32 commandId) const;
+
+    CommandSender m_sender;                                  ///< Versandweg für Befehle
+    QMap<int, QString> m_names;                              ///< Map: Ziel-ID -> Name im Protokoll
+    QMap<int, PreparedCommand> m_prepared;                   ///< Map: Ziel-ID -> vorbereitetes Paket
+    Batch m_inFlight;                                        ///< Gesendeter Befehl (target -1 = keiner)
+    Batch m_pending;                                         ///< Vorgemerktes Ziel (target -1 = keins)
+    TimerWheel *m_timerWheel;                                ///< Gemeinsames Timer-Rad des Threads
+    TimerWheel::TimerId m_deadlineTimer;                     ///< Timeout des laufenden Befehls (0 = keins)
+    quint32 m_commandId;                                     ///< Korrelations-ID des laufenden Befehls
+    int m_confirmed;                                         ///< Bestätigter Zustand (-1 = unbekannt)
+    quint64 m_commandsSent;                                  ///< Statistik: gesendete Befehle
+    quint64 m_shortCircuited;                                ///< Statistik: Anfragen ohne Befehl
+    quint64 m_coalesced;                                     ///< Statistik: zusammengefasste Anfragen
+};
+
+#endif // SWITCHCONTROLLER_H
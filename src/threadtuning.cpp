@@ -0,0 +1,172 @@
+#include "threadtuning.h"
+#include <QStringList>
+
+#include <atomic>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+/// Ob mlockall() in diesem Prozess erfolgreich war (aus beliebigen Threads gelesen)
+static std::atomic<bool> s_memoryLocked(false);
+
+/// Größte darstellbare CPU-Nummer + 1
+static constexpr int MaxCpus = CPU_SETSIZE;
+#else
+static constexpr int MaxCpus = 1024;
+#endif
+
+bool ThreadTuning::applyToCurrentThread(const Placement &placement, QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    QStringList errors;
+
+    if (!placement.cpus.isEmpty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : placement.cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        }
+
+        // pid 0 = aufrufender Thread
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            errors << QString("CPU-Bindung an %1 fehlgeschlagen: %2")
+                          .arg(formatCpuList(placement.cpus), QString::fromLocal8Bit(strerror(errno)));
+    }
+
+    if (placement.fifoPriority > 0) {
+        sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), placement.fifoPriority,
+                                      sched_get_priority_max(SCHED_FIFO));
+
+        const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0)
+            errors << QString("SCHED_FIFO/%1 fehlgeschlagen: %2")
+                          .arg(param.sched_priority).arg(QString::fromLocal8Bit(strerror(result)));
+    }
+
+    if (errorString)
+        *errorString = errors.join("; ");
+    return errors.isEmpty();
+#else
+    Q_UNUSED(placement)
+    if (errorString)
+        *errorString = "Thread-Platzierung wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+bool ThreadTuning::lockMemory(QString *errorString)
+{
+#ifdef Q_OS_LINUX
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        if (errorString)
+            *errorString = QString("mlockall fehlgeschlagen: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    s_memoryLocked = true;
+    return true;
+#else
+    if (errorString)
+        *errorString = "mlockall wird nur unter Linux unterstützt";
+    return false;
+#endif
+}
+
+/**
+ * @brief Liest die tatsächlich wirksamen Einstellungen zurück
+ *
+ * Die Werte kommen vom Kernel, nicht aus der gewünschten Platzierung -
+ * z.B. durch cgroups (cpuset) eingeschränkte CPUs werden korrekt angezeigt.
+ */
+QString ThreadTuning::describeCurrentThread()
+{
+#ifdef Q_OS_LINUX
+    QVector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set))
+                cpus.append(cpu);
+        }
+    }
+
+    int policy = SCHED_OTHER;
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    pthread_getschedparam(pthread_self(), &policy, &param);
+
+    QString scheduler;
+    switch (policy) {
+    case SCHED_FIFO:  scheduler = QString("SCHED_FIFO/%1").arg(param.sched_priority); break;
+    case SCHED_RR:    scheduler = QString("SCHED_RR/%1").arg(param.sched_priority); break;
+    default:          scheduler = "SCHED_OTHER"; break;
+    }
+
+    return QString("tid %1 cpus %2 (läuft auf %3) %4 mlock %5")
+        .arg((qint64)syscall(SYS_gettid))
+        .arg(formatCpuList(cpus))
+        .arg(sched_getcpu())
+        .arg(scheduler)
+        .arg(s_memoryLocked.load() ? "ja" : "nein");
+#else
+    return "Thread-Platzierung nicht verfügbar";
+#endif
+}
+
+QVector<int> ThreadTuning::parseCpuList(const QString &spec, bool *ok)
+{
+    QVector<int> cpus;
+    bool valid = true;
+
+    for (const QString &part : spec.split(',')) {
+        const QString item = part.trimmed();
+        if (item.isEmpty())
+            continue;
+
+        const int dash = item.indexOf('-');
+        bool okFirst = false, okLast = true;
+        const int first = (dash < 0 ? item : item.left(dash)).toInt(&okFirst);
+        const int last = dash < 0 ? first : item.mid(dash + 1).toInt(&okLast);
+
+        if (!okFirst || !okLast || first < 0 || last < first || first >= MaxCpus) {
+            valid = false;
+            continue;
+        }
+
+        // "0-2000000000" würde sonst Milliarden Einträge anlegen
+        if (last >= MaxCpus)
+            valid = false;
+        for (int cpu = first; cpu <= qMin(last, MaxCpus - 1); ++cpu)
+            cpus.append(cpu);
+    }
+
+    if (ok)
+        *ok = valid;
+    return cpus;
+}
+
+QString ThreadTuning::formatCpuList(const QVector<int> &cpus)
+{
+    QStringList ranges;
+    int i = 0;
+    while (i < cpus.size()) {
+        int j = i;
+        while (j + 1 < cpus.size() && cpus.at(j + 1) == cpus.at(j) + 1)
+            j++;
+        ranges << (i == j ? QString::number(cpus.at(i))
+                          : QString("%1-%2").arg(cpus.at(i)).arg(cpus.at(j)));
+        i = j + 1;
+    }
+    return ranges.isEmpty() ? QString("-") : ranges.join(",");
+}
@@ -0,0 +1,81 @@
+#ifndef THREADTUNING_H
+#define THREADTUNING_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief CPU-Bindung, Echtzeit-Priorität und Speichersperre für Threads
+ *
+ * Scheduler-Jitter geht direkt in die Umschaltlatenz ein. Für den I/O-Thread
+ * (MqttReactor) und Handler-Worker kann deshalb festgelegt werden:
+ * - auf welchen CPUs der Thread laufen darf (sched_setaffinity)
+ * - ob er mit SCHED_FIFO und welcher Priorität läuft
+ *
+ * Zusätzlich kann der gesamte Prozessspeicher gesperrt werden (mlockall),
+ * damit keine Seitenfehler durch Auslagerung auftreten.
+ *
+ * SCHED_FIFO und mlockall benötigen CAP_SYS_NICE bzw. CAP_IPC_LOCK
+ * (oder passende RLIMIT_RTPRIO / RLIMIT_MEMLOCK). Schlägt eine Einstellung
+ * fehl, bleibt der Thread unverändert und der Fehler wird gemeldet.
+ *
+ * Verwendung:
+ * @code
+ * ThreadTuning::Placement placement;
+ * placement.cpus = {2};
+ * placement.fifoPriority = 50;
+ * QString error;
+ * if (!ThreadTuning::applyToCurrentThread(placement, &error))
+ *     qDebug() << error;
+ * qDebug() << ThreadTuning::describeCurrentThread();
+ * @endcode
+ *
+ * @note Nur unter Linux wirksam, sonst liefern alle Funktionen false.
+ */
+class ThreadTuning
+{
+public:
+    /// Gewünschte Platzierung eines Threads
+    struct Placement {
+        QVector<int> cpus;                                   ///< Erlaubte CPUs (leer = unverändert)
+        int fifoPriority = 0;                                ///< SCHED_FIFO Priorität 1-99 (0 = normaler Scheduler)
+
+        /// true wenn nichts geändert werden soll
+        bool isDefault() const { return cpus.isEmpty() && fifoPriority == 0; }
+    };
+
+    /**
+     * @brief Wendet die Platzierung auf den aufrufenden Thread an
+     * @param placement CPU-Menge und Priorität
+     * @param errorString Fehlerbeschreibung (optional)
+     * @return true wenn alle Einstellungen übernommen wurden
+     */
+    static bool applyToCurrentThread(const Placement &placement, QString *errorString = nullptr);
+
+    /**
+     * @brief Sperrt den aktuellen und künftigen Prozessspeicher im RAM
+     * @param errorString Fehlerbeschreibung (optional)
+     */
+    static bool lockMemory(QString *errorString = nullptr);
+
+    /**
+     * @brief Beschreibt die tatsächliche Platzierung des aufrufenden Threads
+     *
+     * Beispiel: "tid 4711 cpus 2-3 (läuft auf 2) SCHED_FIFO/50 mlock ja"
+     */
+    static QString describeCurrentThread();
+
+    /**
+     * @brief Liest eine CPU-Liste im Format "0,2,4-7"
+     * @param spec Textuelle CPU-Liste
+     * @param ok false bei ungültiger Angabe oder CPUs jenseits von CPU_SETSIZE (optional)
+     *
+     * Bereiche werden auf CPU_SETSIZE begrenzt.
+     */
+    static QVector<int> parseCpuList(const QString &spec, bool *ok = nullptr);
+
+    /// Formatiert eine CPU-Liste kompakt ("0,2,4-7")
+    static QString formatCpuList(const QVector<int> &cpus);
+};
+
+#endif // THREADTUNING_H
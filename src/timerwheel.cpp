@@ -0,0 +1,340 @@
+#include "timerwheel.h"
+#include <QtAlgorithms>
+
+#include <cstring>
+#include <limits>
+
+/**
+ * @brief Konstruktor - alle Slots leer, Zeitbasis startet bei Tick 0
+ */
+TimerWheel::TimerWheel(QObject *parent)
+    : QObject(parent)
+    , m_freeList(-1)
+    , m_current(0)
+    , m_scheduledTick(std::numeric_limits<quint64>::max())
+    , m_activeCount(0)
+    , m_dispatching(false)
+    , m_driver(std::make_unique<QTimer>(this))
+{
+    for (int level = 0; level < Levels; ++level) {
+        for (int slot = 0; slot < Slots; ++slot)
+            m_heads[level][slot] = -1;
+    }
+    memset(m_occupied, 0, sizeof(m_occupied));
+
+    m_clock.start();
+    m_driver->setSingleShot(true);
+    m_driver->setTimerType(Qt::PreciseTimer);
+    connect(m_driver.get(), &QTimer::timeout, this, &TimerWheel::onTick);
+}
+
+TimerWheel::~TimerWheel() = default;
+
+/**
+ * @brief Ein Rad pro Thread, Lebensdauer an den Thread gebunden
+ */
+TimerWheel* TimerWheel::forCurrentThread()
+{
+    static thread_local std::unique_ptr<TimerWheel> wheel;
+    if (!wheel)
+        wheel = std::make_unique<TimerWheel>();
+    return wheel.get();
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int delayMs, std::function<void()> callback)
+{
+    return arm(delayMs, 0, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleRepeating(int intervalMs, std::function<void()> callback)
+{
+    return arm(intervalMs, qMax(1, intervalMs), std::move(callback));
+}
+
+/**
+ * @brief Bricht einen Timer in O(1) ab
+ *
+ * Der treibende QTimer wird nicht umgestellt - ein überflüssiges
+ * Aufwachen ist billiger als die Neuberechnung.
+ */
+bool TimerWheel::cancel(TimerId id)
+{
+    const int index = nodeIndex(id);
+    if (index < 0)
+        return false;
+
+    unlink(index);
+
+    Node &node = m_nodes[index];
+    node.active = false;
+    node.callback = nullptr;
+    node.generation++;
+    node.next = m_freeList;
+    m_freeList = index;
+    m_activeCount--;
+    return true;
+}
+
+bool TimerWheel::isActive(TimerId id) const
+{
+    return nodeIndex(id) >= 0;
+}
+
+/**
+ * @brief Legt einen Timer im Knoten-Pool an und sortiert ihn ein
+ *
+ * Der Ablauf wird absolut zur aktuellen Uhrzeit berechnet, auch wenn das
+ * Rad selbst (m_current) noch nicht nachgezogen wurde.
+ */
+TimerWheel::TimerId TimerWheel::arm(int delayMs, int periodMs, std::function<void()> callback)
+{
+    // Leeres Rad direkt auf die aktuelle Zeit setzen, statt später
+    // die gesamte Leerlaufzeit Block für Block nachzuziehen
+    if (m_activeCount == 0 && !m_dispatching)
+        m_current = qMax(m_current, nowTicks());
+
+    int index = m_freeList;
+    if (index >= 0) {
+        m_freeList = m_nodes[index].next;
+    } else {
+        index = (int)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    // Während des Dispatch steht m_current auf dem laufenden Tick
+    const quint64 base = m_dispatching ? m_current : qMax(m_current, nowTicks());
+
+    Node &node = m_nodes[index];
+    node.expiry = base + (quint64)qMax(1, delayMs);
+    node.period = periodMs;
+    node.active = true;
+    node.callback = std::move(callback);
+    insert(index);
+    m_activeCount++;
+
+    const TimerId id = ((TimerId)node.generation << 32) | (quint32)(index + 1);
+
+    if (!m_dispatching && node.expiry < m_scheduledTick)
+        reschedule();
+
+    return id;
+}
+
+/**
+ * @brief Hängt einen Knoten in den passenden Slot
+ *
+ * Die Ebene ergibt sich aus dem Abstand zum aktuellen Tick,
+ * der Slot aus den entsprechenden 8 Bit des Ablauf-Ticks.
+ */
+void TimerWheel::insert(int index)
+{
+    Node &node = m_nodes[index];
+    const quint64 delta = node.expiry > m_current ? node.expiry - m_current : 0;
+
+    int level = 0;
+    while (level < Levels - 1 && delta >= (1ULL << (SlotBits * (level + 1))))
+        level++;
+
+    const int slot = (int)((node.expiry >> (SlotBits * level)) & SlotMask);
+    node.level = (quint8)level;
+    node.slot = (quint8)slot;
+    node.prev = -1;
+    node.next = m_heads[level][slot];
+
+    if (node.next >= 0)
+        m_nodes[node.next].prev = index;
+    m_heads[level][slot] = index;
+    m_occupied[level][slot / 64] |= 1ULL << (slot % 64);
+}
+
+void TimerWheel::unlink(int index)
+{
+    Node &node = m_nodes[index];
+
+    if (node.prev >= 0)
+        m_nodes[node.prev].next = node.next;
+    else
+        m_heads[node.level][node.slot] = node.next;
+
+    if (node.next >= 0)
+        m_nodes[node.next].prev = node.prev;
+
+    if (m_heads[node.level][node.slot] < 0)
+        m_occupied[node.level][node.slot / 64] &= ~(1ULL << (node.slot % 64));
+
+    node.prev = -1;
+    node.next = -1;
+}
+
+/**
+ * @brief Prüft ein Handle und liefert den Pool-Index
+ * @return Index oder -1 bei ungültigem/veraltetem Handle
+ */
+int TimerWheel::nodeIndex(TimerId id) const
+{
+    const int index = (int)(quint32)id - 1;
+    if (index < 0 || index >= (int)m_nodes.size())
+        return -1;
+
+    const Node &node = m_nodes[index];
+    if (!node.active || node.generation != (quint32)(id >> 32))
+        return -1;
+    return index;
+}
+
+/**
+ * @brief Treibender QTimer ist abgelaufen
+ */
+void TimerWheel::onTick()
+{
+    m_scheduledTick = std::numeric_limits<quint64>::max();
+    m_dispatching = true;
+    advanceTo(nowTicks());
+    m_dispatching = false;
+    reschedule();
+}
+
+/**
+ * @brief Zieht das Rad bis zum Ziel-Tick nach
+ *
+ * Leere Slots werden über die Belegungs-Bitmap übersprungen, so dass
+ * pro 256 Ticks höchstens eine Iteration (Ebenengrenze) anfällt.
+ */
+void TimerWheel::advanceTo(quint64 target)
+{
+    while (m_current < target) {
+        const quint64 tick = m_current + 1;
+        const quint64 blockStart = tick & ~(quint64)SlotMask;
+
+        quint64 candidate;
+        if ((tick & SlotMask) == 0) {
+            candidate = tick;  // Ebenengrenze - muss verarbeitet werden
+        } else {
+            const int slot = findOccupied(0, (int)(tick & SlotMask));
+            candidate = slot >= 0 ? blockStart + slot : blockStart + Slots;
+        }
+
+        if (candidate > target) {
+            m_current = target;
+            break;
+        }
+
+        m_current = candidate;
+
+        // An Ebenengrenzen Timer der höheren Ebenen nach unten verteilen
+        if ((candidate & SlotMask) == 0) {
+            for (int level = 1; level < Levels; ++level) {
+                cascade(level, candidate);
+                if (((candidate >> (SlotBits * level)) & SlotMask) != 0)
+                    break;
+            }
+        }
+
+        fireSlot(candidate);
+    }
+}
+
+/**
+ * @brief Verteilt alle Timer eines Slots einer höheren Ebene neu
+ */
+void TimerWheel::cascade(int level, quint64 tick)
+{
+    const int slot = (int)((tick >> (SlotBits * level)) & SlotMask);
+
+    int index = m_heads[level][slot];
+    m_heads[level][slot] = -1;
+    m_occupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+
+    while (index >= 0) {
+        const int next = m_nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+/**
+ * @brief Löst alle Timer des Ebene-0-Slots eines Ticks aus
+ *
+ * Der Callback wird kopiert, bevor er aufgerufen wird: er darf beliebig
+ * Timer anlegen oder abbrechen, auch den eigenen.
+ */
+void TimerWheel::fireSlot(quint64 tick)
+{
+    const int slot = (int)(tick & SlotMask);
+
+    while (m_heads[0][slot] >= 0) {
+        const int index = m_heads[0][slot];
+        unlink(index);
+
+        Node &node = m_nodes[index];
+        std::function<void()> callback = node.callback;
+
+        if (node.period > 0) {
+            node.expiry = tick + (quint64)node.period;
+            insert(index);
+        } else {
+            node.active = false;
+            node.callback = nullptr;
+            node.generation++;
+            node.next = m_freeList;
+            m_freeList = index;
+            m_activeCount--;
+        }
+
+        if (callback)
+            callback();
+    }
+}
+
+/**
+ * @brief Stellt den QTimer auf das nächste Ereignis oder stoppt ihn
+ */
+void TimerWheel::reschedule()
+{
+    const quint64 next = nextEventTick();
+    if (next == std::numeric_limits<quint64>::max()) {
+        m_driver->stop();
+        m_scheduledTick = next;
+        return;
+    }
+
+    const quint64 now = nowTicks();
+    m_scheduledTick = next;
+    m_driver->start(next > now ? (int)qMin<quint64>(next - now, std::numeric_limits<int>::max()) : 0);
+}
+
+/**
+ * @brief Nächster belegter Ebene-0-Slot bzw. nächste Ebenengrenze
+ */
+quint64 TimerWheel::nextEventTick() const
+{
+    if (m_activeCount == 0)
+        return std::numeric_limits<quint64>::max();
+
+    const quint64 tick = m_current + 1;
+    const quint64 blockStart = tick & ~(quint64)SlotMask;
+
+    if ((tick & SlotMask) != 0) {
+        const int slot = findOccupied(0, (int)(tick & SlotMask));
+        if (slot >= 0)
+            return blockStart + slot;
+        return blockStart + Slots;
+    }
+    return tick;
+}
+
+/**
+ * @brief Sucht den ersten belegten Slot ab fromSlot über die Bitmap
+ * @return Slot-Index oder -1
+ */
+int TimerWheel::findOccupied(int level, int fromSlot) const
+{
+    for (int word = fromSlot / 64; word < Slots / 64; ++word) {
+        quint64 bits = m_occupied[level][word];
+        if (word == fromSlot / 64)
+            bits &= ~0ULL << (fromSlot % 64);
+        if (bits)
+            return word * 64 + (int)qCountTrailingZeroBits(bits);
+    }
+    return -1;
+}
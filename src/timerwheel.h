@@ -0,0 +1,142 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Hierarchisches Timer-Rad für viele gleichzeitige Timeouts
+ *
+ * Ersetzt einzelne QTimer-Objekte (Keep-Alive, Umschalt-Timeouts, Messproben)
+ * durch ein gemeinsames Rad pro Thread, das von einem einzigen QTimer
+ * angetrieben wird.
+ *
+ * Aufbau: 4 Ebenen mit je 256 Slots, Auflösung 1 ms
+ * - Ebene 0: bis 256 ms
+ * - Ebene 1: bis ~65 s
+ * - Ebene 2: bis ~4,6 h
+ * - Ebene 3: bis ~49 Tage
+ *
+ * Timer liegen in intrusiven doppelt verketteten Listen eines Knoten-Pools.
+ * Anlegen und Abbrechen sind damit O(1). Beim Überlauf einer Ebene werden
+ * die Timer des nächsten Slots der höheren Ebene nach unten verteilt.
+ *
+ * Der treibende QTimer läuft nicht im festen Takt, sondern wird auf den
+ * nächsten belegten Slot (bzw. die nächste Ebenengrenze) gestellt und ist
+ * ohne Timer ganz gestoppt.
+ *
+ * Verwendung:
+ * @code
+ * TimerWheel *wheel = TimerWheel::forCurrentThread();
+ * TimerWheel::TimerId id = wheel->schedule(5000, []() { qDebug() << "Timeout"; });
+ * wheel->cancel(id);
+ * @endcode
+ *
+ * @note Nicht threadsicher - nur aus dem Thread verwenden, dem das Rad gehört.
+ */
+class TimerWheel : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Handle eines Timers (0 = ungültig)
+    using TimerId = quint64;
+
+    /**
+     * @brief Konstruktor
+     * @param parent Eltern-QObject für automatische Speicherverwaltung
+     */
+    explicit TimerWheel(QObject *parent = nullptr);
+    ~TimerWheel() override;
+
+    /**
+     * @brief Liefert das Timer-Rad des aktuellen Threads
+     *
+     * Wird beim ersten Aufruf im Thread angelegt und beim Beenden
+     * des Threads freigegeben.
+     */
+    static TimerWheel* forCurrentThread();
+
+    /**
+     * @brief Startet einen einmaligen Timer
+     * @param delayMs Verzögerung in Millisekunden (mindestens 1 Tick)
+     * @param callback Wird bei Ablauf im Thread des Rads aufgerufen
+     * @return Handle für cancel()
+     */
+    TimerId schedule(int delayMs, std::function<void()> callback);
+
+    /**
+     * @brief Startet einen periodischen Timer
+     * @param intervalMs Intervall in Millisekunden
+     * @param callback Wird bei jedem Ablauf aufgerufen
+     * @return Handle für cancel() (bleibt über alle Perioden gleich)
+     */
+    TimerId scheduleRepeating(int intervalMs, std::function<void()> callback);
+
+    /**
+     * @brief Bricht einen Timer ab
+     * @param id Handle aus schedule() (0 und abgelaufene Handles sind erlaubt)
+     * @return true wenn der Timer noch aktiv war
+     */
+    bool cancel(TimerId id);
+
+    /// true wenn der Timer noch nicht abgelaufen oder abgebrochen ist
+    bool isActive(TimerId id) const;
+
+    /// Anzahl aktiver Timer
+    int activeCount() const { return m_activeCount; }
+
+protected:
+    /// Aktueller Tick der Zeitbasis (Tests stellen hier eine eigene Uhr ein)
+    virtual quint64 nowTicks() const { return (quint64)m_clock.elapsed(); }
+
+    /// Zieht das Rad bis nowTicks() nach und löst fällige Timer aus
+    void onTick();
+
+private:
+    static constexpr int Levels = 4;
+    static constexpr int SlotBits = 8;
+    static constexpr int Slots = 1 << SlotBits;
+    static constexpr int SlotMask = Slots - 1;
+
+    struct Node {
+        quint64 expiry = 0;                                  ///< Ablauf-Tick
+        int period = 0;                                      ///< Periode in Ticks (0 = einmalig)
+        quint32 generation = 0;                              ///< Schutz gegen veraltete Handles
+        int prev = -1;                                       ///< Vorgänger in der Slot-Liste
+        int next = -1;                                       ///< Nachfolger in der Slot-Liste (bzw. Freiliste)
+        quint8 level = 0;
+        quint8 slot = 0;
+        bool active = false;
+        std::function<void()> callback;
+    };
+
+    TimerId arm(int delayMs, int periodMs, std::function<void()> callback);
+    void insert(int index);
+    void unlink(int index);
+    int nodeIndex(TimerId id) const;
+
+    void advanceTo(quint64 target);
+    void cascade(int level, quint64 tick);
+    void fireSlot(quint64 tick);
+    void reschedule();
+    quint64 nextEventTick() const;
+    int findOccupied(int level, int fromSlot) const;
+
+    std::vector<Node> m_nodes;                               ///< Knoten-Pool
+    int m_freeList;                                          ///< Erster freier Knoten (-1 = keiner)
+    int m_heads[Levels][Slots];                              ///< Listenköpfe je Slot (-1 = leer)
+    quint64 m_occupied[Levels][Slots / 64];                  ///< Belegungs-Bitmap je Ebene
+    quint64 m_current;                                       ///< Zuletzt verarbeiteter Tick
+    quint64 m_scheduledTick;                                 ///< Tick, auf den der QTimer gestellt ist
+    int m_activeCount;                                       ///< Anzahl aktiver Timer
+    bool m_dispatching;                                      ///< true während onTick() läuft
+    QElapsedTimer m_clock;                                   ///< Monotone Zeitbasis (1 Tick = 1 ms)
+    std::unique_ptr<QTimer> m_driver;                        ///< Einziger QTimer des Rads
+};
+
+#endif // TIMERWHEEL_H
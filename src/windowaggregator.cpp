@@ -0,0 +1,382 @@
+#include "windowaggregator.h"
+#include "jsonview.h"
+#include "mqttclient.h"
+#include "mqttreactor.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace {
+    /// Obergrenze des Topic-Caches (fremde Topics landen auch dort)
+    constexpr int MaxCachedTopics = 4096;
+}
+
+void WindowAggregator::Pane::addGroup()
+{
+    count.push_back(0);
+    sum.push_back(0.0);
+    min.push_back(std::numeric_limits<double>::infinity());
+    max.push_back(-std::numeric_limits<double>::infinity());
+}
+
+void WindowAggregator::Pane::reset()
+{
+    std::fill(count.begin(), count.end(), 0);
+    std::fill(sum.begin(), sum.end(), 0.0);
+    std::fill(min.begin(), min.end(), std::numeric_limits<double>::infinity());
+    std::fill(max.begin(), max.end(), -std::numeric_limits<double>::infinity());
+}
+
+void WindowAggregator::Pane::compact(const std::vector<bool> &keep)
+{
+    size_t target = 0;
+    for (size_t g = 0; g < keep.size(); ++g) {
+        if (!keep[g])
+            continue;
+        count[target] = count[g];
+        sum[target] = sum[g];
+        min[target] = min[g];
+        max[target] = max[g];
+        ++target;
+    }
+    count.resize(target);
+    sum.resize(target);
+    min.resize(target);
+    max.resize(target);
+}
+
+/**
+ * @brief Konstruktor - Verbindet sich mit dem Empfangssignal des Clients
+ */
+WindowAggregator::WindowAggregator(MqttClient *client, QObject *parent)
+    : QObject(parent)
+    , m_client(client)
+    , m_nextId(1)
+    , m_samples(0)
+    , m_rejected(0)
+    , m_evictedGroups(0)
+{
+    connect(m_client, &MqttClient::messageReceived, this, &WindowAggregator::onMessage);
+    connect(m_client, &MqttClient::connected, this, &WindowAggregator::onConnected);
+}
+
+/**
+ * @brief Destruktor - Stoppt alle Fenster-Timer
+ */
+WindowAggregator::~WindowAggregator()
+{
+    TimerWheel *wheel = m_client->reactor()->timerWheel();
+    for (const auto &aggregation : m_aggregations)
+        wheel->cancel(aggregation->timer);
+}
+
+/**
+ * @brief Legt eine Aggregation an und abonniert den Filter
+ *
+ * Bei Sliding muss slideMs windowMs ohne Rest teilen, damit das Fenster
+ * aus ganzen Teilfenstern besteht.
+ */
+int WindowAggregator::subscribe(const QString &topicFilter, const Spec &spec, ResultHandler handler)
+{
+    int paneCount = 1;
+    int intervalMs = spec.windowMs;
+    if (spec.windowMs <= 0 || !handler) {
+        qDebug() << "Aggregation ungültig für" << topicFilter;
+        return -1;
+    }
+    if (spec.window == Spec::Sliding) {
+        if (spec.slideMs <= 0 || spec.slideMs > spec.windowMs || spec.windowMs % spec.slideMs != 0) {
+            qDebug() << "Sliding-Fenster: slideMs muss windowMs teilen -" << topicFilter;
+            return -1;
+        }
+        paneCount = spec.windowMs / spec.slideMs;
+        intervalMs = spec.slideMs;
+    }
+
+    auto aggregation = std::make_unique<Aggregation>();
+    aggregation->id = m_nextId++;
+    aggregation->filter = topicFilter;
+    aggregation->spec = spec;
+    aggregation->handler = std::move(handler);
+    aggregation->panes.resize(paneCount);
+    aggregation->startedMs = QDateTime::currentMSecsSinceEpoch();
+
+    Aggregation *raw = aggregation.get();
+    aggregation->timer = m_client->reactor()->timerWheel()->scheduleRepeating(intervalMs, [this, raw]() {
+        closeWindow(raw);
+    });
+
+    bool alreadySubscribed = false;
+    for (const auto &existing : m_aggregations)
+        alreadySubscribed |= existing->filter == topicFilter;
+
+    m_aggregations.push_back(std::move(aggregation));
+    m_routes.clear();
+
+    if (!alreadySubscribed && m_client->isConnected())
+        m_client->subscribe(topicFilter);
+
+    return raw->id;
+}
+
+void WindowAggregator::unsubscribe(int id)
+{
+    for (auto it = m_aggregations.begin(); it != m_aggregations.end(); ++it) {
+        if ((*it)->id != id)
+            continue;
+
+        const QString filter = (*it)->filter;
+        m_client->reactor()->timerWheel()->cancel((*it)->timer);
+        m_aggregations.erase(it);
+        m_routes.clear();
+
+        bool stillUsed = false;
+        for (const auto &other : m_aggregations)
+            stillUsed |= other->filter == filter;
+        if (!stillUsed && m_client->isConnected())
+            m_client->unsubscribe(filter);
+        return;
+    }
+}
+
+/**
+ * @brief MQTT Topic-Vergleich
+ *
+ * '+' passt auf genau eine Ebene, '#' (nur am Ende) auf beliebig viele
+ * einschließlich keiner.
+ */
+bool WindowAggregator::topicMatches(const QString &topicFilter, const QString &topic)
+{
+    const QStringList filterLevels = topicFilter.split('/');
+    const QStringList topicLevels = topic.split('/');
+
+    for (int i = 0; i < filterLevels.size(); ++i) {
+        if (filterLevels[i] == "#")
+            return i == filterLevels.size() - 1;
+        if (i >= topicLevels.size())
+            return false;
+        if (filterLevels[i] != "+" && filterLevels[i] != topicLevels[i])
+            return false;
+    }
+    return filterLevels.size() == topicLevels.size();
+}
+
+/**
+ * @brief Bestellt nach einem Reconnect alle Filter neu
+ *
+ * Der MqttClient vergisst seine Abonnements beim Trennen.
+ */
+void WindowAggregator::onConnected()
+{
+    QStringList filters;
+    for (const auto &aggregation : m_aggregations) {
+        if (!filters.contains(aggregation->filter))
+            filters.append(aggregation->filter);
+    }
+    for (const QString &filter : filters)
+        m_client->subscribe(filter);
+}
+
+/**
+ * @brief Liefert die Ziele eines Topics (beim ersten Auftreten berechnet)
+ *
+ * Neue Gruppen werden hier angelegt und in allen Teilfenstern ergänzt.
+ */
+const QVector<WindowAggregator::Route> &WindowAggregator::resolve(const QString &topic)
+{
+    auto it = m_routes.constFind(topic);
+    if (it != m_routes.constEnd())
+        return *it;
+
+    if (m_routes.size() >= MaxCachedTopics)
+        m_routes.clear();
+
+    QVector<Route> routes;
+    for (const auto &aggregation : m_aggregations) {
+        if (!topicMatches(aggregation->filter, topic))
+            continue;
+
+        QString group = topic;
+        if (aggregation->spec.groupSegment >= 0)
+            group = topic.split('/').value(aggregation->spec.groupSegment);
+
+        int index = aggregation->groupIndex.value(group, -1);
+        if (index < 0) {
+            index = aggregation->groups.size();
+            aggregation->groups.append(group);
+            aggregation->groupIndex.insert(group, index);
+            aggregation->idle.push_back(0);
+            for (Pane &pane : aggregation->panes)
+                pane.addGroup();
+        }
+        routes.append(Route{aggregation.get(), index});
+    }
+
+    return *m_routes.insert(topic, routes);
+}
+
+/**
+ * @brief Liest den Zahlenwert einer Nachricht
+ *
+ * Ohne Feldnamen muss die ganze Payload eine Zahl sein (z.B. "21.5"),
+ * sonst wird das Feld per JsonView gelesen.
+ */
+bool WindowAggregator::parseValue(const QByteArray &message, const QByteArray &field, double &value)
+{
+    if (!field.isEmpty()) {
+        const JsonView::Value json = JsonView(message).value(field.constData());
+        if (json.type() != JsonView::Number)
+            return false;
+        value = json.toDouble();
+        return true;
+    }
+
+    // strtod braucht einen nullterminierten Puffer - kurze Zahl auf den Stack kopieren
+    char buffer[64];
+    const int size = message.size();
+    if (size == 0 || size >= (int)sizeof(buffer))
+        return false;
+    memcpy(buffer, message.constData(), size);
+    buffer[size] = '\0';
+
+    char *end = nullptr;
+    value = strtod(buffer, &end);
+    while (end && (*end == ' ' || *end == '\n' || *end == '\r' || *end == '\t'))
+        ++end;
+    return end != buffer && end && *end == '\0';
+}
+
+/**
+ * @brief Nimmt einen Wert in alle passenden Aggregationen auf
+ */
+void WindowAggregator::onMessage(const QString &topic, const QByteArray &message)
+{
+    const QVector<Route> &routes = resolve(topic);
+    if (routes.isEmpty())
+        return;
+
+    // Meist haben alle Ziele dasselbe Feld - nur bei Wechsel neu parsen
+    const QByteArray *parsedField = nullptr;
+    double value = 0.0;
+    bool valid = false;
+
+    for (const Route &route : routes) {
+        const QByteArray &field = route.aggregation->spec.field;
+        if (!parsedField || *parsedField != field) {
+            valid = parseValue(message, field, value);
+            parsedField = &field;
+        }
+        if (!valid) {
+            m_rejected++;
+            continue;
+        }
+
+        Pane &pane = route.aggregation->panes[route.aggregation->currentPane];
+        const int g = route.group;
+        pane.count[g]++;
+        pane.sum[g] += value;
+        if (value < pane.min[g])
+            pane.min[g] = value;
+        if (value > pane.max[g])
+            pane.max[g] = value;
+        m_samples++;
+    }
+}
+
+/**
+ * @brief Fensterende: Ergebnisse bilden, Handler aufrufen, Teilfenster weiterschalten
+ *
+ * Bei Sliding werden alle Teilfenster zusammengefasst und danach das
+ * älteste geleert, es wird zum neuen aktuellen Teilfenster. Gruppen ohne
+ * Werte zählen als inaktiv (evictIdleGroups()).
+ */
+void WindowAggregator::closeWindow(Aggregation *aggregation)
+{
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const int groupCount = aggregation->groups.size();
+    const std::vector<Pane> &panes = aggregation->panes;
+
+    QVector<Result> results;
+    for (int g = 0; g < groupCount; ++g) {
+        Result result;
+        result.min = std::numeric_limits<double>::infinity();
+        result.max = -std::numeric_limits<double>::infinity();
+        for (const Pane &pane : panes) {
+            result.count += pane.count[g];
+            result.sum += pane.sum[g];
+            result.min = qMin(result.min, pane.min[g]);
+            result.max = qMax(result.max, pane.max[g]);
+        }
+        if (result.count == 0) {
+            aggregation->idle[g]++;
+            continue;
+        }
+        aggregation->idle[g] = 0;
+
+        result.group = aggregation->groups.at(g);
+        result.windowEndMs = nowMs;
+        result.windowStartMs = qMax(aggregation->startedMs, nowMs - aggregation->spec.windowMs);
+        results.append(result);
+    }
+
+    aggregation->currentPane = (aggregation->currentPane + 1) % (int)panes.size();
+    aggregation->panes[aggregation->currentPane].reset();
+    evictIdleGroups(aggregation);
+
+    // Kopie: der Handler darf die Aggregation per unsubscribe() entfernen
+    if (!results.isEmpty()) {
+        const ResultHandler handler = aggregation->handler;
+        handler(results);
+    }
+}
+
+/**
+ * @brief Entfernt Gruppen, die spec.idleWindows Auswertungen lang leer waren
+ *
+ * Die Arrays aller Teilfenster werden verdichtet. Da sich dabei
+ * Gruppenindizes verschieben, wird der Topic-Cache geleert und beim
+ * nächsten Auftreten neu aufgebaut.
+ */
+void WindowAggregator::evictIdleGroups(Aggregation *aggregation)
+{
+    const int limit = aggregation->spec.idleWindows;
+    if (limit <= 0)
+        return;
+
+    const int groupCount = aggregation->groups.size();
+    std::vector<bool> keep(groupCount, true);
+    int evicted = 0;
+    for (int g = 0; g < groupCount; ++g) {
+        if (aggregation->idle[g] >= limit) {
+            keep[g] = false;
+            ++evicted;
+        }
+    }
+    if (evicted == 0)
+        return;
+
+    for (Pane &pane : aggregation->panes)
+        pane.compact(keep);
+
+    QStringList groups;
+    std::vector<int> idle;
+    groups.reserve(groupCount - evicted);
+    idle.reserve(groupCount - evicted);
+    aggregation->groupIndex.clear();
+    for (int g = 0; g < groupCount; ++g) {
+        if (!keep[g])
+            continue;
+        aggregation->groupIndex.insert(aggregation->groups.at(g), groups.size());
+        groups.append(aggregation->groups.at(g));
+        idle.push_back(aggregation->idle[g]);
+    }
+    aggregation->groups = groups;
+    aggregation->idle = std::move(idle);
+
+    m_routes.clear();
+    m_evictedGroups += evicted;
+}
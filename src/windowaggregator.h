@@ -0,0 +1,190 @@
+#ifndef WINDOWAGGREGATOR_H
+#define WINDOWAGGREGATOR_H
+
+#include "timerwheel.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class MqttClient;
+
+/**
+ * @brief Fenster-Aggregation numerischer Topics im Client
+ *
+ * Für Sensor-Topics mit hoher Rate, bei denen nur Kennwerte pro Zeitfenster
+ * (Anzahl, Minimum, Maximum, Summe, Mittelwert) interessieren. Statt den
+ * Handler für jede Nachricht aufzurufen, werden die Werte inkrementell
+ * aufsummiert und der Handler einmal pro Fenster mit dem Ergebnis
+ * aufgerufen.
+ *
+ * Fensterarten:
+ * - Tumbling: feste, lückenlose Fenster der Länge windowMs
+ * - Sliding: Fenster der Länge windowMs, ausgewertet alle slideMs
+ *   (aufgeteilt in windowMs / slideMs Teilfenster, "Panes")
+ *
+ * Gruppierung:
+ * - groupSegment = -1: eine Gruppe pro Topic
+ * - groupSegment = n: Gruppe = n-te Topic-Ebene (0-basiert), z.B. bei
+ *   "sensor/+/temp" mit n = 1 eine Gruppe pro Sensor
+ *
+ * Die Zähler liegen als Structure-of-Arrays vor (je ein Array für count,
+ * sum, min, max, Index = Gruppe). Das Topic einer Nachricht wird beim ersten
+ * Auftreten auf (Aggregation, Gruppe) abgebildet und zwischengespeichert,
+ * danach kostet eine Nachricht eine Hash-Suche, das Parsen der Zahl und
+ * vier Array-Zugriffe.
+ *
+ * Gruppen, die spec.idleWindows Auswertungen lang keinen Wert im Fenster
+ * hatten, werden entfernt und die Arrays verdichtet - bei wechselnden
+ * Topics (z.B. Sensor-IDs) wachsen Speicher und Fensterauswertung so
+ * nur mit den aktiven Gruppen. Kommt wieder ein Wert, entsteht die
+ * Gruppe neu.
+ *
+ * Verwendung:
+ * @code
+ * WindowAggregator aggregator(client);
+ * WindowAggregator::Spec spec;
+ * spec.windowMs = 1000;
+ * spec.groupSegment = 1;
+ * spec.field = "value";                       // JSON-Feld, leer = Payload ist die Zahl
+ * aggregator.subscribe("sensor/+/temp", spec, [](const QVector<WindowAggregator::Result> &results) {
+ *     for (const auto &r : results)
+ *         qDebug() << r.group << r.count << r.min << r.max << r.average();
+ * });
+ * @endcode
+ *
+ * @note Die Nachrichten kommen über MqttClient::messageReceived(). Ist für
+ *       ein Topic ein Handler im MqttClient registriert, hat dieser Vorrang
+ *       und die Nachricht wird nicht aggregiert.
+ * @note Der Aggregator muss im Thread des Clients leben (Timer-Rad des
+ *       Reactors).
+ */
+class WindowAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Beschreibung einer Aggregation
+     */
+    struct Spec {
+        enum Window { Tumbling, Sliding };
+
+        Window window = Tumbling;
+        int windowMs = 1000;                                 ///< Fensterlänge
+        int slideMs = 0;                                     ///< Nur Sliding: Auswertungsabstand (Teiler von windowMs)
+        int groupSegment = -1;                               ///< -1 = pro Topic, sonst Index der Topic-Ebene
+        QByteArray field;                                    ///< JSON-Feld mit dem Wert, leer = ganze Payload ist eine Zahl
+        int idleWindows = 3;                                 ///< Leere Auswertungen, nach denen eine Gruppe entfernt wird (0 = nie)
+    };
+
+    /**
+     * @brief Ergebnis eines Fensters für eine Gruppe
+     */
+    struct Result {
+        QString group;                                       ///< Topic bzw. Wert der Gruppierungsebene
+        qint64 windowStartMs = 0;                            ///< Fensterbeginn (ms seit Epoch)
+        qint64 windowEndMs = 0;                              ///< Fensterende (ms seit Epoch)
+        quint64 count = 0;
+        double sum = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+
+        double average() const { return count > 0 ? sum / count : 0.0; }
+    };
+
+    /// Handler, einmal pro Fenster mit den Ergebnissen aller Gruppen mit Werten
+    using ResultHandler = std::function<void(const QVector<Result> &results)>;
+
+    explicit WindowAggregator(MqttClient *client, QObject *parent = nullptr);
+    ~WindowAggregator();
+
+    /**
+     * @brief Abonniert ein Topic (auch mit + und #) mit Aggregation
+     * @param topicFilter MQTT Topic-Filter
+     * @param spec Fenster und Gruppierung
+     * @param handler Wird pro Fenster aufgerufen (nicht bei leeren Fenstern)
+     * @return ID für unsubscribe(), -1 bei ungültiger Spec
+     */
+    int subscribe(const QString &topicFilter, const Spec &spec, ResultHandler handler);
+
+    /**
+     * @brief Entfernt eine Aggregation
+     *
+     * Das Topic wird beim Broker abbestellt, wenn keine andere Aggregation
+     * denselben Filter verwendet. Ein angefangenes Fenster wird verworfen.
+     */
+    void unsubscribe(int id);
+
+    /// Anzahl aggregierter Werte seit dem Start
+    quint64 samples() const { return m_samples; }
+
+    /// Anzahl Nachrichten, deren Payload keine Zahl enthielt
+    quint64 rejected() const { return m_rejected; }
+
+    /// Anzahl wegen Inaktivität entfernter Gruppen
+    quint64 evictedGroups() const { return m_evictedGroups; }
+
+    /// Prüft ob ein Topic auf einen Filter mit + und # passt
+    static bool topicMatches(const QString &topicFilter, const QString &topic);
+
+private slots:
+    void onMessage(const QString &topic, const QByteArray &message);
+    void onConnected();
+
+private:
+    /// Zähler eines (Teil-)Fensters als Structure-of-Arrays, Index = Gruppe
+    struct Pane {
+        std::vector<quint64> count;
+        std::vector<double> sum;
+        std::vector<double> min;
+        std::vector<double> max;
+
+        void addGroup();
+        void reset();
+
+        /// Entfernt alle Gruppen mit keep[g] == false, die übrigen rücken auf
+        void compact(const std::vector<bool> &keep);
+    };
+
+    struct Aggregation {
+        int id = 0;
+        QString filter;
+        Spec spec;
+        ResultHandler handler;
+        TimerWheel::TimerId timer = 0;
+        QStringList groups;                                  ///< Gruppenname pro Index
+        QHash<QString, int> groupIndex;                      ///< Gruppenname -> Index
+        std::vector<int> idle;                               ///< Leere Auswertungen in Folge pro Gruppe
+        std::vector<Pane> panes;                             ///< 1 bei Tumbling, windowMs / slideMs bei Sliding
+        int currentPane = 0;
+        qint64 startedMs = 0;                                ///< Beginn der Aggregation
+    };
+
+    /// Ziel einer Nachricht: Aggregation und Gruppe
+    struct Route {
+        Aggregation *aggregation;
+        int group;
+    };
+
+    const QVector<Route> &resolve(const QString &topic);
+    void closeWindow(Aggregation *aggregation);
+    void evictIdleGroups(Aggregation *aggregation);
+    static bool parseValue(const QByteArray &message, const QByteArray &field, double &value);
+
+    MqttClient *m_client;
+    std::vector<std::unique_ptr<Aggregation>> m_aggregations;
+    QHash<QString, QVector<Route>> m_routes;                 ///< Topic -> Ziele (Cache)
+    int m_nextId;
+    quint64 m_samples;
+    quint64 m_rejected;
+    quint64 m_evictedGroups;
+};
+
+#endif // WINDOWAGGREGATOR_H
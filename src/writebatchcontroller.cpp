@@ -0,0 +1,110 @@
+#include "writebatchcontroller.h"
+
+WriteBatchController::WriteBatchController()
+    : WriteBatchController(Config())
+{
+}
+
+WriteBatchController::WriteBatchController(const Config &config)
+    : m_config(config)
+    , m_fixedWindowMs(-1)
+    , m_lastEvaluationNs(0)
+    , m_messagesSinceEvaluation(0)
+{
+}
+
+void WriteBatchController::setFixedWindow(int windowMs)
+{
+    m_fixedWindowMs = windowMs;
+    m_metrics.windowMs = qMax(0, windowMs);
+    m_metrics.lastDecision = windowMs >= 0 ? Fixed : Hold;
+}
+
+void WriteBatchController::recordMessage(qint64 nowNs)
+{
+    if (m_lastEvaluationNs == 0)
+        m_lastEvaluationNs = nowNs;
+    m_messagesSinceEvaluation++;
+}
+
+void WriteBatchController::recordWrite(int messages)
+{
+    m_metrics.writes++;
+    m_metrics.messages += messages;
+}
+
+int WriteBatchController::windowMs(qint64 nowNs, qint64 backlogBytes)
+{
+    if (m_fixedWindowMs >= 0)
+        return m_fixedWindowMs;
+
+    if (nowNs - m_lastEvaluationNs >= (qint64)EvaluationIntervalMs * 1000000)
+        evaluate(nowNs, backlogBytes);
+    return m_metrics.windowMs;
+}
+
+/**
+ * @brief Obergrenze aus Konfiguration und Latenzbudget
+ *
+ * Die Einweg-Latenz wird mit der halben Round-Trip-Zeit angesetzt.
+ */
+int WriteBatchController::windowCap() const
+{
+    int cap = m_config.maxWindowMs;
+    if (m_metrics.rttUs >= 0) {
+        const int oneWayMs = (int)(m_metrics.rttUs / 2000);
+        cap = qMin(cap, m_config.latencyBudgetMs - oneWayMs);
+    } else {
+        cap = qMin(cap, m_config.latencyBudgetMs);
+    }
+    return qMax(0, cap);
+}
+
+/**
+ * @brief Eine Reglerauswertung
+ *
+ * Senderate als EWMA (alpha 1/2) über die Auswertungsintervalle, damit
+ * ein Lastwechsel nach wenigen Intervallen wirkt.
+ */
+void WriteBatchController::evaluate(qint64 nowNs, qint64 backlogBytes)
+{
+    const double elapsedSec = (nowNs - m_lastEvaluationNs) / 1e9;
+    const double rate = elapsedSec > 0 ? m_messagesSinceEvaluation / elapsedSec : 0.0;
+    m_metrics.sendRate = m_metrics.sendRate == 0.0 ? rate : (m_metrics.sendRate + rate) / 2.0;
+    m_metrics.backlogBytes = backlogBytes;
+    m_lastEvaluationNs = nowNs;
+    m_messagesSinceEvaluation = 0;
+
+    const double sendRate = m_metrics.sendRate;
+    int window = m_metrics.windowMs;
+    Decision decision = Hold;
+
+    if (sendRate < m_config.lightRate && backlogBytes < m_config.backlogHighWater) {
+        decision = Bypass;
+        window = 0;
+    } else if (backlogBytes >= m_config.backlogHighWater) {
+        decision = Increase;
+        window = window == 0 ? 1 : window * 2;
+    } else if (backlogBytes == 0 || sendRate * window / 1000.0 < 2.0) {
+        // Socket kommt nach oder ein Fenster enthält kaum Nachrichten
+        if (window > 0) {
+            decision = Decrease;
+            window--;
+        }
+    }
+
+    if (sendRate >= m_config.heavyRate)
+        window = qMax(window, 1);
+
+    window = qBound(m_config.minWindowMs, window, qMax(m_config.minWindowMs, windowCap()));
+
+    switch (decision) {
+    case Increase: m_metrics.increases++; break;
+    case Decrease: m_metrics.decreases++; break;
+    case Bypass:   m_metrics.bypasses++; break;
+    default: break;
+    }
+
+    m_metrics.windowMs = window;
+    m_metrics.lastDecision = decision;
+}
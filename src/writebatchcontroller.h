@@ -0,0 +1,108 @@
+#ifndef WRITEBATCHCONTROLLER_H
+#define WRITEBATCHCONTROLLER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Regler für das Zusammenfassen ausgehender Pakete
+ *
+ * Bestimmt, wie lange MqttClient ausgehende PUBLISH-Pakete sammelt, bevor
+ * sie gemeinsam in den Socket geschrieben werden (Fenster in ms, 0 = sofort).
+ *
+ * Eingangsgrößen (alle EvaluationIntervalMs ausgewertet):
+ * - Senderate (Nachrichten/s, gleitender Mittelwert)
+ * - Rückstau im Socket (bytesToWrite() + gesammelte Bytes)
+ * - Round-Trip-Zeit zum Broker (PINGREQ -> PINGRESP)
+ *
+ * Entscheidungen:
+ * - Bypass:   geringe Last und kein Rückstau -> Fenster 0, sofort schreiben
+ * - Increase: Rückstau über der Hochwassermarke -> Fenster verdoppeln
+ * - Decrease: kein Rückstau oder zu wenige Nachrichten pro Fenster -> Fenster - 1 ms
+ * - Hold:     sonst unverändert
+ *
+ * Bei hoher Senderate bleibt das Fenster mindestens 1 ms, damit weniger
+ * Systemaufrufe anfallen. Das Fenster überschreitet nie maxWindowMs und
+ * nie das Latenzbudget abzüglich der halben Round-Trip-Zeit.
+ *
+ * Mit setFixedWindow() arbeitet der Regler als feste Strategie (Vergleichsmessung).
+ */
+class WriteBatchController
+{
+public:
+    /// Konfiguration des Reglers
+    struct Config {
+        int minWindowMs = 0;                                 ///< Untere Grenze des Fensters
+        int maxWindowMs = 8;                                 ///< Obere Grenze des Fensters
+        int latencyBudgetMs = 10;                            ///< Maximal zulässige Zusatzlatenz inkl. halber RTT
+        double lightRate = 200.0;                            ///< Darunter wird sofort geschrieben (Nachrichten/s)
+        double heavyRate = 5000.0;                           ///< Darüber wird immer gesammelt (Nachrichten/s)
+        qint64 backlogHighWater = 64 * 1024;                 ///< Rückstau, ab dem das Fenster wächst (Bytes)
+        int maxBatchBytes = 64 * 1024;                       ///< Gesammelte Bytes, ab denen sofort geschrieben wird
+    };
+
+    /// Letzte Entscheidung des Reglers
+    enum Decision { Hold, Increase, Decrease, Bypass, Fixed };
+
+    /// Kennzahlen für Monitoring
+    struct Metrics {
+        int windowMs = 0;                                    ///< Aktuelles Fenster
+        double sendRate = 0.0;                               ///< Geglättete Senderate (Nachrichten/s)
+        qint64 rttUs = -1;                                   ///< Letzte Round-Trip-Zeit (-1 = unbekannt)
+        qint64 backlogBytes = 0;                             ///< Rückstau bei der letzten Auswertung
+        Decision lastDecision = Hold;
+        quint64 increases = 0;                               ///< Anzahl Entscheidungen "Increase"
+        quint64 decreases = 0;                               ///< Anzahl Entscheidungen "Decrease"
+        quint64 bypasses = 0;                                ///< Anzahl Entscheidungen "Bypass"
+        quint64 writes = 0;                                  ///< Schreibvorgänge in den Socket
+        quint64 messages = 0;                                ///< Geschriebene Nachrichten
+
+        /// Durchschnittliche Nachrichten pro Schreibvorgang
+        double messagesPerWrite() const { return writes ? (double)messages / writes : 0.0; }
+    };
+
+    static constexpr int EvaluationIntervalMs = 50;          ///< Abstand der Reglerauswertungen
+
+    WriteBatchController();
+    explicit WriteBatchController(const Config &config);
+
+    void setConfig(const Config &config) { m_config = config; }
+    const Config& config() const { return m_config; }
+
+    /**
+     * @brief Feste Strategie statt Regelung
+     * @param windowMs Festes Fenster (-1 = adaptiv regeln)
+     */
+    void setFixedWindow(int windowMs);
+
+    /// Verbucht eine gesendete Nachricht
+    void recordMessage(qint64 nowNs);
+
+    /// Verbucht einen Schreibvorgang mit der Anzahl enthaltener Nachrichten
+    void recordWrite(int messages);
+
+    /// Verbucht eine gemessene Round-Trip-Zeit
+    void recordRoundTrip(qint64 rttUs) { m_metrics.rttUs = rttUs; }
+
+    /**
+     * @brief Aktuelles Fenster, wertet den Regler bei Bedarf neu aus
+     * @param nowNs Monotone Zeit in Nanosekunden
+     * @param backlogBytes Noch nicht geschriebene Bytes (Socket + Sammelpuffer)
+     * @return Fenster in Millisekunden (0 = sofort schreiben)
+     */
+    int windowMs(qint64 nowNs, qint64 backlogBytes);
+
+    /// Kennzahlen des Reglers
+    const Metrics& metrics() const { return m_metrics; }
+
+private:
+    void evaluate(qint64 nowNs, qint64 backlogBytes);
+    int windowCap() const;
+
+    Config m_config;
+    Metrics m_metrics;
+    int m_fixedWindowMs;                                     ///< -1 = adaptiv
+    qint64 m_lastEvaluationNs;                               ///< Zeitpunkt der letzten Auswertung
+    quint64 m_messagesSinceEvaluation;                       ///< Nachrichten seit der letzten Auswertung
+};
+
+#endif // WRITEBATCHCONTROLLER_H
@@ -0,0 +1,62 @@
+#include "mqttclient.h"
+#include "mqttreactor.h"
+
+#include <QtTest>
+
+#include <vector>
+
+/**
+ * @brief Tatsächlicher Heap-Bedarf eines Clients
+ *
+ * Gemessen über den Allocator, damit auch der private Zustand von
+ * QObject und QTcpSocket zählt, den sizeof() nicht erfasst.
+ */
+class TestClientFootprint : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int ClientCount = 256;
+
+private slots:
+    void idleClientStaysWithinTarget()
+    {
+        if (MqttReactor::heapInUse() < 0)
+            QSKIP("Allocator liefert keinen Heap-Stand");
+
+        MqttReactor reactor;
+
+        // Gemeinsame Strukturen (Timer-Rad, Pools, Meta-Objekte) vorab anlegen
+        delete new MqttClient(&reactor);
+
+        std::vector<MqttClient*> clients;
+        clients.reserve(ClientCount);
+
+        const qint64 before = MqttReactor::heapInUse();
+        for (int i = 0; i < ClientCount; ++i)
+            clients.push_back(new MqttClient(&reactor));
+        const qint64 perClient = (MqttReactor::heapInUse() - before) / ClientCount;
+
+        for (MqttClient *client : clients)
+            delete client;
+
+        qDebug() << "Heap pro Client:" << perClient << "Bytes, Ziel:" << MqttReactor::FootprintTarget;
+        QVERIFY(perClient > 0);
+        QVERIFY2(perClient <= MqttReactor::FootprintTarget,
+                 qPrintable(QString("%1 Bytes pro Client").arg(perClient)));
+    }
+
+    void footprintCountsQueuedState()
+    {
+        MqttReactor reactor;
+        MqttClient client(&reactor);
+        const qint64 idle = client.memoryFootprint();
+
+        client.setPayloadChecksum("sensor/a");
+        client.setTopicEnvelope("sensor/b");
+        QVERIFY(client.memoryFootprint() > idle);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestClientFootprint)
+#include "tst_clientfootprint.moc"
@@ -0,0 +1,190 @@
+#include "clientsnapshot.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtTest>
+
+/**
+ * @brief Schreiben, Einblenden und Prüfen des ClientSnapshot
+ */
+class TestClientSnapshot : public QObject
+{
+    Q_OBJECT
+
+private:
+    static ClientSnapshot::Session session()
+    {
+        ClientSnapshot::Session session;
+        session.clientId = "NetworkSwitch";
+        session.activeNetwork = 1;
+        session.createdMs = 1700000000000;
+        return session;
+    }
+
+    static QVector<ClientSnapshot::Subscription> subscriptions()
+    {
+        QVector<ClientSnapshot::Subscription> subscriptions;
+        subscriptions.append({ "message/new", 1, 0 });
+        subscriptions.append({ "message/err", 0, 1 });
+        subscriptions.append({ "sensor/#", 2, 1 });
+        return subscriptions;
+    }
+
+    static QVector<ClientSnapshot::Value> values(int count)
+    {
+        QVector<ClientSnapshot::Value> values;
+        for (int i = 0; i < count; ++i)
+            values.append({ "sensor/" + QString::number(i), QByteArray::number(i * 7), 1000 + i });
+        return values;
+    }
+
+    /// Kippt ein Byte der Datei an position
+    static bool corrupt(const QString &path, qint64 position)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadWrite))
+            return false;
+        QByteArray data = file.readAll();
+        data[(int)position] = (char)(data.at((int)position) ^ 0x01);
+        return file.seek(0) && file.write(data) == data.size();
+    }
+
+private slots:
+    void roundTrip()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.filePath("snapshot");
+
+        QString error;
+        QVERIFY2(ClientSnapshot::write(path, session(), subscriptions(), values(500), &error), qPrintable(error));
+
+        ClientSnapshot snapshot;
+        QVERIFY2(snapshot.open(path, &error), qPrintable(error));
+        QVERIFY(snapshot.isOpen());
+        QCOMPARE(snapshot.size(), QFile(path).size());
+
+        const ClientSnapshot::Session restored = snapshot.session();
+        QCOMPARE(restored.clientId, QString("NetworkSwitch"));
+        QCOMPARE(restored.activeNetwork, 1);
+        QCOMPARE(restored.createdMs, qint64(1700000000000));
+
+        const QVector<ClientSnapshot::Subscription> restoredSubscriptions = snapshot.subscriptions();
+        QCOMPARE(restoredSubscriptions.size(), 3);
+        QCOMPARE(restoredSubscriptions.at(2).topic, QString("sensor/#"));
+        QCOMPARE(restoredSubscriptions.at(2).qos, quint8(2));
+        QCOMPARE(restoredSubscriptions.at(1).network, 1);
+
+        QCOMPARE(snapshot.valueCount(), 500);
+        for (int i = 0; i < 500; ++i) {
+            QByteArray value;
+            qint64 timestampMs = 0;
+            QVERIFY(snapshot.value("sensor/" + QString::number(i), &value, &timestampMs));
+            QCOMPARE(value, QByteArray::number(i * 7));
+            QCOMPARE(timestampMs, qint64(1000 + i));
+        }
+        QVERIFY(!snapshot.value("sensor/500", nullptr));
+        QCOMPARE(snapshot.values().size(), 500);
+    }
+
+    void emptySnapshot()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("snapshot");
+        QVERIFY(ClientSnapshot::write(path, ClientSnapshot::Session(), {}, {}));
+
+        ClientSnapshot snapshot;
+        QVERIFY(snapshot.open(path));
+        QCOMPARE(snapshot.session().activeNetwork, -1);
+        QVERIFY(snapshot.subscriptions().isEmpty());
+        QCOMPARE(snapshot.valueCount(), 0);
+        QVERIFY(!snapshot.value("message/new", nullptr));
+    }
+
+    void corruptionIsRejected()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("snapshot");
+        QVERIFY(ClientSnapshot::write(path, session(), subscriptions(), values(10)));
+        const qint64 size = QFile(path).size();
+
+        // Letztes Byte der Nutzdaten - nur die Prüfsumme fällt auf
+        QVERIFY(corrupt(path, size - 1));
+        ClientSnapshot snapshot;
+        QString error;
+        QVERIFY(!snapshot.open(path, &error));
+        QVERIFY(!error.isEmpty());
+        QVERIFY(!snapshot.isOpen());
+        QVERIFY(!snapshot.value("sensor/1", nullptr));
+
+        // Magic
+        QVERIFY(ClientSnapshot::write(path, session(), subscriptions(), values(10)));
+        QVERIFY(corrupt(path, 0));
+        QVERIFY(!snapshot.open(path));
+    }
+
+    void truncatedOrMissingFileIsRejected()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("snapshot");
+        ClientSnapshot snapshot;
+        QString error;
+        QVERIFY(!snapshot.open(path, &error));
+        QVERIFY(!error.isEmpty());
+
+        QVERIFY(ClientSnapshot::write(path, session(), subscriptions(), values(10)));
+        QVERIFY(QFile::resize(path, QFile(path).size() - 8));
+        QVERIFY(!snapshot.open(path));
+
+        QVERIFY(QFile::resize(path, 16));
+        QVERIFY(!snapshot.open(path));
+    }
+
+    void rewriteKeepsOpenSnapshotValid()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("snapshot");
+        QVERIFY(ClientSnapshot::write(path, session(), subscriptions(), values(10)));
+
+        ClientSnapshot old;
+        QVERIFY(old.open(path));
+        QByteArray value;
+        QVERIFY(old.value("sensor/3", &value));
+
+        QVector<ClientSnapshot::Value> changed;
+        changed.append({ "sensor/3", "neu", 5000 });
+        QVERIFY(ClientSnapshot::write(path, session(), {}, changed));
+
+        // Die alte Einblendung bleibt lesbar, die neue Datei hat den neuen Wert
+        QCOMPARE(value, QByteArray::number(21));
+        QVERIFY(old.value("sensor/9", &value));
+        QCOMPARE(value, QByteArray::number(63));
+
+        ClientSnapshot current;
+        QVERIFY(current.open(path));
+        QVERIFY(current.value("sensor/3", &value));
+        QCOMPARE(value, QByteArray("neu"));
+        QCOMPARE(current.valueCount(), 1);
+    }
+
+    void invalidContentIsNotWritten()
+    {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("snapshot");
+
+        QVector<ClientSnapshot::Subscription> badNetwork;
+        badNetwork.append({ "message/new", 0, 200 });
+        QString error;
+        QVERIFY(!ClientSnapshot::write(path, session(), badNetwork, {}, &error));
+        QVERIFY(!error.isEmpty());
+
+        QVector<ClientSnapshot::Subscription> longTopic;
+        longTopic.append({ QString(70000, 'x'), 0, 0 });
+        QVERIFY(!ClientSnapshot::write(path, session(), longTopic, {}));
+
+        QVERIFY(!QFile::exists(path));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestClientSnapshot)
+#include "tst_clientsnapshot.moc"
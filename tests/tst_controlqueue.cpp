@@ -0,0 +1,130 @@
+#include "controlqueue.h"
+
+#include <QtTest>
+
+#include <vector>
+
+/**
+ * @brief Fristreihenfolge und Verwerfen abgelaufener Pakete der ControlQueue
+ */
+class TestControlQueue : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray packet(int id)
+    {
+        return QByteArray(1, (char)id);
+    }
+
+    static int id(const ControlQueue::Operation &operation)
+    {
+        return operation.packet.at(0);
+    }
+
+private slots:
+    void popsEarliestDeadlineFirst()
+    {
+        ControlQueue queue;
+        queue.push(300, packet(3), nullptr);
+        queue.push(100, packet(1), nullptr);
+        queue.push(400, packet(4), nullptr);
+        queue.push(200, packet(2), nullptr);
+        QCOMPARE(queue.size(), 4);
+        QCOMPARE(queue.nextDeadlineNs(), qint64(100));
+
+        std::vector<int> order;
+        while (!queue.isEmpty())
+            order.push_back(id(queue.pop()));
+        QCOMPARE(order, std::vector<int>({1, 2, 3, 4}));
+    }
+
+    void equalDeadlinesKeepInsertionOrder()
+    {
+        ControlQueue queue;
+        for (int i = 1; i <= 8; ++i)
+            queue.push(500, packet(i), nullptr);
+        queue.push(100, packet(9), nullptr);
+
+        std::vector<int> order;
+        while (!queue.isEmpty())
+            order.push_back(id(queue.pop()));
+        QCOMPARE(order, std::vector<int>({9, 1, 2, 3, 4, 5, 6, 7, 8}));
+    }
+
+    void interleavedPushAndPop()
+    {
+        ControlQueue queue;
+        queue.push(200, packet(2), nullptr);
+        queue.push(400, packet(4), nullptr);
+        QCOMPARE(id(queue.pop()), 2);
+
+        // Späteres Einstellen mit früherer Frist überholt wartende Pakete
+        queue.push(100, packet(1), nullptr);
+        queue.push(400, packet(5), nullptr);
+        QCOMPARE(id(queue.pop()), 1);
+        QCOMPARE(id(queue.pop()), 4);
+        QCOMPARE(id(queue.pop()), 5);
+        QVERIFY(queue.isEmpty());
+    }
+
+    void takeExpiredIncludesDeadline()
+    {
+        ControlQueue queue;
+        queue.push(100, packet(1), nullptr);
+        queue.push(200, packet(2), nullptr);
+        queue.push(300, packet(3), nullptr);
+
+        QVERIFY(queue.takeExpired(99).empty());
+
+        const std::vector<ControlQueue::Operation> expired = queue.takeExpired(200);
+        QCOMPARE(expired.size(), size_t(2));
+        QCOMPARE(id(expired.at(0)), 1);
+        QCOMPARE(id(expired.at(1)), 2);
+        QCOMPARE(queue.size(), 1);
+        QCOMPARE(queue.nextDeadlineNs(), qint64(300));
+    }
+
+    void takeExpiredLeavesCallbacksToCaller()
+    {
+        ControlQueue queue;
+        int expiredCalls = 0;
+        int writtenCalls = 0;
+        queue.push(100, packet(1), [&]() { expiredCalls++; }, [&]() { writtenCalls++; });
+
+        std::vector<ControlQueue::Operation> expired = queue.takeExpired(1000);
+        QCOMPARE(expired.size(), size_t(1));
+        QCOMPARE(expiredCalls, 0);
+
+        expired.at(0).expired();
+        QCOMPARE(expiredCalls, 1);
+        QCOMPARE(writtenCalls, 0);
+    }
+
+    void callbackMayPushIntoQueue()
+    {
+        ControlQueue queue;
+        queue.push(100, packet(1), [&]() { queue.push(150, packet(2), nullptr); });
+
+        for (ControlQueue::Operation &operation : queue.takeExpired(100))
+            operation.expired();
+        QCOMPARE(queue.size(), 1);
+        QCOMPARE(id(queue.pop()), 2);
+    }
+
+    void takeAllEmptiesQueue()
+    {
+        ControlQueue queue;
+        queue.push(300, packet(3), nullptr);
+        queue.push(100, packet(1), nullptr);
+        QVERIFY(queue.memoryFootprint() > 0);
+
+        QCOMPARE(queue.takeAll().size(), size_t(2));
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.memoryFootprint(), qint64(0));
+        QVERIFY(queue.takeExpired(1000).empty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestControlQueue)
+#include "tst_controlqueue.moc"
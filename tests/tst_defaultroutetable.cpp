@@ -0,0 +1,124 @@
+#include "defaultroutetable.h"
+
+#include <QtTest>
+
+#include <sys/socket.h>
+
+/**
+ * @brief Default-Routen je Interface, Adressfamilie und Nexthop
+ */
+class TestDefaultRouteTable : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray v4(quint32 metric = 100, const QByteArray &gateway = QByteArray::fromHex("c0a80001"))
+    {
+        return DefaultRouteTable::routeKey(AF_INET, metric, gateway);
+    }
+
+    static QByteArray v6(quint32 metric = 100)
+    {
+        return DefaultRouteTable::routeKey(AF_INET6, metric, QByteArray::fromHex("fe800000000000000000000000000001"));
+    }
+
+private slots:
+    void removingOneFamilyKeepsRoute()
+    {
+        DefaultRouteTable table;
+        QVERIFY(table.add("wlan0", v4()));
+        QVERIFY(!table.add("wlan0", v6()));
+        QCOMPARE(table.routeCount("wlan0"), 2);
+
+        QVERIFY(!table.remove("wlan0", v4()));
+        QVERIFY(table.hasRoute("wlan0"));
+        QVERIFY(table.remove("wlan0", v6()));
+        QVERIFY(!table.hasRoute("wlan0"));
+    }
+
+    void ecmpNexthopsAreSeparateRoutes()
+    {
+        DefaultRouteTable table;
+        const QByteArray first = v4(100, QByteArray::fromHex("0a000001"));
+        const QByteArray second = v4(100, QByteArray::fromHex("0a000002"));
+        QVERIFY(first != second);
+        QVERIFY(v4(100) != v4(200));
+
+        QVERIFY(table.add("eth0", first));
+        QVERIFY(!table.add("eth0", second));
+        QVERIFY(!table.add("eth0", second));
+        QCOMPARE(table.routeCount("eth0"), 2);
+
+        QVERIFY(!table.remove("eth0", first));
+        QVERIFY(table.remove("eth0", second));
+    }
+
+    void unknownRemovalChangesNothing()
+    {
+        DefaultRouteTable table;
+        QVERIFY(!table.remove("eth0", v4()));
+
+        table.add("eth0", v4());
+        QVERIFY(!table.remove("eth0", v6()));
+        QVERIFY(!table.remove("wlan0", v4()));
+        QVERIFY(table.hasRoute("eth0"));
+    }
+
+    void removeInterfaceDropsAllRoutes()
+    {
+        DefaultRouteTable table;
+        table.add("eth0", v4());
+        table.add("eth0", v6());
+        table.add("wlan0", v4());
+
+        QVERIFY(table.removeInterface("eth0"));
+        QVERIFY(!table.hasRoute("eth0"));
+        QVERIFY(table.hasRoute("wlan0"));
+        QVERIFY(!table.removeInterface("eth0"));
+
+        // Nach dem Wiederkommen zählt die erste Route wieder als Übergang
+        QVERIFY(table.add("eth0", v4()));
+    }
+
+    void resyncReportsChangedInterfaces()
+    {
+        DefaultRouteTable table;
+        table.add("eth0", v4());
+        table.add("wlan0", v4());
+
+        table.beginResync();
+        QVERIFY(table.isResyncing());
+        table.addDumped("wlan0", v6());
+        table.addDumped("wwan0", v4());
+        const QVector<DefaultRouteTable::Change> changes = table.endResync();
+        QVERIFY(!table.isResyncing());
+
+        QCOMPARE(changes.size(), 2);
+        QVERIFY(changes.contains(DefaultRouteTable::Change("eth0", false)));
+        QVERIFY(changes.contains(DefaultRouteTable::Change("wwan0", true)));
+
+        QVERIFY(!table.hasRoute("eth0"));
+        QCOMPARE(table.routeCount("wlan0"), 1);
+        QVERIFY(table.hasRoute("wwan0"));
+    }
+
+    void eventsDuringResyncAreKept()
+    {
+        DefaultRouteTable table;
+        table.add("eth0", v4());
+
+        table.beginResync();
+        table.addDumped("eth0", v4());
+        QVERIFY(table.add("wlan0", v4()));
+        QVERIFY(table.remove("eth0", v4()));
+        const QVector<DefaultRouteTable::Change> changes = table.endResync();
+
+        // Die Ereignisse wurden bereits gemeldet, der Dump bestätigt sie nur
+        QVERIFY(changes.isEmpty());
+        QVERIFY(!table.hasRoute("eth0"));
+        QVERIFY(table.hasRoute("wlan0"));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestDefaultRouteTable)
+#include "tst_defaultroutetable.moc"
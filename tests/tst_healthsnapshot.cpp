@@ -0,0 +1,142 @@
+#include "healthsnapshot.h"
+
+#include <QtTest>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+/**
+ * @brief Seqlock des HealthPublisher und Perzentile des RttWindow
+ */
+class TestHealthSnapshot : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Alle Felder aus einem Zähler - ein gemischter Snapshot fällt sofort auf
+    static HealthSnapshot snapshot(qint64 k)
+    {
+        HealthSnapshot health;
+        memset(&health, 0, sizeof(health));
+        health.publishedNs = k;
+        health.activeNetwork = (qint32)(k % HealthSnapshot::MaxNetworks);
+        health.bestNetwork = health.activeNetwork;
+        health.networkCount = HealthSnapshot::MaxNetworks;
+        health.switchCount = (quint32)k;
+        health.lastSwitchNs = k;
+        health.lastSwitchDurationNs = -k;
+        for (int i = 0; i < HealthSnapshot::MaxNetworks; ++i) {
+            health.networks[i].rttUs = k + i;
+            health.networks[i].rttP99Us = k - i;
+            health.networks[i].missedProbes = (qint32)k;
+        }
+        return health;
+    }
+
+    static bool consistent(const HealthSnapshot &health)
+    {
+        const qint64 k = health.publishedNs;
+        if (health.activeNetwork != (qint32)(k % HealthSnapshot::MaxNetworks) || health.switchCount != (quint32)k
+            || health.lastSwitchNs != k || health.lastSwitchDurationNs != -k)
+            return false;
+        for (int i = 0; i < HealthSnapshot::MaxNetworks; ++i) {
+            if (health.networks[i].rttUs != k + i || health.networks[i].rttP99Us != k - i
+                || health.networks[i].missedProbes != (qint32)k)
+                return false;
+        }
+        return true;
+    }
+
+private slots:
+    void readBeforePublishFails()
+    {
+        HealthPublisher publisher;
+        HealthSnapshot health;
+        QVERIFY(!publisher.read(&health));
+        QCOMPARE(publisher.version(), quint64(0));
+    }
+
+    void publishSetsVersionAndRoundTrips()
+    {
+        HealthPublisher publisher;
+        HealthSnapshot health = snapshot(42);
+        health.version = 999;                                // wird vom Publisher überschrieben
+        publisher.publish(health);
+        publisher.publish(snapshot(43));
+
+        HealthSnapshot read;
+        QVERIFY(publisher.read(&read));
+        QCOMPARE(publisher.version(), quint64(2));
+        QCOMPARE(read.version, quint64(2));
+        QCOMPARE(read.publishedNs, qint64(43));
+        QVERIFY(consistent(read));
+    }
+
+    void concurrentReadersSeeWholeSnapshots()
+    {
+        HealthPublisher publisher;
+        publisher.publish(snapshot(0));
+
+        std::atomic<bool> done(false);
+        std::atomic<int> torn(0);
+        std::atomic<int> backwards(0);
+        std::atomic<int> reads(0);
+
+        auto reader = [&]() {
+            quint64 lastVersion = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                HealthSnapshot health;
+                if (!publisher.read(&health))
+                    continue;
+                if (!consistent(health))
+                    torn++;
+                if (health.version < lastVersion)
+                    backwards++;
+                lastVersion = health.version;
+                reads++;
+            }
+        };
+        std::thread first(reader);
+        std::thread second(reader);
+
+        for (qint64 k = 1; k <= 20000; ++k)
+            publisher.publish(snapshot(k));
+        done.store(true, std::memory_order_release);
+        first.join();
+        second.join();
+
+        QCOMPARE(torn.load(), 0);
+        QCOMPARE(backwards.load(), 0);
+        QVERIFY(reads.load() > 0);
+        QCOMPARE(publisher.version(), quint64(20001));
+    }
+
+    void rttPercentilesOfEmptyWindow()
+    {
+        RttWindow window;
+        qint64 p50 = 0, p90 = 0, p99 = 0;
+        window.percentiles(&p50, &p90, &p99);
+        QCOMPARE(p50, qint64(-1));
+        QCOMPARE(p90, qint64(-1));
+        QCOMPARE(p99, qint64(-1));
+    }
+
+    void rttPercentilesUseLastSamples()
+    {
+        RttWindow window;
+        for (qint64 rtt = 100; rtt >= 1; --rtt)
+            window.add(rtt);
+        QCOMPARE(window.count(), RttWindow::Capacity);
+
+        // Im Fenster stehen die letzten 64 Proben: 1..64
+        qint64 p50 = 0, p90 = 0, p99 = 0;
+        window.percentiles(&p50, &p90, &p99);
+        QCOMPARE(p50, qint64(33));
+        QCOMPARE(p90, qint64(58));
+        QCOMPARE(p99, qint64(63));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestHealthSnapshot)
+#include "tst_healthsnapshot.moc"
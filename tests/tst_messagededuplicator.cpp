@@ -0,0 +1,75 @@
+#include "messagededuplicator.h"
+
+#include <QtTest>
+
+/**
+ * @brief Zusammenführen zweier redundanter Empfangsströme
+ */
+class TestMessageDeduplicator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void copyFromOtherSourceIsDropped()
+    {
+        MessageDeduplicator dedup;
+        QVERIFY(dedup.accept(0, "sensor/a", "1"));
+        QVERIFY(!dedup.accept(1, "sensor/a", "1"));
+
+        QCOMPARE(dedup.duplicatesDropped(), quint64(1));
+        QCOMPARE(dedup.deliveredFrom(0), quint64(1));
+        QCOMPARE(dedup.deliveredFrom(1), quint64(0));
+    }
+
+    void repeatFromSameSourceIsNewMessage()
+    {
+        MessageDeduplicator dedup;
+        QVERIFY(dedup.accept(0, "sensor/a", "1"));
+        QVERIFY(dedup.accept(0, "sensor/a", "1"));
+
+        // Die andere Quelle schuldet zwei Kopien, die dritte ist neu
+        QVERIFY(!dedup.accept(1, "sensor/a", "1"));
+        QVERIFY(!dedup.accept(1, "sensor/a", "1"));
+        QVERIFY(dedup.accept(1, "sensor/a", "1"));
+    }
+
+    void topicAndPayloadBoundaryMatters()
+    {
+        MessageDeduplicator dedup;
+        QVERIFY(dedup.accept(0, "ab", "c"));
+        QVERIFY(dedup.accept(1, "a", "bc"));
+        QVERIFY(MessageDeduplicator::contentHash("ab", "c") != MessageDeduplicator::contentHash("a", "bc"));
+    }
+
+    void evictingSettledEntryKeepsOwedCopy()
+    {
+        MessageDeduplicator dedup(2);
+        QVERIFY(dedup.accept(0, "t", "a"));
+        QVERIFY(!dedup.accept(1, "t", "a"));   // erster Eintrag erfüllt
+        QVERIFY(dedup.accept(0, "t", "a"));    // neue Nachricht, Kopie von 1 ausstehend
+        QVERIFY(dedup.accept(0, "t", "b"));    // verdrängt den erfüllten Eintrag
+
+        // Die ausstehende Kopie muss weiterhin als Duplikat erkannt werden
+        QVERIFY(!dedup.accept(1, "t", "a"));
+    }
+
+    void evictedOwedCopyIsDeliveredAgain()
+    {
+        MessageDeduplicator dedup(1);
+        QVERIFY(dedup.accept(0, "t", "a"));
+        QVERIFY(dedup.accept(0, "t", "b"));    // verdrängt "a"
+        QVERIFY(dedup.accept(1, "t", "a"));
+    }
+
+    void clearForgetsPendingCopies()
+    {
+        MessageDeduplicator dedup;
+        QVERIFY(dedup.accept(0, "t", "a"));
+        dedup.clear();
+        QVERIFY(dedup.accept(1, "t", "a"));
+        QCOMPARE(dedup.duplicatesDropped(), quint64(0));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestMessageDeduplicator)
+#include "tst_messagededuplicator.moc"
@@ -0,0 +1,159 @@
+#include "payloadcipher.h"
+
+#include <QtTest>
+
+#include <cstring>
+
+/**
+ * @brief Versiegeln, Prüfen und Schlüsselwechsel des PayloadCipher
+ */
+class TestPayloadCipher : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr const char *Topic = "message/new";
+
+    static QByteArray key(char fill)
+    {
+        return QByteArray(PayloadCipher::KeySize, fill);
+    }
+
+    /// Paket wie im Sendepfad: authentifizierter Vorspann (Topic), danach die versiegelte Payload
+    static bool seal(PayloadCipher &cipher, const QString &topic, const QByteArray &payload, QByteArray *packet)
+    {
+        *packet = topic.toUtf8();
+        return cipher.seal(topic, *packet, 0, payload);
+    }
+
+    static bool open(PayloadCipher &cipher, const QString &topic, const QByteArray &packet, QByteArray *plaintext)
+    {
+        const int prefix = topic.toUtf8().size();
+        return cipher.open(topic, packet.constData(), packet.constData() + prefix, packet.size() - prefix, *plaintext);
+    }
+
+private slots:
+    void roundTripBothAlgorithms()
+    {
+        const PayloadCipher::Algorithm algorithms[] = { PayloadCipher::Aes256Gcm, PayloadCipher::ChaCha20Poly1305 };
+        for (PayloadCipher::Algorithm algorithm : algorithms) {
+            PayloadCipher cipher;
+            QVERIFY(cipher.setKey(Topic, 1, key('k'), algorithm));
+
+            const QByteArray payload("Schalterstellung: secure");
+            QByteArray packet;
+            QVERIFY(seal(cipher, Topic, payload, &packet));
+            QCOMPARE(packet.size(), (int)strlen(Topic) + payload.size() + PayloadCipher::Overhead);
+            QVERIFY(!packet.contains(payload));
+
+            QByteArray plaintext;
+            QVERIFY(open(cipher, Topic, packet, &plaintext));
+            QCOMPARE(plaintext, payload);
+        }
+    }
+
+    void emptyPayloadRoundTrips()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.setKey(Topic, 1, key('k')));
+
+        QByteArray packet;
+        QVERIFY(seal(cipher, Topic, QByteArray(), &packet));
+        QByteArray plaintext("alt");
+        QVERIFY(open(cipher, Topic, packet, &plaintext));
+        QVERIFY(plaintext.isEmpty());
+    }
+
+    void noncesDifferPerMessage()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.setKey(Topic, 1, key('k')));
+
+        QByteArray first;
+        QByteArray second;
+        QVERIFY(seal(cipher, Topic, "gleich", &first));
+        QVERIFY(seal(cipher, Topic, "gleich", &second));
+        QVERIFY(first != second);
+    }
+
+    void tamperingIsRejected()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.setKey(Topic, 1, key('k')));
+
+        QByteArray packet;
+        QVERIFY(seal(cipher, Topic, "Umschalten auf unsecure", &packet));
+        const int prefix = (int)strlen(Topic);
+
+        // Chiffrat, Tag, Nonce und authentifizierter Vorspann
+        const int positions[] = { prefix + PayloadCipher::HeaderSize, packet.size() - 1, prefix + 6, 0 };
+        for (int position : positions) {
+            QByteArray tampered = packet;
+            tampered[position] = (char)(tampered.at(position) ^ 0x01);
+            QByteArray plaintext;
+            QVERIFY(!open(cipher, Topic, tampered, &plaintext));
+            QVERIFY(plaintext.isEmpty());
+        }
+
+        QByteArray plaintext;
+        QVERIFY(!open(cipher, Topic, packet.left(prefix + PayloadCipher::Overhead - 1), &plaintext));
+    }
+
+    void otherTopicKeyIsRejected()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.setKey(Topic, 1, key('k')));
+        QVERIFY(cipher.setKey("message/err", 1, key('e')));
+
+        QByteArray packet;
+        QVERIFY(seal(cipher, Topic, "umgeleitet", &packet));
+
+        // Gleiche Länge des Topics, damit nur der Schlüssel abweicht
+        QByteArray plaintext;
+        QVERIFY(!open(cipher, "message/err", packet, &plaintext));
+    }
+
+    void keyRotationKeepsPreviousUntilRetired()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.setKey(Topic, 1, key('a')));
+        QByteArray oldPacket;
+        QVERIFY(seal(cipher, Topic, "alt", &oldPacket));
+
+        QVERIFY(cipher.setKey(Topic, 2, key('b')));
+        QByteArray newPacket;
+        QVERIFY(seal(cipher, Topic, "neu", &newPacket));
+
+        QByteArray plaintext;
+        QVERIFY(open(cipher, Topic, oldPacket, &plaintext));
+        QCOMPARE(plaintext, QByteArray("alt"));
+        QVERIFY(open(cipher, Topic, newPacket, &plaintext));
+        QCOMPARE(plaintext, QByteArray("neu"));
+
+        cipher.retirePreviousKey(Topic);
+        QVERIFY(!open(cipher, Topic, oldPacket, &plaintext));
+        QVERIFY(open(cipher, Topic, newPacket, &plaintext));
+    }
+
+    void keysAreRequired()
+    {
+        PayloadCipher cipher;
+        QVERIFY(cipher.isEmpty());
+        QVERIFY(!cipher.setKey(Topic, 1, QByteArray(16, 'k')));
+        QVERIFY(!cipher.hasKey(Topic));
+
+        QByteArray packet;
+        QVERIFY(!seal(cipher, Topic, "ohne Schlüssel", &packet));
+
+        QVERIFY(cipher.setKey(Topic, 1, key('k')));
+        QVERIFY(cipher.hasKey(Topic));
+        QVERIFY(!cipher.needsRotation(Topic));
+
+        cipher.removeTopic(Topic);
+        QVERIFY(!cipher.hasKey(Topic));
+        QVERIFY(cipher.isEmpty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestPayloadCipher)
+#include "tst_payloadcipher.moc"
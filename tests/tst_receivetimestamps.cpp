@@ -0,0 +1,119 @@
+#include "mqttclient.h"
+
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest>
+
+/**
+ * @brief Kernel-Empfangszeitstempel über eine Loopback-Verbindung
+ *
+ * Ein QTcpServer spielt einen minimalen Broker: CONNACK auf CONNECT,
+ * danach eine PUBLISH-Nachricht mit QoS 0.
+ */
+class TestReceiveTimestamps : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QByteArray publishPacket(const QByteArray &topic, const QByteArray &payload)
+    {
+        QByteArray packet;
+        packet.append(char(0x30));
+        packet.append(char(2 + topic.size() + payload.size()));
+        packet.append(char(topic.size() >> 8));
+        packet.append(char(topic.size() & 0xFF));
+        packet.append(topic);
+        packet.append(payload);
+        return packet;
+    }
+
+private slots:
+    void timestampsAreOrderedOnLoopback()
+    {
+#ifndef Q_OS_LINUX
+        QSKIP("Kernel-Empfangszeitstempel nur unter Linux");
+#endif
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        QTcpSocket *broker = nullptr;
+        QByteArray received;
+        connect(&server, &QTcpServer::newConnection, this, [&]() {
+            broker = server.nextPendingConnection();
+            connect(broker, &QTcpSocket::readyRead, this, [&]() {
+                const bool first = received.isEmpty();
+                received.append(broker->readAll());
+                if (first)
+                    broker->write(QByteArray::fromHex("20020000"));
+            });
+        });
+
+        MqttClient client;
+        client.setReceiveTimestampsEnabled(true);
+        QSignalSpy connectedSpy(&client, &MqttClient::connected);
+        client.connectToHost("127.0.0.1", server.serverPort(), "tst");
+        QTRY_COMPARE(connectedSpy.count(), 1);
+
+        qint64 receiveNs = 0;
+        qint64 dispatchNs = 0;
+        qint64 handlerNs = 0;
+        QByteArray payload;
+        client.subscribe("sensor/t", [&](const QByteArray &data) {
+            receiveNs = client.receiveTimestampNs();
+            dispatchNs = client.dispatchTimestampNs();
+            handlerNs = MqttClient::realtimeNs();
+            payload = data;
+        });
+
+        // SUBSCRIBE abwarten, damit der Handler sicher registriert ist
+        QTRY_VERIFY(received.contains(char(0x82)));
+
+        const qint64 beforeSendNs = MqttClient::realtimeNs();
+        broker->write(publishPacket("sensor/t", "21.5"));
+        QTRY_COMPARE(payload, QByteArray("21.5"));
+
+        QVERIFY(receiveNs > 0);
+        QVERIFY(beforeSendNs <= receiveNs);
+        QVERIFY(receiveNs <= dispatchNs);
+        QVERIFY(dispatchNs <= handlerNs);
+    }
+
+    void disabledLeavesReceiveTimestampUnset()
+    {
+        QTcpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        QTcpSocket *broker = nullptr;
+        QByteArray received;
+        connect(&server, &QTcpServer::newConnection, this, [&]() {
+            broker = server.nextPendingConnection();
+            connect(broker, &QTcpSocket::readyRead, this, [&]() {
+                const bool first = received.isEmpty();
+                received.append(broker->readAll());
+                if (first)
+                    broker->write(QByteArray::fromHex("20020000"));
+            });
+        });
+
+        MqttClient client;
+        QSignalSpy connectedSpy(&client, &MqttClient::connected);
+        client.connectToHost("127.0.0.1", server.serverPort(), "tst");
+        QTRY_COMPARE(connectedSpy.count(), 1);
+
+        bool called = false;
+        qint64 receiveNs = -1;
+        client.subscribe("sensor/t", [&](const QByteArray &) {
+            receiveNs = client.receiveTimestampNs();
+            called = true;
+        });
+        QTRY_VERIFY(received.contains(char(0x82)));
+
+        broker->write(publishPacket("sensor/t", "1"));
+        QTRY_VERIFY(called);
+        QCOMPARE(receiveNs, qint64(0));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestReceiveTimestamps)
+#include "tst_receivetimestamps.moc"
@@ -0,0 +1,205 @@
+#include "sequencetracker.h"
+
+#include <QtTest>
+
+/**
+ * @brief Verlust-, Duplikat- und Umsortierungszählung des SequenceTracker
+ */
+class TestSequenceTracker : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr quint32 Publisher = 0x1234;
+
+    static MessageEnvelope::View envelope(quint32 sequence, quint8 epoch = 0)
+    {
+        MessageEnvelope::View view;
+        view.publisherId = Publisher;
+        view.sequence = sequence;
+        view.epoch = epoch;
+        view.sendTimestampNs = 1000;
+        return view;
+    }
+
+    static bool record(SequenceTracker &tracker, quint32 sequence, quint8 epoch = 0)
+    {
+        return tracker.record(envelope(sequence, epoch), 2000);
+    }
+
+private slots:
+    void inOrderHasNoLoss()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence < 10; ++sequence)
+            QVERIFY(record(tracker, sequence));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.received, quint64(10));
+        QCOMPARE(stats.lost, quint64(0));
+        QCOMPARE(stats.duplicates, quint64(0));
+        QCOMPARE(stats.lastLatencyNs, qint64(1000));
+    }
+
+    void gapCountsAsLoss()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0);
+        record(tracker, 1);
+        record(tracker, 5);
+
+        QCOMPARE(tracker.stats(Publisher).lost, quint64(3));
+        QCOMPARE(tracker.stats(Publisher).received, quint64(3));
+    }
+
+    void lateArrivalIsReorderedNotLost()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0);
+        record(tracker, 3);
+        QVERIFY(record(tracker, 1));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.lost, quint64(1));
+        QCOMPARE(stats.reordered, quint64(1));
+    }
+
+    void repeatedSequenceIsDuplicate()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0);
+        record(tracker, 1);
+        record(tracker, 2);
+        QVERIFY(!record(tracker, 2));
+        QVERIFY(!record(tracker, 1));
+
+        QCOMPARE(tracker.stats(Publisher).duplicates, quint64(2));
+        QCOMPARE(tracker.stats(Publisher).received, quint64(3));
+    }
+
+    void olderThanWindowIsDuplicate()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0);
+        record(tracker, 100);
+        QVERIFY(!record(tracker, 10));
+        QCOMPARE(tracker.stats(Publisher).duplicates, quint64(1));
+    }
+
+    void wrapAroundIsNoLoss()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0xFFFFFFFEu);
+        record(tracker, 0xFFFFFFFFu);
+        QVERIFY(record(tracker, 0));
+        QVERIFY(record(tracker, 1));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.lost, quint64(0));
+        QCOMPARE(stats.resets, quint64(0));
+    }
+
+    void sequenceZeroRestartsPublisherWithoutEpoch()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence < 6; ++sequence)
+            record(tracker, sequence);
+        QVERIFY(record(tracker, 0));
+        QVERIFY(record(tracker, 1));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.resets, quint64(1));
+        QCOMPARE(stats.duplicates, quint64(0));
+        QCOMPARE(stats.received, quint64(8));
+    }
+
+    void newEpochRestartsWithoutSequenceZero()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence <= 10; ++sequence)
+            record(tracker, sequence, 5);
+
+        // Sequenz 0 bis 2 der neuen Epoch gingen verloren
+        QVERIFY(record(tracker, 3, 9));
+        QVERIFY(record(tracker, 4, 9));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.resets, quint64(1));
+        QCOMPARE(stats.duplicates, quint64(0));
+        QCOMPARE(stats.lost, quint64(3));
+        QCOMPARE(stats.received, quint64(13));
+    }
+
+    void previousEpochStragglerIsDuplicate()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence <= 10; ++sequence) {
+            if (sequence != 7)
+                record(tracker, sequence, 5);
+        }
+        record(tracker, 0, 9);
+
+        // Verspätet über das zweite Netz, innerhalb des alten Fensters
+        QVERIFY(!record(tracker, 7, 5));
+        QVERIFY(record(tracker, 1, 9));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.duplicates, quint64(1));
+        QCOMPARE(stats.resets, quint64(1));
+    }
+
+    void returningToPreviousEpochIsRestart()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence <= 100; ++sequence)
+            record(tracker, sequence, 5);
+        for (quint32 sequence = 0; sequence <= 10; ++sequence)
+            record(tracker, sequence, 9);
+
+        // Zweiter Neustart zieht wieder Epoch 5 (A -> B -> A)
+        for (quint32 sequence = 0; sequence <= 10; ++sequence)
+            QVERIFY(record(tracker, sequence, 5));
+
+        const SequenceTracker::Stats stats = tracker.stats(Publisher);
+        QCOMPARE(stats.resets, quint64(2));
+        QCOMPARE(stats.duplicates, quint64(0));
+        QCOMPARE(stats.received, quint64(101 + 11 + 11));
+
+        // Nachzügler der Epoch 9 sind jetzt die Duplikate
+        QVERIFY(!record(tracker, 10, 9));
+    }
+
+    void epochZeroKeepsSequenceZeroRule()
+    {
+        SequenceTracker tracker;
+        for (quint32 sequence = 0; sequence < 4; ++sequence)
+            record(tracker, sequence, 0);
+
+        // Ohne Epoch ist eine Lücke kein Neustart
+        QVERIFY(record(tracker, 7, 0));
+        QCOMPARE(tracker.stats(Publisher).resets, quint64(0));
+        QCOMPARE(tracker.stats(Publisher).lost, quint64(3));
+
+        QVERIFY(record(tracker, 0, 0));
+        QCOMPARE(tracker.stats(Publisher).resets, quint64(1));
+    }
+
+    void totalsSumPublishers()
+    {
+        SequenceTracker tracker;
+        record(tracker, 0);
+        MessageEnvelope::View other = envelope(0);
+        other.publisherId = Publisher + 1;
+        tracker.record(other, 2000);
+        other.sequence = 2;
+        tracker.record(other, 2000);
+
+        const SequenceTracker::Stats totals = tracker.totals();
+        QCOMPARE(totals.received, quint64(3));
+        QCOMPARE(totals.lost, quint64(1));
+        QCOMPARE(tracker.publishers().size(), 2);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSequenceTracker)
+#include "tst_sequencetracker.moc"
@@ -0,0 +1,217 @@
+#include "timerwheel.h"
+
+#include <QtTest>
+
+#include <vector>
+
+/**
+ * @brief Timer-Rad mit von Hand gestellter Uhr
+ *
+ * Der treibende QTimer wird nie abgewartet: advance() stellt die Uhr und
+ * verarbeitet die Ticks sofort, auch Sprünge über mehrere Ebenengrenzen.
+ */
+class ManualTimerWheel : public TimerWheel
+{
+public:
+    void setNow(quint64 tick) { m_now = tick; }
+
+    void advance(quint64 tick)
+    {
+        m_now = tick;
+        onTick();
+    }
+
+protected:
+    quint64 nowTicks() const override { return m_now; }
+
+private:
+    quint64 m_now = 0;
+};
+
+/**
+ * @brief Ebenenübergänge, Abbruch, Perioden und Nachlauf des TimerWheel
+ */
+class TestTimerWheel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void firesExactlyAtLevelBoundaries()
+    {
+        ManualTimerWheel wheel;
+        std::vector<int> fired;
+        wheel.schedule(255, [&]() { fired.push_back(255); });
+        wheel.schedule(256, [&]() { fired.push_back(256); });
+        wheel.schedule(65536, [&]() { fired.push_back(65536); });
+
+        wheel.advance(254);
+        QVERIFY(fired.empty());
+        wheel.advance(255);
+        QCOMPARE(fired, std::vector<int>({255}));
+        wheel.advance(256);
+        QCOMPARE(fired, std::vector<int>({255, 256}));
+
+        wheel.advance(65535);
+        QCOMPARE(fired.size(), size_t(2));
+        wheel.advance(65536);
+        QCOMPARE(fired, std::vector<int>({255, 256, 65536}));
+        QCOMPARE(wheel.activeCount(), 0);
+    }
+
+    void cascadesFromUnalignedStart()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        wheel.schedule(1000000, []() {});            // hält das Rad belegt
+        wheel.advance(100);
+
+        // Ablauf 65636: liegt auf Ebene 2 und muss über Ebene 1 nach unten
+        wheel.schedule(65536, [&]() { fired++; });
+        wheel.advance(65535);
+        QCOMPARE(fired, 0);
+        wheel.advance(65635);
+        QCOMPARE(fired, 0);
+        wheel.advance(65636);
+        QCOMPARE(fired, 1);
+    }
+
+    void jumpFiresInOrder()
+    {
+        ManualTimerWheel wheel;
+        std::vector<int> fired;
+        wheel.schedule(65536, [&]() { fired.push_back(3); });
+        wheel.schedule(256, [&]() { fired.push_back(2); });
+        wheel.schedule(255, [&]() { fired.push_back(1); });
+
+        wheel.advance(70000);
+        QCOMPARE(fired, std::vector<int>({1, 2, 3}));
+    }
+
+    void cancelDuringDispatch()
+    {
+        ManualTimerWheel wheel;
+        int firstFired = 0;
+        int secondFired = 0;
+        TimerWheel::TimerId first = 0;
+        TimerWheel::TimerId second = 0;
+
+        // Beide im selben Slot - wer zuerst läuft, bricht den anderen ab
+        first = wheel.schedule(10, [&]() {
+            firstFired++;
+            QVERIFY(!wheel.cancel(first));
+            wheel.cancel(second);
+        });
+        second = wheel.schedule(10, [&]() {
+            secondFired++;
+            QVERIFY(!wheel.cancel(second));
+            wheel.cancel(first);
+        });
+
+        wheel.advance(10);
+        QCOMPARE(firstFired + secondFired, 1);
+        QVERIFY(!wheel.isActive(first));
+        QVERIFY(!wheel.isActive(second));
+        QCOMPARE(wheel.activeCount(), 0);
+
+        wheel.advance(1000);
+        QCOMPARE(firstFired + secondFired, 1);
+    }
+
+    void cancelLaterSlotDuringDispatch()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        const TimerWheel::TimerId later = wheel.schedule(300, [&]() { fired++; });
+        wheel.schedule(100, [&]() { QVERIFY(wheel.cancel(later)); });
+
+        // Ein Sprung über beide Abläufe darf den abgebrochenen nicht mehr auslösen
+        wheel.advance(1000);
+        QCOMPARE(fired, 0);
+        QCOMPARE(wheel.activeCount(), 0);
+    }
+
+    void periodicRearmsWithoutDrift()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        const TimerWheel::TimerId id = wheel.scheduleRepeating(100, [&]() { fired++; });
+
+        wheel.advance(100);
+        wheel.advance(250);
+        wheel.advance(300);
+        QCOMPARE(fired, 3);
+
+        // Nachholen verpasster Perioden, Handle bleibt gleich
+        wheel.advance(1000);
+        QCOMPARE(fired, 10);
+        QVERIFY(wheel.isActive(id));
+        QCOMPARE(wheel.activeCount(), 1);
+
+        QVERIFY(wheel.cancel(id));
+        wheel.advance(2000);
+        QCOMPARE(fired, 10);
+    }
+
+    void periodicCancelsItself()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        TimerWheel::TimerId id = 0;
+        id = wheel.scheduleRepeating(256, [&]() {
+            if (++fired == 3)
+                QVERIFY(wheel.cancel(id));
+        });
+
+        wheel.advance(100000);
+        QCOMPARE(fired, 3);
+        QVERIFY(!wheel.isActive(id));
+        QCOMPARE(wheel.activeCount(), 0);
+    }
+
+    void scheduleWhileLagging()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        wheel.schedule(1000000, []() {});
+
+        // Das Rad steht noch auf 0, die Uhr ist schon bei 1000
+        wheel.setNow(1000);
+        wheel.schedule(10, [&]() { fired++; });
+
+        wheel.advance(1009);
+        QCOMPARE(fired, 0);
+        wheel.advance(1010);
+        QCOMPARE(fired, 1);
+    }
+
+    void scheduleFromCallbackUsesCurrentTick()
+    {
+        ManualTimerWheel wheel;
+        std::vector<int> fired;
+        wheel.schedule(50, [&]() {
+            fired.push_back(50);
+            wheel.schedule(10, [&]() { fired.push_back(60); });
+        });
+        wheel.schedule(100, [&]() { fired.push_back(100); });
+
+        // Verspäteter Tick: der Folgetimer läuft relativ zum Ablauf, nicht zur Uhr
+        wheel.advance(500);
+        QCOMPARE(fired, std::vector<int>({50, 60, 100}));
+    }
+
+    void idleWheelSkipsToNow()
+    {
+        ManualTimerWheel wheel;
+        int fired = 0;
+        wheel.setNow(10000000);
+        wheel.schedule(5, [&]() { fired++; });
+
+        wheel.advance(10000004);
+        QCOMPARE(fired, 0);
+        wheel.advance(10000005);
+        QCOMPARE(fired, 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestTimerWheel)
+#include "tst_timerwheel.moc"
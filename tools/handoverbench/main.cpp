@@ -0,0 +1,198 @@
+#include "mqttclient.h"
+#include "sequencetracker.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+/**
+ * @brief Nachrichtenverlust beim Netzwechsel: break-before-make gegen make-before-break
+ *
+ * Ein Publisher sendet mit konstanter Rate und Umschlag. Zwei Empfänger
+ * verbinden sich über verschiedene Loopback-Adressen (eigene 4-Tupel, wie
+ * zwei Netze) und teilen sich einen SequenceTracker. Das Nachrichten-Topic
+ * wird wiederholt zwischen beiden umgezogen:
+ * - break: altes Abonnement abmelden, dann neues anlegen (bisheriges Verhalten)
+ * - make:  neues anlegen, nach dessen SUBACK das alte abmelden (NetworkSelector)
+ *
+ * Verloren = gesendet - eindeutig zugestellt, Duplikate der Überlappung
+ * werden vom gemeinsamen Tracker verworfen und gezählt.
+ *
+ * Der Broker muss auf allen Loopback-Adressen lauschen (z.B. 0.0.0.0:1883);
+ * unter Linux ist 127.0.0.0/8 ohne weitere Konfiguration erreichbar.
+ */
+
+static const QString Topic = QStringLiteral("handover/bench");
+
+/// true = Debug-Ausgaben der MqttClients anzeigen
+static bool s_verbose = false;
+
+static void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type == QtDebugMsg && !s_verbose)
+        return;
+    std::cerr << message.toStdString() << std::endl;
+}
+
+/// Lässt die Event-Loop laufen
+static void waitMs(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/// Wartet auf ein Signal des Clients oder den Timeout
+template<typename Signal>
+static void waitFor(MqttClient *client, Signal signal, int timeoutMs)
+{
+    QEventLoop loop;
+    QObject::connect(client, signal, &loop, [&loop]() { loop.quit(); });
+    QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+struct Result {
+    quint64 published = 0;
+    quint64 delivered = 0;
+    quint64 duplicates = 0;
+    double avgHandoverMs = 0.0;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("handoverbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Nachrichtenverlust beim Netzwechsel über Loopback-Aliase");
+    parser.addHelpOption();
+    parser.addOption({"publish-host", "Adresse des Publishers", "host", "127.0.0.1"});
+    parser.addOption({"path-a", "Adresse des ersten Netzes", "host", "127.0.0.2"});
+    parser.addOption({"path-b", "Adresse des zweiten Netzes", "host", "127.0.0.3"});
+    parser.addOption({"port", "Broker-Port", "port", "1883"});
+    parser.addOption({"rate", "Nachrichten pro Sekunde", "rate", "2000"});
+    parser.addOption({"switches", "Netzwechsel pro Modus", "n", "20"});
+    parser.addOption({"dwell", "Zeit zwischen zwei Wechseln in ms", "ms", "250"});
+    parser.addOption({"mode", "Modus: break, make oder both", "mode", "both"});
+    parser.addOption({"verbose", "Debug-Ausgaben der Clients anzeigen"});
+    parser.process(app);
+
+    s_verbose = parser.isSet("verbose");
+    qInstallMessageHandler(messageHandler);
+
+    const quint16 port = (quint16)parser.value("port").toInt();
+    const double rate = qMax(1.0, parser.value("rate").toDouble());
+    const int switches = qMax(1, parser.value("switches").toInt());
+    const int dwellMs = qMax(10, parser.value("dwell").toInt());
+    const QString mode = parser.value("mode");
+
+    MqttClient publisher;
+    MqttClient paths[2];
+    auto tracker = std::make_shared<SequenceTracker>();
+    publisher.setEnvelopeEnabled(true);
+    publisher.setWriteBatchingEnabled(false);
+
+    quint64 delivered = 0;
+    for (MqttClient &path : paths) {
+        path.setEnvelopeEnabled(true);
+        path.setSequenceTracker(tracker);
+        path.setDropDuplicates(true);
+        QObject::connect(&path, &MqttClient::messageReceived, [&delivered](const QString &, const QByteArray &) { delivered++; });
+    }
+
+    publisher.connectToHost(parser.value("publish-host"), port, "handoverbench-pub");
+    paths[0].connectToHost(parser.value("path-a"), port, "handoverbench-a");
+    paths[1].connectToHost(parser.value("path-b"), port, "handoverbench-b");
+    for (MqttClient *client : {&publisher, &paths[0], &paths[1]}) {
+        if (!client->isConnected())
+            waitFor(client, &MqttClient::connected, 5000);
+        if (!client->isConnected()) {
+            std::cerr << "Keine Verbindung zum Broker" << std::endl;
+            return 1;
+        }
+    }
+
+    // Konstante Senderate über einen 1-ms-Takt
+    quint64 published = 0;
+    double credit = 0.0;
+    bool publishing = false;
+    const QByteArray payload(32, 'x');
+    QTimer ticker;
+    ticker.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&ticker, &QTimer::timeout, [&]() {
+        if (!publishing)
+            return;
+        credit += rate / 1000.0;
+        for (; credit >= 1.0; credit -= 1.0) {
+            publisher.publish(Topic, payload);
+            published++;
+        }
+    });
+    ticker.start(1);
+
+    auto run = [&](bool makeBeforeBreak) {
+        Result result;
+        int active = 0;
+        paths[active].subscribe(Topic);
+        waitFor(&paths[active], &MqttClient::subscriptionAcknowledged, 3000);
+
+        const quint64 duplicatesBefore = paths[0].droppedDuplicates() + paths[1].droppedDuplicates();
+        delivered = 0;
+        published = 0;
+        publishing = true;
+
+        qint64 handoverNs = 0;
+        for (int i = 0; i < switches; ++i) {
+            waitMs(dwellMs);
+            const int next = 1 - active;
+            const qint64 startNs = (qint64)MessageEnvelope::monotonicNs();
+            if (makeBeforeBreak) {
+                paths[next].subscribe(Topic);
+                waitFor(&paths[next], &MqttClient::subscriptionAcknowledged, 3000);
+                paths[active].unsubscribe(Topic);
+            } else {
+                paths[active].unsubscribe(Topic);
+                paths[next].subscribe(Topic);
+            }
+            handoverNs += (qint64)MessageEnvelope::monotonicNs() - startNs;
+            active = next;
+        }
+
+        waitMs(dwellMs);
+        publishing = false;
+        waitMs(500);    // Nachzügler abwarten
+
+        paths[active].unsubscribe(Topic);
+        waitMs(100);
+
+        result.published = published;
+        result.delivered = delivered;
+        result.duplicates = paths[0].droppedDuplicates() + paths[1].droppedDuplicates() - duplicatesBefore;
+        result.avgHandoverMs = handoverNs / 1e6 / switches;
+        return result;
+    };
+
+    std::cout << std::setw(8) << "Modus" << std::setw(12) << "Gesendet" << std::setw(12) << "Zugestellt"
+              << std::setw(12) << "Verloren" << std::setw(12) << "Duplikate" << std::setw(14) << "Wechsel ms" << std::endl;
+
+    for (const QString &name : {QStringLiteral("break"), QStringLiteral("make")}) {
+        if (mode != "both" && mode != name)
+            continue;
+        const Result result = run(name == "make");
+        const quint64 lost = result.published > result.delivered ? result.published - result.delivered : 0;
+        std::cout << std::setw(8) << name.toStdString() << std::setw(12) << result.published << std::setw(12) << result.delivered
+                  << std::setw(12) << lost << std::setw(12) << result.duplicates
+                  << std::fixed << std::setprecision(2) << std::setw(14) << result.avgHandoverMs << std::endl;
+    }
+
+    ticker.stop();
+    for (MqttClient *client : {&publisher, &paths[0], &paths[1]})
+        client->disconnect();
+    return 0;
+}
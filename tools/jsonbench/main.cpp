@@ -0,0 +1,125 @@
+#include "jsonview.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Vergleich JsonView gegen QJsonDocument beim Lesen zweier Felder
+ *
+ * Ohne Argumente werden typische Nachrichten verwendet (Zustandsmeldung
+ * des Umschalters, message/new, message/err). Alternativ können Dateien
+ * mit mitgeschnittenen Nachrichten übergeben werden, eine Nachricht pro
+ * Zeile, gefolgt von den beiden zu lesenden Feldnamen:
+ *
+ *   jsonbench messages.jsonl text level
+ */
+
+struct Sample {
+    QByteArray name;
+    QByteArray payload;
+    QByteArray first;
+    QByteArray second;
+};
+
+static QList<Sample> builtinSamples()
+{
+    return {
+        {"switch/state",
+         R"({"state":"secure","id":4711})",
+         "state", "id"},
+        {"message/new",
+         R"({"id":182734,"timestamp":"2024-05-14T09:31:27.512Z","source":"gateway-03","level":"info",)"
+         R"("tags":["network","uplink"],"meta":{"seq":99812,"host":"gw03.local","retries":0},)"
+         R"("text":"Uplink secure wieder verfügbar, Latenz 4.2 ms"})",
+         "level", "text"},
+        {"message/err",
+         R"({"id":182735,"timestamp":"2024-05-14T09:31:28.004Z","source":"gateway-03","level":"error",)"
+         R"("code":503,"context":{"interface":"eth1","route":"default","history":[12,15,18,250,251]},)"
+         R"("text":"Broker nicht erreichbar: \"connection refused\" nach 3 Versuchen"})",
+         "code", "text"},
+    };
+}
+
+/// Mittlere Dauer in ns für eine Abfrage beider Felder
+template <typename Function>
+static double measure(const QByteArray &payload, Function function)
+{
+    const int rounds = qMax(1000, (int)(64LL * 1024 * 1024 / qMax(1, (int)payload.size())));
+    qint64 checksum = 0;
+
+    for (int i = 0; i < rounds / 10; ++i)
+        checksum += function(payload);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < rounds; ++i)
+        checksum += function(payload);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    // Ergebnis verwenden, damit die Schleife nicht entfällt
+    if (checksum == 42)
+        std::cout << "";
+    return (double)elapsedNs / rounds;
+}
+
+static void run(const Sample &sample)
+{
+    const char *first = sample.first.constData();
+    const char *second = sample.second.constData();
+
+    const double dom = measure(sample.payload, [first, second](const QByteArray &payload) {
+        const QJsonObject object = QJsonDocument::fromJson(payload).object();
+        return (qint64)object.value(first).toString().size() + (qint64)object.value(second).toString().size();
+    });
+
+    const double view = measure(sample.payload, [first, second](const QByteArray &payload) {
+        JsonView json(payload);
+        return (qint64)json.value(first).toString().size() + (qint64)json.value(second).toString().size();
+    });
+
+    const double raw = measure(sample.payload, [first, second](const QByteArray &payload) {
+        JsonView json(payload);
+        return (qint64)json.value(first).rawString().size() + (qint64)json.value(second).rawString().size();
+    });
+
+    std::cout << std::setw(14) << sample.name.constData() << std::setw(7) << sample.payload.size()
+              << std::setw(12) << std::fixed << std::setprecision(0) << dom
+              << std::setw(12) << view << std::setw(12) << raw
+              << std::setw(9) << std::setprecision(1) << dom / view << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QList<Sample> samples;
+
+    if (argc >= 4) {
+        QFile file(argv[1]);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << "Datei kann nicht geöffnet werden: " << argv[1] << std::endl;
+            return 1;
+        }
+        int line = 0;
+        while (!file.atEnd()) {
+            const QByteArray payload = file.readLine().trimmed();
+            if (!payload.isEmpty())
+                samples.append({"Zeile " + QByteArray::number(++line), payload, argv[2], argv[3]});
+        }
+    } else {
+        samples = builtinSamples();
+    }
+
+    std::cout << std::setw(14) << "Nachricht" << std::setw(7) << "Bytes"
+              << std::setw(12) << "QJson ns" << std::setw(12) << "View ns" << std::setw(12) << "Roh ns"
+              << std::setw(9) << "Faktor" << std::endl;
+
+    for (const Sample &sample : samples)
+        run(sample);
+
+    return 0;
+}
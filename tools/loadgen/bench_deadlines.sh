@@ -0,0 +1,26 @@
+#!/bin/sh
+# Fristverfehlung von Steuernachrichten unter Überlast: FIFO gegen EDF
+#
+# Läuft zweimal dieselbe Überlast (große Payloads, hohe Rate) gegen den
+# Broker, jeweils mit Steuernachrichten auf denselben Verbindungen:
+# - fifo: Steuernachrichten über publish(), in der Reihe hinter der Last
+# - edf:  Steuernachrichten über publishBefore(), nach Frist geordnet,
+#         abgelaufene werden vor dem Senden verworfen
+# Ausgewertet wird der Anteil der Steuernachrichten, die nicht vor ihrer
+# Frist beim Empfänger ankamen.
+#
+# Verwendung: bench_deadlines.sh [FRIST-MS] [weitere loadgen-Optionen]
+#   FRIST-MS  Frist einer Steuernachricht (Standard: 20)
+
+LOADGEN=${LOADGEN:-./loadgen}
+DEADLINE=${1:-20}
+[ $# -gt 0 ] && shift
+
+COMMON="--sessions 50 --threads 2 --pattern loopback --rate 2000 --payload exp:16384 --arrival poisson --duration 30 --control-rate 20 --control-deadline $DEADLINE"
+
+echo "=== FIFO ==="
+$LOADGEN $COMMON --control fifo "$@" | grep -E "^(Durchsatz|Latenz|Steuerung|  Verfehlt)"
+
+echo
+echo "=== EDF ==="
+$LOADGEN $COMMON --control edf "$@" | grep -E "^(Durchsatz|Latenz|Steuerung|  Verfehlt)"
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Vergleich der Latenzverteilung mit und ohne Thread-Platzierung
+#
+# Läuft zweimal dieselbe Last gegen den Broker: einmal mit freiem Scheduler,
+# einmal mit an CPUs gebundenen I/O-Threads, SCHED_FIFO und mlockall.
+# SCHED_FIFO und mlockall benötigen CAP_SYS_NICE / CAP_IPC_LOCK (z.B. root);
+# fehlen die Rechte, meldet loadgen das und misst nur mit CPU-Bindung.
+#
+# Verwendung: bench_pinning.sh [CPU-LISTE] [weitere loadgen-Optionen]
+#   CPU-LISTE  CPUs für die I/O-Threads (Standard: 2-3)
+
+LOADGEN=${LOADGEN:-./loadgen}
+CPUS=${1:-2-3}
+[ $# -gt 0 ] && shift
+
+COMMON="--sessions 500 --threads 2 --pattern loopback --rate 20 --arrival poisson --duration 30"
+
+echo "=== ohne Bindung ==="
+$LOADGEN $COMMON "$@" | grep -E "^(  |Durchsatz|Verloren|Latenz)"
+
+echo
+echo "=== gebunden an $CPUS, SCHED_FIFO/50, mlockall ==="
+$LOADGEN $COMMON --pin "$CPUS" --fifo 50 --mlock "$@" | grep -E "^(  |Durchsatz|Verloren|Latenz)"
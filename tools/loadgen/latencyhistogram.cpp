@@ -0,0 +1,82 @@
+#include "latencyhistogram.h"
+
+#include <limits>
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+/**
+ * @brief Bucket eines Werts
+ *
+ * Werte < 16 liegen direkt in Gruppe 0. Darüber bestimmt das höchste
+ * gesetzte Bit die Gruppe, die folgenden 4 Bit die Unterteilung.
+ */
+int LatencyHistogram::bucketIndex(quint64 value)
+{
+    if (value < SubBuckets)
+        return (int)value;
+
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - SubBits;
+    const int group = shift + 1;
+    if (group > Groups)
+        return BucketCount - 1;  // Überlauf im letzten Bucket sammeln
+    return group * SubBuckets + (int)((value >> shift) & (SubBuckets - 1));
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    const int group = index / SubBuckets;
+    const int sub = index % SubBuckets;
+    if (group == 0)
+        return sub;
+
+    const int shift = group - 1;
+    return ((qint64)(SubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 valueUs)
+{
+    const qint64 value = qMax<qint64>(0, valueUs);
+    m_buckets[bucketIndex((quint64)value)]++;
+    m_count++;
+    m_sum += value;
+    m_min = qMin(m_min, value);
+    m_max = qMax(m_max, value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BucketCount; ++i)
+        m_buckets[i] += other.m_buckets[i];
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = qMin(m_min, other.m_min);
+    m_max = qMax(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<qint64>::max();
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0)
+        return 0;
+
+    const quint64 rank = qMax<quint64>(1, (quint64)(percentile / 100.0 * m_count + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank)
+            return qMin(bucketUpperBound(i), m_max);
+    }
+    return m_max;
+}
@@ -0,0 +1,57 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <array>
+
+/**
+ * @brief Log-lineares Latenz-Histogramm mit fester Größe
+ *
+ * Werte (Mikrosekunden) werden in Gruppen pro Zweierpotenz mit je 16
+ * Unterteilungen einsortiert, der relative Fehler der Perzentile liegt
+ * damit unter 6,25 %. Aufzeichnen ist O(1) und allokationsfrei, Histogramme
+ * verschiedener Threads werden mit merge() zusammengeführt.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    /// Zeichnet einen Wert in Mikrosekunden auf (negative Werte zählen als 0)
+    void record(qint64 valueUs);
+
+    /// Addiert ein anderes Histogramm
+    void merge(const LatencyHistogram &other);
+
+    /// Setzt alle Zähler zurück
+    void reset();
+
+    /**
+     * @brief Wert beim gegebenen Perzentil
+     * @param percentile 0.0 - 100.0
+     * @return Obere Grenze des Buckets in Mikrosekunden (0 bei leerem Histogramm)
+     */
+    qint64 percentile(double percentile) const;
+
+    quint64 count() const { return m_count; }
+    qint64 min() const { return m_count ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_count ? (double)m_sum / m_count : 0.0; }
+
+private:
+    static constexpr int SubBits = 4;
+    static constexpr int SubBuckets = 1 << SubBits;
+    static constexpr int Groups = 40;                         ///< Bis ~2^43 us (> 100 Tage)
+    static constexpr int BucketCount = (Groups + 1) * SubBuckets;
+
+    static int bucketIndex(quint64 value);
+    static qint64 bucketUpperBound(int index);
+
+    std::array<quint64, BucketCount> m_buckets;
+    quint64 m_count;
+    qint64 m_sum;
+    qint64 m_min;
+    qint64 m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
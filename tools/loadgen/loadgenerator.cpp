@@ -0,0 +1,686 @@
+#include "loadgenerator.h"
+#include "messageenvelope.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QStringList>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+/// Takt des Verbindungsaufbaus in Millisekunden
+static constexpr int ConnectTickMs = 10;
+
+/// Wartezeit nach dem Ende der Publish-Phase für Nachzügler
+static constexpr int DrainMs = 1000;
+
+/// Kennung einer Steuernachricht (Bytes 16-23, Massendaten enthalten dort 'x')
+static const char ControlMarker[8] = {'C', 'T', 'R', 'L', 'C', 'T', 'R', 'L'};
+
+// ===== PayloadDistribution =====
+
+bool PayloadDistribution::parse(const QString &spec)
+{
+    const QStringList parts = spec.split(':');
+    bool ok1 = true, ok2 = true;
+
+    if (parts.size() == 2 && parts.at(0) == "fixed") {
+        kind = Fixed;
+        a = b = parts.at(1).toInt(&ok1);
+    } else if (parts.size() == 3 && parts.at(0) == "uniform") {
+        kind = Uniform;
+        a = parts.at(1).toInt(&ok1);
+        b = parts.at(2).toInt(&ok2);
+        ok2 = ok2 && b >= a;
+    } else if (parts.size() == 2 && parts.at(0) == "exp") {
+        kind = Exponential;
+        a = b = parts.at(1).toInt(&ok1);
+    } else {
+        return false;
+    }
+    return ok1 && ok2 && a > 0;
+}
+
+int PayloadDistribution::sample(QRandomGenerator &random) const
+{
+    int size = a;
+    if (kind == Uniform)
+        size = random.bounded(a, b + 1);
+    else if (kind == Exponential)
+        size = (int)(-std::log(1.0 - random.generateDouble()) * a);
+    return qBound(MinSize, size, MaxSize);
+}
+
+int PayloadDistribution::maximum() const
+{
+    if (kind == Exponential)
+        return MaxSize;
+    return qBound(MinSize, b, MaxSize);
+}
+
+// ===== LoadProfile =====
+
+bool LoadProfile::isPublisher(int session) const
+{
+    return pattern != FanOut || session < publishers;
+}
+
+bool LoadProfile::isSubscriber(int session) const
+{
+    return pattern != FanIn || session < subscribers;
+}
+
+QString LoadProfile::publishTopic(int session) const
+{
+    if (pattern == FanOut)
+        return topicPrefix + "/broadcast";
+    return topicPrefix + "/" + QString::number(session);
+}
+
+QString LoadProfile::subscribeTopic(int session) const
+{
+    if (pattern == FanIn)
+        return topicPrefix + "/#";
+    return publishTopic(session);
+}
+
+// ===== LoadSnapshot =====
+
+void LoadSnapshot::merge(const LoadSnapshot &other)
+{
+    sessions += other.sessions;
+    connected += other.connected;
+    sent += other.sent;
+    received += other.received;
+    bytesSent += other.bytesSent;
+    bytesReceived += other.bytesReceived;
+    lost += other.lost;
+    errors += other.errors;
+    behind += other.behind;
+    writes += other.writes;
+    writtenMessages += other.writtenMessages;
+    controlSent += other.controlSent;
+    controlOnTime += other.controlOnTime;
+    controlLate += other.controlLate;
+    controlExpired += other.controlExpired;
+    latency.merge(other.latency);
+}
+
+// ===== LoadWorker =====
+
+LoadWorker::LoadWorker(const LoadProfile &profile, MqttReactor *reactor, int firstSession, int sessionCount)
+    : m_profile(profile)
+    , m_reactor(reactor)
+    , m_timerWheel(reactor->timerWheel())
+    , m_sessions(sessionCount)
+    , m_firstSession(firstSession)
+    , m_nextToConnect(0)
+    , m_connectTimer(0)
+    , m_controlTimer(0)
+    , m_random((quint32)firstSession + 1)
+    , m_payload(profile.payload.maximum(), 'x')
+    , m_publishing(false)
+    , m_bytesSent(0)
+    , m_bytesReceived(0)
+    , m_errors(0)
+    , m_behind(0)
+    , m_controlSent(0)
+    , m_controlOnTime(0)
+    , m_controlLate(0)
+    , m_controlExpired(0)
+{
+    for (int slot = 0; slot < sessionCount; ++slot) {
+        m_sessions[slot].index = firstSession + slot;
+        m_sessions[slot].publishTopic = profile.publishTopic(firstSession + slot);
+    }
+}
+
+/**
+ * @brief Destruktor - Clients werden hier statt im QObject-Destruktor
+ *        freigegeben, da ihre Signale noch auf m_sessions zugreifen
+ */
+LoadWorker::~LoadWorker()
+{
+    m_timerWheel->cancel(m_connectTimer);
+    m_timerWheel->cancel(m_controlTimer);
+    for (Session &session : m_sessions) {
+        m_timerWheel->cancel(session.publishTimer);
+        session.publishTimer = 0;
+    }
+
+    m_publishing = false;
+    for (Session &session : m_sessions) {
+        delete session.client;
+        session.client = nullptr;
+    }
+}
+
+void LoadWorker::start()
+{
+    m_publishing = true;
+    m_connectTimer = m_timerWheel->scheduleRepeating(ConnectTickMs, [this]() { connectBatch(); });
+
+    if (m_profile.control != LoadProfile::ControlOff && m_profile.controlRate > 0) {
+        const int intervalMs = qMax(1, (int)(1000.0 / m_profile.controlRate));
+        m_controlTimer = m_timerWheel->scheduleRepeating(intervalMs, [this]() { onControlTimer(); });
+    }
+}
+
+void LoadWorker::stopPublishing()
+{
+    m_publishing = false;
+    m_timerWheel->cancel(m_controlTimer);
+    m_controlTimer = 0;
+    for (Session &session : m_sessions) {
+        m_timerWheel->cancel(session.publishTimer);
+        session.publishTimer = 0;
+    }
+}
+
+/**
+ * @brief Baut pro Takt einen Teil der Verbindungen auf
+ *
+ * Die Verbindungsrate wird gleichmäßig auf die Worker verteilt, damit
+ * der Broker nicht alle CONNECTs gleichzeitig erhält.
+ */
+void LoadWorker::connectBatch()
+{
+    const int perWorker = qMax(1, m_profile.connectRate / qMax(1, m_profile.threads));
+    const int perTick = qMax(1, perWorker * ConnectTickMs / 1000);
+    const QString idPrefix = QString("loadgen-%1-").arg(QCoreApplication::applicationPid());
+
+    for (int n = 0; n < perTick && m_nextToConnect < (int)m_sessions.size(); ++n) {
+        const int slot = m_nextToConnect++;
+        Session &session = m_sessions[slot];
+
+        session.client = new MqttClient(m_reactor, this);
+        session.client->setEnvelopeEnabled(m_profile.envelope);
+        session.client->setReceiveTimestampsEnabled(m_profile.receiveTimestamps);
+        session.client->setWriteBatchingEnabled(m_profile.batching != LoadProfile::BatchingOff);
+        if (m_profile.batching == LoadProfile::BatchingFixed)
+            session.client->writeBatchController().setFixedWindow(m_profile.fixedWindowMs);
+        if (m_profile.control == LoadProfile::ControlDeadline)
+            session.client->setControlBacklogLimit(16 * 1024);  // Massenlast zurückhalten, damit EDF greift
+
+        connect(session.client, &MqttClient::connected, this, [this, slot]() { onConnected(slot); });
+        connect(session.client, &MqttClient::disconnected, this, [this, slot]() { onDisconnected(slot); });
+        connect(session.client, &MqttClient::error, this, [this]() { m_errors++; });
+
+        session.client->connectToHost(m_profile.host, m_profile.port, idPrefix + QString::number(session.index));
+    }
+
+    if (m_nextToConnect >= (int)m_sessions.size()) {
+        m_timerWheel->cancel(m_connectTimer);
+        m_connectTimer = 0;
+    }
+}
+
+void LoadWorker::onConnected(int slot)
+{
+    Session &session = m_sessions[slot];
+    session.connected = true;
+
+    if (m_profile.isSubscriber(session.index)) {
+        MqttClient *client = session.client;
+        session.client->subscribe(m_profile.subscribeTopic(session.index), [this, slot, client](const QByteArray &payload) {
+            onMessage(slot, payload, client->receiveTimestampNs(), client->dispatchTimestampNs());
+        });
+    }
+
+    if (m_publishing && m_profile.isPublisher(session.index) && m_profile.rate > 0) {
+        // Erster Termin zufällig innerhalb eines Intervalls, damit die Sessions nicht im Gleichtakt senden
+        const qint64 now = (qint64)MessageEnvelope::monotonicNs();
+        session.nextSendNs = now + (qint64)(m_random.generateDouble() * (1e9 / m_profile.rate));
+        schedulePublish(slot, now);
+    }
+}
+
+void LoadWorker::onDisconnected(int slot)
+{
+    Session &session = m_sessions[slot];
+    session.connected = false;
+    m_timerWheel->cancel(session.publishTimer);
+    session.publishTimer = 0;
+}
+
+/**
+ * @brief Wertet eine empfangene Nachricht aus
+ *
+ * Die ersten 8 Byte der Payload enthalten den Sendezeitpunkt.
+ * Mit Kernel-Zeitstempel wird die Zeit im Empfangspfad zusätzlich in
+ * Wartezeit im Kernel und Verarbeitung im Prozess aufgeteilt.
+ */
+void LoadWorker::onMessage(int slot, const QByteArray &payload, qint64 receiveNs, qint64 dispatchNs)
+{
+    if (onControlMessage(payload))
+        return;
+
+    Session &session = m_sessions[slot];
+    session.received++;
+    m_bytesReceived += payload.size();
+
+    if (receiveNs > 0) {
+        m_totalKernelQueue.record(qMax<qint64>(0, dispatchNs - receiveNs) / 1000);
+        m_totalProcessing.record(qMax<qint64>(0, MqttClient::realtimeNs() - dispatchNs) / 1000);
+    }
+
+    if (payload.size() < PayloadDistribution::MinSize)
+        return;
+
+    qint64 sentNs;
+    memcpy(&sentNs, payload.constData(), sizeof(sentNs));
+    const qint64 latencyUs = ((qint64)MessageEnvelope::monotonicNs() - sentNs) / 1000;
+
+    m_intervalLatency.record(latencyUs);
+    m_totalLatency.record(latencyUs);
+
+    if (session.received == 1 || latencyUs < session.minLatencyUs)
+        session.minLatencyUs = latencyUs;
+    session.maxLatencyUs = qMax(session.maxLatencyUs, latencyUs);
+    session.sumLatencyUs += latencyUs;
+}
+
+/**
+ * @brief Sendet alle fälligen Nachrichten einer Session
+ *
+ * Die Sendetermine laufen unabhängig von der Timer-Auflösung weiter,
+ * bei hohen Raten werden mehrere Nachrichten pro Aufruf gesendet. Liegt
+ * die Session mehr als MaxBurst Termine zurück, entfallen die übrigen
+ * Termine und werden als "behind" gezählt.
+ */
+void LoadWorker::onPublishTimer(int slot)
+{
+    Session &session = m_sessions[slot];
+    session.publishTimer = 0;
+    if (!session.connected || !m_publishing)
+        return;
+
+    const qint64 now = (qint64)MessageEnvelope::monotonicNs();
+    int burst = 0;
+
+    while (session.nextSendNs <= now && burst < MaxBurst) {
+        const int size = m_profile.payload.sample(m_random);
+        const qint64 sentNs = (qint64)MessageEnvelope::monotonicNs();
+        memcpy(m_payload.data(), &sentNs, sizeof(sentNs));
+
+        session.client->publish(session.publishTopic, QByteArray::fromRawData(m_payload.constData(), size));
+        session.sent++;
+        m_bytesSent += size;
+
+        session.nextSendNs += nextGapNs();
+        burst++;
+    }
+
+    if (session.nextSendNs <= now) {
+        const double meanGapNs = 1e9 / m_profile.rate;
+        m_behind += (quint64)((now - session.nextSendNs) / meanGapNs) + 1;
+        session.nextSendNs = now + nextGapNs();
+    }
+
+    schedulePublish(slot, now);
+}
+
+/**
+ * @brief Sendet eine Steuernachricht pro verbundenem Publisher
+ *
+ * Die Steuernachrichten laufen neben der Massenlast auf demselben Topic.
+ * Mit ControlDeadline gehen sie über MqttClient::publishBefore(), sonst
+ * über publish() wie alle anderen Nachrichten.
+ */
+void LoadWorker::onControlTimer()
+{
+    if (!m_publishing)
+        return;
+
+    char payload[ControlPayloadSize];
+    memcpy(payload + 16, ControlMarker, sizeof(ControlMarker));
+
+    for (Session &session : m_sessions) {
+        if (!session.connected || !m_profile.isPublisher(session.index))
+            continue;
+
+        const qint64 sentNs = (qint64)MessageEnvelope::monotonicNs();
+        const qint64 deadlineNs = sentNs + (qint64)m_profile.controlDeadlineMs * 1000000;
+        memcpy(payload, &sentNs, sizeof(sentNs));
+        memcpy(payload + 8, &deadlineNs, sizeof(deadlineNs));
+        const QByteArray message = QByteArray::fromRawData(payload, ControlPayloadSize);
+
+        m_controlSent++;
+        if (m_profile.control == LoadProfile::ControlDeadline) {
+            if (!session.client->publishBefore(session.publishTopic, message, deadlineNs, [this]() { m_controlExpired++; }))
+                m_controlExpired++;
+        } else {
+            session.client->publish(session.publishTopic, message);
+        }
+    }
+}
+
+/**
+ * @brief Wertet eine Steuernachricht aus
+ * @return false wenn es keine Steuernachricht ist
+ */
+bool LoadWorker::onControlMessage(const QByteArray &payload)
+{
+    if (payload.size() != ControlPayloadSize || memcmp(payload.constData() + 16, ControlMarker, sizeof(ControlMarker)) != 0)
+        return false;
+
+    qint64 sentNs, deadlineNs;
+    memcpy(&sentNs, payload.constData(), sizeof(sentNs));
+    memcpy(&deadlineNs, payload.constData() + 8, sizeof(deadlineNs));
+
+    const qint64 now = (qint64)MessageEnvelope::monotonicNs();
+    m_totalControlLatency.record((now - sentNs) / 1000);
+    if (now <= deadlineNs)
+        m_controlOnTime++;
+    else
+        m_controlLate++;
+    return true;
+}
+
+void LoadWorker::schedulePublish(int slot, qint64 nowNs)
+{
+    Session &session = m_sessions[slot];
+    const qint64 delayNs = session.nextSendNs - nowNs;
+    const int delayMs = qMax(1, (int)((delayNs + 999999) / 1000000));
+    session.publishTimer = m_timerWheel->schedule(delayMs, [this, slot]() { onPublishTimer(slot); });
+}
+
+/**
+ * @brief Abstand bis zur nächsten Nachricht
+ *
+ * Poisson-Ankünfte haben exponentialverteilte Abstände.
+ */
+qint64 LoadWorker::nextGapNs()
+{
+    const double meanGapNs = 1e9 / m_profile.rate;
+    if (m_profile.arrival == LoadProfile::Poisson)
+        return qMax<qint64>(1, (qint64)(-std::log(1.0 - m_random.generateDouble()) * meanGapNs));
+    return qMax<qint64>(1, (qint64)meanGapNs);
+}
+
+LoadSnapshot LoadWorker::takeSnapshot()
+{
+    LoadSnapshot snapshot;
+    snapshot.sessions = (int)m_sessions.size();
+    snapshot.bytesSent = m_bytesSent;
+    snapshot.bytesReceived = m_bytesReceived;
+    snapshot.errors = m_errors;
+    snapshot.behind = m_behind;
+    snapshot.controlSent = m_controlSent;
+    snapshot.controlOnTime = m_controlOnTime;
+    snapshot.controlLate = m_controlLate;
+    snapshot.controlExpired = m_controlExpired;
+
+    for (const Session &session : m_sessions) {
+        if (session.connected)
+            snapshot.connected++;
+        snapshot.sent += session.sent;
+        snapshot.received += session.received;
+        if (session.client) {
+            snapshot.lost += session.client->sequenceTracker().totals().lost;
+            const WriteBatchController::Metrics &batching = session.client->writeBatchController().metrics();
+            snapshot.writes += batching.writes;
+            snapshot.writtenMessages += batching.messages;
+        }
+    }
+
+    snapshot.latency = m_intervalLatency;
+    m_intervalLatency.reset();
+    return snapshot;
+}
+
+QVector<SessionReport> LoadWorker::sessionReports() const
+{
+    QVector<SessionReport> reports;
+    reports.reserve((int)m_sessions.size());
+
+    for (const Session &session : m_sessions) {
+        SessionReport report;
+        report.index = session.index;
+        report.connected = session.connected;
+        report.sent = session.sent;
+        report.received = session.received;
+        report.lost = session.client ? session.client->sequenceTracker().totals().lost : 0;
+        report.minLatencyUs = session.minLatencyUs;
+        report.maxLatencyUs = session.maxLatencyUs;
+        report.avgLatencyUs = session.received ? (double)session.sumLatencyUs / session.received : 0.0;
+        reports.append(report);
+    }
+    return reports;
+}
+
+// ===== LoadGenerator =====
+
+/**
+ * @brief Konstruktor - startet einen Reactor-Thread pro Worker
+ *
+ * Die Sessions werden in zusammenhängenden Blöcken auf die Threads verteilt.
+ */
+LoadGenerator::LoadGenerator(const LoadProfile &profile, QObject *parent)
+    : QObject(parent)
+    , m_profile(profile)
+    , m_reportTimer(std::make_unique<QTimer>(this))
+    , m_lastReportMs(0)
+    , m_heapBefore(-1)
+    , m_heapPerSession(-1)
+{
+    const int threads = qBound(1, profile.threads, qMax(1, profile.sessions));
+    m_profile.threads = threads;
+
+    int first = 0;
+    for (int i = 0; i < threads; ++i) {
+        const int count = profile.sessions / threads + (i < profile.sessions % threads ? 1 : 0);
+
+        auto reactor = std::make_unique<MqttReactor>();
+        reactor->startThread(QString("loadgen-%1").arg(i));
+
+        ThreadTuning::Placement placement;
+        if (!m_profile.pinCpus.isEmpty())
+            placement.cpus = {m_profile.pinCpus.at(i % m_profile.pinCpus.size())};
+        placement.fifoPriority = m_profile.fifoPriority;
+        if (!placement.isDefault())
+            reactor->applyPlacement(placement);
+
+        LoadWorker *worker = new LoadWorker(m_profile, reactor.get(), first, count);
+        worker->moveToThread(reactor->thread());
+
+        m_reactors.push_back(std::move(reactor));
+        m_workers.append(worker);
+        first += count;
+    }
+
+    connect(m_reportTimer.get(), &QTimer::timeout, this, &LoadGenerator::onReportTimer);
+}
+
+/**
+ * @brief Destruktor - Worker werden in ihrem Thread freigegeben,
+ *        danach beenden die Reactors ihre Threads
+ */
+LoadGenerator::~LoadGenerator()
+{
+    for (int i = 0; i < m_workers.size(); ++i) {
+        LoadWorker *worker = m_workers.at(i);
+        QMetaObject::invokeMethod(m_reactors[i].get(), [worker]() { delete worker; }, Qt::BlockingQueuedConnection);
+    }
+    m_workers.clear();
+    m_reactors.clear();
+}
+
+void LoadGenerator::start()
+{
+    m_heapBefore = MqttReactor::heapInUse();
+    for (LoadWorker *worker : m_workers)
+        QMetaObject::invokeMethod(worker, [worker]() { worker->start(); });
+
+    // Publish-Phase beginnt erst, wenn alle Sessions verbunden sein sollten
+    const qint64 rampMs = (qint64)m_profile.sessions * 1000 / qMax(1, m_profile.connectRate);
+
+    std::cout << "Lastgenerator: " << m_profile.sessions << " Sessions auf " << m_profile.threads
+              << " Threads -> " << m_profile.host.toStdString() << ":" << m_profile.port
+              << " (Aufbau ~" << rampMs << " ms, Dauer " << m_profile.durationSec << " s)" << std::endl;
+
+    // Tatsächliche Platzierung, damit Messungen mit und ohne Bindung vergleichbar sind
+    std::cout << "  main      " << ThreadTuning::describeCurrentThread().toStdString() << std::endl;
+    for (size_t i = 0; i < m_reactors.size(); ++i)
+        std::cout << "  loadgen-" << i << " " << m_reactors[i]->placementReport().toStdString() << std::endl;
+
+    m_clock.start();
+    m_reportTimer->start(1000);
+    QTimer::singleShot((int)rampMs + m_profile.durationSec * 1000, this, [this]() { onDurationElapsed(); });
+}
+
+LoadSnapshot LoadGenerator::collect()
+{
+    LoadSnapshot total;
+    for (LoadWorker *worker : m_workers) {
+        LoadSnapshot snapshot;
+        QMetaObject::invokeMethod(worker, [worker, &snapshot]() {
+            snapshot = worker->takeSnapshot();
+        }, Qt::BlockingQueuedConnection);
+        total.merge(snapshot);
+    }
+    return total;
+}
+
+void LoadGenerator::onReportTimer()
+{
+    const qint64 nowMs = m_clock.elapsed();
+    const double intervalSec = qMax<qint64>(1, nowMs - m_lastReportMs) / 1000.0;
+    m_lastReportMs = nowMs;
+
+    LoadSnapshot snapshot = collect();
+    printLine(snapshot, intervalSec);
+    m_last = snapshot;
+
+    // Heap-Zuwachs je Session, sobald alle verbunden sind (enthält auch laufende Sendepuffer)
+    if (m_heapPerSession < 0 && m_heapBefore >= 0 && snapshot.sessions > 0 && snapshot.connected == snapshot.sessions)
+        m_heapPerSession = (MqttReactor::heapInUse() - m_heapBefore) / snapshot.sessions;
+}
+
+void LoadGenerator::printLine(const LoadSnapshot &snapshot, double intervalSec)
+{
+    const double txRate = (snapshot.sent - m_last.sent) / intervalSec;
+    const double rxRate = (snapshot.received - m_last.received) / intervalSec;
+    const double txMb = (snapshot.bytesSent - m_last.bytesSent) / intervalSec / 1e6;
+    const double rxMb = (snapshot.bytesReceived - m_last.bytesReceived) / intervalSec / 1e6;
+
+    std::cout << QString("t=%1s verbunden %2/%3 | tx %4 msg/s %5 MB/s | rx %6 msg/s %7 MB/s"
+                         " | p50 %8 us p99 %9 us p99.9 %10 us max %11 us | verloren %12 Fehler %13")
+                     .arg(m_clock.elapsed() / 1000)
+                     .arg(snapshot.connected).arg(snapshot.sessions)
+                     .arg(txRate, 0, 'f', 0).arg(txMb, 0, 'f', 2)
+                     .arg(rxRate, 0, 'f', 0).arg(rxMb, 0, 'f', 2)
+                     .arg(snapshot.latency.percentile(50)).arg(snapshot.latency.percentile(99))
+                     .arg(snapshot.latency.percentile(99.9)).arg(snapshot.latency.max())
+                     .arg(snapshot.lost).arg(snapshot.errors)
+                     .toStdString() << std::endl;
+}
+
+void LoadGenerator::onDurationElapsed()
+{
+    for (LoadWorker *worker : m_workers)
+        QMetaObject::invokeMethod(worker, [worker]() { worker->stopPublishing(); }, Qt::BlockingQueuedConnection);
+
+    QTimer::singleShot(DrainMs, this, [this]() { finish(); });
+}
+
+void LoadGenerator::finish()
+{
+    m_reportTimer->stop();
+    printSummary();
+    writeSessionReport();
+    emit finished();
+}
+
+/**
+ * @brief Gesamtauswertung über die ganze Laufzeit
+ */
+void LoadGenerator::printSummary()
+{
+    LoadSnapshot total = collect();
+
+    LatencyHistogram latency;
+    LatencyHistogram kernelQueue;
+    LatencyHistogram processing;
+    LatencyHistogram control;
+    for (LoadWorker *worker : m_workers) {
+        QMetaObject::invokeMethod(worker, [worker, &latency, &kernelQueue, &processing, &control]() {
+            latency.merge(worker->totalLatency());
+            kernelQueue.merge(worker->totalKernelQueue());
+            processing.merge(worker->totalProcessing());
+            control.merge(worker->totalControlLatency());
+        }, Qt::BlockingQueuedConnection);
+    }
+
+    const double seconds = m_clock.elapsed() / 1000.0;
+    std::cout << "===== Zusammenfassung =====" << std::endl
+              << "Sessions:     " << total.connected << "/" << total.sessions << " verbunden" << std::endl
+              << "Gesendet:     " << total.sent << " Nachrichten, " << total.bytesSent << " Bytes" << std::endl
+              << "Empfangen:    " << total.received << " Nachrichten, " << total.bytesReceived << " Bytes" << std::endl
+              << "Durchsatz:    " << (quint64)(total.received / seconds) << " msg/s (Mittel über " << seconds << " s)" << std::endl
+              << "Verloren:     " << total.lost << " (Sequenzlücken)" << std::endl
+              << "Ausgelassen:  " << total.behind << " Sendetermine (Überlast)" << std::endl
+              << "Fehler:       " << total.errors << std::endl
+              << "Heap/Session: " << (m_heapPerSession >= 0 ? QString::number(m_heapPerSession) + " Bytes" : QString("nicht gemessen")).toStdString()
+              << " nach Aufbau (Ziel ruhend, ohne Verbindung: " << MqttReactor::FootprintTarget << ")" << std::endl
+              << "Schreiben:    " << total.writes << " Schreibvorgänge, "
+              << (total.writes ? (double)total.writtenMessages / total.writes : 0.0) << " Nachrichten pro Schreibvorgang" << std::endl
+              << "Latenz (us):  min " << latency.min() << " mean " << (qint64)latency.mean()
+              << " p50 " << latency.percentile(50) << " p90 " << latency.percentile(90)
+              << " p99 " << latency.percentile(99) << " p99.9 " << latency.percentile(99.9)
+              << " max " << latency.max() << std::endl;
+
+    if (kernelQueue.count() > 0) {
+        std::cout << "  Kernel:     p50 " << kernelQueue.percentile(50) << " p99 " << kernelQueue.percentile(99)
+                  << " max " << kernelQueue.max() << " (Empfang bis Lesen)" << std::endl
+                  << "  Prozess:    p50 " << processing.percentile(50) << " p99 " << processing.percentile(99)
+                  << " max " << processing.max() << " (Lesen bis Handler)" << std::endl;
+    }
+
+    // Fristverfehlung: alles, was nicht rechtzeitig ankam (verspätet, verworfen, verloren)
+    if (total.controlSent > 0) {
+        const quint64 missed = total.controlSent - qMin(total.controlSent, total.controlOnTime);
+        const quint64 missing = total.controlSent - qMin(total.controlSent, total.controlOnTime + total.controlLate + total.controlExpired);
+        std::cout << "Steuerung:    " << (m_profile.control == LoadProfile::ControlDeadline ? "EDF" : "FIFO")
+                  << ", Frist " << m_profile.controlDeadlineMs << " ms: " << total.controlSent << " gesendet, "
+                  << total.controlOnTime << " rechtzeitig, " << total.controlLate << " verspätet, "
+                  << total.controlExpired << " verworfen, " << missing << " fehlend" << std::endl
+                  << "  Verfehlt:   " << 100.0 * missed / total.controlSent << " %"
+                  << " | Latenz (us) p50 " << control.percentile(50) << " p99 " << control.percentile(99)
+                  << " max " << control.max() << std::endl;
+    }
+}
+
+/**
+ * @brief Schreibt die Kennzahlen aller Sessions als CSV
+ */
+void LoadGenerator::writeSessionReport()
+{
+    if (m_sessionReportFile.isEmpty())
+        return;
+
+    QFile file(m_sessionReportFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        std::cout << "Kann " << m_sessionReportFile.toStdString() << " nicht schreiben" << std::endl;
+        return;
+    }
+
+    file.write("session,connected,sent,received,lost,min_us,avg_us,max_us\n");
+    for (LoadWorker *worker : m_workers) {
+        QVector<SessionReport> reports;
+        QMetaObject::invokeMethod(worker, [worker, &reports]() {
+            reports = worker->sessionReports();
+        }, Qt::BlockingQueuedConnection);
+
+        for (const SessionReport &report : reports) {
+            file.write(QString("%1,%2,%3,%4,%5,%6,%7,%8\n")
+                           .arg(report.index).arg(report.connected ? 1 : 0)
+                           .arg(report.sent).arg(report.received).arg(report.lost)
+                           .arg(report.minLatencyUs).arg(report.avgLatencyUs, 0, 'f', 1).arg(report.maxLatencyUs)
+                           .toUtf8());
+        }
+    }
+    std::cout << "Session-Kennzahlen geschrieben: " << m_sessionReportFile.toStdString() << std::endl;
+}
@@ -0,0 +1,285 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include "latencyhistogram.h"
+#include "mqttclient.h"
+#include "mqttreactor.h"
+
+#include <QObject>
+#include <QRandomGenerator>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Verteilung der Payload-Größen
+ *
+ * Jede Payload beginnt mit dem 8-Byte Sendezeitpunkt, kleinere Werte
+ * werden auf MinSize angehoben.
+ */
+struct PayloadDistribution
+{
+    enum Kind { Fixed, Uniform, Exponential };
+
+    static constexpr int MinSize = 8;                        ///< Platz für den Sendezeitpunkt
+    static constexpr int MaxSize = 256 * 1024;
+
+    Kind kind = Fixed;
+    int a = 64;                                              ///< Fixed: Größe, Uniform: Minimum, Exponential: Mittelwert
+    int b = 64;                                              ///< Uniform: Maximum
+
+    /**
+     * @brief Liest eine Verteilung aus "fixed:N", "uniform:MIN:MAX" oder "exp:MEAN"
+     * @return false bei ungültiger Angabe
+     */
+    bool parse(const QString &spec);
+
+    /// Zieht eine Payload-Größe
+    int sample(QRandomGenerator &random) const;
+
+    /// Größte mögliche Payload
+    int maximum() const;
+};
+
+/**
+ * @brief Lastprofil des Generators
+ *
+ * Muster:
+ * - Loopback: jede Session publiziert auf prefix/<n> und abonniert prefix/<n>
+ * - FanIn:    alle Sessions publizieren auf prefix/<n>, die ersten
+ *             subscribers Sessions abonnieren prefix/#
+ * - FanOut:   die ersten publishers Sessions publizieren auf prefix/broadcast,
+ *             alle Sessions abonnieren prefix/broadcast
+ */
+struct LoadProfile
+{
+    enum Pattern { Loopback, FanIn, FanOut };
+    enum Arrival { Constant, Poisson };
+    enum Batching { BatchingOff, BatchingAdaptive, BatchingFixed };
+    enum Control { ControlOff, ControlFifo, ControlDeadline };
+
+    QString host = QStringLiteral("localhost");
+    quint16 port = 1883;
+    QString topicPrefix = QStringLiteral("load");
+    int sessions = 1000;
+    int threads = 4;
+    Pattern pattern = Loopback;
+    int publishers = 1;                                      ///< Nur FanOut
+    int subscribers = 1;                                     ///< Nur FanIn
+    double rate = 1.0;                                       ///< Nachrichten pro Sekunde und publizierender Session
+    Arrival arrival = Constant;
+    PayloadDistribution payload;
+    int connectRate = 1000;                                  ///< Neue Verbindungen pro Sekunde (gesamt)
+    int durationSec = 30;                                    ///< Dauer der Publish-Phase
+    bool envelope = true;                                    ///< Umschlag für Verlusterkennung
+    Batching batching = BatchingAdaptive;                    ///< Strategie für das Sammeln ausgehender Pakete
+    int fixedWindowMs = 1;                                   ///< Fenster bei BatchingFixed
+    QVector<int> pinCpus;                                    ///< CPUs für die I/O-Threads, reihum vergeben (leer = frei)
+    int fifoPriority = 0;                                    ///< SCHED_FIFO Priorität der I/O-Threads (0 = aus)
+    bool receiveTimestamps = false;                          ///< Kernel-Empfangszeitstempel auswerten
+    Control control = ControlOff;                            ///< Steuernachrichten: aus, normal publizieren, mit Frist (EDF)
+    double controlRate = 10.0;                               ///< Steuernachrichten pro Sekunde und Publisher
+    int controlDeadlineMs = 20;                              ///< Frist einer Steuernachricht ab Sendeauftrag
+
+    bool isPublisher(int session) const;
+    bool isSubscriber(int session) const;
+    QString publishTopic(int session) const;
+    QString subscribeTopic(int session) const;
+};
+
+/**
+ * @brief Kennzahlen einer einzelnen Session
+ */
+struct SessionReport
+{
+    int index = 0;
+    bool connected = false;
+    quint64 sent = 0;
+    quint64 received = 0;
+    quint64 lost = 0;
+    qint64 minLatencyUs = 0;
+    qint64 maxLatencyUs = 0;
+    double avgLatencyUs = 0.0;
+};
+
+/**
+ * @brief Summe der Kennzahlen eines oder mehrerer Worker
+ */
+struct LoadSnapshot
+{
+    int sessions = 0;
+    int connected = 0;
+    quint64 sent = 0;
+    quint64 received = 0;
+    quint64 bytesSent = 0;
+    quint64 bytesReceived = 0;
+    quint64 lost = 0;
+    quint64 errors = 0;
+    quint64 behind = 0;                                      ///< Sendetermine, die wegen Überlast entfallen sind
+    quint64 writes = 0;                                      ///< Schreibvorgänge in die Sockets
+    quint64 writtenMessages = 0;                             ///< Darin enthaltene Nachrichten
+    quint64 controlSent = 0;                                 ///< Beauftragte Steuernachrichten
+    quint64 controlOnTime = 0;                               ///< Vor der Frist empfangen
+    quint64 controlLate = 0;                                 ///< Nach der Frist empfangen (Bandbreite verschwendet)
+    quint64 controlExpired = 0;                              ///< Vom Client wegen Frist verworfen
+    LatencyHistogram latency;
+
+    void merge(const LoadSnapshot &other);
+};
+
+/**
+ * @brief Sessions eines I/O-Threads
+ *
+ * Lebt im Thread eines MqttReactor. Alle Sessions teilen dessen Timer-Rad
+ * für Verbindungsaufbau und Sendetermine.
+ */
+class LoadWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Konstruktor
+     * @param profile Lastprofil
+     * @param reactor Reactor, in dessen Thread der Worker läuft
+     * @param firstSession Globale Nummer der ersten Session
+     * @param sessionCount Anzahl Sessions dieses Workers
+     */
+    LoadWorker(const LoadProfile &profile, MqttReactor *reactor, int firstSession, int sessionCount);
+    ~LoadWorker() override;
+
+    /// Startet den Verbindungsaufbau (im Worker-Thread aufrufen)
+    void start();
+
+    /// Beendet alle Sendetermine (im Worker-Thread aufrufen)
+    void stopPublishing();
+
+    /**
+     * @brief Kennzahlen seit dem letzten Aufruf
+     *
+     * Zähler sind kumuliert, das Latenz-Histogramm enthält nur das Intervall.
+     */
+    LoadSnapshot takeSnapshot();
+
+    /// Gesamtes Latenz-Histogramm seit dem Start
+    const LatencyHistogram& totalLatency() const { return m_totalLatency; }
+
+    /// Wartezeit im Kernel (Empfang bis Lesen) seit dem Start
+    const LatencyHistogram& totalKernelQueue() const { return m_totalKernelQueue; }
+
+    /// Verarbeitung im Prozess (Lesen bis Handler) seit dem Start
+    const LatencyHistogram& totalProcessing() const { return m_totalProcessing; }
+
+    /// Latenz der empfangenen Steuernachrichten seit dem Start
+    const LatencyHistogram& totalControlLatency() const { return m_totalControlLatency; }
+
+    /// Kennzahlen aller Sessions
+    QVector<SessionReport> sessionReports() const;
+
+private:
+    struct Session {
+        MqttClient *client = nullptr;
+        QString publishTopic;
+        int index = 0;
+        bool connected = false;
+        TimerWheel::TimerId publishTimer = 0;
+        qint64 nextSendNs = 0;
+        quint64 sent = 0;
+        quint64 received = 0;
+        qint64 minLatencyUs = 0;
+        qint64 maxLatencyUs = 0;
+        qint64 sumLatencyUs = 0;
+    };
+
+    static constexpr int MaxBurst = 64;                      ///< Maximal nachgeholte Sendetermine pro Aufruf
+    static constexpr int ControlPayloadSize = 24;            ///< Sendezeitpunkt, Frist, Kennung
+
+    void connectBatch();
+    void onConnected(int slot);
+    void onDisconnected(int slot);
+    void onMessage(int slot, const QByteArray &payload, qint64 receiveNs, qint64 dispatchNs);
+    void onPublishTimer(int slot);
+    void onControlTimer();
+    bool onControlMessage(const QByteArray &payload);
+    void schedulePublish(int slot, qint64 nowNs);
+    qint64 nextGapNs();
+
+    LoadProfile m_profile;
+    MqttReactor *m_reactor;
+    TimerWheel *m_timerWheel;
+    std::vector<Session> m_sessions;
+    int m_firstSession;
+    int m_nextToConnect;
+    TimerWheel::TimerId m_connectTimer;
+    TimerWheel::TimerId m_controlTimer;
+    QRandomGenerator m_random;
+    QByteArray m_payload;                                    ///< Wiederverwendeter Sendepuffer (größte Payload)
+    bool m_publishing;
+
+    quint64 m_bytesSent;
+    quint64 m_bytesReceived;
+    quint64 m_errors;
+    quint64 m_behind;
+    quint64 m_controlSent;
+    quint64 m_controlOnTime;
+    quint64 m_controlLate;
+    quint64 m_controlExpired;
+    LatencyHistogram m_intervalLatency;
+    LatencyHistogram m_totalLatency;
+    LatencyHistogram m_totalKernelQueue;
+    LatencyHistogram m_totalProcessing;
+    LatencyHistogram m_totalControlLatency;
+};
+
+/**
+ * @brief Lastgenerator für viele gleichzeitige MQTT-Sessions
+ *
+ * Verteilt die Sessions auf mehrere MqttReactor-Threads, gibt periodisch
+ * Durchsatz und Latenz-Perzentile aus und schreibt am Ende eine
+ * Zusammenfassung (optional mit CSV pro Session).
+ *
+ * Die Latenz wird über einen Sendezeitpunkt am Anfang jeder Payload
+ * gemessen (monotone Uhr, Sender und Empfänger im selben Prozess).
+ */
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LoadGenerator(const LoadProfile &profile, QObject *parent = nullptr);
+    ~LoadGenerator() override;
+
+    /// Startet Threads und Sessions
+    void start();
+
+    /// Datei für die CSV-Ausgabe pro Session (leer = keine)
+    void setSessionReportFile(const QString &path) { m_sessionReportFile = path; }
+
+signals:
+    /// Lauf ist beendet, Zusammenfassung wurde ausgegeben
+    void finished();
+
+private:
+    void onReportTimer();
+    void onDurationElapsed();
+    void finish();
+    LoadSnapshot collect();
+    void printLine(const LoadSnapshot &snapshot, double intervalSec);
+    void printSummary();
+    void writeSessionReport();
+
+    LoadProfile m_profile;
+    std::vector<std::unique_ptr<MqttReactor>> m_reactors;
+    QVector<LoadWorker*> m_workers;
+    std::unique_ptr<QTimer> m_reportTimer;
+    QElapsedTimer m_clock;
+    qint64 m_lastReportMs;
+    qint64 m_heapBefore;                                     ///< MqttReactor::heapInUse() vor dem Aufbau (-1 = unbekannt)
+    qint64 m_heapPerSession;                                 ///< Heap-Zuwachs je Session nach dem Aufbau (-1 = nicht gemessen)
+    LoadSnapshot m_last;
+    QString m_sessionReportFile;
+};
+
+#endif // LOADGENERATOR_H
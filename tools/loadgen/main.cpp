@@ -0,0 +1,152 @@
+#include "loadgenerator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QStringList>
+
+#include <iostream>
+
+/// true = Debug-Ausgaben der MqttClients anzeigen
+static bool s_verbose = false;
+
+/**
+ * @brief Unterdrückt die Debug-Ausgaben pro Nachricht
+ *
+ * Bei tausenden Sessions würde qDebug() aus MqttClient die Messung dominieren.
+ */
+static void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type == QtDebugMsg && !s_verbose)
+        return;
+    std::cerr << message.toStdString() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Lastgenerator: simuliert viele MQTT-Clients gegen einen Broker");
+    parser.addHelpOption();
+    parser.addOption({"host", "Broker-Adresse", "host", "localhost"});
+    parser.addOption({"port", "Broker-Port", "port", "1883"});
+    parser.addOption({"sessions", "Anzahl Sessions", "n", "1000"});
+    parser.addOption({"threads", "Anzahl I/O-Threads", "n", "4"});
+    parser.addOption({"pattern", "Muster: loopback, fanin, fanout", "pattern", "loopback"});
+    parser.addOption({"publishers", "Publizierende Sessions bei fanout", "n", "1"});
+    parser.addOption({"subscribers", "Abonnierende Sessions bei fanin", "n", "1"});
+    parser.addOption({"rate", "Nachrichten pro Sekunde und Publisher", "rate", "1"});
+    parser.addOption({"arrival", "Sendeabstände: constant, poisson", "arrival", "constant"});
+    parser.addOption({"payload", "Payload-Größe: fixed:N, uniform:MIN:MAX, exp:MEAN", "spec", "fixed:64"});
+    parser.addOption({"connect-rate", "Neue Verbindungen pro Sekunde", "rate", "1000"});
+    parser.addOption({"duration", "Dauer der Publish-Phase in Sekunden", "s", "30"});
+    parser.addOption({"prefix", "Topic-Präfix", "prefix", "load"});
+    parser.addOption({"batching", "Sammeln ausgehender Pakete: off, adaptive, fixed:MS", "policy", "adaptive"});
+    parser.addOption({"pin", "I/O-Threads reihum an CPUs binden, z.B. 2-5", "cpus"});
+    parser.addOption({"fifo", "I/O-Threads mit SCHED_FIFO und dieser Priorität", "prio", "0"});
+    parser.addOption({"mlock", "Prozessspeicher sperren (mlockall)"});
+    parser.addOption({"rx-timestamps", "Kernel-Empfangszeitstempel: Wartezeit im Kernel getrennt ausweisen"});
+    parser.addOption({"control", "Steuernachrichten neben der Last: fifo (publish) oder edf (mit Frist)", "mode"});
+    parser.addOption({"control-rate", "Steuernachrichten pro Sekunde und Publisher", "rate", "10"});
+    parser.addOption({"control-deadline", "Frist einer Steuernachricht in ms", "ms", "20"});
+    parser.addOption({"no-envelope", "Ohne Nachrichten-Umschlag (keine Verlusterkennung)"});
+    parser.addOption({"per-session", "CSV-Datei mit Kennzahlen pro Session", "file"});
+    parser.addOption({"verbose", "Debug-Ausgaben der Clients anzeigen"});
+    parser.process(app);
+
+    s_verbose = parser.isSet("verbose");
+    qInstallMessageHandler(messageHandler);
+
+    LoadProfile profile;
+    profile.host = parser.value("host");
+    profile.port = (quint16)parser.value("port").toInt();
+    profile.sessions = qMax(1, parser.value("sessions").toInt());
+    profile.threads = qMax(1, parser.value("threads").toInt());
+    profile.publishers = qMax(1, parser.value("publishers").toInt());
+    profile.subscribers = qMax(1, parser.value("subscribers").toInt());
+    profile.rate = parser.value("rate").toDouble();
+    profile.connectRate = qMax(1, parser.value("connect-rate").toInt());
+    profile.durationSec = qMax(1, parser.value("duration").toInt());
+    profile.topicPrefix = parser.value("prefix");
+    profile.envelope = !parser.isSet("no-envelope");
+    profile.receiveTimestamps = parser.isSet("rx-timestamps");
+
+    const QString pattern = parser.value("pattern");
+    if (pattern == "loopback") {
+        profile.pattern = LoadProfile::Loopback;
+    } else if (pattern == "fanin") {
+        profile.pattern = LoadProfile::FanIn;
+    } else if (pattern == "fanout") {
+        profile.pattern = LoadProfile::FanOut;
+    } else {
+        std::cerr << "Unbekanntes Muster: " << pattern.toStdString() << std::endl;
+        return 1;
+    }
+
+    const QString arrival = parser.value("arrival");
+    if (arrival == "constant") {
+        profile.arrival = LoadProfile::Constant;
+    } else if (arrival == "poisson") {
+        profile.arrival = LoadProfile::Poisson;
+    } else {
+        std::cerr << "Unbekannte Ankunftsverteilung: " << arrival.toStdString() << std::endl;
+        return 1;
+    }
+
+    const QStringList batching = parser.value("batching").split(':');
+    if (batching.at(0) == "off") {
+        profile.batching = LoadProfile::BatchingOff;
+    } else if (batching.at(0) == "adaptive") {
+        profile.batching = LoadProfile::BatchingAdaptive;
+    } else if (batching.at(0) == "fixed" && batching.size() == 2) {
+        profile.batching = LoadProfile::BatchingFixed;
+        profile.fixedWindowMs = qMax(0, batching.at(1).toInt());
+    } else {
+        std::cerr << "Unbekannte Batching-Strategie: " << parser.value("batching").toStdString() << std::endl;
+        return 1;
+    }
+
+    if (parser.isSet("control")) {
+        const QString control = parser.value("control");
+        if (control == "fifo") {
+            profile.control = LoadProfile::ControlFifo;
+        } else if (control == "edf") {
+            profile.control = LoadProfile::ControlDeadline;
+        } else {
+            std::cerr << "Unbekannter Steuermodus: " << control.toStdString() << std::endl;
+            return 1;
+        }
+        profile.controlRate = parser.value("control-rate").toDouble();
+        profile.controlDeadlineMs = qMax(1, parser.value("control-deadline").toInt());
+    }
+
+    if (!profile.payload.parse(parser.value("payload"))) {
+        std::cerr << "Ungültige Payload-Angabe: " << parser.value("payload").toStdString() << std::endl;
+        return 1;
+    }
+
+    if (parser.isSet("pin")) {
+        bool ok = false;
+        profile.pinCpus = ThreadTuning::parseCpuList(parser.value("pin"), &ok);
+        if (!ok || profile.pinCpus.isEmpty()) {
+            std::cerr << "Ungültige CPU-Liste: " << parser.value("pin").toStdString() << std::endl;
+            return 1;
+        }
+    }
+    profile.fifoPriority = qBound(0, parser.value("fifo").toInt(), 99);
+
+    // Vor dem Start der Threads, damit auch deren Stacks gesperrt werden
+    if (parser.isSet("mlock")) {
+        QString error;
+        if (!ThreadTuning::lockMemory(&error))
+            std::cerr << error.toStdString() << std::endl;
+    }
+
+    LoadGenerator generator(profile);
+    generator.setSessionReportFile(parser.value("per-session"));
+    QObject::connect(&generator, &LoadGenerator::finished, &app, &QCoreApplication::quit);
+    generator.start();
+
+    return app.exec();
+}
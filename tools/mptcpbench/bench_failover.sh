@@ -0,0 +1,67 @@
+#!/bin/sh
+# Failover-Zeit und Verlust beim Ausfall eines Uplinks, TCP gegen MPTCP
+#
+# Baut in einem unprivilegierten Network-Namespace (unshare -rn, kein root
+# nötig) zwei Uplinks und einen ungestörten Steuerpfad als veth-Paare zu
+# einem zweiten Namespace mit dem Broker auf:
+#
+#   mpa  10.0.1.2 <-> 10.0.1.1  Uplink A (wird getrennt)
+#   mpb  10.0.2.2 <-> 10.0.2.1  Uplink B (Reserve)
+#   ctl  10.0.9.2 <-> 10.0.9.1  Publisher
+#
+# Der Subflow über B erreicht den Broker über dieselbe Adresse wie A
+# (10.0.1.1), dafür gibt es eine Host-Route über mpb.
+#
+# Der Broker muss MPTCP annehmen, z.B. mosquitto über mptcpize (mptcpd);
+# ohne MPTCP fällt die Verbindung auf TCP zurück und mptcpbench warnt.
+#
+# Verwendung: bench_failover.sh [weitere mptcpbench-Optionen]
+#   MPTCPBENCH  Pfad zu mptcpbench (Standard: ./mptcpbench)
+#   BROKER      Broker-Befehl (Standard: mptcpize run mosquitto -c <Konfiguration>)
+
+MPTCPBENCH=${MPTCPBENCH:-./mptcpbench}
+
+if [ -z "$MPTCPBENCH_NETNS" ]; then
+    exec unshare -rn env MPTCPBENCH_NETNS=1 sh "$0" "$@"
+fi
+
+set -e
+
+CONF=$(mktemp)
+printf 'listener 1883 0.0.0.0\nallow_anonymous true\n' > "$CONF"
+BROKER=${BROKER:-"mptcpize run mosquitto -c $CONF"}
+
+# Namespace des Brokers - lebt, solange der Platzhalter-Prozess läuft
+unshare -n sleep 3600 &
+BROKER_NS=$!
+sleep 0.2
+IN_BROKER="nsenter -t $BROKER_NS -n"
+
+cleanup() {
+    [ -n "$BROKER_PID" ] && kill "$BROKER_PID" 2>/dev/null
+    kill "$BROKER_NS" 2>/dev/null
+    rm -f "$CONF"
+}
+trap cleanup EXIT
+
+ip link set lo up
+$IN_BROKER ip link set lo up
+for link in mpa:10.0.1 mpb:10.0.2 ctl:10.0.9; do
+    name=${link%%:*}
+    net=${link#*:}
+    ip link add name "$name" type veth peer name "${name}0"
+    ip link set "${name}0" netns "$BROKER_NS"
+    ip addr add "$net.2/24" dev "$name"
+    ip link set "$name" up
+    $IN_BROKER ip addr add "$net.1/24" dev "${name}0"
+    $IN_BROKER ip link set "${name}0" up
+done
+ip route add 10.0.1.1/32 via 10.0.2.1 dev mpb metric 200
+
+$IN_BROKER $BROKER &
+BROKER_PID=$!
+sleep 0.5
+
+# Endpunkte legt mptcpbench selbst an und räumt sie wieder ab
+$MPTCPBENCH --publish-host 10.0.9.1 --broker-a 10.0.1.1 --broker-b 10.0.2.1 \
+            --path-a 10.0.1.2 --path-b 10.0.2.2 --iface-a mpa --iface-b mpb "$@"
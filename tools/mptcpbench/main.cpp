@@ -0,0 +1,292 @@
+#include "messageenvelope.h"
+#include "mptcppathmanager.h"
+#include "mqttclient.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QSet>
+#include <QTimer>
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+/**
+ * @brief Ausfall eines Uplinks: TCP mit Übergabe gegen Multipath-TCP
+ *
+ * Ein Publisher sendet über einen eigenen, nie gestörten Pfad mit
+ * konstanter Rate; jede Payload trägt ihre laufende Nummer. Der Empfänger
+ * ist über Uplink A verbunden, Uplink B ist Reserve. Pro Runde wird A
+ * mit --fail-cmd getrennt und danach mit --restore-cmd wiederhergestellt:
+ * - tcp:      je Uplink eine Verbindung, nach dem Ausfall abonniert die
+ *             Verbindung über B (wie NetworkSelector ohne MPTCP)
+ * - mptcp:    eine MPTCP-Verbindung, A aktiv und B Reserve, der Kernel
+ *             erkennt den toten Subflow selbst
+ * - withdraw: wie mptcp, der Endpunkt von A wird sofort zurückgezogen
+ *             und B aktiv geschaltet (wie NetworkSelector mit MPTCP)
+ *
+ * Failover = Zeit vom Trennen bis zur ersten Nachricht, die nach dem
+ * Trennen gesendet wurde; Stillstand = längste Lücke zwischen zwei
+ * Zustellungen; Verloren = gesendet - eindeutig zugestellt.
+ *
+ * Die Pfadmanager-Befehle benötigen CAP_NET_ADMIN, der Aufbau mit
+ * Namespaces und veth-Paaren steht in bench_failover.sh.
+ */
+
+static const QString Topic = QStringLiteral("mptcp/bench");
+
+/// true = Debug-Ausgaben der MqttClients anzeigen
+static bool s_verbose = false;
+
+static void messageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type == QtDebugMsg && !s_verbose)
+        return;
+    std::cerr << message.toStdString() << std::endl;
+}
+
+/// Lässt die Event-Loop laufen
+static void waitMs(int ms)
+{
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+/// Wartet auf ein Signal des Clients oder den Timeout
+template<typename Signal>
+static void waitFor(MqttClient *client, Signal signal, int timeoutMs)
+{
+    QEventLoop loop;
+    QObject::connect(client, signal, &loop, [&loop]() { loop.quit(); });
+    QTimer::singleShot(timeoutMs, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+static bool connectClient(MqttClient *client, const QString &host, quint16 port, const QString &clientId)
+{
+    client->connectToHost(host, port, clientId);
+    if (!client->isConnected())
+        waitFor(client, &MqttClient::connected, 5000);
+    return client->isConnected();
+}
+
+/// Führt einen Shell-Befehl aus, %1 wird durch das Interface ersetzt
+static bool runCommand(const QString &command, const QString &interfaceName)
+{
+    const QString expanded = command.arg(interfaceName);
+    if (std::system(expanded.toLocal8Bit().constData()) != 0) {
+        std::cerr << "Befehl fehlgeschlagen: " << expanded.toStdString() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+struct Result {
+    int rounds = 0;
+    quint64 published = 0;
+    quint64 delivered = 0;
+    double failoverMs = 0.0;                                 ///< Summe über alle Runden
+    double maxFailoverMs = 0.0;
+    double maxStallMs = 0.0;
+    int multipathRounds = 0;                                 ///< Runden, in denen die Verbindung MPTCP sprach
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("mptcpbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Failover-Zeit und Verlust beim Ausfall eines Uplinks, TCP gegen MPTCP");
+    parser.addHelpOption();
+    parser.addOption({"publish-host", "Broker über den ungestörten Pfad des Publishers", "host", "10.0.9.1"});
+    parser.addOption({"broker-a", "Broker über Uplink A", "host", "10.0.1.1"});
+    parser.addOption({"broker-b", "Broker über Uplink B (nur tcp)", "host", "10.0.2.1"});
+    parser.addOption({"port", "Broker-Port", "port", "1883"});
+    parser.addOption({"path-a", "Eigene Adresse auf Uplink A", "address", "10.0.1.2"});
+    parser.addOption({"path-b", "Eigene Adresse auf Uplink B", "address", "10.0.2.2"});
+    parser.addOption({"iface-a", "Interface von Uplink A", "name", "mpa"});
+    parser.addOption({"iface-b", "Interface von Uplink B", "name", "mpb"});
+    parser.addOption({"fail-cmd", "Befehl zum Trennen (%1 = Interface)", "cmd", "ip link set %1 down"});
+    parser.addOption({"restore-cmd", "Befehl zum Wiederherstellen (%1 = Interface)", "cmd", "ip link set %1 up"});
+    parser.addOption({"rate", "Nachrichten pro Sekunde", "rate", "1000"});
+    parser.addOption({"rounds", "Ausfälle pro Modus", "n", "5"});
+    parser.addOption({"dwell", "Zeit vor und nach dem Ausfall in ms", "ms", "1500"});
+    parser.addOption({"mode", "Modus: tcp, mptcp, withdraw oder all", "mode", "all"});
+    parser.addOption({"verbose", "Debug-Ausgaben der Clients anzeigen"});
+    parser.process(app);
+
+    s_verbose = parser.isSet("verbose");
+    qInstallMessageHandler(messageHandler);
+
+    const quint16 port = (quint16)parser.value("port").toInt();
+    const double rate = qMax(1.0, parser.value("rate").toDouble());
+    const int rounds = qMax(1, parser.value("rounds").toInt());
+    const int dwellMs = qMax(200, parser.value("dwell").toInt());
+    const QString mode = parser.value("mode");
+    const QString pathA = parser.value("path-a");
+    const QString pathB = parser.value("path-b");
+    const QString interfaceA = parser.value("iface-a");
+    const QString interfaceB = parser.value("iface-b");
+
+    // Endpunkte für die MPTCP-Modi: A sendet, B ist Reserve
+    MptcpPathManager pathManager;
+    if (mode != "tcp") {
+        QString errorString;
+        if (!MptcpPathManager::isSupported()) {
+            std::cerr << "Kernel bietet kein MPTCP an" << std::endl;
+            return 1;
+        }
+        if (!pathManager.open(&errorString) || !pathManager.setLimits(2, 2, &errorString)
+            || !pathManager.addEndpoint(pathA, interfaceA, MptcpPathManager::Subflow, &errorString)
+            || !pathManager.addEndpoint(pathB, interfaceB, MptcpPathManager::Subflow | MptcpPathManager::Backup, &errorString)) {
+            std::cerr << errorString.toStdString() << std::endl;
+            return 1;
+        }
+    }
+
+    MqttClient publisher;
+    publisher.setWriteBatchingEnabled(false);
+    if (!connectClient(&publisher, parser.value("publish-host"), port, "mptcpbench-pub")) {
+        std::cerr << "Keine Verbindung zum Broker" << std::endl;
+        return 1;
+    }
+
+    // Konstante Senderate über einen 1-ms-Takt, Payload = laufende Nummer
+    quint64 published = 0;
+    double credit = 0.0;
+    bool publishing = false;
+    QByteArray payload(32, 'x');
+    QTimer ticker;
+    ticker.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&ticker, &QTimer::timeout, [&]() {
+        if (!publishing)
+            return;
+        credit += rate / 1000.0;
+        for (; credit >= 1.0; credit -= 1.0) {
+            memcpy(payload.data(), &published, sizeof(published));
+            publisher.publish(Topic, payload);
+            published++;
+        }
+    });
+    ticker.start(1);
+
+    auto runRound = [&](const QString &name, Result &result) {
+        const bool multipath = name != "tcp";
+        std::unique_ptr<MqttClient> primary = std::make_unique<MqttClient>();
+        std::unique_ptr<MqttClient> reserve;
+        primary->setMultipathEnabled(multipath);
+
+        QSet<quint64> received;
+        quint64 sequenceAtCut = 0;
+        qint64 cutNs = 0;
+        qint64 failoverNs = -1;
+        qint64 lastNs = 0;
+        qint64 maxGapNs = 0;
+        auto onMessage = [&](const QString &, const QByteArray &message) {
+            if (message.size() < (int)sizeof(quint64))
+                return;
+            quint64 sequence;
+            memcpy(&sequence, message.constData(), sizeof(sequence));
+            const qint64 nowNs = (qint64)MessageEnvelope::monotonicNs();
+            if (lastNs != 0)
+                maxGapNs = qMax(maxGapNs, nowNs - lastNs);
+            lastNs = nowNs;
+            if (cutNs != 0 && failoverNs < 0 && sequence >= sequenceAtCut)
+                failoverNs = nowNs - cutNs;
+            received.insert(sequence);
+        };
+
+        QObject::connect(primary.get(), &MqttClient::messageReceived, onMessage);
+        if (!connectClient(primary.get(), parser.value("broker-a"), port, "mptcpbench-a"))
+            return false;
+        if (multipath && primary->isMultipathActive())
+            result.multipathRounds++;
+
+        if (!multipath) {
+            // Reserve-Verbindung steht bereits, wie im NetworkRegistry
+            reserve = std::make_unique<MqttClient>();
+            QObject::connect(reserve.get(), &MqttClient::messageReceived, onMessage);
+            if (!connectClient(reserve.get(), parser.value("broker-b"), port, "mptcpbench-b"))
+                return false;
+        }
+
+        primary->subscribe(Topic);
+        waitFor(primary.get(), &MqttClient::subscriptionAcknowledged, 3000);
+
+        published = 0;
+        publishing = true;
+        waitMs(dwellMs);    // Zeit für den Beitritt des Subflows über B
+
+        sequenceAtCut = published;
+        cutNs = (qint64)MessageEnvelope::monotonicNs();
+        runCommand(parser.value("fail-cmd"), interfaceA);
+
+        // Reaktion auf den Linkverlust, wie sie LinkMonitor auslösen würde
+        QString errorString;
+        if (name == "tcp") {
+            reserve->subscribe(Topic);
+        } else if (name == "withdraw") {
+            if (!pathManager.removeEndpoint(pathA, &errorString) || !pathManager.setBackup(pathB, false, &errorString))
+                std::cerr << errorString.toStdString() << std::endl;
+        }
+
+        waitMs(dwellMs);
+        publishing = false;
+        waitMs(500);    // Nachzügler abwarten
+
+        result.rounds++;
+        result.published += published;
+        result.delivered += (quint64)received.size();
+        const double failoverMs = failoverNs < 0 ? dwellMs : failoverNs / 1e6;
+        result.failoverMs += failoverMs;
+        result.maxFailoverMs = qMax(result.maxFailoverMs, failoverMs);
+        result.maxStallMs = qMax(result.maxStallMs, maxGapNs / 1e6);
+
+        // Ausgangszustand für die nächste Runde
+        runCommand(parser.value("restore-cmd"), interfaceA);
+        if (name == "withdraw") {
+            if (!pathManager.addEndpoint(pathA, interfaceA, MptcpPathManager::Subflow, &errorString)
+                || !pathManager.setBackup(pathB, true, &errorString))
+                std::cerr << errorString.toStdString() << std::endl;
+        }
+        waitMs(300);
+        primary.reset();
+        reserve.reset();
+        return true;
+    };
+
+    std::cout << std::setw(10) << "Modus" << std::setw(8) << "Runden" << std::setw(11) << "Gesendet"
+              << std::setw(10) << "Verloren" << std::setw(14) << "Failover ms" << std::setw(14) << "max ms"
+              << std::setw(16) << "Stillstand ms" << std::endl;
+
+    for (const QString &name : {QStringLiteral("tcp"), QStringLiteral("mptcp"), QStringLiteral("withdraw")}) {
+        if (mode != "all" && mode != name)
+            continue;
+
+        Result result;
+        for (int i = 0; i < rounds; ++i) {
+            if (!runRound(name, result)) {
+                std::cerr << "Keine Verbindung über Uplink " << (name == "tcp" ? "A/B" : "A") << std::endl;
+                return 1;
+            }
+        }
+        if (name != "tcp" && result.multipathRounds < result.rounds)
+            std::cerr << "Warnung: Broker spricht kein MPTCP (" << result.rounds - result.multipathRounds
+                      << " Runden als TCP), z.B. mit mptcpize starten" << std::endl;
+
+        const quint64 lost = result.published > result.delivered ? result.published - result.delivered : 0;
+        std::cout << std::setw(10) << name.toStdString() << std::setw(8) << result.rounds << std::setw(11) << result.published
+                  << std::setw(10) << lost << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.failoverMs / result.rounds << std::setw(14) << result.maxFailoverMs
+                  << std::setw(16) << result.maxStallMs << std::endl;
+    }
+
+    ticker.stop();
+    publisher.disconnect();
+    return 0;
+}
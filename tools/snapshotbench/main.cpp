@@ -0,0 +1,113 @@
+#include "clientsnapshot.h"
+
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Kaltstart aus einem ClientSnapshot
+ *
+ * Misst pro Anzahl Topics die Zeit zum Schreiben, zum Einblenden bis zum
+ * ersten nutzbaren Wert und pro Lookup - im Vergleich zum vollständigen
+ * Laden aller Werte in einen QHash, wie es ein klassisches Deserialisieren
+ * vor dem ersten Zugriff erfordern würde.
+ */
+
+struct Result {
+    qint64 bytes = 0;
+    double writeMs = 0;
+    double firstValueUs = 0;
+    double lookupNs = 0;
+    double loadMs = 0;
+};
+
+static QString topicName(int i)
+{
+    return QString("sensor/%1/value").arg(i);
+}
+
+static Result measure(const QString &path, int topics)
+{
+    ClientSnapshot::Session session;
+    session.clientId = "snapshotbench";
+    session.activeNetwork = 0;
+
+    QVector<ClientSnapshot::Subscription> subscriptions;
+    ClientSnapshot::Subscription subscription;
+    subscription.topic = "sensor/#";
+    subscriptions.append(subscription);
+
+    QVector<ClientSnapshot::Value> values;
+    values.reserve(topics);
+    for (int i = 0; i < topics; ++i) {
+        ClientSnapshot::Value value;
+        value.topic = topicName(i);
+        value.value = QByteArray::number(i * 0.25) + QByteArray(24, 'x');
+        value.timestampMs = i;
+        values.append(value);
+    }
+
+    Result result;
+    QElapsedTimer timer;
+    timer.start();
+    if (!ClientSnapshot::write(path, session, subscriptions, values))
+        std::cerr << "Snapshot konnte nicht geschrieben werden" << std::endl;
+    result.writeMs = timer.nsecsElapsed() / 1e6;
+
+    // Kaltstart: Einblenden und erster Wert
+    const QString probe = topicName(topics / 2);
+    QByteArray value;
+    timer.restart();
+    ClientSnapshot snapshot;
+    if (!snapshot.open(path) || !snapshot.value(probe, &value))
+        std::cerr << "Snapshot konnte nicht gelesen werden" << std::endl;
+    result.firstValueUs = timer.nsecsElapsed() / 1e3;
+    result.bytes = snapshot.size();
+
+    QVector<QString> keys;
+    keys.reserve(topics);
+    for (int i = 0; i < topics; ++i)
+        keys.append(topicName((int)((i * 7919LL) % topics)));
+
+    int found = 0;
+    timer.restart();
+    for (const QString &key : keys)
+        found += snapshot.value(key, &value) ? 1 : 0;
+    result.lookupNs = (double)timer.nsecsElapsed() / topics;
+    if (found != topics)
+        std::cerr << "Fehlende Werte: " << topics - found << std::endl;
+
+    // Vergleich: alle Werte vor dem ersten Zugriff laden
+    timer.restart();
+    QHash<QString, QByteArray> loaded;
+    loaded.reserve(topics);
+    for (const ClientSnapshot::Value &entry : snapshot.values())
+        loaded.insert(entry.topic, entry.value);
+    result.loadMs = timer.nsecsElapsed() / 1e6;
+
+    return result;
+}
+
+int main()
+{
+    const QString path = QDir::tempPath() + "/snapshotbench.snap";
+
+    std::cout << std::setw(10) << "Topics" << std::setw(12) << "Bytes" << std::setw(14) << "Schreiben ms"
+              << std::setw(16) << "Erster Wert us" << std::setw(12) << "Lookup ns" << std::setw(14) << "Laden ms" << std::endl;
+
+    for (int topics : {100, 1000, 10000, 100000}) {
+        const Result result = measure(path, topics);
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << topics << std::setw(12) << result.bytes << std::setw(14) << result.writeMs
+                  << std::setw(16) << result.firstValueUs << std::setw(12) << result.lookupNs
+                  << std::setw(14) << result.loadMs << std::endl;
+    }
+
+    QFile::remove(path);
+    return 0;
+}